@@ -32,8 +32,98 @@
 #include <memory>
 #include <cstring>
 
+// The swaps of ranges use the widest SIMD instructions enabled at compile time.
+#if !defined(ITK_WRAPPING_PARSER)
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#    define ITK_BYTESWAPPER_USE_AVX2
+#  elif defined(__SSSE3__)
+#    include <tmmintrin.h>
+#    define ITK_BYTESWAPPER_USE_SSSE3
+#  elif defined(ITK_COMPILER_SUPPORTS_SSE2_32) || defined(ITK_COMPILER_SUPPORTS_SSE2_64)
+#    include <emmintrin.h>
+#    define ITK_BYTESWAPPER_USE_SSE2
+#  elif defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define ITK_BYTESWAPPER_USE_NEON
+#  endif
+#endif
+
 namespace itk
 {
+namespace ByteSwapperDetail
+{
+// Reverses the bytes of the words of VWordSize bytes at the start of the
+// range, a SIMD register at a time, and returns the number of words swapped.
+// The remaining words, fewer than a register, are left to the caller.
+template <unsigned int VWordSize>
+inline SizeValueType
+SwapRangeVectorized(char * pos, SizeValueType num)
+{
+  SizeValueType i = 0;
+#if defined(ITK_BYTESWAPPER_USE_AVX2) || defined(ITK_BYTESWAPPER_USE_SSSE3)
+  // Shuffle indices reversing each word, within each 16 byte lane.
+  alignas(32) char indices[32];
+  for (unsigned int j = 0; j < 32; ++j)
+  {
+    indices[j] = static_cast<char>((j % 16) / VWordSize * VWordSize + VWordSize - 1 - j % VWordSize);
+  }
+#endif
+#if defined(ITK_BYTESWAPPER_USE_AVX2)
+  const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i *>(indices));
+  for (; i + 32 / VWordSize <= num; i += 32 / VWordSize, pos += 32)
+  {
+    const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(pos), _mm256_shuffle_epi8(words, mask));
+  }
+#elif defined(ITK_BYTESWAPPER_USE_SSSE3)
+  const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(indices));
+  for (; i + 16 / VWordSize <= num; i += 16 / VWordSize, pos += 16)
+  {
+    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pos), _mm_shuffle_epi8(words, mask));
+  }
+#elif defined(ITK_BYTESWAPPER_USE_SSE2)
+  for (; i + 16 / VWordSize <= num; i += 16 / VWordSize, pos += 16)
+  {
+    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+    // Swap the bytes of each 2 byte word, then the 2 byte words of the longer words.
+    __m128i swapped = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+    if constexpr (VWordSize == 4)
+    {
+      swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(swapped, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    }
+    else if constexpr (VWordSize == 8)
+    {
+      swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(swapped, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pos), swapped);
+  }
+#elif defined(ITK_BYTESWAPPER_USE_NEON)
+  for (; i + 16 / VWordSize <= num; i += 16 / VWordSize, pos += 16)
+  {
+    const uint8x16_t words = vld1q_u8(reinterpret_cast<const uint8_t *>(pos));
+    if constexpr (VWordSize == 2)
+    {
+      vst1q_u8(reinterpret_cast<uint8_t *>(pos), vrev16q_u8(words));
+    }
+    else if constexpr (VWordSize == 4)
+    {
+      vst1q_u8(reinterpret_cast<uint8_t *>(pos), vrev32q_u8(words));
+    }
+    else
+    {
+      vst1q_u8(reinterpret_cast<uint8_t *>(pos), vrev64q_u8(words));
+    }
+  }
+#else
+  (void)pos;
+  (void)num;
+#endif
+  return i;
+}
+} // namespace ByteSwapperDetail
+
 // The following are the public methods --------------------------------
 //
 // Machine definitions
@@ -284,8 +374,10 @@ template <typename T>
 void
 ByteSwapper<T>::Swap2Range(void * ptr, BufferSizeType num)
 {
-  auto * pos = static_cast<char *>(ptr);
-  for (BufferSizeType i = 0; i < num; ++i)
+  auto *               pos = static_cast<char *>(ptr);
+  const BufferSizeType numberOfSwapped = ByteSwapperDetail::SwapRangeVectorized<2>(pos, num);
+  pos += numberOfSwapped * 2;
+  for (BufferSizeType i = numberOfSwapped; i < num; ++i)
   {
     Self::Swap2(pos);
     pos = pos + 2;
@@ -307,7 +399,7 @@ ByteSwapper<T>::SwapWrite2Range(const void * ptr, BufferSizeType num, OStreamTyp
   {
     memcpy(cpy.get(), ptr, chunkSize * 2);
 
-    Self::Swap2Range(cpy.get(), num);
+    Self::Swap2Range(cpy.get(), chunkSize);
 
     fp->write(cpy.get(), static_cast<std::streamsize>(2 * chunkSize));
     ptr = static_cast<const char *>(ptr) + chunkSize * 2;
@@ -336,9 +428,10 @@ template <typename T>
 void
 ByteSwapper<T>::Swap4Range(void * ptr, BufferSizeType num)
 {
-  auto * pos = static_cast<char *>(ptr);
-
-  for (BufferSizeType i = 0; i < num; ++i)
+  auto *               pos = static_cast<char *>(ptr);
+  const BufferSizeType numberOfSwapped = ByteSwapperDetail::SwapRangeVectorized<4>(pos, num);
+  pos += numberOfSwapped * 4;
+  for (BufferSizeType i = numberOfSwapped; i < num; ++i)
   {
     Self::Swap4(pos);
     pos = pos + 4;
@@ -362,7 +455,7 @@ ByteSwapper<T>::SwapWrite4Range(const void * ptr, BufferSizeType num, OStreamTyp
   {
     memcpy(cpy.get(), ptr, chunkSize * 4);
 
-    Self::Swap4Range(cpy.get(), num);
+    Self::Swap4Range(cpy.get(), chunkSize);
 
     fp->write(cpy.get(), static_cast<std::streamsize>(4 * chunkSize));
     ptr = static_cast<const char *>(ptr) + chunkSize * 4;
@@ -394,9 +487,10 @@ template <typename T>
 void
 ByteSwapper<T>::Swap8Range(void * ptr, BufferSizeType num)
 {
-  auto * pos = static_cast<char *>(ptr);
-
-  for (BufferSizeType i = 0; i < num; ++i)
+  auto *               pos = static_cast<char *>(ptr);
+  const BufferSizeType numberOfSwapped = ByteSwapperDetail::SwapRangeVectorized<8>(pos, num);
+  pos += numberOfSwapped * 8;
+  for (BufferSizeType i = numberOfSwapped; i < num; ++i)
   {
     Self::Swap8(pos);
     pos = pos + 8;
@@ -432,4 +526,9 @@ ByteSwapper<T>::SwapWrite8Range(const void * ptr, BufferSizeType num, OStreamTyp
 }
 } // end namespace itk
 
+#undef ITK_BYTESWAPPER_USE_AVX2
+#undef ITK_BYTESWAPPER_USE_SSSE3
+#undef ITK_BYTESWAPPER_USE_SSE2
+#undef ITK_BYTESWAPPER_USE_NEON
+
 #endif
@@ -513,6 +513,17 @@ public:
     return true;
   }
 
+  /** Return the memory, in bytes, of the bulk data needed to hold the
+   * RequestedRegion. This is used to predict the memory of a pipeline
+   * update before it is executed (see PipelineMemory). Default
+   * implementation returns 0, for DataObjects which do not know the
+   * size of their bulk data. */
+  virtual SizeValueType
+  GetRequestedRegionMemorySize() const
+  {
+    return 0;
+  }
+
   /** Copy information from the specified data set.  This method is
    * part of the pipeline execution model. By default, a ProcessObject
    * will copy meta-data from the first input to all of its
@@ -320,6 +320,10 @@ public:
   unsigned int
   GetNumberOfComponentsPerPixel() const override;
 
+  /** Return the memory, in bytes, of the pixels of the RequestedRegion. */
+  SizeValueType
+  GetRequestedRegionMemorySize() const override;
+
   /** Returns (image1 == image2).
    * \note `operator==` and `operator!=` are defined as function templates
    * (rather than as non-templates), just to allow template instantiation of
@@ -61,8 +61,14 @@ Image<TPixel, VImageDimension>::Initialize()
 
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
-  // Grafted outputs and in place filters).
+  // Grafted outputs and in place filters). The allocation policy set
+  // for this image is kept.
+  const PixelContainerPointer oldBuffer = m_Buffer;
   m_Buffer = PixelContainer::New();
+  if (oldBuffer)
+  {
+    m_Buffer->SetAllocationPolicy(oldBuffer->GetAllocationPolicy());
+  }
 }
 
 
@@ -144,6 +150,14 @@ Image<TPixel, VImageDimension>::GetNumberOfComponentsPerPixel() const
 }
 
 
+template <typename TPixel, unsigned int VImageDimension>
+auto
+Image<TPixel, VImageDimension>::GetRequestedRegionMemorySize() const -> SizeValueType
+{
+  return this->GetRequestedRegion().GetNumberOfPixels() * sizeof(PixelType);
+}
+
+
 template <typename TPixel, unsigned int VImageDimension>
 void
 Image<TPixel, VImageDimension>::PrintSelf(std::ostream & os, Indent indent) const
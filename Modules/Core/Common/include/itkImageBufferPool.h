@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferPool_h
+#define itkImageBufferPool_h
+
+#include "itkImageBufferAllocationPolicy.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace itk
+{
+
+/**
+ * \class ImageBufferPool
+ * \brief Process-wide cache of image buffers, recycled between allocations.
+ *
+ * A pipeline re-allocates its intermediate images at every Update(), and
+ * releases them again when their ReleaseDataFlag is set. When the pool is
+ * enabled, image buffers released by ImportImageContainer are kept, up to
+ * MaximumNumberOfBytes, and handed out again to the next allocation of the
+ * same size class, which avoids the page faults of freshly mapped memory.
+ *
+ * Sizes are rounded up to size classes spaced by a quarter of a power of two
+ * (at most 25% overhead). Buffers smaller than MinimumNumberOfBytes are not
+ * pooled. When the cap is reached, the least recently released buffers are
+ * freed first. The pool is thread safe.
+ *
+ * The pool is disabled by default. It is enabled with SetEnabled(true), or
+ * with the environment variable ITK_IMAGE_BUFFER_POOL set to ON; its cap can
+ * be set with ITK_IMAGE_BUFFER_POOL_MAXIMUM_BYTES.
+ *
+ * \sa ImageBufferAllocationPolicy
+ * \ingroup ITKCommon
+ */
+
+struct ImageBufferPoolGlobals;
+
+class ITKCommon_EXPORT ImageBufferPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageBufferPool);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferPool, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the ImageBufferPool */
+  static Pointer
+  GetInstance();
+
+  /** Enable or disable the pool. Disabling it frees the cached buffers;
+   * buffers handed out before are still recognized when released. */
+  static void
+  SetEnabled(bool enabled);
+  static bool
+  GetEnabled();
+
+  /** Maximum number of bytes of the buffers cached by the pool (not of the
+   * buffers in use). Default is 1 GiB. */
+  void
+  SetMaximumNumberOfBytes(SizeValueType maximumNumberOfBytes);
+  SizeValueType
+  GetMaximumNumberOfBytes() const;
+
+  /** Buffers smaller than this are allocated and freed directly. */
+  static constexpr SizeValueType MinimumNumberOfBytes = 64 * 1024;
+
+  /** Size class used for a buffer of the given size. */
+  static SizeValueType
+  GetSizeClass(SizeValueType numberOfBytes);
+
+  /** Statistics of the pool, since its creation or ResetStatistics(). */
+  struct Statistics
+  {
+    /** Allocations served by a cached buffer. */
+    SizeValueType Hits{ 0 };
+    /** Pooled allocations which required a new buffer. */
+    SizeValueType Misses{ 0 };
+    /** Cached buffers freed to respect the cap (or by Clear()). */
+    SizeValueType Evictions{ 0 };
+    /** Bytes of the buffers currently cached, and their peak value. */
+    SizeValueType CachedBytes{ 0 };
+    SizeValueType PeakCachedBytes{ 0 };
+    /** Bytes of the pooled buffers currently in use, and their peak value. */
+    SizeValueType InUseBytes{ 0 };
+    SizeValueType PeakInUseBytes{ 0 };
+  };
+  Statistics
+  GetStatistics() const;
+  void
+  ResetStatistics();
+
+  /** Free all cached buffers. */
+  void
+  Clear();
+
+  /** Return a buffer of at least numberOfBytes, allocated according to the
+   * policy: a cached one if available, a new one otherwise. Returns nullptr
+   * when the allocation fails. Called by ImageBufferAllocationPolicy. */
+  void *
+  Acquire(SizeValueType numberOfBytes, const ImageBufferAllocationPolicy & policy);
+
+  /** Take back a buffer returned by Acquire(). Returns false (leaving the
+   * memory to the caller) when the buffer does not come from the pool. */
+  static bool
+  Release(void * memory);
+
+protected:
+  ImageBufferPool();
+  ~ImageBufferPool() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(ImageBufferPoolGlobals, PimplGlobals);
+
+  /** Buffers are only interchangeable when they have the same size class
+   * and were allocated with the same alignment and huge page advice. */
+  struct Key
+  {
+    SizeValueType m_SizeClass;
+    SizeValueType m_Alignment;
+    bool          m_UseHugePages;
+
+    bool
+    operator==(const Key & other) const
+    {
+      return m_SizeClass == other.m_SizeClass && m_Alignment == other.m_Alignment &&
+             m_UseHugePages == other.m_UseHugePages;
+    }
+  };
+
+  struct CachedBuffer
+  {
+    Key    m_Key;
+    void * m_Memory;
+  };
+
+  bool
+  ReleaseBuffer(void * memory);
+
+  /** Free cached buffers, least recently released first, until at most
+   * numberOfBytes remain cached. Called with m_Mutex locked. */
+  void
+  EvictUntil(SizeValueType numberOfBytes);
+
+  mutable std::mutex m_Mutex;
+
+  /** Cached buffers, most recently released first. */
+  std::list<CachedBuffer> m_CachedBuffers;
+
+  /** Buffers handed out by Acquire() and not released yet. */
+  std::unordered_map<void *, Key> m_BuffersInUse;
+
+  SizeValueType m_MaximumNumberOfBytes;
+  Statistics    m_Statistics;
+
+  static ImageBufferPoolGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+
+#endif
@@ -226,6 +226,28 @@ public:
   ProcessObject::DataObjectPointer
   MakeOutput(const ProcessObject::DataObjectIdentifierType &) override;
 
+  /** Set/Get the minimum number of output pixels processed by one work unit
+   * (the grain size) with dynamic multi-threading. When the output requested
+   * region has fewer than NumberOfWorkUnits * GrainSize pixels, it is split
+   * into fewer pieces, so that cheap filters do not pay the scheduling
+   * overhead of many tiny pieces on small images. The grain size is rounded
+   * up to whole slices along the dimension cut by the splitter, the
+   * outermost dimension of more than one pixel. Zero (the default) means
+   * that the grain size is derived from the PixelCostHint. */
+  itkSetMacro(GrainSize, SizeValueType);
+  itkGetConstMacro(GrainSize, SizeValueType);
+
+  /** Set/Get an estimate of the time needed to produce one output pixel,
+   * in nanoseconds. Zero (the default) means unknown. When known, the
+   * number of pieces used by dynamic multi-threading is adapted to the
+   * amount of work: cheap filters get at least
+   * ImageSourceCommon::MinimumWorkUnitDuration of work per piece, and
+   * expensive filters are split into more pieces than NumberOfWorkUnits so
+   * that the load is balanced over the threads.
+   * \sa ImageSourceCommon::ComputeNumberOfWorkUnits */
+  itkSetMacro(PixelCostHint, double);
+  itkGetConstMacro(PixelCostHint, double);
+
 protected:
   ImageSource();
   ~ImageSource() override = default;
@@ -400,6 +422,10 @@ protected:
   itkBooleanMacro(DynamicMultiThreading);
 
   bool m_DynamicMultiThreading{};
+
+private:
+  SizeValueType m_GrainSize{ 0 };
+  double        m_PixelCostHint{ 0.0 };
 };
 } // end namespace itk
 
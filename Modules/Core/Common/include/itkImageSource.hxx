@@ -225,10 +225,23 @@ ImageSource<TOutputImage>::GenerateData()
   }
   else
   {
-    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    // ParallelizeImageRegion splits the region with the global default
+    // splitter, along its outermost dimension of more than one pixel.
+    const OutputImageRegionType & requestedRegion = this->GetOutput()->GetRequestedRegion();
+    unsigned int                  splitDimension = OutputImageDimension - 1;
+    while (splitDimension > 0 && requestedRegion.GetSize(splitDimension) <= 1)
+    {
+      --splitDimension;
+    }
+    this->GetMultiThreader()->SetNumberOfWorkUnits(
+      ImageSourceCommon::ComputeNumberOfWorkUnits(requestedRegion.GetNumberOfPixels(),
+                                                  requestedRegion.GetSize(splitDimension),
+                                                  this->GetNumberOfWorkUnits(),
+                                                  m_GrainSize,
+                                                  m_PixelCostHint));
     this->GetMultiThreader()->SetUpdateProgress(this->GetThreaderUpdateProgress());
     this->GetMultiThreader()->template ParallelizeImageRegion<OutputImageDimension>(
-      this->GetOutput()->GetRequestedRegion(),
+      requestedRegion,
       [this](const OutputImageRegionType & outputRegionForThread) {
         this->DynamicThreadedGenerateData(outputRegionForThread);
       },
@@ -315,6 +328,8 @@ ImageSource<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "DynamicMultiThreading: " << (m_DynamicMultiThreading ? "On" : "Off") << std::endl;
+  os << indent << "GrainSize: " << m_GrainSize << std::endl;
+  os << indent << "PixelCostHint: " << m_PixelCostHint << std::endl;
 }
 
 } // end namespace itk
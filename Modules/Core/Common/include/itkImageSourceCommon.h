@@ -20,6 +20,7 @@
 
 #include "ITKCommonExport.h"
 #include "itkImageRegionSplitterBase.h"
+#include "itkIntTypes.h"
 
 namespace itk
 {
@@ -43,6 +44,31 @@ struct ITKCommon_EXPORT ImageSourceCommon
    */
   static const ImageRegionSplitterBase *
   GetGlobalDefaultSplitter();
+
+  /** Work (in nanoseconds) below which a piece is not worth scheduling on
+   * its own, which is in the order of the cost of handing a piece to a
+   * thread, and above which a piece is likely to cause load imbalance. */
+  static constexpr double MinimumWorkUnitDuration = 5.0e3;
+  static constexpr double MaximumWorkUnitDuration = 20.0e6;
+
+  /** Number of pieces into which a region of numberOfPixels pixels should be
+   * split for dynamic multi-threading, given the filter's numberOfWorkUnits.
+   * The pieces are slices of the region along the dimension cut by the
+   * global default splitter, whose size is splitDimensionSize.
+   *
+   * If grainSize is zero and pixelCostHint (in nanoseconds per pixel) is
+   * positive, the grain size is MinimumWorkUnitDuration / pixelCostHint
+   * pixels, and numberOfWorkUnits is raised so that no piece represents
+   * more than MaximumWorkUnitDuration of work. The grain size is rounded up
+   * to whole slices, and the result is reduced so that each piece has at
+   * least one grain of pixels. Without grain size nor cost hint,
+   * numberOfWorkUnits is returned unchanged. */
+  static ThreadIdType
+  ComputeNumberOfWorkUnits(SizeValueType numberOfPixels,
+                           SizeValueType splitDimensionSize,
+                           ThreadIdType  numberOfWorkUnits,
+                           SizeValueType grainSize,
+                           double        pixelCostHint);
 };
 
 } // end namespace itk
@@ -20,6 +20,8 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocationPolicy.h"
+#include "itkImageBufferPool.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +38,11 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * The memory allocated by the container follows its allocation policy
+ * (alignment, huge pages, parallel first touch), which defaults to the
+ * global default of ImageBufferAllocationPolicy. When the ImageBufferPool is
+ * enabled, buffers are drawn from and returned to the pool.
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -146,11 +153,34 @@ public:
    *  is intended to be used by external applications.
    *  Note that the normal logic of this class set the value of the boolean
    *  flag. This may override your setting if you call this methods prematurely.
+   *  The memory of a buffer allocated according to a non-default allocation
+   *  policy, or from the ImageBufferPool, cannot be released with delete[]:
+   *  turning the memory management off for such a buffer throws an
+   *  exception.
    *  \warning Improper use of these methods will result in memory leaks */
-  itkSetMacro(ContainerManageMemory, bool);
+  virtual void
+  SetContainerManageMemory(const bool containerManageMemory);
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the policy used by the next allocations of the container.
+   * The current buffer is not reallocated.
+   * \sa ImageBufferAllocationPolicy */
+  void
+  SetAllocationPolicy(const ImageBufferAllocationPolicy & policy)
+  {
+    if (m_AllocationPolicy != policy)
+    {
+      m_AllocationPolicy = policy;
+      this->Modified();
+    }
+  }
+  const ImageBufferAllocationPolicy &
+  GetAllocationPolicy() const
+  {
+    return m_AllocationPolicy;
+  }
+
 protected:
   ImportImageContainer() = default;
   ~ImportImageContainer() override;
@@ -164,7 +194,9 @@ protected:
   /**
    * Allocates elements of the array.  If UseDefaultConstructor is true, then
    * the default constructor is used to initialize each element.  POD date types
-   * initialize to zero.
+   * initialize to zero. The elements are allocated with new[] when the
+   * allocation policy is the default one and the ImageBufferPool is disabled,
+   * otherwise as the policy specifies.
    */
   virtual TElement *
   AllocateElements(ElementIdentifier size, bool UseDefaultConstructor = false) const;
@@ -203,6 +235,8 @@ private:
   TElementIdentifier m_Size{};
   TElementIdentifier m_Capacity{};
   bool               m_ContainerManageMemory{ true };
+
+  ImageBufferAllocationPolicy m_AllocationPolicy{ ImageBufferAllocationPolicy::GetGlobalDefault() };
 };
 } // end namespace itk
 
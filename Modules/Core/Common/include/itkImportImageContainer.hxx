@@ -29,6 +29,8 @@
 #define itkImportImageContainer_hxx
 
 #include <algorithm> // For copy_n.
+#include <memory>    // For uninitialized_value_construct_n, destroy_n.
+#include <type_traits>
 
 namespace itk
 {
@@ -94,7 +96,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
     if (m_Size < m_Capacity)
     {
       const TElementIdentifier size = m_Size;
-      TElement *               temp = this->AllocateElements(size, false);
+      TElement * temp = this->AllocateElements(size, false);
       std::copy_n(m_ImportPointer, m_Size, temp);
 
       DeallocateManagedMemory();
@@ -150,6 +152,22 @@ ImportImageContainer<TElementIdentifier, TElement>::SetImportPointer(TElement *
   this->Modified();
 }
 
+template <typename TElementIdentifier, typename TElement>
+void
+ImportImageContainer<TElementIdentifier, TElement>::SetContainerManageMemory(const bool containerManageMemory)
+{
+  // The application would release the buffer with delete[].
+  if (!containerManageMemory && ImageBufferAllocationPolicy::IsAllocated(m_ImportPointer))
+  {
+    itkExceptionMacro(<< "The memory of a buffer allocated by an allocation policy is managed by the container.");
+  }
+  if (m_ContainerManageMemory != containerManageMemory)
+  {
+    m_ContainerManageMemory = containerManageMemory;
+    this->Modified();
+  }
+}
+
 template <typename TElementIdentifier, typename TElement>
 TElement *
 ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIdentifier size,
@@ -160,6 +178,36 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
   // does not do this by default.
   TElement * data;
 
+  if (!m_AllocationPolicy.IsDefault() || ImageBufferPool::GetEnabled())
+  {
+    data = static_cast<TElement *>(m_AllocationPolicy.Allocate(size * sizeof(TElement)));
+    if (!data)
+    {
+      throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+    }
+    const bool touched = m_AllocationPolicy.GetParallelFirstTouch();
+    if (touched)
+    {
+      ImageBufferAllocationPolicy::TouchInParallel(data, size * sizeof(TElement));
+    }
+    if (!std::is_trivially_default_constructible<TElement>::value)
+    {
+      if (UseDefaultConstructor)
+      {
+        std::uninitialized_value_construct_n(data, size);
+      }
+      else
+      {
+        std::uninitialized_default_construct_n(data, size);
+      }
+    }
+    else if (UseDefaultConstructor && !touched)
+    {
+      std::uninitialized_value_construct_n(data, size); // zero, as new[]() does
+    }
+    return data;
+  }
+
   try
   {
     if (UseDefaultConstructor)
@@ -191,7 +239,15 @@ ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
   // Encapsulate all image memory deallocation here
   if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (ImageBufferAllocationPolicy::IsAllocated(m_ImportPointer))
+    {
+      std::destroy_n(m_ImportPointer, m_Capacity);
+      ImageBufferAllocationPolicy::Deallocate(m_ImportPointer, m_Capacity * sizeof(TElement));
+    }
+    else
+    {
+      delete[] m_ImportPointer;
+    }
   }
   m_ImportPointer = nullptr;
   m_Capacity = 0;
@@ -208,6 +264,7 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "AllocationPolicy: " << m_AllocationPolicy << std::endl;
 }
 } // end namespace itk
 
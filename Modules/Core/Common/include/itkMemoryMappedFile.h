@@ -0,0 +1,134 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFileEnums
+ *
+ * \brief enums for MemoryMappedFile
+ *
+ * \ingroup ITKCommon
+ */
+class MemoryMappedFileEnums
+{
+public:
+  /** \class AccessMode
+   * \ingroup ITKCommon
+   * How the mapped pages may be accessed. */
+  enum class AccessMode : uint8_t
+  {
+    /** The pages are read-only: writing to them is a segmentation fault. */
+    ReadOnly = 0,
+    /** The pages are writable, and copied on the first write to each of them:
+     * the file itself is never modified. */
+    CopyOnWrite = 1
+  };
+};
+extern ITKCommon_EXPORT std::ostream &
+                        operator<<(std::ostream & out, const MemoryMappedFileEnums::AccessMode value);
+
+/** \class MemoryMappedFile
+ * \brief Maps a range of bytes of a file into memory.
+ *
+ * The pages of the mapping are read from the file on demand, when first
+ * accessed, and may be discarded by the operating system under memory
+ * pressure (as they can be read again), so that files larger than the
+ * physical memory can be processed. The mapping is released by Unmap(), or
+ * when the object is destroyed.
+ *
+ * The offset needs not be a multiple of the page size: the mapping starts at
+ * the page containing it, and GetPointer() points at the offset.
+ *
+ * \sa MemoryMappedImageContainer
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT MemoryMappedFile : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedFile);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFile;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using AccessModeEnum = MemoryMappedFileEnums::AccessMode;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFile, Object);
+
+  /** Map numberOfBytes of the file, starting at offset. Any previous mapping
+   * is released first. Throws an exception when the file cannot be opened,
+   * is too short, or cannot be mapped. */
+  void
+  Map(const std::string & fileName, SizeValueType offset, SizeValueType numberOfBytes, AccessModeEnum accessMode);
+
+  /** Release the mapping. Modifications made in CopyOnWrite mode are lost. */
+  void
+  Unmap();
+
+  bool
+  IsMapped() const
+  {
+    return m_Pointer != nullptr;
+  }
+
+  /** Pointer to the byte at the offset given to Map(), nullptr when unmapped. */
+  void *
+  GetPointer() const
+  {
+    return m_Pointer;
+  }
+
+  itkGetStringMacro(FileName);
+  itkGetConstMacro(Offset, SizeValueType);
+  itkGetConstMacro(NumberOfBytes, SizeValueType);
+  itkGetConstMacro(AccessMode, AccessModeEnum);
+
+protected:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  std::string    m_FileName{};
+  SizeValueType  m_Offset{ 0 };
+  SizeValueType  m_NumberOfBytes{ 0 };
+  AccessModeEnum m_AccessMode{ AccessModeEnum::ReadOnly };
+
+  /** Pointer at the offset, and start and length of the whole mapped pages. */
+  void *        m_Pointer{ nullptr };
+  void *        m_MappedAddress{ nullptr };
+  SizeValueType m_MappedLength{ 0 };
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,128 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_h
+#define itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+
+/** \class MemoryMappedImageContainer
+ * \brief Image pixel container whose elements are the bytes of a file.
+ *
+ * MemoryMappedImageContainer is an ImportImageContainer which imports the
+ * memory mapping of a range of a file, holding the elements in their raw
+ * layout (native byte order). It can be used as the PixelContainer of an
+ * Image or a VectorImage: the pixels are read from the file lazily, page by
+ * page, when first accessed, so that volumes larger than the physical memory
+ * can be processed, as long as the filters only visit part of them at a time.
+ *
+ * In CopyOnWrite mode, the default, the pages which are written to are
+ * copied into private memory, and the file is never modified, so the image
+ * may be the input of filters running in place. In ReadOnly mode, the buffer
+ * must not be written to (doing so is a segmentation fault), so the image may
+ * only be the input of filters which do not run in place.
+ *
+ * The mapping is released together with the buffer: when the container is
+ * destroyed, initialized, or reallocated (in which case the elements are
+ * first copied into the new buffer).
+ *
+ * \code
+ * auto container = MemoryMappedImageContainer<SizeValueType, float>::New();
+ * container->MapFile("volume.raw", 0, region.GetNumberOfPixels());
+ * image->SetRegions(region);
+ * image->SetPixelContainer(container);
+ * \endcode
+ *
+ * \sa MemoryMappedFile
+ * \sa ImageFileReader::SetUseMemoryMapping
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(MemoryMappedImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Save the template parameters. */
+  using ElementIdentifier = TElementIdentifier;
+  using Element = TElement;
+
+  using AccessModeEnum = MemoryMappedFileEnums::AccessMode;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Standard part of every itk Object. */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Import numberOfElements elements from the file, starting at the given
+   * offset in bytes, which must be a multiple of the alignment of the
+   * elements. Throws an exception when the file cannot be mapped. */
+  void
+  MapFile(const std::string & fileName,
+          SizeValueType       offset,
+          ElementIdentifier   numberOfElements,
+          AccessModeEnum      accessMode = AccessModeEnum::CopyOnWrite);
+
+  /** The mapping of the current buffer, nullptr when the buffer is not
+   * mapped from a file. */
+  const MemoryMappedFile *
+  GetMemoryMappedFile() const
+  {
+    return m_MemoryMappedFile.GetPointer();
+  }
+
+  /** Whether the current buffer is mapped from a file. */
+  bool
+  IsMapped() const
+  {
+    return m_MemoryMappedFile.IsNotNull();
+  }
+
+protected:
+  MemoryMappedImageContainer() = default;
+  ~MemoryMappedImageContainer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Release the mapping together with the buffer. */
+  void
+  DeallocateManagedMemory() override;
+
+private:
+  MemoryMappedFile::Pointer m_MemoryMappedFile{};
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkMemoryMappedImageContainer.hxx"
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImageContainer_hxx
+#define itkMemoryMappedImageContainer_hxx
+
+#include <type_traits>
+
+namespace itk
+{
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImageContainer<TElementIdentifier, TElement>::MapFile(const std::string & fileName,
+                                                                  SizeValueType       offset,
+                                                                  ElementIdentifier   numberOfElements,
+                                                                  AccessModeEnum      accessMode)
+{
+  static_assert(std::is_trivially_copyable<TElement>::value,
+                "Only trivially copyable elements can be mapped from a file.");
+
+  if (offset % alignof(TElement) != 0)
+  {
+    itkExceptionMacro("Cannot map elements at offset " << offset << " of " << fileName
+                                                       << ", which is not a multiple of their alignment, "
+                                                       << alignof(TElement));
+  }
+
+  auto memoryMappedFile = MemoryMappedFile::New();
+  memoryMappedFile->Map(fileName, offset, numberOfElements * sizeof(TElement), accessMode);
+
+  // Releases the previous buffer, and its mapping.
+  this->SetImportPointer(static_cast<TElement *>(memoryMappedFile->GetPointer()), numberOfElements, false);
+  m_MemoryMappedFile = memoryMappedFile;
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
+{
+  Superclass::DeallocateManagedMemory();
+  m_MemoryMappedFile = nullptr;
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+MemoryMappedImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MemoryMappedFile: ";
+  if (m_MemoryMappedFile.IsNotNull())
+  {
+    os << std::endl;
+    m_MemoryMappedFile->Print(os, indent.GetNextIndent());
+  }
+  else
+  {
+    os << "(null)" << std::endl;
+  }
+}
+} // end namespace itk
+
+#endif
@@ -64,7 +64,8 @@ public:
     First = Platform,
     Pool,
     TBB,
-    Last = TBB,
+    WorkStealing,
+    Last = WorkStealing,
     Unknown = -1
   };
 
@@ -164,6 +165,7 @@ public:
   static constexpr ThreaderEnum First = ThreaderEnum::First;
   static constexpr ThreaderEnum Pool = ThreaderEnum::Pool;
   static constexpr ThreaderEnum TBB = ThreaderEnum::TBB;
+  static constexpr ThreaderEnum WorkStealing = ThreaderEnum::WorkStealing;
   static constexpr ThreaderEnum Last = ThreaderEnum::Last;
   static constexpr ThreaderEnum Unknown = ThreaderEnum::Unknown;
 #endif
@@ -187,6 +189,9 @@ public:
       case ThreaderEnum::TBB:
         return "TBB";
         break;
+      case ThreaderEnum::WorkStealing:
+        return "WorkStealing";
+        break;
       case ThreaderEnum::Unknown:
       default:
         return "Unknown";
@@ -219,6 +224,28 @@ public:
   static ThreadIdType
   GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get whether the threads of the thread pools (used by
+   * PoolMultiThreader and WorkStealingMultiThreader) are bound to
+   * processors. The n-th thread of a pool is bound to the n-th processor
+   * of the process affinity mask (modulo its size), which keeps a thread's
+   * caches and NUMA-local memory close to it. Threads are bound when they
+   * start, so this has to be set before a pool is first used. Only
+   * supported on Linux.
+   *
+   * The default is picked up from the ITK_GLOBAL_DEFAULT_THREAD_AFFINITY
+   * environment variable (e.g. ITK_GLOBAL_DEFAULT_THREAD_AFFINITY=ON),
+   * and is off otherwise. */
+  static void
+  SetGlobalDefaultThreadAffinity(bool threadAffinity);
+  static bool
+  GetGlobalDefaultThreadAffinity();
+
+  /** Bind the calling thread to the processor processorIndex of the process
+   * affinity mask (modulo its size). Returns false if binding is not
+   * supported on this platform, or failed. */
+  static bool
+  BindCurrentThreadToProcessor(ThreadIdType processorIndex);
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** Get/Set the number of threads to use.
    * DEPRECATED! Use WorkUnits and MaximumNumberOfThreads instead. */
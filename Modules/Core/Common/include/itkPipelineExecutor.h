@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineExecutor_h
+#define itkPipelineExecutor_h
+
+#include "itkDataObject.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkProcessObject.h"
+
+namespace itk
+{
+
+/** \class PipelineExecutor
+ * \brief Updates a pipeline, executing its independent upstream branches
+ * concurrently.
+ *
+ * DataObject::Update() executes the filters of a pipeline one after the
+ * other: ProcessObject::UpdateOutputData() updates the inputs of a filter
+ * depth first, in order. When a filter has several independent upstream
+ * branches, like a ComposeImageFilter fed by three readers, or a metric fed
+ * by fixed and moving preprocessing chains, these branches are executed
+ * serially, although they could run at the same time.
+ *
+ * PipelineExecutor is an opt-in replacement of Update(). It updates the
+ * output information and propagates the requested regions like Update(),
+ * then discovers the graph of the filters upstream of the data object, and
+ * executes each filter as a task of the WorkStealingThreadPool once all the
+ * filters it depends on have completed. The filters of independent branches
+ * thereby execute concurrently, while each filter still executes once, after
+ * its inputs, with its own multi-threader. The calling thread executes tasks
+ * too while it waits, and waiting inside a task does not block a worker of
+ * the pool, so that the parallel sections of the filters do not deadlock.
+ *
+ * The filters consuming the same data object execute one after the other,
+ * in the order of the serial update, as a filter running in place or
+ * releasing its inputs modifies the data object it consumes.
+ *
+ * The filters of independent branches must not share state other than
+ * through the pipeline, and their observers must be thread safe.
+ *
+ * \code
+ * auto executor = itk::PipelineExecutor::New();
+ * executor->Update(composeFilter);
+ * \endcode
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineExecutor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PipelineExecutor);
+
+  /** Standard class type aliases. */
+  using Self = PipelineExecutor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineExecutor, Object);
+
+  /** Brings the requested region of data up to date, like
+   * DataObject::Update(), executing independent upstream branches
+   * concurrently. */
+  void
+  Update(DataObject * data);
+
+  /** Brings the primary output of filter up to date, like
+   * ProcessObject::Update(). */
+  void
+  Update(ProcessObject * filter);
+
+  /** Brings the largest possible region of the primary output of filter up
+   * to date, like ProcessObject::UpdateLargestPossibleRegion(). */
+  void
+  UpdateLargestPossibleRegion(ProcessObject * filter);
+
+  /** Number of filters executed by the last update, which are the filters
+   * whose outputs were out of date. */
+  itkGetConstMacro(NumberOfExecutedFilters, SizeValueType);
+
+protected:
+  PipelineExecutor() = default;
+  ~PipelineExecutor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  SizeValueType m_NumberOfExecutedFilters{ 0 };
+};
+} // end namespace itk
+
+#endif
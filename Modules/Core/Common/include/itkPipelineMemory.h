@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPipelineMemory_h
+#define itkPipelineMemory_h
+
+#include "ITKCommonExport.h"
+#include "itkDataObject.h"
+#include "itkIntTypes.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+namespace itk
+{
+
+/** \class PipelineMemory
+ * \brief A container of static functions predicting the memory of a
+ * pipeline update before it is executed.
+ *
+ * The prediction relies on the requested regions propagated upstream by
+ * PropagateRequestedRegion(), which are the regions the filters generate on
+ * the next update. It is the sum of the memory of these requested regions
+ * (see DataObject::GetRequestedRegionMemorySize()), for the data object
+ * updated and every upstream data object generated by a filter, as if the
+ * pipeline held the outputs of all its filters at the same time. Filters
+ * releasing their inputs, or running in place, hold less, so that the
+ * prediction is an upper bound of the memory of the update, rather than its
+ * peak. The data objects without a source, which are in memory before the
+ * update, and the temporary memory used by the filters while they execute
+ * are not counted.
+ *
+ * \ingroup ITKCommon
+ */
+struct ITKCommon_EXPORT PipelineMemory
+{
+  /** Returns the predicted memory, in bytes, of the update of the
+   * requested region of data. PropagateRequestedRegion() must be called
+   * before, to set the requested regions upstream. */
+  static SizeValueType
+  EstimateRequestedRegionMemorySize(DataObject * data);
+
+  /** Propagates region upstream, as requested region of image, and returns
+   * the predicted memory, in bytes, of its update. The output information
+   * of image must be up to date. */
+  template <typename TImage>
+  static SizeValueType
+  EstimateMemorySize(TImage * image, const typename TImage::RegionType & region)
+  {
+    image->SetRequestedRegion(region);
+    image->PropagateRequestedRegion();
+    return EstimateRequestedRegionMemorySize(image);
+  }
+
+  /** Returns the largest predicted memory, in bytes, of the pieces of a
+   * division in numberOfDivisions pieces, pieceMemorySize(piece) returning
+   * the predicted memory of a piece. The pieces of a splitter have nearly the
+   * same size: only the first, middle and last ones are estimated, which
+   * cover the differences of size, and of padding of the requested regions
+   * upstream at the borders of the image. */
+  template <typename TPieceMemorySizeFunction>
+  static SizeValueType
+  EstimateLargestPieceMemorySize(unsigned int numberOfDivisions, TPieceMemorySizeFunction pieceMemorySize)
+  {
+    SizeValueType memorySize = 0;
+    for (const unsigned int piece : { 0u, numberOfDivisions / 2, numberOfDivisions - 1 })
+    {
+      memorySize = std::max(memorySize, static_cast<SizeValueType>(pieceMemorySize(piece)));
+    }
+    return memorySize;
+  }
+
+  /** Returns the smallest number of pieces fitting in a memory budget,
+   * searched by bisection, as the memory of a piece decreases with the
+   * number of pieces. numberOfDivisions(requested) returns the number of
+   * pieces of a division requested in the given number of pieces, which a
+   * splitter may limit, and fits(numberOfDivisions) whether the pieces of a
+   * division fit in the budget. Returns 0 when even the largest number of
+   * pieces does not fit. */
+  template <typename TNumberOfDivisionsFunction, typename TFitsFunction>
+  static unsigned int
+  SearchSmallestNumberOfDivisions(TNumberOfDivisionsFunction numberOfDivisions, TFitsFunction fits)
+  {
+    unsigned int lower = 1;
+    unsigned int upper = numberOfDivisions(NumericTraits<unsigned int>::max());
+    if (!fits(upper))
+    {
+      return 0;
+    }
+    while (lower < upper)
+    {
+      const unsigned int middle = lower + (upper - lower) / 2;
+      const unsigned int middleNumberOfDivisions = numberOfDivisions(middle);
+      if (fits(middleNumberOfDivisions))
+      {
+        upper = middleNumberOfDivisions;
+      }
+      else
+      {
+        lower = middle + 1;
+      }
+    }
+    return upper;
+  }
+};
+} // end namespace itk
+
+#endif
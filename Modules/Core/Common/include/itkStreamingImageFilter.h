@@ -20,6 +20,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImageRegionSplitterBase.h"
+#include <functional>
+#include <vector>
 
 namespace itk
 {
@@ -36,6 +38,22 @@ namespace itk
  * This filter will produce the entire output as one image, but the upstream
  * filters will do their processing in pieces.
  *
+ * By default the pieces are processed one after another, which leaves cores
+ * idle when the upstream filters have little work per piece or serial
+ * sections. Several pieces may be processed concurrently instead (see
+ * SetNumberOfConcurrentPieces). As a pipeline updates one requested region
+ * at a time, each additional concurrent piece goes through its own instance
+ * of the upstream pipeline, created by the function given to
+ * SetPipelineFactory. The number of pieces in flight is further bounded so
+ * that their estimated memory fits in the memory budget (see
+ * SetMemoryBudget).
+ *
+ * With a memory budget, the number of pieces may also be chosen
+ * automatically (see AutomaticStreamDivisionsOn), and an upper bound of the
+ * peak memory of an update may be predicted before it is executed (see
+ * PredictPeakMemorySize). The memory of a piece is estimated by propagating
+ * its region upstream, as explained in PipelineMemory.
+ *
  * \ingroup ITKSystemObjects
  * \ingroup DataProcessing
  * \ingroup ITKCommon
@@ -78,6 +96,19 @@ public:
   using SplitterType = ImageRegionSplitterBase;
   using RegionSplitterPointer = typename SplitterType::Pointer;
 
+  /** Instance of the upstream pipeline created by the pipeline factory:
+   * Output is the output image of its last filter. As a data object only
+   * holds a weak pointer to its source, Filters must hold all the filters of
+   * the instance, which live as long as the instance. */
+  struct PipelineInstance
+  {
+    InputImagePointer                   Output;
+    std::vector<ProcessObject::Pointer> Filters;
+  };
+
+  /** Function creating a new instance of the upstream pipeline. */
+  using PipelineFactoryType = std::function<PipelineInstance()>;
+
   /** Set the number of pieces to divide the input.  The upstream pipeline
    * will be executed this many times. */
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
@@ -90,6 +121,64 @@ public:
   itkSetObjectMacro(RegionSplitter, SplitterType);
   itkGetModifiableObjectMacro(RegionSplitter, SplitterType);
 
+  /** Set/Get the maximum number of pieces processed concurrently. Each piece
+   * after the first one needs an instance of the upstream pipeline created
+   * by the pipeline factory, so that this has no effect without a pipeline
+   * factory. Defaults to 1: the pieces are processed one after another. */
+  itkSetClampMacro(NumberOfConcurrentPieces, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(NumberOfConcurrentPieces, unsigned int);
+
+  /** Set/Get the memory budget, in bytes, of the pieces processed
+   * concurrently, not counting the output image. At least one piece is
+   * always processed. Defaults to 0, meaning no limit. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
+  /** Set/Get whether the number of pieces is chosen automatically, instead
+   * of NumberOfStreamDivisions, as the smallest number whose pieces fit in
+   * the memory budget, with as many concurrent pieces as possible up to
+   * NumberOfConcurrentPieces. The pieces are then shaped either by the
+   * region splitter or by an ImageRegionSplitterMultidimensional, whichever
+   * needs the fewest pieces: blocks need less memory than slabs when the
+   * upstream filters pad their requested regions with large neighborhoods.
+   * Has no effect without a memory budget. Defaults to off. */
+  itkSetMacro(AutomaticStreamDivisions, bool);
+  itkGetConstMacro(AutomaticStreamDivisions, bool);
+  itkBooleanMacro(AutomaticStreamDivisions);
+
+  /** Predicts the peak memory, in bytes, of the next update of the output
+   * requested region: the output image plus the pieces processed
+   * concurrently. The memory of a piece sums the requested regions of every
+   * upstream data object (see PipelineMemory), so that the prediction is an
+   * upper bound of the peak rather than the peak. This updates the output
+   * information, and sets the requested regions upstream. */
+  SizeValueType
+  PredictPeakMemorySize();
+
+  /** Returns the number of pieces of the next update of the output
+   * requested region, which differs from NumberOfStreamDivisions when it is
+   * chosen automatically or limited by the region splitter. */
+  unsigned int
+  PredictNumberOfStreamDivisions();
+
+  /** Set/Get the function creating the additional instances of the upstream
+   * pipeline used to process pieces concurrently. Each call must return a
+   * PipelineInstance of a new pipeline: its Output is the same image as the
+   * input of this filter, and its Filters hold the filters of the pipeline,
+   * which share no filter nor data object with the other instances. The
+   * instances are created at each update. */
+  void
+  SetPipelineFactory(const PipelineFactoryType & pipelineFactory)
+  {
+    m_PipelineFactory = pipelineFactory;
+    this->Modified();
+  }
+  const PipelineFactoryType &
+  GetPipelineFactory() const
+  {
+    return m_PipelineFactory;
+  }
+
   /** Override UpdateOutputData() from ProcessObject to divide upstream
    * updates into pieces. This filter does not have a GenerateData()
    * or ThreadedGenerateData() method.  Instead, all the work is done
@@ -118,9 +207,53 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Estimates the memory, in bytes, needed to process one piece, by
+   * propagating its region upstream with PipelineMemory. This sets the
+   * requested regions of the upstream pipeline. */
+  virtual SizeValueType
+  EstimatePieceMemorySize(const InputImageRegionType & streamRegion);
+
+  /** Returns the number of pieces to process concurrently, according to
+   * NumberOfConcurrentPieces, the pipeline factory and the memory budget. */
+  unsigned int
+  ComputeNumberOfConcurrentPieces(SizeValueType pieceMemorySize, unsigned int numberOfDivisions) const;
+
 private:
+  /** How the output requested region is streamed. */
+  struct StreamingPlan
+  {
+    const SplitterType * Splitter{ nullptr };
+    unsigned int         NumberOfDivisions{ 1 };
+    unsigned int         NumberOfConcurrentPieces{ 1 };
+    SizeValueType        PieceMemorySize{ 0 };
+  };
+
+  /** Plans the streaming of outputRegion with the splitter in
+   * numberOfRequestedDivisions pieces. The piece memory is only estimated
+   * when estimateMemory is true, or when needed by the memory budget. */
+  StreamingPlan
+  PlanStreaming(const OutputImageRegionType & outputRegion,
+                const SplitterType *          splitter,
+                unsigned int                  numberOfRequestedDivisions,
+                bool                          estimateMemory);
+
+  /** Plans the streaming of outputRegion, according to the settings of the
+   * filter. */
+  StreamingPlan
+  PlanStreaming(const OutputImageRegionType & outputRegion, bool estimateMemory);
+
+  /** Processes the pieces with numberOfConcurrentPieces threads, each one
+   * updating its own instance of the upstream pipeline. */
+  void
+  StreamConcurrently(const OutputImageRegionType & outputRegion, const StreamingPlan & plan);
+
   unsigned int          m_NumberOfStreamDivisions{};
   RegionSplitterPointer m_RegionSplitter{};
+  unsigned int          m_NumberOfConcurrentPieces{ 1 };
+  SizeValueType         m_MemoryBudget{ 0 };
+  bool                  m_AutomaticStreamDivisions{ false };
+  PipelineFactoryType   m_PipelineFactory{};
+  RegionSplitterPointer m_MultidimensionalSplitter{};
 };
 } // end namespace itk
 
@@ -19,7 +19,15 @@
 #define itkStreamingImageFilter_hxx
 #include "itkCommand.h"
 #include "itkImageAlgorithm.h"
+#include "itkImageRegionSplitterMultidimensional.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include "itkPipelineMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace itk
 {
@@ -34,6 +42,9 @@ StreamingImageFilter<TInputImage, TOutputImage>::StreamingImageFilter()
 
   // create default region splitter
   m_RegionSplitter = ImageRegionSplitterSlowDimension::New();
+
+  // candidate shape of the pieces for automatic stream divisions
+  m_MultidimensionalSplitter = ImageRegionSplitterMultidimensional::New();
 }
 
 /**
@@ -48,6 +59,218 @@ StreamingImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, In
   os << indent << "Number of stream divisions: " << m_NumberOfStreamDivisions << std::endl;
 
   itkPrintSelfObjectMacro(RegionSplitter);
+
+  os << indent << "NumberOfConcurrentPieces: " << m_NumberOfConcurrentPieces << std::endl;
+  os << indent << "MemoryBudget: " << m_MemoryBudget << std::endl;
+  os << indent << "AutomaticStreamDivisions: " << (m_AutomaticStreamDivisions ? "On" : "Off") << std::endl;
+  os << indent << "PipelineFactory: " << (m_PipelineFactory ? "(set)" : "(none)") << std::endl;
+}
+
+template <typename TInputImage, typename TOutputImage>
+SizeValueType
+StreamingImageFilter<TInputImage, TOutputImage>::EstimatePieceMemorySize(const InputImageRegionType & streamRegion)
+{
+  return PipelineMemory::EstimateMemorySize(const_cast<InputImageType *>(this->GetInput()), streamRegion);
+}
+
+template <typename TInputImage, typename TOutputImage>
+unsigned int
+StreamingImageFilter<TInputImage, TOutputImage>::ComputeNumberOfConcurrentPieces(
+  const SizeValueType pieceMemorySize,
+  const unsigned int  numberOfDivisions) const
+{
+  if (!m_PipelineFactory)
+  {
+    return 1;
+  }
+
+  unsigned int numberOfConcurrentPieces = std::min(m_NumberOfConcurrentPieces, numberOfDivisions);
+  if (m_MemoryBudget > 0 && pieceMemorySize > 0)
+  {
+    const SizeValueType numberOfPiecesInBudget = m_MemoryBudget / pieceMemorySize;
+    numberOfConcurrentPieces = static_cast<unsigned int>(
+      std::max<SizeValueType>(1, std::min<SizeValueType>(numberOfConcurrentPieces, numberOfPiecesInBudget)));
+  }
+  return numberOfConcurrentPieces;
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+StreamingImageFilter<TInputImage, TOutputImage>::PlanStreaming(const OutputImageRegionType & outputRegion,
+                                                               const SplitterType *          splitter,
+                                                               const unsigned int            numberOfRequestedDivisions,
+                                                               const bool estimateMemory) -> StreamingPlan
+{
+  StreamingPlan plan;
+  plan.Splitter = splitter;
+  plan.NumberOfDivisions = splitter->GetNumberOfSplits(outputRegion, numberOfRequestedDivisions);
+  plan.NumberOfConcurrentPieces = std::min(m_PipelineFactory ? m_NumberOfConcurrentPieces : 1, plan.NumberOfDivisions);
+
+  if (plan.NumberOfDivisions > 0 && (estimateMemory || (m_MemoryBudget > 0 && plan.NumberOfConcurrentPieces > 1)))
+  {
+    plan.PieceMemorySize =
+      PipelineMemory::EstimateLargestPieceMemorySize(plan.NumberOfDivisions, [&](const unsigned int piece) {
+        InputImageRegionType streamRegion = outputRegion;
+        splitter->GetSplit(piece, plan.NumberOfDivisions, streamRegion);
+        return this->EstimatePieceMemorySize(streamRegion);
+      });
+    plan.NumberOfConcurrentPieces = this->ComputeNumberOfConcurrentPieces(plan.PieceMemorySize, plan.NumberOfDivisions);
+  }
+  return plan;
+}
+
+template <typename TInputImage, typename TOutputImage>
+auto
+StreamingImageFilter<TInputImage, TOutputImage>::PlanStreaming(const OutputImageRegionType & outputRegion,
+                                                               const bool estimateMemory) -> StreamingPlan
+{
+  if (!m_AutomaticStreamDivisions || m_MemoryBudget == 0)
+  {
+    return this->PlanStreaming(outputRegion, m_RegionSplitter, m_NumberOfStreamDivisions, estimateMemory);
+  }
+
+  const unsigned int maximumConcurrentPieces = m_PipelineFactory ? m_NumberOfConcurrentPieces : 1;
+  const auto         fitsInBudget = [this, maximumConcurrentPieces](const StreamingPlan & plan) {
+    const SizeValueType numberOfConcurrentPieces = std::min(maximumConcurrentPieces, plan.NumberOfDivisions);
+    return numberOfConcurrentPieces * plan.PieceMemorySize <= m_MemoryBudget;
+  };
+
+  // For each splitter, search the smallest number of pieces fitting in the
+  // budget, the memory of a piece decreasing with the number of pieces.
+  StreamingPlan bestPlan;
+  bool          bestPlanFits = false;
+  for (const SplitterType * splitter : { m_RegionSplitter.GetPointer(), m_MultidimensionalSplitter.GetPointer() })
+  {
+    const unsigned int numberOfDivisions = PipelineMemory::SearchSmallestNumberOfDivisions(
+      [&](const unsigned int numberOfRequestedDivisions) {
+        return splitter->GetNumberOfSplits(outputRegion, numberOfRequestedDivisions);
+      },
+      [&](const unsigned int numberOfRequestedDivisions) {
+        return fitsInBudget(this->PlanStreaming(outputRegion, splitter, numberOfRequestedDivisions, true));
+      });
+    const bool          fits = numberOfDivisions > 0;
+    const StreamingPlan plan = this->PlanStreaming(
+      outputRegion, splitter, fits ? numberOfDivisions : NumericTraits<unsigned int>::max(), true);
+
+    if (bestPlan.Splitter == nullptr || (fits && !bestPlanFits) ||
+        (fits == bestPlanFits && (plan.NumberOfDivisions < bestPlan.NumberOfDivisions ||
+                                  (plan.NumberOfDivisions == bestPlan.NumberOfDivisions &&
+                                   plan.PieceMemorySize < bestPlan.PieceMemorySize))))
+    {
+      bestPlan = plan;
+      bestPlanFits = fits;
+    }
+  }
+
+  if (!bestPlanFits)
+  {
+    itkWarningMacro(<< "No division of the output requested region fits in the memory budget of " << m_MemoryBudget
+                    << " bytes: using " << bestPlan.NumberOfDivisions << " pieces of " << bestPlan.PieceMemorySize
+                    << " bytes.");
+  }
+  return bestPlan;
+}
+
+template <typename TInputImage, typename TOutputImage>
+SizeValueType
+StreamingImageFilter<TInputImage, TOutputImage>::PredictPeakMemorySize()
+{
+  OutputImageType * outputPtr = this->GetOutput();
+  outputPtr->UpdateOutputInformation();
+
+  const StreamingPlan plan = this->PlanStreaming(outputPtr->GetRequestedRegion(), true);
+  return outputPtr->GetRequestedRegionMemorySize() + plan.NumberOfConcurrentPieces * plan.PieceMemorySize;
+}
+
+template <typename TInputImage, typename TOutputImage>
+unsigned int
+StreamingImageFilter<TInputImage, TOutputImage>::PredictNumberOfStreamDivisions()
+{
+  OutputImageType * outputPtr = this->GetOutput();
+  outputPtr->UpdateOutputInformation();
+
+  return this->PlanStreaming(outputPtr->GetRequestedRegion(), false).NumberOfDivisions;
+}
+
+template <typename TInputImage, typename TOutputImage>
+void
+StreamingImageFilter<TInputImage, TOutputImage>::StreamConcurrently(const OutputImageRegionType & outputRegion,
+                                                                    const StreamingPlan &         plan)
+{
+  const unsigned int numberOfDivisions = plan.NumberOfDivisions;
+  const unsigned int numberOfConcurrentPieces = plan.NumberOfConcurrentPieces;
+  OutputImageType * outputPtr = this->GetOutput(0);
+
+  // The first instance of the upstream pipeline is the input of this filter.
+  std::vector<PipelineInstance> instances;
+  std::vector<InputImageType *> inputs{ const_cast<InputImageType *>(this->GetInput(0)) };
+  for (unsigned int i = 1; i < numberOfConcurrentPieces; ++i)
+  {
+    instances.push_back(m_PipelineFactory());
+    if (instances.back().Output.IsNull())
+    {
+      itkExceptionMacro(<< "The pipeline factory returned a null output.");
+    }
+    inputs.push_back(instances.back().Output);
+    inputs.back()->UpdateOutputInformation();
+  }
+
+  std::atomic<unsigned int> nextPiece{ 0 };
+  std::atomic<bool>         failed{ false };
+  std::mutex                mutex;
+  unsigned int              numberOfProcessedPieces = 0;
+  std::exception_ptr        exception;
+
+  const auto streamPieces = [&](InputImageType * inputPtr) {
+    try
+    {
+      for (unsigned int piece = nextPiece++; piece < numberOfDivisions && !this->GetAbortGenerateData() && !failed;
+           piece = nextPiece++)
+      {
+        InputImageRegionType streamRegion = outputRegion;
+        plan.Splitter->GetSplit(piece, numberOfDivisions, streamRegion);
+
+        inputPtr->SetRequestedRegion(streamRegion);
+        inputPtr->PropagateRequestedRegion();
+        inputPtr->UpdateOutputData();
+
+        // the pieces are disjoint, so that they are copied to the output
+        // without synchronization
+        ImageAlgorithm::Copy(inputPtr, outputPtr, streamRegion, streamRegion);
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        ++numberOfProcessedPieces;
+        this->UpdateProgress(static_cast<float>(numberOfProcessedPieces) / static_cast<float>(numberOfDivisions));
+      }
+    }
+    catch (...)
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if (!exception)
+      {
+        exception = std::current_exception();
+      }
+      failed = true;
+    }
+  };
+
+  // The pieces run on their own threads rather than on the thread pool,
+  // which the upstream filters use for their own multithreading.
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < numberOfConcurrentPieces; ++i)
+  {
+    threads.emplace_back(streamPieces, inputs[i]);
+  }
+  streamPieces(inputs[0]);
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
 }
 
 /**
@@ -149,39 +372,49 @@ StreamingImageFilter<TInputImage, TOutputImage>::UpdateOutputData(DataObject * i
   /**
    * Determine of number of pieces to divide the input.  This will be the
    * minimum of what the user specified via SetNumberOfStreamDivisions()
-   * and what the Splitter thinks is a reasonable value.
+   * and what the Splitter thinks is a reasonable value, unless it is
+   * chosen automatically from the memory budget.
    */
-  unsigned int numDivisions, numDivisionsFromSplitter;
-
-  numDivisions = m_NumberOfStreamDivisions;
-  numDivisionsFromSplitter = m_RegionSplitter->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
-  if (numDivisionsFromSplitter < numDivisions)
-  {
-    numDivisions = numDivisionsFromSplitter;
-  }
+  const StreamingPlan plan = this->PlanStreaming(outputRegion, false);
+  const unsigned int  numDivisions = plan.NumberOfDivisions;
 
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
    * piece, and copy the results into the output image.
    */
-  unsigned int piece = 0;
-  for (; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
+  if (plan.NumberOfConcurrentPieces > 1)
+  {
+    try
+    {
+      this->StreamConcurrently(outputRegion, plan);
+    }
+    catch (...)
+    {
+      this->ResetPipeline();
+      throw;
+    }
+  }
+  else
   {
-    InputImageRegionType streamRegion = outputRegion;
-    m_RegionSplitter->GetSplit(piece, numDivisions, streamRegion);
+    unsigned int piece = 0;
+    for (; piece < numDivisions && !this->GetAbortGenerateData(); ++piece)
+    {
+      InputImageRegionType streamRegion = outputRegion;
+      plan.Splitter->GetSplit(piece, numDivisions, streamRegion);
 
-    inputPtr->SetRequestedRegion(streamRegion);
-    inputPtr->PropagateRequestedRegion();
-    inputPtr->UpdateOutputData();
+      inputPtr->SetRequestedRegion(streamRegion);
+      inputPtr->PropagateRequestedRegion();
+      inputPtr->UpdateOutputData();
 
-    // copy the result to the proper place in the output. the input
-    // requested region determined by the RegionSplitter (as opposed
-    // to what the pipeline might have enlarged it to) is used to
-    // copy the regions from the input to output
-    ImageAlgorithm::Copy(inputPtr, outputPtr, streamRegion, streamRegion);
+      // copy the result to the proper place in the output. the input
+      // requested region determined by the RegionSplitter (as opposed
+      // to what the pipeline might have enlarged it to) is used to
+      // copy the regions from the input to output
+      ImageAlgorithm::Copy(inputPtr, outputPtr, streamRegion, streamRegion);
 
 
-    this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+      this->UpdateProgress(static_cast<float>(piece) / static_cast<float>(numDivisions));
+    }
   }
 
   /**
@@ -166,9 +166,12 @@ private:
   /** To lock on the internal variables */
   static ThreadPoolGlobals * m_PimplGlobals;
 
-  /** The continuously running thread function */
+  /** The continuously running thread function. threadIndex is the index
+   * of the thread in m_Threads, used to bind it to a processor. The global
+   * default thread affinity is queried by the creating thread: a thread
+   * started while the process exits must not access the global state. */
   static void
-  ThreadExecute();
+  ThreadExecute(ThreadIdType threadIndex, bool bindToProcessor);
 };
 
 } // namespace itk
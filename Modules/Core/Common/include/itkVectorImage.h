@@ -366,6 +366,10 @@ public:
   void
   SetNumberOfComponentsPerPixel(unsigned int n) override;
 
+  /** Return the memory, in bytes, of the pixels of the RequestedRegion. */
+  SizeValueType
+  GetRequestedRegionMemorySize() const override;
+
 protected:
   VectorImage() = default;
   void
@@ -63,8 +63,14 @@ VectorImage<TPixel, VImageDimension>::Initialize()
 
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
-  // Grafted outputs and in place filters).
+  // Grafted outputs and in place filters). The allocation policy set
+  // for this image is kept.
+  const PixelContainerPointer oldBuffer = m_Buffer;
   m_Buffer = PixelContainer::New();
+  if (oldBuffer)
+  {
+    m_Buffer->SetAllocationPolicy(oldBuffer->GetAllocationPolicy());
+  }
 }
 
 template <typename TPixel, unsigned int VImageDimension>
@@ -143,6 +149,14 @@ VectorImage<TPixel, VImageDimension>::GetNumberOfComponentsPerPixel() const
   return this->m_VectorLength;
 }
 
+//----------------------------------------------------------------------------
+template <typename TPixel, unsigned int VImageDimension>
+auto
+VectorImage<TPixel, VImageDimension>::GetRequestedRegionMemorySize() const -> SizeValueType
+{
+  return this->GetRequestedRegion().GetNumberOfPixels() * m_VectorLength * sizeof(InternalPixelType);
+}
+
 //----------------------------------------------------------------------------
 template <typename TPixel, unsigned int VImageDimension>
 void
@@ -0,0 +1,213 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+
+namespace itk
+{
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool with one task deque per worker thread.
+ *
+ * Each worker pushes the tasks it spawns onto the back of its own deque
+ * and pops them from the back (LIFO, cache friendly). An idle worker
+ * steals from the front of the other workers' deques (FIFO, which takes
+ * the biggest remaining pieces of work first). Tasks spawned from threads
+ * outside of the pool are distributed round-robin over the worker deques.
+ *
+ * Tasks are grouped into TaskGroup objects. Waiting on a TaskGroup does not
+ * block the calling thread: it keeps executing pending tasks (its own ones
+ * first, then stolen ones) until every task of the group has completed.
+ * Nested parallel sections started from inside a task are therefore
+ * executed by the same fixed set of threads, without oversubscription and
+ * without the deadlock that a blocking join would cause once all workers
+ * are waiting for their children.
+ *
+ * Initially the pool is started with GlobalDefaultNumberOfThreads threads.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+
+struct WorkStealingThreadPoolGlobals;
+
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer
+  GetInstance();
+
+  /** \class TaskGroup
+   * \brief Set of tasks which are waited for together.
+   *
+   * The first exception thrown by any task of the group is stored
+   * and rethrown by WorkStealingThreadPool::Wait().
+   * \ingroup ITKCommon */
+  class ITKCommon_EXPORT TaskGroup
+  {
+  public:
+    TaskGroup() = default;
+    ITK_DISALLOW_COPY_AND_MOVE(TaskGroup);
+
+    /** Number of spawned tasks which have not completed yet. */
+    SizeValueType
+    GetNumberOfPendingTasks() const
+    {
+      return m_PendingTasks.load(std::memory_order_acquire);
+    }
+
+  private:
+    friend class WorkStealingThreadPool;
+
+    std::atomic<SizeValueType> m_PendingTasks{ 0 };
+    std::mutex                 m_ExceptionMutex;
+    std::exception_ptr         m_FirstCaughtException;
+  };
+
+  /** Add a task to the pool. The task is accounted for in the given group,
+   * which must outlive the execution of the task (i.e. call Wait() on it). */
+  void
+  AddWork(TaskGroup & group, std::function<void()> task);
+
+  /** Execute pending tasks on the calling thread until every task of the
+   * group has completed, then rethrow the first exception thrown by any of
+   * them. Safe to call from inside a task of the pool. */
+  void
+  Wait(TaskGroup & group);
+
+  /** Number of worker threads owned by the pool. */
+  ThreadIdType
+  GetMaximumNumberOfThreads() const
+  {
+    return static_cast<ThreadIdType>(m_Threads.size());
+  }
+
+  /** Index of the worker thread calling this method, or -1 if the calling
+   * thread does not belong to the pool. */
+  static int
+  GetCurrentWorkerIndex();
+
+protected:
+  WorkStealingThreadPool();
+
+  /** Stop the pool and release threads. To be called by the destructor and atfork. */
+  void
+  CleanUp();
+
+  ~WorkStealingThreadPool() override { this->CleanUp(); }
+
+  static void
+  PrepareForFork();
+  static void
+  ResumeFromFork();
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(WorkStealingThreadPoolGlobals, PimplGlobals);
+
+  struct Task
+  {
+    std::function<void()> m_Function;
+    TaskGroup *           m_Group;
+  };
+
+  /** The deque of one worker. Aligned to avoid false sharing between workers. */
+  struct alignas(64) WorkerQueue
+  {
+    std::mutex       m_Mutex;
+    std::deque<Task> m_Tasks;
+  };
+
+  /** Start the worker threads, one deque per thread. */
+  void
+  StartThreads(ThreadIdType count);
+
+  /** Pop a task from the own deque of worker workerIndex, or steal one from
+   * another deque. Returns false if no task was found anywhere. */
+  bool
+  TryPopTask(int workerIndex, Task & task);
+
+  /** Run a task, storing its exception (if any) into its group. */
+  static void
+  RunTask(Task & task);
+
+  /** The continuously running thread function. The global default thread
+   * affinity is queried by the creating thread, like in ThreadPool. */
+  void
+  ThreadExecute(int workerIndex, bool bindToProcessor);
+
+  std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+
+  /** Vector to hold all thread handles.
+   * Thread handles are used to delete (join) the threads. */
+  std::vector<std::thread> m_Threads;
+
+  /** Total number of tasks sitting in the deques. Idle workers sleep on
+   * m_Condition while it is zero. */
+  std::atomic<SizeValueType> m_NumberOfQueuedTasks{ 0 };
+
+  /** Round-robin counter used to distribute tasks from external threads. */
+  std::atomic<SizeValueType> m_NextQueue{ 0 };
+
+  std::mutex              m_SleepMutex;
+  std::condition_variable m_Condition;
+
+  /* Has destruction started? */
+  bool m_Stopping{ false }; // guarded by m_SleepMutex
+
+  /** To lock on the internal variables */
+  static WorkStealingThreadPoolGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+#endif
@@ -0,0 +1,271 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocationPolicy.h"
+#include "itkImageBufferPool.h"
+#include "itkMultiThreaderBase.h"
+#include "itksys/SystemTools.hxx"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#else
+#  include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+// Size of the transparent huge pages of x86-64 and most aarch64 kernels.
+constexpr SizeValueType hugePageSize = 2 * 1024 * 1024;
+
+// Size of the chunks zero-filled by one work unit: a multiple of the page size.
+constexpr SizeValueType pageSize = 4096;
+
+// The memory returned by Allocate() and not released yet, so that the
+// containers know how to release their buffers. The count avoids locking
+// the mutex when no buffer is allocated by a policy.
+struct Allocations
+{
+  std::mutex                 m_Mutex;
+  std::unordered_set<void *> m_Memory;
+};
+std::atomic<SizeValueType> numberOfAllocations{ 0 };
+
+// Never destroyed, as images may be released during static destruction.
+Allocations &
+GetAllocations()
+{
+  static auto * const allocations = new Allocations();
+  return *allocations;
+}
+
+bool
+EnvironmentFlag(const char * name)
+{
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv(name, envVar))
+  {
+    envVar = itksys::SystemTools::UpperCase(envVar);
+    return envVar == "ON" || envVar == "1" || envVar == "TRUE";
+  }
+  return false;
+}
+
+// The global default policy, packed in a single integer so that it is read
+// and written atomically: the alignment above the two flags.
+std::uint64_t
+Pack(const ImageBufferAllocationPolicy & policy)
+{
+  return (static_cast<std::uint64_t>(policy.GetAlignment()) << 2) |
+         (static_cast<std::uint64_t>(policy.GetUseHugePages()) << 1) |
+         static_cast<std::uint64_t>(policy.GetParallelFirstTouch());
+}
+
+ImageBufferAllocationPolicy
+Unpack(std::uint64_t packedPolicy)
+{
+  ImageBufferAllocationPolicy policy;
+  policy.SetAlignment(static_cast<SizeValueType>(packedPolicy >> 2));
+  policy.SetUseHugePages((packedPolicy & 2) != 0);
+  policy.SetParallelFirstTouch((packedPolicy & 1) != 0);
+  return policy;
+}
+
+ImageBufferAllocationPolicy
+PolicyFromEnvironment()
+{
+  ImageBufferAllocationPolicy policy;
+  std::string                 envVar;
+  if (itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_IMAGE_BUFFER_ALIGNMENT", envVar))
+  {
+    policy.SetAlignment(static_cast<SizeValueType>(std::strtoull(envVar.c_str(), nullptr, 10)));
+  }
+  policy.SetUseHugePages(EnvironmentFlag("ITK_GLOBAL_DEFAULT_IMAGE_BUFFER_HUGE_PAGES"));
+  policy.SetParallelFirstTouch(EnvironmentFlag("ITK_GLOBAL_DEFAULT_IMAGE_BUFFER_FIRST_TOUCH"));
+  return policy;
+}
+
+// Initialized from the environment variables on first use.
+std::atomic<std::uint64_t> &
+GlobalDefault()
+{
+  static std::atomic<std::uint64_t> globalDefault{ Pack(PolicyFromEnvironment()) };
+  return globalDefault;
+}
+
+SizeValueType
+RoundUpToPowerOfTwo(SizeValueType value)
+{
+  SizeValueType result = 1;
+  while (result < value)
+  {
+    result <<= 1;
+  }
+  return result;
+}
+} // namespace
+
+ImageBufferAllocationPolicy
+ImageBufferAllocationPolicy::AlignedHugePages()
+{
+  ImageBufferAllocationPolicy policy;
+  policy.SetAlignment(64);
+  policy.SetUseHugePages(true);
+  return policy;
+}
+
+void *
+ImageBufferAllocationPolicy::Allocate(SizeValueType numberOfBytes) const
+{
+  void * const memory = numberOfBytes >= ImageBufferPool::MinimumNumberOfBytes && ImageBufferPool::GetEnabled()
+                          ? ImageBufferPool::GetInstance()->Acquire(numberOfBytes, *this)
+                          : this->AllocateWithoutPool(numberOfBytes);
+  if (memory)
+  {
+    Allocations &                     allocations = GetAllocations();
+    const std::lock_guard<std::mutex> lock(allocations.m_Mutex);
+    allocations.m_Memory.insert(memory);
+    ++numberOfAllocations;
+  }
+  return memory;
+}
+
+bool
+ImageBufferAllocationPolicy::IsAllocated(const void * memory)
+{
+  if (memory == nullptr || numberOfAllocations == 0)
+  {
+    return false;
+  }
+  Allocations &                     allocations = GetAllocations();
+  const std::lock_guard<std::mutex> lock(allocations.m_Mutex);
+  return allocations.m_Memory.count(const_cast<void *>(memory)) != 0;
+}
+
+void *
+ImageBufferAllocationPolicy::AllocateWithoutPool(SizeValueType numberOfBytes) const
+{
+  SizeValueType alignment = std::max<SizeValueType>(m_Alignment, alignof(std::max_align_t));
+  if (m_UseHugePages && numberOfBytes >= hugePageSize)
+  {
+    // Huge pages can only back the whole huge pages of the buffer.
+    alignment = std::max(alignment, hugePageSize);
+  }
+  alignment = RoundUpToPowerOfTwo(alignment);
+  numberOfBytes = std::max<SizeValueType>(numberOfBytes, 1);
+
+  void * memory = nullptr;
+#if defined(_WIN32)
+  memory = _aligned_malloc(numberOfBytes, alignment);
+#else
+  if (posix_memalign(&memory, alignment, numberOfBytes) != 0)
+  {
+    return nullptr;
+  }
+#  if defined(MADV_HUGEPAGE)
+  if (m_UseHugePages && numberOfBytes >= hugePageSize)
+  {
+    // Only a hint: it fails harmlessly when huge pages are disabled.
+    madvise(memory, numberOfBytes - numberOfBytes % hugePageSize, MADV_HUGEPAGE);
+  }
+#  endif
+#endif
+  return memory;
+}
+
+void
+ImageBufferAllocationPolicy::Deallocate(void * memory, SizeValueType itkNotUsed(numberOfBytes))
+{
+  {
+    Allocations &                     allocations = GetAllocations();
+    const std::lock_guard<std::mutex> lock(allocations.m_Mutex);
+    if (allocations.m_Memory.erase(memory) == 0)
+    {
+      return;
+    }
+    --numberOfAllocations;
+  }
+  if (!ImageBufferPool::Release(memory))
+  {
+    DeallocateWithoutPool(memory);
+  }
+}
+
+void
+ImageBufferAllocationPolicy::DeallocateWithoutPool(void * memory)
+{
+#if defined(_WIN32)
+  _aligned_free(memory);
+#else
+  free(memory);
+#endif
+}
+
+void
+ImageBufferAllocationPolicy::TouchInParallel(void * memory, SizeValueType numberOfBytes)
+{
+  auto                threader = MultiThreaderBase::New();
+  const SizeValueType numberOfChunks = std::max<SizeValueType>(threader->GetNumberOfWorkUnits(), 1);
+  SizeValueType       chunkSize = (numberOfBytes + numberOfChunks - 1) / numberOfChunks;
+  chunkSize = ((chunkSize + pageSize - 1) / pageSize) * pageSize;
+
+  auto * bytes = static_cast<char *>(memory);
+  threader->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [bytes, numberOfBytes, chunkSize](SizeValueType chunk) {
+      const SizeValueType start = std::min(chunk * chunkSize, numberOfBytes);
+      const SizeValueType end = std::min(start + chunkSize, numberOfBytes);
+      std::memset(bytes + start, 0, end - start);
+    },
+    nullptr);
+}
+
+void
+ImageBufferAllocationPolicy::SetGlobalDefault(const ImageBufferAllocationPolicy & policy)
+{
+  GlobalDefault() = Pack(policy);
+}
+
+ImageBufferAllocationPolicy
+ImageBufferAllocationPolicy::GetGlobalDefault()
+{
+  return Unpack(GlobalDefault());
+}
+
+std::ostream &
+operator<<(std::ostream & os, const ImageBufferAllocationPolicy & policy)
+{
+  if (policy.IsDefault())
+  {
+    return os << "new[]";
+  }
+  os << "Alignment: " << policy.GetAlignment() << ", UseHugePages: " << (policy.GetUseHugePages() ? "On" : "Off")
+     << ", ParallelFirstTouch: " << (policy.GetParallelFirstTouch() ? "On" : "Off");
+  return os;
+}
+
+} // namespace itk
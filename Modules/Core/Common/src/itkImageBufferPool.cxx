@@ -0,0 +1,314 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkSingleton.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace itk
+{
+
+struct ImageBufferPoolGlobals
+{
+  ImageBufferPoolGlobals() = default;
+
+  // To allow singleton creation of ImageBufferPool.
+  std::once_flag m_PoolOnceFlag;
+
+  // The singleton instance of ImageBufferPool.
+  ImageBufferPool::Pointer m_PoolInstance;
+
+  // Whether the pool is enabled, initialized from the environment.
+  std::once_flag    m_EnabledOnceFlag;
+  std::atomic<bool> m_Enabled{ false };
+
+  // Number of pooled buffers in use, so that releasing memory which does
+  // not come from the pool does not need to lock it.
+  std::atomic<SizeValueType> m_NumberOfBuffersInUse{ 0 };
+};
+
+itkGetGlobalSimpleMacro(ImageBufferPool, ImageBufferPoolGlobals, PimplGlobals);
+
+namespace
+{
+void
+InitializeEnabledFromEnvironment(ImageBufferPoolGlobals * globals)
+{
+  std::call_once(globals->m_EnabledOnceFlag, [globals]() {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      globals->m_Enabled = (envVar == "ON" || envVar == "1" || envVar == "TRUE");
+    }
+  });
+}
+} // namespace
+
+ImageBufferPool::Pointer
+ImageBufferPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+ImageBufferPool::Pointer
+ImageBufferPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  // Create a singleton ImageBufferPool.
+  std::call_once(m_PimplGlobals->m_PoolOnceFlag, []() {
+    m_PimplGlobals->m_PoolInstance = ObjectFactory<Self>::Create();
+    if (m_PimplGlobals->m_PoolInstance.IsNull())
+    {
+      new ImageBufferPool(); // constructor sets m_PimplGlobals->m_PoolInstance
+    }
+  });
+
+  return m_PimplGlobals->m_PoolInstance;
+}
+
+ImageBufferPool::ImageBufferPool()
+  : m_MaximumNumberOfBytes(SizeValueType{ 1 } << 30)
+{
+  // Construction only occurs via GetInstance which is protected by call_once.
+  m_PimplGlobals->m_PoolInstance = this;        // like the thread pools
+  m_PimplGlobals->m_PoolInstance->UnRegister(); // Remove extra reference
+
+  std::string envVar;
+  if (itksys::SystemTools::GetEnv("ITK_IMAGE_BUFFER_POOL_MAXIMUM_BYTES", envVar))
+  {
+    m_MaximumNumberOfBytes = static_cast<SizeValueType>(std::strtoull(envVar.c_str(), nullptr, 10));
+  }
+}
+
+ImageBufferPool::~ImageBufferPool()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  this->EvictUntil(0);
+}
+
+void
+ImageBufferPool::SetEnabled(bool enabled)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  InitializeEnabledFromEnvironment(m_PimplGlobals);
+  m_PimplGlobals->m_Enabled = enabled;
+  if (!enabled && m_PimplGlobals->m_PoolInstance.IsNotNull())
+  {
+    m_PimplGlobals->m_PoolInstance->Clear();
+  }
+}
+
+bool
+ImageBufferPool::GetEnabled()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  InitializeEnabledFromEnvironment(m_PimplGlobals);
+  return m_PimplGlobals->m_Enabled;
+}
+
+void
+ImageBufferPool::SetMaximumNumberOfBytes(SizeValueType maximumNumberOfBytes)
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MaximumNumberOfBytes == maximumNumberOfBytes)
+    {
+      return;
+    }
+    m_MaximumNumberOfBytes = maximumNumberOfBytes;
+    this->EvictUntil(maximumNumberOfBytes);
+  }
+  this->Modified();
+}
+
+SizeValueType
+ImageBufferPool::GetMaximumNumberOfBytes() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumNumberOfBytes;
+}
+
+SizeValueType
+ImageBufferPool::GetSizeClass(SizeValueType numberOfBytes)
+{
+  if (numberOfBytes <= 4)
+  {
+    return numberOfBytes;
+  }
+  // Four size classes per power of two: 1, 1.25, 1.5 and 1.75 times 2^n.
+  SizeValueType powerOfTwo = 1;
+  while (powerOfTwo <= numberOfBytes / 2)
+  {
+    powerOfTwo <<= 1;
+  }
+  const SizeValueType step = powerOfTwo / 4;
+  return ((numberOfBytes + step - 1) / step) * step;
+}
+
+ImageBufferPool::Statistics
+ImageBufferPool::GetStatistics() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Statistics;
+}
+
+void
+ImageBufferPool::ResetStatistics()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  const SizeValueType               cachedBytes = m_Statistics.CachedBytes;
+  const SizeValueType               inUseBytes = m_Statistics.InUseBytes;
+  m_Statistics = Statistics();
+  m_Statistics.CachedBytes = cachedBytes;
+  m_Statistics.PeakCachedBytes = cachedBytes;
+  m_Statistics.InUseBytes = inUseBytes;
+  m_Statistics.PeakInUseBytes = inUseBytes;
+}
+
+void
+ImageBufferPool::Clear()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  this->EvictUntil(0);
+}
+
+void *
+ImageBufferPool::Acquire(SizeValueType numberOfBytes, const ImageBufferAllocationPolicy & policy)
+{
+  const Key key{ GetSizeClass(numberOfBytes), policy.GetAlignment(), policy.GetUseHugePages() };
+
+  void * memory = nullptr;
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    const auto                        cached = std::find_if(
+      m_CachedBuffers.begin(), m_CachedBuffers.end(), [&key](const CachedBuffer & buffer) { return buffer.m_Key == key; });
+    if (cached != m_CachedBuffers.end())
+    {
+      memory = cached->m_Memory;
+      m_CachedBuffers.erase(cached);
+      m_Statistics.CachedBytes -= key.m_SizeClass;
+      ++m_Statistics.Hits;
+    }
+    else
+    {
+      ++m_Statistics.Misses;
+    }
+  }
+
+  if (memory == nullptr)
+  {
+    // Allocate outside of the lock, allocating gigabytes may take a while.
+    memory = policy.AllocateWithoutPool(key.m_SizeClass);
+    if (memory == nullptr)
+    {
+      // Give the memory of the cached buffers back, and try again.
+      this->Clear();
+      memory = policy.AllocateWithoutPool(key.m_SizeClass);
+      if (memory == nullptr)
+      {
+        return nullptr;
+      }
+    }
+  }
+
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  m_BuffersInUse.emplace(memory, key);
+  ++m_PimplGlobals->m_NumberOfBuffersInUse;
+  m_Statistics.InUseBytes += key.m_SizeClass;
+  m_Statistics.PeakInUseBytes = std::max(m_Statistics.PeakInUseBytes, m_Statistics.InUseBytes);
+  return memory;
+}
+
+bool
+ImageBufferPool::Release(void * memory)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  if (memory == nullptr || m_PimplGlobals->m_NumberOfBuffersInUse == 0 || m_PimplGlobals->m_PoolInstance.IsNull())
+  {
+    return false;
+  }
+  return m_PimplGlobals->m_PoolInstance->ReleaseBuffer(memory);
+}
+
+bool
+ImageBufferPool::ReleaseBuffer(void * memory)
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  const auto                        inUse = m_BuffersInUse.find(memory);
+  if (inUse == m_BuffersInUse.end())
+  {
+    return false;
+  }
+  const Key key = inUse->second;
+  m_BuffersInUse.erase(inUse);
+  --m_PimplGlobals->m_NumberOfBuffersInUse;
+  m_Statistics.InUseBytes -= key.m_SizeClass;
+
+  if (!m_PimplGlobals->m_Enabled || key.m_SizeClass > m_MaximumNumberOfBytes)
+  {
+    ImageBufferAllocationPolicy::DeallocateWithoutPool(memory);
+    return true;
+  }
+  this->EvictUntil(m_MaximumNumberOfBytes - key.m_SizeClass);
+  m_CachedBuffers.push_front(CachedBuffer{ key, memory });
+  m_Statistics.CachedBytes += key.m_SizeClass;
+  m_Statistics.PeakCachedBytes = std::max(m_Statistics.PeakCachedBytes, m_Statistics.CachedBytes);
+  return true;
+}
+
+void
+ImageBufferPool::EvictUntil(SizeValueType numberOfBytes)
+{
+  while (m_Statistics.CachedBytes > numberOfBytes && !m_CachedBuffers.empty())
+  {
+    const CachedBuffer & oldest = m_CachedBuffers.back();
+    ImageBufferAllocationPolicy::DeallocateWithoutPool(oldest.m_Memory);
+    m_Statistics.CachedBytes -= oldest.m_Key.m_SizeClass;
+    ++m_Statistics.Evictions;
+    m_CachedBuffers.pop_back();
+  }
+}
+
+void
+ImageBufferPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const Statistics statistics = this->GetStatistics();
+  os << indent << "Enabled: " << (GetEnabled() ? "On" : "Off") << std::endl;
+  os << indent << "MaximumNumberOfBytes: " << this->GetMaximumNumberOfBytes() << std::endl;
+  os << indent << "Hits: " << statistics.Hits << std::endl;
+  os << indent << "Misses: " << statistics.Misses << std::endl;
+  os << indent << "Evictions: " << statistics.Evictions << std::endl;
+  os << indent << "CachedBytes: " << statistics.CachedBytes << std::endl;
+  os << indent << "PeakCachedBytes: " << statistics.PeakCachedBytes << std::endl;
+  os << indent << "InUseBytes: " << statistics.InUseBytes << std::endl;
+  os << indent << "PeakInUseBytes: " << statistics.PeakInUseBytes << std::endl;
+}
+
+ImageBufferPoolGlobals * ImageBufferPool::m_PimplGlobals;
+
+} // namespace itk
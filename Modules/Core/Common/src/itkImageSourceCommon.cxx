@@ -18,6 +18,9 @@
 
 #include "itkImageRegionSplitterSlowDimension.h"
 #include "itkImageSourceCommon.h"
+#include "itkThreadSupport.h"
+#include <algorithm>
+#include <cmath>
 #include <mutex>
 
 namespace itk
@@ -38,5 +41,40 @@ ImageSourceCommon::GetGlobalDefaultSplitter()
   return globalDefaultSplitter;
 }
 
+ThreadIdType
+ImageSourceCommon::ComputeNumberOfWorkUnits(SizeValueType numberOfPixels,
+                                            SizeValueType splitDimensionSize,
+                                            ThreadIdType  numberOfWorkUnits,
+                                            SizeValueType grainSize,
+                                            double        pixelCostHint)
+{
+  if (grainSize == 0 && pixelCostHint > 0.0)
+  {
+    grainSize = static_cast<SizeValueType>(std::ceil(MinimumWorkUnitDuration / pixelCostHint));
+
+    // Expensive filters: smaller pieces, so that a slow piece does not keep
+    // one thread busy long after all the others are done.
+    const double balancedWorkUnits = std::ceil(static_cast<double>(numberOfPixels) * pixelCostHint /
+                                               MaximumWorkUnitDuration);
+    if (balancedWorkUnits > static_cast<double>(numberOfWorkUnits))
+    {
+      numberOfWorkUnits = static_cast<ThreadIdType>(std::min(balancedWorkUnits, static_cast<double>(ITK_MAX_THREADS)));
+    }
+  }
+  if (grainSize == 0 || numberOfPixels == 0)
+  {
+    return numberOfWorkUnits;
+  }
+
+  // The splitter cuts the region into whole slices, so a piece of at least
+  // one grain has a whole number of slices of at least one grain.
+  const SizeValueType slicePixels =
+    std::max<SizeValueType>(numberOfPixels / std::max<SizeValueType>(splitDimensionSize, 1), 1);
+  grainSize = ((grainSize + slicePixels - 1) / slicePixels) * slicePixels;
+
+  const SizeValueType maximumWorkUnits = std::max<SizeValueType>(numberOfPixels / grainSize, 1);
+  return static_cast<ThreadIdType>(std::min<SizeValueType>(numberOfWorkUnits, maximumWorkUnits));
+}
+
 
 } // namespace itk
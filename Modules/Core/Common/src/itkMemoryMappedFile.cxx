@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined(_WIN32)
+#  include "itkWindows.h"
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+std::ostream &
+operator<<(std::ostream & out, const MemoryMappedFileEnums::AccessMode value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case MemoryMappedFileEnums::AccessMode::ReadOnly:
+        return "MemoryMappedFileEnums::AccessMode::ReadOnly";
+      case MemoryMappedFileEnums::AccessMode::CopyOnWrite:
+        return "MemoryMappedFileEnums::AccessMode::CopyOnWrite";
+      default:
+        return "INVALID VALUE FOR MemoryMappedFileEnums::AccessMode";
+    }
+  }();
+}
+
+namespace
+{
+// Granularity of the offset of a mapping.
+SizeValueType
+GetAllocationGranularity()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  return static_cast<SizeValueType>(systemInfo.dwAllocationGranularity);
+#else
+  return static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+#endif
+}
+} // namespace
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+void
+MemoryMappedFile::Map(const std::string & fileName,
+                      SizeValueType       offset,
+                      SizeValueType       numberOfBytes,
+                      AccessModeEnum      accessMode)
+{
+  this->Unmap();
+
+  if (numberOfBytes == 0)
+  {
+    itkExceptionMacro("Cannot map zero bytes of " << fileName);
+  }
+  const auto fileLength = static_cast<SizeValueType>(itksys::SystemTools::FileLength(fileName));
+  if (offset > fileLength || numberOfBytes > fileLength - offset)
+  {
+    itkExceptionMacro("Cannot map " << numberOfBytes << " bytes at offset " << offset << " of " << fileName
+                                    << ", which has only " << fileLength << " bytes");
+  }
+
+  const SizeValueType granularity = GetAllocationGranularity();
+  const SizeValueType mappedOffset = offset - offset % granularity;
+  const SizeValueType mappedLength = numberOfBytes + (offset - mappedOffset);
+  void *              mappedAddress = nullptr;
+
+#if defined(_WIN32)
+  const std::wstring wideFileName = itksys::SystemTools::ConvertToWindowsExtendedPath(fileName);
+  HANDLE             file = CreateFileW(
+    wideFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    itkExceptionMacro("Cannot open " << fileName << " for mapping");
+  }
+  const DWORD protection = (accessMode == AccessModeEnum::CopyOnWrite) ? PAGE_WRITECOPY : PAGE_READONLY;
+  HANDLE      mapping = CreateFileMappingW(file, nullptr, protection, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    itkExceptionMacro("Cannot create a file mapping of " << fileName);
+  }
+  const DWORD access = (accessMode == AccessModeEnum::CopyOnWrite) ? FILE_MAP_COPY : FILE_MAP_READ;
+  mappedAddress = MapViewOfFile(mapping,
+                                access,
+                                static_cast<DWORD>(static_cast<uint64_t>(mappedOffset) >> 32),
+                                static_cast<DWORD>(mappedOffset & 0xFFFFFFFF),
+                                static_cast<SIZE_T>(mappedLength));
+  // The view keeps the mapping alive.
+  CloseHandle(mapping);
+  if (mappedAddress == nullptr)
+  {
+    itkExceptionMacro("Cannot map " << mappedLength << " bytes of " << fileName);
+  }
+#else
+  const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    itkExceptionMacro("Cannot open " << fileName << " for mapping: " << itksys::SystemTools::GetLastSystemError());
+  }
+  const int protection = (accessMode == AccessModeEnum::CopyOnWrite) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  const int flags = (accessMode == AccessModeEnum::CopyOnWrite) ? MAP_PRIVATE : MAP_SHARED;
+  mappedAddress =
+    mmap(nullptr, static_cast<size_t>(mappedLength), protection, flags, fileDescriptor, static_cast<off_t>(mappedOffset));
+  // The mapping keeps the file alive.
+  close(fileDescriptor);
+  if (mappedAddress == MAP_FAILED)
+  {
+    itkExceptionMacro("Cannot map " << mappedLength << " bytes of " << fileName << ": "
+                                    << itksys::SystemTools::GetLastSystemError());
+  }
+#endif
+
+  m_FileName = fileName;
+  m_Offset = offset;
+  m_NumberOfBytes = numberOfBytes;
+  m_AccessMode = accessMode;
+  m_MappedAddress = mappedAddress;
+  m_MappedLength = mappedLength;
+  m_Pointer = static_cast<char *>(mappedAddress) + (offset - mappedOffset);
+  this->Modified();
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if (m_MappedAddress == nullptr)
+  {
+    return;
+  }
+#if defined(_WIN32)
+  UnmapViewOfFile(m_MappedAddress);
+#else
+  munmap(m_MappedAddress, static_cast<size_t>(m_MappedLength));
+#endif
+  m_MappedAddress = nullptr;
+  m_MappedLength = 0;
+  m_Pointer = nullptr;
+  m_NumberOfBytes = 0;
+  this->Modified();
+}
+
+void
+MemoryMappedFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Offset: " << m_Offset << std::endl;
+  os << indent << "NumberOfBytes: " << m_NumberOfBytes << std::endl;
+  os << indent << "AccessMode: " << m_AccessMode << std::endl;
+  os << indent << "Pointer: " << m_Pointer << std::endl;
+}
+
+} // end namespace itk
@@ -30,6 +30,7 @@
 
 #if defined(ITK_USE_POOL_MULTI_THREADER)
 #  include "itkPoolMultiThreader.h"
+#  include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -44,6 +45,11 @@
 #include <algorithm>
 #include <cctype>
 
+#if defined(__linux__) && defined(ITK_USE_PTHREADS)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
 #if defined(ITK_USE_TBB)
 #  include "itkTBBMultiThreader.h"
 #endif
@@ -83,6 +89,12 @@ struct MultiThreaderBaseGlobals
   //  m_GlobalMaximumNumberOfThreads and larger or equal to 1 once it has been
   //  initialized in the constructor of the first MultiThreaderBase instantiation.
   ThreadIdType m_GlobalDefaultNumberOfThreads{ 0 };
+
+  // Whether pool threads are bound to processors. Initialized from the
+  // ITK_GLOBAL_DEFAULT_THREAD_AFFINITY environment variable on first use,
+  // unless SetGlobalDefaultThreadAffinity was called before.
+  bool GlobalDefaultThreadAffinityIsInitialized{ false };
+  bool m_GlobalDefaultThreadAffinity{ false };
 };
 
 itkGetGlobalSimpleMacro(MultiThreaderBase, MultiThreaderBaseGlobals, PimplGlobals);
@@ -201,6 +213,10 @@ MultiThreaderBase::ThreaderTypeFromString(std::string threaderString)
   {
     return ThreaderEnum::TBB;
   }
+  else if (threaderString == "WORKSTEALING")
+  {
+    return ThreaderEnum::WorkStealing;
+  }
   else
   {
     return ThreaderEnum::Unknown;
@@ -248,6 +264,72 @@ MultiThreaderBase::SetGlobalDefaultNumberOfThreads(ThreadIdType val)
     std::max(m_PimplGlobals->m_GlobalDefaultNumberOfThreads, NumericTraits<ThreadIdType>::OneValue());
 }
 
+void
+MultiThreaderBase::SetGlobalDefaultThreadAffinity(bool threadAffinity)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  const std::lock_guard lock(m_PimplGlobals->globalDefaultInitializerLock);
+
+  m_PimplGlobals->m_GlobalDefaultThreadAffinity = threadAffinity;
+  m_PimplGlobals->GlobalDefaultThreadAffinityIsInitialized = true;
+}
+
+bool
+MultiThreaderBase::GetGlobalDefaultThreadAffinity()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+
+  const std::lock_guard lock(m_PimplGlobals->globalDefaultInitializerLock);
+
+  if (!m_PimplGlobals->GlobalDefaultThreadAffinityIsInitialized)
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_THREAD_AFFINITY", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      m_PimplGlobals->m_GlobalDefaultThreadAffinity = (envVar == "ON" || envVar == "1" || envVar == "TRUE");
+    }
+    m_PimplGlobals->GlobalDefaultThreadAffinityIsInitialized = true;
+  }
+  return m_PimplGlobals->m_GlobalDefaultThreadAffinity;
+}
+
+bool
+MultiThreaderBase::BindCurrentThreadToProcessor(ThreadIdType processorIndex)
+{
+#if defined(__linux__) && defined(ITK_USE_PTHREADS)
+  // Restrict to the processors this process may run on (taskset, cgroups).
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    return false;
+  }
+  const int allowedCount = CPU_COUNT(&allowed);
+  if (allowedCount <= 0)
+  {
+    return false;
+  }
+
+  int remaining = static_cast<int>(processorIndex % static_cast<ThreadIdType>(allowedCount));
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &allowed) && remaining-- == 0)
+    {
+      cpu_set_t single;
+      CPU_ZERO(&single);
+      CPU_SET(cpu, &single);
+      return pthread_setaffinity_np(pthread_self(), sizeof(single), &single) == 0;
+    }
+  }
+  return false;
+#else
+  (void)processorIndex;
+  return false;
+#endif
+}
+
 void
 MultiThreaderBase::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
 {
@@ -423,6 +505,12 @@ MultiThreaderBase::New()
         return TBBMultiThreader::New();
 #else
         itkGenericExceptionMacro("ITK has been built without TBB support!");
+#endif
+      case ThreaderEnum::WorkStealing:
+#if defined(ITK_USE_POOL_MULTI_THREADER)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
 #endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
@@ -599,6 +687,7 @@ MultiThreaderBase::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Global Maximum Number Of Threads: " << m_PimplGlobals->m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: " << m_PimplGlobals->m_GlobalDefaultNumberOfThreads << std::endl;
   os << indent << "Global Default Threader Type: " << m_PimplGlobals->m_GlobalDefaultThreader << std::endl;
+  os << indent << "Global Default Thread Affinity: " << m_PimplGlobals->m_GlobalDefaultThreadAffinity << std::endl;
   os << indent << "SingleMethod: " << m_SingleMethod << std::endl;
   os << indent << "SingleData: " << m_SingleData << std::endl;
 }
@@ -620,6 +709,8 @@ operator<<(std::ostream & out, const MultiThreaderBaseEnums::Threader value)
         return "itk::MultiThreaderBaseEnums::Threader::Pool";
       case MultiThreaderBaseEnums::Threader::TBB:
         return "itk::MultiThreaderBaseEnums::Threader::TBB";
+      case MultiThreaderBaseEnums::Threader::WorkStealing:
+        return "itk::MultiThreaderBaseEnums::Threader::WorkStealing";
         //      TODO    case MultiThreaderBaseEnums::Threader::Last:
         //                    return "itk::MultiThreaderBaseEnums::Threader::Last";
       case MultiThreaderBaseEnums::Threader::Unknown:
@@ -0,0 +1,250 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineExecutor.h"
+#include "itkWorkStealingThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+namespace
+{
+// A filter of the graph, with the data objects to bring up to date when it
+// executes, and the filters which can only execute after it.
+struct FilterNode
+{
+  ProcessObject::Pointer     Filter;
+  std::vector<DataObject *>  Outputs;
+  std::vector<SizeValueType> Downstream;
+  std::atomic<SizeValueType> NumberOfPendingUpstream{ 0 };
+};
+
+template <typename T>
+void
+AppendUnique(std::vector<T> & values, const T & value)
+{
+  if (std::find(values.cbegin(), values.cend(), value) == values.cend())
+  {
+    values.push_back(value);
+  }
+}
+
+// Lists the filters upstream of filter in post order, which is the order of
+// their execution by the serial update: the sources of the inputs of a
+// filter come before the filter.
+void
+VisitUpstream(ProcessObject *                                     filter,
+              std::unordered_map<ProcessObject *, SizeValueType> & indices,
+              std::vector<ProcessObject::Pointer> &              filters)
+{
+  if (!indices.emplace(filter, 0).second)
+  {
+    return;
+  }
+  for (const auto & input : filter->GetInputs())
+  {
+    if (input)
+    {
+      const auto source = input->GetSource();
+      if (source)
+      {
+        VisitUpstream(source.GetPointer(), indices, filters);
+      }
+    }
+  }
+  indices[filter] = filters.size();
+  filters.emplace_back(filter);
+}
+
+// The primary output of filter, which is its first indexed output.
+DataObject *
+GetPrimaryOutput(ProcessObject * filter)
+{
+  const ProcessObject::DataObjectPointerArray outputs = filter->GetIndexedOutputs();
+  return outputs.empty() ? nullptr : outputs[0].GetPointer();
+}
+} // namespace
+
+
+void
+PipelineExecutor::Update(DataObject * data)
+{
+  if (data == nullptr)
+  {
+    itkExceptionMacro(<< "The data object to update is null.");
+  }
+  m_NumberOfExecutedFilters = 0;
+
+  data->UpdateOutputInformation();
+  data->PropagateRequestedRegion();
+
+  const auto rootSource = data->GetSource();
+  if (!rootSource)
+  {
+    return;
+  }
+
+  // Discover the graph of the filters upstream of data.
+  std::unordered_map<ProcessObject *, SizeValueType> indices;
+  std::vector<ProcessObject::Pointer>                filters;
+  VisitUpstream(rootSource.GetPointer(), indices, filters);
+
+  std::vector<FilterNode> nodes(filters.size());
+  std::unordered_map<const DataObject *, std::vector<SizeValueType>> consumers;
+  std::vector<std::vector<SizeValueType>>                          upstream(filters.size());
+  for (SizeValueType index = 0; index < filters.size(); ++index)
+  {
+    nodes[index].Filter = filters[index];
+    for (const auto & input : filters[index]->GetInputs())
+    {
+      if (!input)
+      {
+        continue;
+      }
+      const auto source = input->GetSource();
+      if (source)
+      {
+        const SizeValueType sourceIndex = indices[source.GetPointer()];
+        AppendUnique(nodes[sourceIndex].Outputs, input.GetPointer());
+        AppendUnique(upstream[index], sourceIndex);
+      }
+      AppendUnique(consumers[input.GetPointer()], index);
+    }
+  }
+  nodes.back().Outputs.push_back(data);
+
+  // The consumers of a data object may modify it, when running in place or
+  // releasing their inputs: they execute one after the other, in post order,
+  // which cannot introduce a cycle.
+  for (const auto & dataConsumers : consumers)
+  {
+    for (SizeValueType i = 1; i < dataConsumers.second.size(); ++i)
+    {
+      AppendUnique(upstream[dataConsumers.second[i]], dataConsumers.second[i - 1]);
+    }
+  }
+  for (SizeValueType index = 0; index < nodes.size(); ++index)
+  {
+    nodes[index].NumberOfPendingUpstream = upstream[index].size();
+    for (const SizeValueType upstreamIndex : upstream[index])
+    {
+      nodes[upstreamIndex].Downstream.push_back(index);
+    }
+  }
+
+  // Execute each filter as a task once the filters it depends on have
+  // completed. A failed filter stops the execution of the filters which are
+  // not started yet, and Wait() rethrows its exception.
+  const WorkStealingThreadPool::Pointer pool = WorkStealingThreadPool::GetInstance();
+  WorkStealingThreadPool::TaskGroup     group;
+  std::atomic<bool>                     failed{ false };
+  std::atomic<SizeValueType>            numberOfExecutedFilters{ 0 };
+
+  std::function<void(SizeValueType)> addTask = [&](const SizeValueType index) {
+    pool->AddWork(group, [&, index]() {
+      if (failed)
+      {
+        return;
+      }
+      FilterNode & node = nodes[index];
+      bool         executed = false;
+      try
+      {
+        for (DataObject * output : node.Outputs)
+        {
+          const ModifiedTimeType updateTime = output->GetUpdateMTime();
+          output->UpdateOutputData();
+          executed = executed || output->GetUpdateMTime() != updateTime;
+        }
+      }
+      catch (...)
+      {
+        failed = true;
+        throw;
+      }
+      if (executed)
+      {
+        ++numberOfExecutedFilters;
+      }
+      for (const SizeValueType downstreamIndex : node.Downstream)
+      {
+        if (--nodes[downstreamIndex].NumberOfPendingUpstream == 0)
+        {
+          addTask(downstreamIndex);
+        }
+      }
+    });
+  };
+
+  for (SizeValueType index = 0; index < nodes.size(); ++index)
+  {
+    if (nodes[index].NumberOfPendingUpstream == 0)
+    {
+      addTask(index);
+    }
+  }
+  try
+  {
+    pool->Wait(group);
+  }
+  catch (...)
+  {
+    m_NumberOfExecutedFilters = numberOfExecutedFilters;
+    throw;
+  }
+  m_NumberOfExecutedFilters = numberOfExecutedFilters;
+}
+
+
+void
+PipelineExecutor::Update(ProcessObject * filter)
+{
+  DataObject * output = GetPrimaryOutput(filter);
+  if (output)
+  {
+    this->Update(output);
+  }
+}
+
+
+void
+PipelineExecutor::UpdateLargestPossibleRegion(ProcessObject * filter)
+{
+  filter->UpdateOutputInformation();
+
+  DataObject * output = GetPrimaryOutput(filter);
+  if (output)
+  {
+    output->SetRequestedRegionToLargestPossibleRegion();
+    this->Update(output);
+  }
+}
+
+
+void
+PipelineExecutor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfExecutedFilters: " << m_NumberOfExecutedFilters << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,58 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineMemory.h"
+#include "itkProcessObject.h"
+#include <unordered_set>
+#include <vector>
+
+namespace itk
+{
+
+SizeValueType
+PipelineMemory::EstimateRequestedRegionMemorySize(DataObject * data)
+{
+  SizeValueType memorySize = 0;
+
+  // Walk the pipeline upstream, visiting each data object once, as several
+  // filters may share an input.
+  std::unordered_set<const DataObject *> visited;
+  std::vector<DataObject *>              toVisit{ data };
+  while (!toVisit.empty())
+  {
+    DataObject * current = toVisit.back();
+    toVisit.pop_back();
+    if (current == nullptr || !visited.insert(current).second)
+    {
+      continue;
+    }
+
+    const auto source = current->GetSource();
+    if (source)
+    {
+      memorySize += current->GetRequestedRegionMemorySize();
+      for (const auto & input : source->GetInputs())
+      {
+        toVisit.push_back(input.GetPointer());
+      }
+    }
+  }
+  return memorySize;
+}
+
+} // end namespace itk
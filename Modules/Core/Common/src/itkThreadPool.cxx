@@ -112,21 +112,23 @@ ThreadPool::ThreadPool()
   m_PimplGlobals->m_ThreadPoolInstance = this;        // threads need this
   m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
   ThreadIdType threadCount = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const bool   bindToProcessor = MultiThreaderBase::GetGlobalDefaultThreadAffinity();
   m_Threads.reserve(threadCount);
   for (ThreadIdType i = 0; i < threadCount; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, i, bindToProcessor);
   }
 }
 
 void
 ThreadPool::AddThreads(ThreadIdType count)
 {
+  const bool                   bindToProcessor = MultiThreaderBase::GetGlobalDefaultThreadAffinity();
   std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
   m_Threads.reserve(m_Threads.size() + count);
   for (ThreadIdType i = 0; i < count; ++i)
   {
-    m_Threads.emplace_back(&ThreadPool::ThreadExecute);
+    m_Threads.emplace_back(&ThreadPool::ThreadExecute, static_cast<ThreadIdType>(m_Threads.size()), bindToProcessor);
   }
 }
 
@@ -187,8 +189,13 @@ ThreadPool::ResumeFromFork()
 }
 
 void
-ThreadPool::ThreadExecute()
+ThreadPool::ThreadExecute(ThreadIdType threadIndex, bool bindToProcessor)
 {
+  if (bindToProcessor)
+  {
+    MultiThreaderBase::BindCurrentThreadToProcessor(threadIndex);
+  }
+
   // plain pointer does not increase reference count
   ThreadPool * threadPool = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
 
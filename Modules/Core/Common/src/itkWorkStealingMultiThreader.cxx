@@ -0,0 +1,236 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingMultiThreader.h"
+#include "itkProcessObject.h"
+#include "itkImageSourceCommon.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+namespace
+{
+// Run the calling thread's share of the work, then help the pool until all
+// tasks of the group are completed. The first exception is rethrown, after
+// every task has finished (tasks may reference the caller's stack).
+template <typename TFunction>
+void
+ExecuteShareAndWait(WorkStealingThreadPool & pool, WorkStealingThreadPool::TaskGroup & group, const TFunction & share)
+{
+  std::exception_ptr firstCaughtException = nullptr;
+  try
+  {
+    share();
+  }
+  catch (...)
+  {
+    firstCaughtException = std::current_exception();
+  }
+  try
+  {
+    pool.Wait(group);
+  }
+  catch (...)
+  {
+    if (firstCaughtException == nullptr)
+    {
+      firstCaughtException = std::current_exception();
+    }
+  }
+  if (firstCaughtException != nullptr)
+  {
+    std::rethrow_exception(firstCaughtException);
+  }
+}
+} // namespace
+
+WorkStealingMultiThreader::WorkStealingMultiThreader()
+  : m_ThreadPool(WorkStealingThreadPool::GetInstance())
+{
+  ThreadIdType defaultThreads = std::max(1u, GetGlobalDefaultNumberOfThreads());
+#if !defined(ITKV4_COMPATIBILITY)
+  if (defaultThreads > 1) // one work unit for only one thread
+  {
+    defaultThreads *= 4;
+  }
+#endif
+  m_NumberOfWorkUnits = std::min<ThreadIdType>(ITK_MAX_THREADS, defaultThreads);
+}
+
+WorkStealingMultiThreader::~WorkStealingMultiThreader() = default;
+
+void
+WorkStealingMultiThreader::SetSingleMethod(ThreadFunctionType f, void * data)
+{
+  m_SingleMethod = f;
+  m_SingleData = data;
+}
+
+void
+WorkStealingMultiThreader::SingleMethodExecute()
+{
+  if (!m_SingleMethod)
+  {
+    itkExceptionMacro(<< "No single method set!");
+  }
+
+  // obey the global maximum number of threads limit
+  m_NumberOfWorkUnits = std::min(this->GetGlobalMaximumNumberOfThreads(), m_NumberOfWorkUnits);
+
+  // The work unit information is local (not a member array as in
+  // PoolMultiThreader), so that nested calls on the same threader are safe.
+  std::vector<WorkUnitInfo> workUnitInfos(m_NumberOfWorkUnits);
+  for (ThreadIdType i = 0; i < m_NumberOfWorkUnits; ++i)
+  {
+    workUnitInfos[i].WorkUnitID = i;
+    workUnitInfos[i].NumberOfWorkUnits = m_NumberOfWorkUnits;
+    workUnitInfos[i].UserData = m_SingleData;
+  }
+
+  const ThreadFunctionType          singleMethod = m_SingleMethod;
+  WorkStealingThreadPool::TaskGroup group;
+  for (ThreadIdType i = 1; i < m_NumberOfWorkUnits; ++i)
+  {
+    m_ThreadPool->AddWork(group, [singleMethod, &workUnitInfos, i] { singleMethod(&workUnitInfos[i]); });
+  }
+
+  // The calling thread executes the first work unit itself,
+  // then helps with the remaining ones while waiting for them.
+  ExecuteShareAndWait(*m_ThreadPool, group, [&] { singleMethod(&workUnitInfos[0]); });
+}
+
+void
+WorkStealingMultiThreader::ParallelizeArray(SizeValueType             firstIndex,
+                                            SizeValueType             lastIndexPlus1,
+                                            ArrayThreadingFunctorType aFunc,
+                                            ProcessObject *           filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progressStartEnd(filter, 0, 1);
+
+  if (firstIndex + 1 < lastIndexPlus1)
+  {
+    const SizeValueType count = lastIndexPlus1 - firstIndex;
+    const SizeValueType chunkCount = std::min<SizeValueType>(count, m_NumberOfWorkUnits);
+    SizeValueType       chunkSize = count / chunkCount;
+    if (count % chunkCount > 0)
+    {
+      ++chunkSize; // we want slightly bigger chunks to be processed first
+    }
+
+    auto lambda = [aFunc, filter, count](SizeValueType start, SizeValueType end) {
+      TotalProgressReporter progress(filter, count, 100);
+      progress.CheckAbortGenerateData();
+      for (SizeValueType ii = start; ii < end; ++ii)
+      {
+        aFunc(ii);
+      }
+      progress.Completed(end - start);
+    };
+
+    WorkStealingThreadPool::TaskGroup group;
+    for (SizeValueType i = firstIndex + chunkSize; i < lastIndexPlus1; i += chunkSize)
+    {
+      const SizeValueType end = std::min(i + chunkSize, lastIndexPlus1);
+      m_ThreadPool->AddWork(group, [lambda, i, end] { lambda(i, end); });
+    }
+
+    // execute this thread's share, then help with the others
+    ExecuteShareAndWait(
+      *m_ThreadPool, group, [&] { lambda(firstIndex, std::min(firstIndex + chunkSize, lastIndexPlus1)); });
+  }
+  else if (firstIndex + 1 == lastIndexPlus1)
+  {
+    aFunc(firstIndex);
+  }
+  // else nothing needs to be executed
+}
+
+void
+WorkStealingMultiThreader::ParallelizeImageRegion(unsigned int         dimension,
+                                                  const IndexValueType index[],
+                                                  const SizeValueType  size[],
+                                                  ThreadingFunctorType funcP,
+                                                  ProcessObject *      filter)
+{
+  if (!this->GetUpdateProgress())
+  {
+    filter = nullptr;
+  }
+  ProgressReporter progressStartEnd(filter, 0, 1);
+
+  if (m_NumberOfWorkUnits == 1) // no multi-threading wanted
+  {
+    funcP(index, size); // process whole region
+    return;
+  }
+
+  ImageIORegion region(dimension);
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    region.SetIndex(d, index[d]);
+    region.SetSize(d, size[d]);
+  }
+  if (region.GetNumberOfPixels() <= 1)
+  {
+    funcP(index, size); // process whole region
+    return;
+  }
+
+  const ImageRegionSplitterBase * splitter = ImageSourceCommon::GetGlobalDefaultSplitter();
+  const ThreadIdType              splitCount = splitter->GetNumberOfSplits(region, m_NumberOfWorkUnits);
+  const SizeValueType             totalCount = region.GetNumberOfPixels();
+
+  auto lambda = [funcP, filter, totalCount](const ImageIORegion & regionToProcess) {
+    TotalProgressReporter progress(filter, totalCount, 100);
+    progress.CheckAbortGenerateData();
+
+    funcP(&regionToProcess.GetIndex()[0], &regionToProcess.GetSize()[0]);
+
+    progress.Completed(regionToProcess.GetNumberOfPixels());
+  };
+
+  WorkStealingThreadPool::TaskGroup group;
+  for (ThreadIdType i = 1; i < splitCount; ++i)
+  {
+    ImageIORegion      iRegion = region;
+    const ThreadIdType total = splitter->GetSplit(i, splitCount, iRegion);
+    if (i < total)
+    {
+      m_ThreadPool->AddWork(group, [lambda, iRegion] { lambda(iRegion); });
+    }
+  }
+
+  // execute this thread's share, then help with the others
+  ImageIORegion iRegion = region;
+  splitter->GetSplit(0, splitCount, iRegion);
+  ExecuteShareAndWait(*m_ThreadPool, group, [&] { lambda(iRegion); });
+}
+
+void
+WorkStealingMultiThreader::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ThreadPool: " << m_ThreadPool.GetPointer() << std::endl;
+}
+
+} // namespace itk
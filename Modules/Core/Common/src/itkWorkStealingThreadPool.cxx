@@ -0,0 +1,291 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingThreadPool.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSingleton.h"
+
+#include <cassert>
+
+namespace itk
+{
+
+namespace
+{
+// Index of the pool worker running on this thread, -1 for foreign threads.
+thread_local int currentWorkerIndex = -1;
+} // namespace
+
+struct WorkStealingThreadPoolGlobals
+{
+  WorkStealingThreadPoolGlobals() = default;
+
+  // To allow singleton creation of WorkStealingThreadPool.
+  std::once_flag m_ThreadPoolOnceFlag;
+
+  // The singleton instance of WorkStealingThreadPool.
+  WorkStealingThreadPool::Pointer m_ThreadPoolInstance;
+};
+
+itkGetGlobalSimpleMacro(WorkStealingThreadPool, WorkStealingThreadPoolGlobals, PimplGlobals);
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  // Create a singleton WorkStealingThreadPool.
+  std::call_once(m_PimplGlobals->m_ThreadPoolOnceFlag, []() {
+    m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
+    if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+    {
+      new WorkStealingThreadPool(); // constructor sets m_PimplGlobals->m_ThreadPoolInstance
+    }
+#if defined(ITK_USE_PTHREADS)
+    pthread_atfork(WorkStealingThreadPool::PrepareForFork,
+                   WorkStealingThreadPool::ResumeFromFork,
+                   WorkStealingThreadPool::ResumeFromFork);
+#endif
+  });
+
+  return m_PimplGlobals->m_ThreadPoolInstance;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+{
+  // Construction only occurs via GetInstance which is protected by call_once.
+  m_PimplGlobals->m_ThreadPoolInstance = this;        // threads need this
+  m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
+  this->StartThreads(std::max(1u, MultiThreaderBase::GetGlobalDefaultNumberOfThreads()));
+}
+
+void
+WorkStealingThreadPool::StartThreads(ThreadIdType count)
+{
+  // All deques are created before the first thread starts,
+  // so that m_Queues never changes while workers are running.
+  m_Queues.clear();
+  m_Queues.reserve(count);
+  for (ThreadIdType i = 0; i < count; ++i)
+  {
+    m_Queues.push_back(std::make_unique<WorkerQueue>());
+  }
+  const bool bindToProcessor = MultiThreaderBase::GetGlobalDefaultThreadAffinity();
+  m_Threads.reserve(count);
+  for (ThreadIdType i = 0; i < count; ++i)
+  {
+    m_Threads.emplace_back(&WorkStealingThreadPool::ThreadExecute, this, static_cast<int>(i), bindToProcessor);
+  }
+}
+
+int
+WorkStealingThreadPool::GetCurrentWorkerIndex()
+{
+  return currentWorkerIndex;
+}
+
+void
+WorkStealingThreadPool::AddWork(TaskGroup & group, std::function<void()> task)
+{
+  group.m_PendingTasks.fetch_add(1, std::memory_order_relaxed);
+
+  int queueIndex = currentWorkerIndex;
+  if (queueIndex < 0 || static_cast<SizeValueType>(queueIndex) >= m_Queues.size())
+  {
+    queueIndex = static_cast<int>(m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size());
+  }
+  {
+    WorkerQueue &                queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.m_Mutex);
+    queue.m_Tasks.push_back(Task{ std::move(task), &group });
+  }
+  m_NumberOfQueuedTasks.fetch_add(1, std::memory_order_release);
+
+  // Acquiring the mutex orders this notification after the check done by a
+  // worker which is about to go to sleep, so that no wake-up gets lost.
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+  }
+  m_Condition.notify_one();
+}
+
+bool
+WorkStealingThreadPool::TryPopTask(int workerIndex, Task & task)
+{
+  if (m_NumberOfQueuedTasks.load(std::memory_order_acquire) == 0)
+  {
+    return false;
+  }
+
+  const auto numberOfQueues = static_cast<int>(m_Queues.size());
+  if (workerIndex >= 0 && workerIndex < numberOfQueues)
+  {
+    // Own deque: newest task first.
+    WorkerQueue &                queue = *m_Queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.m_Mutex);
+    if (!queue.m_Tasks.empty())
+    {
+      task = std::move(queue.m_Tasks.back());
+      queue.m_Tasks.pop_back();
+      m_NumberOfQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  // Steal the oldest task of another deque, starting from the next neighbor
+  // so that thieves spread over the victims.
+  const int start = workerIndex >= 0 ? workerIndex + 1 : 0;
+  for (int i = 0; i < numberOfQueues; ++i)
+  {
+    const int victim = (start + i) % numberOfQueues;
+    if (victim == workerIndex)
+    {
+      continue;
+    }
+    WorkerQueue &                queue = *m_Queues[victim];
+    std::lock_guard<std::mutex> lock(queue.m_Mutex);
+    if (!queue.m_Tasks.empty())
+    {
+      task = std::move(queue.m_Tasks.front());
+      queue.m_Tasks.pop_front();
+      m_NumberOfQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+WorkStealingThreadPool::RunTask(Task & task)
+{
+  TaskGroup * group = task.m_Group;
+  try
+  {
+    task.m_Function();
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(group->m_ExceptionMutex);
+    if (group->m_FirstCaughtException == nullptr)
+    {
+      group->m_FirstCaughtException = std::current_exception();
+    }
+  }
+  // Release the callable (and whatever it captured) before signaling completion.
+  task.m_Function = nullptr;
+  group->m_PendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void
+WorkStealingThreadPool::Wait(TaskGroup & group)
+{
+  const int workerIndex = currentWorkerIndex;
+  while (group.m_PendingTasks.load(std::memory_order_acquire) > 0)
+  {
+    Task task;
+    if (this->TryPopTask(workerIndex, task))
+    {
+      RunTask(task);
+    }
+    else
+    {
+      // The remaining tasks of the group are being executed by other threads.
+      std::this_thread::yield();
+    }
+  }
+
+  if (group.m_FirstCaughtException != nullptr)
+  {
+    std::exception_ptr exception = nullptr;
+    std::swap(exception, group.m_FirstCaughtException);
+    std::rethrow_exception(exception);
+  }
+}
+
+void
+WorkStealingThreadPool::CleanUp()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+
+  for (auto & thread : m_Threads)
+  {
+    assert(thread.joinable());
+    thread.join();
+  }
+}
+
+void
+WorkStealingThreadPool::PrepareForFork()
+{
+  m_PimplGlobals->m_ThreadPoolInstance->CleanUp();
+}
+
+void
+WorkStealingThreadPool::ResumeFromFork()
+{
+  WorkStealingThreadPool * instance = m_PimplGlobals->m_ThreadPoolInstance.GetPointer();
+  const auto               threadCount = static_cast<ThreadIdType>(instance->m_Threads.size());
+  instance->m_Threads.clear();
+  instance->m_Stopping = false;
+  instance->StartThreads(threadCount);
+}
+
+void
+WorkStealingThreadPool::ThreadExecute(int workerIndex, bool bindToProcessor)
+{
+  currentWorkerIndex = workerIndex;
+  if (bindToProcessor)
+  {
+    MultiThreaderBase::BindCurrentThreadToProcessor(static_cast<ThreadIdType>(workerIndex));
+  }
+
+  while (true)
+  {
+    Task task;
+    if (this->TryPopTask(workerIndex, task))
+    {
+      RunTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_SleepMutex);
+    m_Condition.wait(lock, [this] {
+      return m_Stopping || m_NumberOfQueuedTasks.load(std::memory_order_acquire) > 0;
+    });
+    if (m_Stopping && m_NumberOfQueuedTasks.load(std::memory_order_acquire) == 0)
+    {
+      return;
+    }
+  }
+}
+
+WorkStealingThreadPoolGlobals * WorkStealingThreadPool::m_PimplGlobals;
+
+} // namespace itk
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkByteSwapper.h"
+#include "itkTimeProbe.h"
+#include <gtest/gtest.h>
+#include <algorithm> // For reverse.
+#include <cstring>   // For memcpy.
+#include <numeric>   // For iota.
+#include <sstream>
+#include <vector>
+
+namespace
+{
+// Returns the values with the order of their bytes reversed, one by one.
+template <typename T>
+std::vector<T>
+ReverseBytes(std::vector<T> values)
+{
+  for (T & value : values)
+  {
+    auto * const bytes = reinterpret_cast<unsigned char *>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+  return values;
+}
+
+
+template <typename T>
+std::vector<T>
+MakeValues(size_t numberOfValues)
+{
+  std::vector<unsigned char> bytes(numberOfValues * sizeof(T));
+  std::iota(bytes.begin(), bytes.end(), static_cast<unsigned char>(1));
+  std::vector<T> values(numberOfValues);
+  if (!bytes.empty())
+  {
+    std::memcpy(values.data(), bytes.data(), bytes.size());
+  }
+  return values;
+}
+
+
+// Checks the swap of ranges of all lengths around the widths of the SIMD
+// registers, and at unaligned addresses.
+template <typename T>
+void
+Expect_range_swap_reverses_bytes_of_each_value()
+{
+  using ByteSwapperType = itk::ByteSwapper<T>;
+
+  for (size_t numberOfValues = 0; numberOfValues <= 70; ++numberOfValues)
+  {
+    const std::vector<T> values = MakeValues<T>(numberOfValues);
+    const std::vector<T> reversed = ReverseBytes(values);
+
+    std::vector<T> swapped = values;
+    ByteSwapperType::SwapRangeFromSystemToBigEndian(swapped.data(), numberOfValues);
+    EXPECT_EQ(swapped, ByteSwapperType::SystemIsBigEndian() ? values : reversed);
+
+    swapped = values;
+    ByteSwapperType::SwapRangeFromSystemToLittleEndian(swapped.data(), numberOfValues);
+    EXPECT_EQ(swapped, ByteSwapperType::SystemIsLittleEndian() ? values : reversed);
+  }
+
+  // Values that do not start at a multiple of their size.
+  constexpr size_t           numberOfValues = 37;
+  std::vector<unsigned char> buffer(numberOfValues * sizeof(T) + 1);
+  const std::vector<T>       values = MakeValues<T>(numberOfValues);
+  std::memcpy(buffer.data() + 1, values.data(), numberOfValues * sizeof(T));
+  T * const unaligned = reinterpret_cast<T *>(buffer.data() + 1);
+  ByteSwapperType::SwapRangeFromSystemToBigEndian(unaligned, numberOfValues);
+  ByteSwapperType::SwapRangeFromSystemToLittleEndian(unaligned, numberOfValues);
+
+  std::vector<T> swappedTwice(numberOfValues);
+  std::memcpy(swappedTwice.data(), buffer.data() + 1, numberOfValues * sizeof(T));
+  EXPECT_EQ(swappedTwice, ReverseBytes(values));
+}
+
+
+// Checks the write of more values than the chunks in which they are swapped.
+template <typename T>
+void
+Expect_write_range_swaps_values_of_several_chunks()
+{
+  using ByteSwapperType = itk::ByteSwapper<T>;
+
+  const std::vector<T> values = MakeValues<T>(2500001);
+  std::ostringstream   stream;
+  if (ByteSwapperType::SystemIsBigEndian())
+  {
+    ByteSwapperType::SwapWriteRangeFromSystemToLittleEndian(values.data(), static_cast<int>(values.size()), &stream);
+  }
+  else
+  {
+    ByteSwapperType::SwapWriteRangeFromSystemToBigEndian(values.data(), static_cast<int>(values.size()), &stream);
+  }
+  const std::string written = stream.str();
+  ASSERT_EQ(written.size(), values.size() * sizeof(T));
+
+  std::vector<T> writtenValues(values.size());
+  std::memcpy(writtenValues.data(), written.data(), written.size());
+  EXPECT_EQ(writtenValues, ReverseBytes(values));
+}
+
+
+// Reports the time taken to swap a range of 64 MiB.
+template <typename T>
+void
+ReportRangeSwapTime(const char * typeName)
+{
+  std::vector<T> values = MakeValues<T>((size_t{ 64 } << 20) / sizeof(T));
+  itk::TimeProbe probe;
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    probe.Start();
+    itk::ByteSwapper<T>::SwapRangeFromSystemToBigEndian(values.data(), values.size());
+    itk::ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(values.data(), values.size());
+    probe.Stop();
+  }
+  std::cout << "Swap of 64 MiB of " << typeName << ": " << probe.GetMean() * 1000 << " ms" << std::endl;
+}
+} // namespace
+
+
+TEST(ByteSwapper, SwapRangeReversesBytesOfEachValue)
+{
+  Expect_range_swap_reverses_bytes_of_each_value<short>();
+  Expect_range_swap_reverses_bytes_of_each_value<unsigned short>();
+  Expect_range_swap_reverses_bytes_of_each_value<int>();
+  Expect_range_swap_reverses_bytes_of_each_value<float>();
+  Expect_range_swap_reverses_bytes_of_each_value<double>();
+  Expect_range_swap_reverses_bytes_of_each_value<unsigned long long>();
+}
+
+
+TEST(ByteSwapper, SwapWriteRangeSwapsValuesOfSeveralChunks)
+{
+  Expect_write_range_swaps_values_of_several_chunks<unsigned short>();
+  Expect_write_range_swaps_values_of_several_chunks<float>();
+  Expect_write_range_swaps_values_of_several_chunks<double>();
+}
+
+
+TEST(ByteSwapper, ReportRangeSwapTime)
+{
+  ReportRangeSwapTime<unsigned short>("unsigned short");
+  ReportRangeSwapTime<float>("float");
+  ReportRangeSwapTime<double>("double");
+}
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImageBufferAllocationPolicy.h"
+
+#include "itkImage.h"
+#include "itkImportImageContainer.h"
+#include "itkVectorImage.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+
+namespace
+{
+template <typename TElement>
+bool
+IsAligned(const TElement * pointer, itk::SizeValueType alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+itk::ImageBufferAllocationPolicy
+MakeAlignedPolicy(itk::SizeValueType alignment)
+{
+  itk::ImageBufferAllocationPolicy policy;
+  policy.SetAlignment(alignment);
+  return policy;
+}
+} // namespace
+
+
+TEST(ImageBufferAllocationPolicy, DefaultConstructedPolicyUsesNewArray)
+{
+  const itk::ImageBufferAllocationPolicy policy;
+  EXPECT_TRUE(policy.IsDefault());
+  EXPECT_EQ(policy.GetAlignment(), 0u);
+  EXPECT_FALSE(policy.GetUseHugePages());
+  EXPECT_FALSE(policy.GetParallelFirstTouch());
+  EXPECT_FALSE(itk::ImageBufferAllocationPolicy::AlignedHugePages().IsDefault());
+}
+
+
+TEST(ImageBufferAllocationPolicy, AllocateIsAligned)
+{
+  // Alignments are rounded up to a power of two.
+  const std::pair<itk::SizeValueType, itk::SizeValueType> alignments[] = { { 16, 16 },
+                                                                           { 64, 64 },
+                                                                           { 100, 128 },
+                                                                           { 4096, 4096 } };
+  for (const auto & alignment : alignments)
+  {
+    void * const memory = MakeAlignedPolicy(alignment.first).Allocate(1000);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_TRUE(IsAligned(static_cast<char *>(memory), alignment.second));
+    itk::ImageBufferAllocationPolicy::Deallocate(memory, 1000);
+  }
+
+  // Huge pages can only back huge buffers aligned on the huge page size.
+  const auto                   policy = itk::ImageBufferAllocationPolicy::AlignedHugePages();
+  constexpr itk::SizeValueType numberOfBytes = 5 * 1024 * 1024;
+  void * const                 memory = policy.Allocate(numberOfBytes);
+  ASSERT_NE(memory, nullptr);
+  EXPECT_TRUE(IsAligned(static_cast<char *>(memory), 2 * 1024 * 1024));
+  itk::ImageBufferAllocationPolicy::Deallocate(memory, numberOfBytes);
+}
+
+
+TEST(ImageBufferAllocationPolicy, ContainerAllocatesWithItsPolicy)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, float>;
+  auto container = ContainerType::New();
+  container->SetAllocationPolicy(MakeAlignedPolicy(64));
+
+  container->Reserve(1001, true);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+  EXPECT_TRUE(std::all_of(
+    container->GetBufferPointer(), container->GetBufferPointer() + 1001, [](float value) { return value == 0.0f; }));
+
+  // Growing keeps the values, and the alignment.
+  container->GetBufferPointer()[1000] = 3.0f;
+  container->Reserve(5000);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+  EXPECT_EQ(container->GetBufferPointer()[1000], 3.0f);
+
+  container->Reserve(10);
+  container->Squeeze();
+  EXPECT_EQ(container->Capacity(), 10u);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+
+  container->Initialize();
+  EXPECT_EQ(container->GetBufferPointer(), nullptr);
+}
+
+
+TEST(ImageBufferAllocationPolicy, ContainerConstructsAndDestroysElements)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, std::string>;
+  auto container = ContainerType::New();
+  container->SetAllocationPolicy(MakeAlignedPolicy(64));
+  container->Reserve(100, true);
+  EXPECT_TRUE(container->GetBufferPointer()[99].empty());
+  container->GetBufferPointer()[99] = std::string(1000, 'x');
+  container->Reserve(200);
+  EXPECT_EQ(container->GetBufferPointer()[99].size(), 1000u);
+  // The elements are destroyed with the container.
+}
+
+
+TEST(ImageBufferAllocationPolicy, ParallelFirstTouchZeroFills)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, short>;
+  auto policy = MakeAlignedPolicy(64);
+  policy.SetParallelFirstTouch(true);
+
+  for (const bool useDefaultConstructor : { false, true })
+  {
+    auto container = ContainerType::New();
+    container->SetAllocationPolicy(policy);
+    container->Reserve(1000003, useDefaultConstructor);
+    EXPECT_TRUE(std::all_of(container->GetBufferPointer(),
+                            container->GetBufferPointer() + container->Size(),
+                            [](short value) { return value == 0; }));
+  }
+}
+
+
+TEST(ImageBufferAllocationPolicy, ImportedBuffersAreReleasedWithDeleteArray)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, int>;
+  auto container = ContainerType::New();
+  container->SetAllocationPolicy(MakeAlignedPolicy(64));
+  container->Reserve(10);
+  container->SetImportPointer(new int[20], 20, true);
+  container->Reserve(30);
+  EXPECT_TRUE(IsAligned(container->GetBufferPointer(), 64));
+}
+
+
+TEST(ImageBufferAllocationPolicy, AllocatedMemoryIsTracked)
+{
+  const auto   policy = MakeAlignedPolicy(64);
+  void * const memory = policy.Allocate(1000);
+  EXPECT_TRUE(itk::ImageBufferAllocationPolicy::IsAllocated(memory));
+  itk::ImageBufferAllocationPolicy::Deallocate(memory, 1000);
+  EXPECT_FALSE(itk::ImageBufferAllocationPolicy::IsAllocated(memory));
+
+  const auto importedMemory = std::make_unique<int[]>(10);
+  EXPECT_FALSE(itk::ImageBufferAllocationPolicy::IsAllocated(importedMemory.get()));
+  EXPECT_FALSE(itk::ImageBufferAllocationPolicy::IsAllocated(nullptr));
+}
+
+
+TEST(ImageBufferAllocationPolicy, ContainerKeepsManagingPolicyBuffers)
+{
+  using ContainerType = itk::ImportImageContainer<itk::SizeValueType, int>;
+  auto container = ContainerType::New();
+  container->SetAllocationPolicy(MakeAlignedPolicy(64));
+  container->Reserve(10);
+
+  // The application would release the buffer with delete[].
+  EXPECT_THROW(container->ContainerManageMemoryOff(), itk::ExceptionObject);
+  EXPECT_TRUE(container->GetContainerManageMemory());
+
+  // A buffer allocated by new[] can still be handed over.
+  container->SetAllocationPolicy(itk::ImageBufferAllocationPolicy());
+  container->Initialize();
+  container->Reserve(10);
+  container->ContainerManageMemoryOff();
+  EXPECT_FALSE(container->GetContainerManageMemory());
+  const std::unique_ptr<int[]> memory(container->GetImportPointer());
+  container->Initialize();
+}
+
+
+TEST(ImageBufferAllocationPolicy, ImageKeepsItsPolicy)
+{
+  const auto policy = MakeAlignedPolicy(128);
+
+  auto image = itk::Image<unsigned char, 3>::New();
+  image->GetPixelContainer()->SetAllocationPolicy(policy);
+  image->SetRegions(itk::Size<3>{ { 7, 5, 3 } });
+  image->Allocate();
+  EXPECT_TRUE(IsAligned(image->GetBufferPointer(), 128));
+
+  // Initialize() replaces the pixel container, as filters do before
+  // reallocating their outputs.
+  image->Initialize();
+  EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), policy);
+  image->SetRegions(itk::Size<3>{ { 9, 5, 3 } });
+  image->Allocate();
+  EXPECT_TRUE(IsAligned(image->GetBufferPointer(), 128));
+
+  auto vectorImage = itk::VectorImage<float, 2>::New();
+  vectorImage->GetPixelContainer()->SetAllocationPolicy(policy);
+  vectorImage->Initialize();
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->SetRegions(itk::Size<2>{ { 11, 7 } });
+  vectorImage->Allocate();
+  EXPECT_TRUE(IsAligned(vectorImage->GetBufferPointer(), 128));
+}
+
+
+TEST(ImageBufferAllocationPolicy, GlobalDefaultAppliesToNewImages)
+{
+  const auto originalPolicy = itk::ImageBufferAllocationPolicy::GetGlobalDefault();
+  const auto policy = itk::ImageBufferAllocationPolicy::AlignedHugePages();
+  itk::ImageBufferAllocationPolicy::SetGlobalDefault(policy);
+  EXPECT_EQ(itk::ImageBufferAllocationPolicy::GetGlobalDefault(), policy);
+
+  auto image = itk::Image<float, 2>::New();
+  EXPECT_EQ(image->GetPixelContainer()->GetAllocationPolicy(), policy);
+  image->SetRegions(itk::Size<2>{ { 1024, 1024 } });
+  image->Allocate(true);
+  EXPECT_TRUE(IsAligned(image->GetBufferPointer(), 64));
+  EXPECT_EQ(image->GetPixel({ { 1023, 1023 } }), 0.0f);
+
+  itk::ImageBufferAllocationPolicy::SetGlobalDefault(originalPolicy);
+}
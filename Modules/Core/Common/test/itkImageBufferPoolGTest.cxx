@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImageBufferPool.h"
+
+#include "itkImage.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+// 1 MiB of pixels.
+ImageType::Pointer
+MakeImage(itk::SizeValueType numberOfRows = 512)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 512, numberOfRows } });
+  image->Allocate();
+  return image;
+}
+
+// Enables an empty pool for the duration of a test.
+class ImageBufferPoolFixture : public ::testing::Test
+{
+protected:
+  void
+  SetUp() override
+  {
+    m_Pool = itk::ImageBufferPool::GetInstance();
+    m_OriginalMaximumNumberOfBytes = m_Pool->GetMaximumNumberOfBytes();
+    itk::ImageBufferPool::SetEnabled(true);
+    m_Pool->Clear();
+    m_Pool->ResetStatistics();
+  }
+
+  void
+  TearDown() override
+  {
+    itk::ImageBufferPool::SetEnabled(false);
+    m_Pool->SetMaximumNumberOfBytes(m_OriginalMaximumNumberOfBytes);
+    m_Pool->ResetStatistics();
+  }
+
+  itk::ImageBufferPool::Pointer m_Pool;
+  itk::SizeValueType            m_OriginalMaximumNumberOfBytes{};
+};
+} // namespace
+
+
+TEST(ImageBufferPool, SizeClassesHaveAtMostAQuarterOverhead)
+{
+  EXPECT_EQ(itk::ImageBufferPool::GetSizeClass(1 << 20), itk::SizeValueType{ 1 } << 20);
+  EXPECT_EQ(itk::ImageBufferPool::GetSizeClass((1 << 20) + 1), itk::SizeValueType{ 5 } << 18);
+  EXPECT_EQ(itk::ImageBufferPool::GetSizeClass(3 << 20), itk::SizeValueType{ 3 } << 20);
+  for (itk::SizeValueType numberOfBytes = 100000; numberOfBytes < 10000000; numberOfBytes += 99991)
+  {
+    const itk::SizeValueType sizeClass = itk::ImageBufferPool::GetSizeClass(numberOfBytes);
+    EXPECT_GE(sizeClass, numberOfBytes);
+    EXPECT_LE(sizeClass, numberOfBytes + numberOfBytes / 4);
+  }
+}
+
+
+TEST(ImageBufferPool, IsSingleton)
+{
+  EXPECT_EQ(itk::ImageBufferPool::New(), itk::ImageBufferPool::GetInstance());
+}
+
+
+TEST_F(ImageBufferPoolFixture, ReleasedBuffersAreReused)
+{
+  auto         image = MakeImage();
+  const void * buffer = image->GetBufferPointer();
+  image = nullptr;
+
+  auto statistics = m_Pool->GetStatistics();
+  EXPECT_EQ(statistics.Misses, 1u);
+  EXPECT_EQ(statistics.CachedBytes, itk::SizeValueType{ 1 } << 20);
+  EXPECT_EQ(statistics.InUseBytes, 0u);
+
+  // Slightly smaller images use the same size class.
+  image = MakeImage(500);
+  EXPECT_EQ(image->GetBufferPointer(), buffer);
+
+  // ReleaseData (ReleaseDataFlag) gives the buffer back.
+  image->ReleaseData();
+  image = MakeImage();
+  EXPECT_EQ(image->GetBufferPointer(), buffer);
+
+  statistics = m_Pool->GetStatistics();
+  EXPECT_EQ(statistics.Hits, 2u);
+  EXPECT_EQ(statistics.Misses, 1u);
+  EXPECT_EQ(statistics.PeakInUseBytes, itk::SizeValueType{ 1 } << 20);
+}
+
+
+TEST_F(ImageBufferPoolFixture, CapEvictsLeastRecentlyReleasedBuffers)
+{
+  m_Pool->SetMaximumNumberOfBytes(3 << 19); // 1.5 MiB
+
+  auto image1 = MakeImage();
+  auto image2 = MakeImage();
+  image1 = nullptr;
+  image2 = nullptr;
+
+  auto statistics = m_Pool->GetStatistics();
+  EXPECT_EQ(statistics.Evictions, 1u);
+  EXPECT_EQ(statistics.CachedBytes, itk::SizeValueType{ 1 } << 20);
+  EXPECT_EQ(statistics.PeakCachedBytes, itk::SizeValueType{ 1 } << 20);
+
+  // Buffers larger than the cap are not cached at all.
+  image1 = MakeImage(1024);
+  image1 = nullptr;
+  EXPECT_EQ(m_Pool->GetStatistics().CachedBytes, itk::SizeValueType{ 1 } << 20);
+
+  m_Pool->Clear();
+  EXPECT_EQ(m_Pool->GetStatistics().CachedBytes, 0u);
+}
+
+
+TEST_F(ImageBufferPoolFixture, SmallBuffersAreNotPooled)
+{
+  auto image = MakeImage(4);
+  image = nullptr;
+  const auto statistics = m_Pool->GetStatistics();
+  EXPECT_EQ(statistics.Hits + statistics.Misses, 0u);
+  EXPECT_EQ(statistics.CachedBytes, 0u);
+}
+
+
+TEST_F(ImageBufferPoolFixture, BuffersOutliveDisabling)
+{
+  auto image = MakeImage();
+  itk::ImageBufferPool::SetEnabled(false);
+  image = nullptr; // freed, not cached
+  EXPECT_EQ(m_Pool->GetStatistics().CachedBytes, 0u);
+  EXPECT_EQ(m_Pool->GetStatistics().InUseBytes, 0u);
+}
+
+
+TEST_F(ImageBufferPoolFixture, IsThreadSafe)
+{
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([t]() {
+      for (unsigned int i = 0; i < 50; ++i)
+      {
+        auto image = MakeImage(256 + 64 * ((t + i) % 4));
+        image->FillBuffer(static_cast<float>(t));
+        EXPECT_EQ(image->GetPixel({ { 511, 255 } }), static_cast<float>(t));
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  const auto statistics = m_Pool->GetStatistics();
+  EXPECT_EQ(statistics.Hits + statistics.Misses, 400u);
+  EXPECT_GT(statistics.Hits, 0u);
+  EXPECT_EQ(statistics.InUseBytes, 0u);
+  EXPECT_LE(statistics.CachedBytes, m_Pool->GetMaximumNumberOfBytes());
+}
@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkImageSourceCommon.h"
+
+#include "itkImage.h"
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+
+
+namespace
+{
+// Image source which records the regions it is asked to generate.
+template <typename TImage>
+class RecordingImageSource : public itk::ImageSource<TImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(RecordingImageSource);
+
+  using Self = RecordingImageSource;
+  using Superclass = itk::ImageSource<TImage>;
+  using Pointer = itk::SmartPointer<Self>;
+  using RegionType = typename TImage::RegionType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(RecordingImageSource, ImageSource);
+
+  void
+  SetSize(const typename TImage::SizeType & size)
+  {
+    m_Size = size;
+  }
+
+  std::vector<RegionType> m_Regions;
+
+protected:
+  RecordingImageSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(RegionType(m_Size));
+  }
+
+  void
+  DynamicThreadedGenerateData(const RegionType & region) override
+  {
+    for (itk::ImageRegionIterator<TImage> it(this->GetOutput(), region); !it.IsAtEnd(); ++it)
+    {
+      it.Set(1);
+    }
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Regions.push_back(region);
+  }
+
+private:
+  typename TImage::SizeType m_Size{};
+  std::mutex                m_Mutex;
+};
+} // namespace
+
+
+TEST(ImageSourceCommon, ComputeNumberOfWorkUnitsWithoutHintsKeepsNumberOfWorkUnits)
+{
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(100, 10, 16, 0, 0.0), 16u);
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(0, 0, 16, 0, 0.0), 16u);
+}
+
+
+TEST(ImageSourceCommon, ComputeNumberOfWorkUnitsHonorsGrainSize)
+{
+  // 64 slices of 100 pixels, at least 1000 pixels per piece: 6 pieces.
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(6400, 64, 16, 1000, 0.0), 6u);
+
+  // The grain size is rounded up to whole slices: 150 -> 200 pixels.
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(1000, 10, 16, 150, 0.0), 5u);
+
+  // Never less than one piece, never more than requested.
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(10, 1, 16, 1000, 0.0), 1u);
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(1000000, 10000, 16, 100, 0.0), 16u);
+
+  // Slices larger than the grain size: at most one piece per slice.
+  EXPECT_EQ(itk::ImageSourceCommon::ComputeNumberOfWorkUnits(64 * 64 * 4, 4, 16, 100, 0.0), 4u);
+}
+
+
+TEST(ImageSourceCommon, ComputeNumberOfWorkUnitsAdaptsToPixelCost)
+{
+  using itk::ImageSourceCommon;
+
+  // Cheap filter on a tiny image: a single piece.
+  const auto cheapTiny = ImageSourceCommon::ComputeNumberOfWorkUnits(64 * 64, 64, 32, 0, 1.0);
+  EXPECT_EQ(cheapTiny, 1u);
+
+  // Cheap filter on a small image: fewer pieces than work units, but more
+  // than one.
+  const auto cheapSmall = ImageSourceCommon::ComputeNumberOfWorkUnits(256 * 256, 256, 32, 0, 1.0);
+  EXPECT_GT(cheapSmall, 1u);
+  EXPECT_LT(cheapSmall, 32u);
+
+  // Cheap filter on a large image: the requested number of work units.
+  const auto cheapLarge = ImageSourceCommon::ComputeNumberOfWorkUnits(512 * 512 * 512, 512, 32, 0, 1.0);
+  EXPECT_EQ(cheapLarge, 32u);
+
+  // Expensive filter on a large image: more pieces, for load balancing.
+  const auto expensiveLarge = ImageSourceCommon::ComputeNumberOfWorkUnits(512 * 512 * 512, 512, 32, 0, 1000.0);
+  EXPECT_GT(expensiveLarge, 32u);
+  EXPECT_LE(expensiveLarge, static_cast<itk::ThreadIdType>(itk::ITK_MAX_THREADS));
+}
+
+
+TEST(ImageSourceCommon, ImageSourceSplitsIntoWholeSlicesOfAtLeastGrainSize)
+{
+  using ImageType = itk::Image<unsigned char, 3>;
+  auto source = RecordingImageSource<ImageType>::New();
+  source->SetSize({ { 30, 20, 10 } });
+  source->SetNumberOfWorkUnits(16);
+  source->SetGrainSize(1000);
+  source->Update();
+
+  ASSERT_FALSE(source->m_Regions.empty());
+  EXPECT_LE(source->m_Regions.size(), 5u); // 6000 pixels in pieces of at least 1200 pixels
+
+  itk::SizeValueType numberOfPixels = 0;
+  for (const auto & region : source->m_Regions)
+  {
+    EXPECT_EQ(region.GetSize(0), 30u);
+    EXPECT_EQ(region.GetSize(1), 20u);
+    EXPECT_GE(region.GetNumberOfPixels(), 1000u);
+    numberOfPixels += region.GetNumberOfPixels();
+  }
+  EXPECT_EQ(numberOfPixels, 6000u);
+}
@@ -20,6 +20,7 @@
 #include "itkMultiThreaderBase.h"
 #include "itkPlatformMultiThreader.h"
 #include "itkPoolMultiThreader.h"
+#include "itkWorkStealingMultiThreader.h"
 #ifdef ITK_USE_TBB
 #  include "itkTBBMultiThreader.h"
 #endif
@@ -117,6 +118,7 @@ itkMultiThreaderBaseTest(int argc, char * argv[])
   bool result = true;
   TEST_SINGLE_CLASS(PlatformMultiThreader);
   TEST_SINGLE_CLASS(PoolMultiThreader);
+  TEST_SINGLE_CLASS(WorkStealingMultiThreader);
 #ifdef ITK_USE_TBB
   TEST_SINGLE_CLASS(TBBMultiThreader);
 #endif
@@ -141,6 +143,7 @@ itkMultiThreaderBaseTest(int argc, char * argv[])
     //            itk::MultiThreaderBaseEnums::Threader::First,
     itk::MultiThreaderBaseEnums::Threader::Pool,
     itk::MultiThreaderBaseEnums::Threader::TBB,
+    itk::MultiThreaderBaseEnums::Threader::WorkStealing,
     //            itk::MultiThreaderBaseEnums::Threader::Last,
     itk::MultiThreaderBaseEnums::Threader::Unknown
   };
@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMultiThreaderBase.h"
+#include "itkPlatformMultiThreader.h"
+#include "itkPoolMultiThreader.h"
+#include "itkWorkStealingMultiThreader.h"
+#ifdef ITK_USE_TBB
+#  include "itkTBBMultiThreader.h"
+#endif
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+#include <atomic>
+#include <cmath>
+
+// Nested parallelism: every index of an outer ParallelizeArray parallelizes
+// an image region with its own threader, the way a threaded metric calls a
+// threaded interpolator. The per-index cost is deliberately unbalanced.
+// The test verifies the result for each threader, and reports timings so the
+// scaling of the implementations can be compared (e.g. by running it with
+// different ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS values).
+
+namespace
+{
+constexpr itk::SizeValueType outerCount = 64;
+constexpr itk::SizeValueType regionSize = 48;
+
+double
+PixelCost(itk::SizeValueType outerIndex, itk::IndexValueType x, itk::IndexValueType y)
+{
+  double value = 0.0;
+  // Work per outer index varies between 1 and 8 iterations per pixel.
+  const unsigned int iterations = 1 + outerIndex % 8;
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    value += std::sqrt(static_cast<double>(x * y + i + 1));
+  }
+  return value;
+}
+
+template <typename TThreader>
+bool
+RunNested(const std::string & name, bool parallelInner, itk::TimeProbesCollectorBase & collector)
+{
+  using RegionType = itk::ImageRegion<2>;
+  RegionType region;
+  region.SetSize({ { regionSize, regionSize } });
+
+  std::vector<double> results(outerCount, 0.0);
+
+  collector.Start(name.c_str());
+  auto outer = TThreader::New();
+  outer->ParallelizeArray(
+    0,
+    outerCount,
+    [&results, &region, parallelInner](itk::SizeValueType outerIndex) {
+      itk::MultiThreaderBase::Pointer inner = TThreader::New();
+      if (!parallelInner)
+      {
+        inner->SetNumberOfWorkUnits(1);
+      }
+      std::atomic<long long> sum{ 0 };
+      inner->ParallelizeImageRegion<2>(
+        region,
+        [outerIndex, &sum](const RegionType & piece) {
+          double partial = 0.0;
+          for (itk::IndexValueType y = piece.GetIndex(1); y < piece.GetUpperIndex()[1] + 1; ++y)
+          {
+            for (itk::IndexValueType x = piece.GetIndex(0); x < piece.GetUpperIndex()[0] + 1; ++x)
+            {
+              partial += PixelCost(outerIndex, x, y);
+            }
+          }
+          sum += static_cast<long long>(partial);
+        },
+        nullptr);
+      results[outerIndex] = static_cast<double>(sum.load());
+    },
+    nullptr);
+  collector.Stop(name.c_str());
+
+  // Compare against a serial computation. Each piece truncates its partial
+  // sum, and the number of pieces depends on the threader, so allow for it.
+  bool success = true;
+  for (itk::SizeValueType outerIndex = 0; outerIndex < outerCount; ++outerIndex)
+  {
+    double expected = 0.0;
+    for (itk::SizeValueType y = 0; y < regionSize; ++y)
+    {
+      for (itk::SizeValueType x = 0; x < regionSize; ++x)
+      {
+        expected += PixelCost(outerIndex, x, y);
+      }
+    }
+    if (std::abs(results[outerIndex] - expected) > static_cast<double>(regionSize * regionSize))
+    {
+      std::cerr << name << ": wrong result for outer index " << outerIndex << ": " << results[outerIndex]
+                << " instead of " << expected << std::endl;
+      success = false;
+    }
+  }
+  return success;
+}
+} // namespace
+
+int
+itkMultiThreaderNestedParallelismTest(int, char *[])
+{
+  itk::TimeProbesCollectorBase collector;
+  bool                         success = true;
+
+  // PoolMultiThreader cannot wait on nested work without risking a deadlock
+  // once every pool thread waits for its children, so its inner level is
+  // serialized, as filters using it have to do.
+  success &= RunNested<itk::PoolMultiThreader>("Pool (serial inner)", false, collector);
+  success &= RunNested<itk::PlatformMultiThreader>("Platform", true, collector);
+#ifdef ITK_USE_TBB
+  success &= RunNested<itk::TBBMultiThreader>("TBB", true, collector);
+#endif
+  success &= RunNested<itk::WorkStealingMultiThreader>("WorkStealing (serial inner)", false, collector);
+  success &= RunNested<itk::WorkStealingMultiThreader>("WorkStealing", true, collector);
+
+  // Nested exceptions must propagate to the outermost caller.
+  auto threader = itk::WorkStealingMultiThreader::New();
+  ITK_TRY_EXPECT_EXCEPTION(threader->ParallelizeArray(
+    0,
+    outerCount,
+    [](itk::SizeValueType outerIndex) {
+      auto inner = itk::WorkStealingMultiThreader::New();
+      inner->ParallelizeArray(
+        0,
+        outerCount,
+        [outerIndex](itk::SizeValueType innerIndex) {
+          if (outerIndex == 3 && innerIndex == 5)
+          {
+            itkGenericExceptionMacro("Expected exception in nested work unit");
+          }
+        },
+        nullptr);
+    },
+    nullptr));
+
+  std::cout << "Number of threads: " << itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() << std::endl;
+  collector.Report(std::cout);
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -67,7 +67,7 @@ itkMultiThreaderTypeFromEnvironmentTest(int argc, char * argv[])
   success &= checkThreaderByName(expectedThreaderType);
 
   // check that developer's choice for default is respected
-  std::set<ThreaderEnum> threadersToTest = { ThreaderEnum::Platform, ThreaderEnum::Pool };
+  std::set<ThreaderEnum> threadersToTest = { ThreaderEnum::Platform, ThreaderEnum::Pool, ThreaderEnum::WorkStealing };
 #ifdef ITK_USE_TBB
   threadersToTest.insert(ThreaderEnum::TBB);
 #endif // ITK_USE_TBB
@@ -81,7 +81,7 @@ itkMultiThreaderTypeFromEnvironmentTest(int argc, char * argv[])
   // 1. insert it into threadersToTest set
   // 2. add tests to Modules/Core/Common/test/CMakeLists.txt similarly to tests for other multi-threaders
   // 3. rewrite the condition below to use whatever is really the last threader type
-  itkAssertOrThrowMacro(ThreaderEnum::TBB == ThreaderEnum::Last,
+  itkAssertOrThrowMacro(ThreaderEnum::WorkStealing == ThreaderEnum::Last,
                         "All multi-threader implementation have to be tested!");
 
   if (success)
@@ -0,0 +1,317 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkPipelineExecutor.h"
+
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageSource.h"
+#include "itkInPlaceImageFilter.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+// Counts the sources generating data at the same time.
+struct ConcurrencyCounter
+{
+  std::atomic<unsigned int> m_Current{ 0 };
+  std::atomic<unsigned int> m_Maximum{ 0 };
+};
+
+// Single-threaded source filling its output with a constant, slowly enough
+// for concurrent sources to overlap.
+class SlowConstantSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SlowConstantSource);
+
+  using Self = SlowConstantSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SlowConstantSource, ImageSource);
+
+  ConcurrencyCounter * m_Counter{ nullptr };
+  float                m_Value{ 0.0f };
+  bool                 m_Throw{ false };
+  unsigned int         m_NumberOfExecutions{ 0 };
+
+protected:
+  SlowConstantSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(itk::MakeSize(32, 24)));
+  }
+
+  void
+  GenerateData() override
+  {
+    ++m_NumberOfExecutions;
+    if (m_Throw)
+    {
+      itkExceptionMacro(<< "Failed on purpose.");
+    }
+    if (m_Counter)
+    {
+      const unsigned int current = ++m_Counter->m_Current;
+      unsigned int       maximum = m_Counter->m_Maximum;
+      while (current > maximum && !m_Counter->m_Maximum.compare_exchange_weak(maximum, current))
+      {
+      }
+    }
+
+    this->AllocateOutputs();
+    this->GetOutput()->FillBuffer(m_Value);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    if (m_Counter)
+    {
+      --m_Counter->m_Current;
+    }
+  }
+};
+
+
+// Filter adding a constant to its input, in place when InPlace is on.
+class AddConstantFilter : public itk::InPlaceImageFilter<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AddConstantFilter);
+
+  using Self = AddConstantFilter;
+  using Superclass = itk::InPlaceImageFilter<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(AddConstantFilter, InPlaceImageFilter);
+
+  float m_Constant{ 0.0f };
+
+protected:
+  AddConstantFilter() { this->DynamicMultiThreadingOn(); }
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    itk::ImageRegionConstIterator<ImageType> inputIt(this->GetInput(), region);
+    itk::ImageRegionIterator<ImageType>      outputIt(this->GetOutput(), region);
+    for (; !outputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    {
+      outputIt.Set(inputIt.Get() + m_Constant);
+    }
+  }
+};
+
+
+// Filter summing its indexed inputs.
+class SumImageFilter : public itk::ImageToImageFilter<ImageType, ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SumImageFilter);
+
+  using Self = SumImageFilter;
+  using Superclass = itk::ImageToImageFilter<ImageType, ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SumImageFilter, ImageToImageFilter);
+
+protected:
+  SumImageFilter() { this->DynamicMultiThreadingOn(); }
+
+  void
+  DynamicThreadedGenerateData(const ImageType::RegionType & region) override
+  {
+    itk::ImageRegionIterator<ImageType> outputIt(this->GetOutput(), region);
+    for (; !outputIt.IsAtEnd(); ++outputIt)
+    {
+      outputIt.Set(0.0f);
+    }
+    for (unsigned int i = 0; i < this->GetNumberOfIndexedInputs(); ++i)
+    {
+      itk::ImageRegionConstIterator<ImageType> inputIt(this->GetInput(i), region);
+      for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++inputIt, ++outputIt)
+      {
+        outputIt.Set(outputIt.Get() + inputIt.Get());
+      }
+    }
+  }
+};
+
+
+// Pipeline of three sources, with the values 1, 2 and 4, each followed by
+// an AddConstantFilter adding 10, 20 and 40, and summed together.
+struct BranchesPipeline
+{
+  BranchesPipeline()
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      m_Sources[i] = SlowConstantSource::New();
+      m_Sources[i]->m_Counter = &m_Counter;
+      m_Sources[i]->m_Value = static_cast<float>(1u << i);
+      m_AddFilters[i] = AddConstantFilter::New();
+      m_AddFilters[i]->SetInput(m_Sources[i]->GetOutput());
+      m_AddFilters[i]->InPlaceOff();
+      m_AddFilters[i]->m_Constant = 10.0f * static_cast<float>(1u << i);
+      m_SumFilter->SetInput(i, m_AddFilters[i]->GetOutput());
+    }
+  }
+
+  ConcurrencyCounter            m_Counter;
+  SlowConstantSource::Pointer   m_Sources[3];
+  AddConstantFilter::Pointer    m_AddFilters[3];
+  const SumImageFilter::Pointer m_SumFilter{ SumImageFilter::New() };
+};
+
+
+void
+ExpectConstantImage(const ImageType * image, float value)
+{
+  EXPECT_EQ(image->GetBufferedRegion(), ImageType::RegionType(itk::MakeSize(32, 24)));
+  for (itk::ImageRegionConstIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    ASSERT_EQ(it.Get(), value);
+  }
+}
+} // namespace
+
+
+TEST(PipelineExecutor, IndependentBranchesExecuteConcurrently)
+{
+  BranchesPipeline pipeline;
+  auto             executor = itk::PipelineExecutor::New();
+  executor->Update(pipeline.m_SumFilter);
+
+  ExpectConstantImage(pipeline.m_SumFilter->GetOutput(), 77.0f);
+  EXPECT_EQ(executor->GetNumberOfExecutedFilters(), 7u);
+  EXPECT_GE(pipeline.m_Counter.m_Maximum, 2u);
+  for (const auto & source : pipeline.m_Sources)
+  {
+    EXPECT_EQ(source->m_NumberOfExecutions, 1u);
+  }
+}
+
+
+TEST(PipelineExecutor, ExecutesOutOfDateFiltersOnly)
+{
+  BranchesPipeline pipeline;
+  auto             executor = itk::PipelineExecutor::New();
+  executor->Update(pipeline.m_SumFilter);
+
+  executor->Update(pipeline.m_SumFilter);
+  EXPECT_EQ(executor->GetNumberOfExecutedFilters(), 0u);
+
+  pipeline.m_Sources[1]->m_Value = 3.0f;
+  pipeline.m_Sources[1]->Modified();
+  executor->UpdateLargestPossibleRegion(pipeline.m_SumFilter);
+  EXPECT_EQ(executor->GetNumberOfExecutedFilters(), 3u);
+  EXPECT_EQ(pipeline.m_Sources[0]->m_NumberOfExecutions, 1u);
+  EXPECT_EQ(pipeline.m_Sources[1]->m_NumberOfExecutions, 2u);
+  ExpectConstantImage(pipeline.m_SumFilter->GetOutput(), 78.0f);
+}
+
+
+TEST(PipelineExecutor, SharedInputIsComputedOnce)
+{
+  auto source = SlowConstantSource::New();
+  source->m_Value = 1.0f;
+  auto                       sumFilter = SumImageFilter::New();
+  AddConstantFilter::Pointer addFilters[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    addFilters[i] = AddConstantFilter::New();
+    addFilters[i]->SetInput(source->GetOutput());
+    addFilters[i]->InPlaceOff();
+    addFilters[i]->m_Constant = 10.0f * static_cast<float>(i + 1);
+    sumFilter->SetInput(i, addFilters[i]->GetOutput());
+  }
+
+  auto executor = itk::PipelineExecutor::New();
+  executor->Update(sumFilter);
+
+  ExpectConstantImage(sumFilter->GetOutput(), 32.0f);
+  EXPECT_EQ(source->m_NumberOfExecutions, 1u);
+  EXPECT_EQ(executor->GetNumberOfExecutedFilters(), 4u);
+}
+
+
+TEST(PipelineExecutor, SharedInputConsumersRunInPlaceLikeSerialUpdate)
+{
+  // The first consumer takes the buffer of the shared input, and the second
+  // one executes the source again, as in the serial update.
+  auto source = SlowConstantSource::New();
+  source->m_Value = 1.0f;
+  auto                       sumFilter = SumImageFilter::New();
+  AddConstantFilter::Pointer addFilters[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    addFilters[i] = AddConstantFilter::New();
+    addFilters[i]->SetInput(source->GetOutput());
+    addFilters[i]->InPlaceOn();
+    addFilters[i]->m_Constant = 10.0f * static_cast<float>(i + 1);
+    sumFilter->SetInput(i, addFilters[i]->GetOutput());
+  }
+
+  auto executor = itk::PipelineExecutor::New();
+  executor->Update(sumFilter);
+
+  ExpectConstantImage(sumFilter->GetOutput(), 32.0f);
+  EXPECT_EQ(source->m_NumberOfExecutions, 2u);
+}
+
+
+TEST(PipelineExecutor, RethrowsException)
+{
+  BranchesPipeline pipeline;
+  pipeline.m_Sources[2]->m_Throw = true;
+
+  auto executor = itk::PipelineExecutor::New();
+  EXPECT_THROW(executor->Update(pipeline.m_SumFilter), itk::ExceptionObject);
+
+  // The pipeline is reset, and can be updated again.
+  pipeline.m_Sources[2]->m_Throw = false;
+  pipeline.m_Sources[2]->Modified();
+  executor->Update(pipeline.m_SumFilter);
+  ExpectConstantImage(pipeline.m_SumFilter->GetOutput(), 77.0f);
+}
+
+
+TEST(PipelineExecutor, UpdatesDataObjectWithoutSource)
+{
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(4, 4));
+  image->Allocate();
+
+  auto executor = itk::PipelineExecutor::New();
+  executor->Update(image);
+  EXPECT_EQ(executor->GetNumberOfExecutedFilters(), 0u);
+  EXPECT_THROW(executor->Update(static_cast<itk::DataObject *>(nullptr)), itk::ExceptionObject);
+}
@@ -0,0 +1,367 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkStreamingImageFilter.h"
+
+#include "itkImage.h"
+#include "itkImageAlgorithm.h"
+#include "itkImageRegionSplitterMultidimensional.h"
+#include "itkImageSource.h"
+#include "itkImageToImageFilter.h"
+#include "itkPipelineMemory.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+using ImageType = itk::Image<float, 2>;
+
+// Counts the sources generating data at the same time.
+struct ConcurrencyCounter
+{
+  std::atomic<unsigned int> m_Current{ 0 };
+  std::atomic<unsigned int> m_Maximum{ 0 };
+  std::atomic<unsigned int> m_NumberOfPieces{ 0 };
+};
+
+// Single-threaded image source giving index[0] + 1000 * index[1] to each
+// pixel, slowly enough for concurrent pieces to overlap.
+class IndexImageSource : public itk::ImageSource<ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(IndexImageSource);
+
+  using Self = IndexImageSource;
+  using Superclass = itk::ImageSource<ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(IndexImageSource, ImageSource);
+
+  ConcurrencyCounter * m_Counter{ nullptr };
+
+protected:
+  IndexImageSource() = default;
+
+  void
+  GenerateOutputInformation() override
+  {
+    this->GetOutput()->SetLargestPossibleRegion(ImageType::RegionType(itk::MakeSize(64, 40)));
+  }
+
+  void
+  GenerateData() override
+  {
+    const unsigned int current = ++m_Counter->m_Current;
+    unsigned int       maximum = m_Counter->m_Maximum;
+    while (current > maximum && !m_Counter->m_Maximum.compare_exchange_weak(maximum, current))
+    {
+    }
+    ++m_Counter->m_NumberOfPieces;
+
+    ImageType * output = this->GetOutput();
+    this->AllocateOutputs();
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(output, output->GetRequestedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(static_cast<float>(it.GetIndex()[0] + 1000 * it.GetIndex()[1]));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --m_Counter->m_Current;
+  }
+};
+
+
+// Filter copying its input, which requests its input padded along the slow
+// dimension, as a neighborhood filter would.
+class PaddingImageFilter : public itk::ImageToImageFilter<ImageType, ImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(PaddingImageFilter);
+
+  using Self = PaddingImageFilter;
+  using Superclass = itk::ImageToImageFilter<ImageType, ImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PaddingImageFilter, ImageToImageFilter);
+
+  itk::SizeValueType m_Radius{ 0 };
+
+protected:
+  PaddingImageFilter() = default;
+
+  void
+  GenerateInputRequestedRegion() override
+  {
+    auto                  input = const_cast<ImageType *>(this->GetInput());
+    ImageType::RegionType region = this->GetOutput()->GetRequestedRegion();
+    region.PadByRadius(itk::MakeSize(0, m_Radius));
+    region.Crop(input->GetLargestPossibleRegion());
+    input->SetRequestedRegion(region);
+  }
+
+  void
+  GenerateData() override
+  {
+    this->AllocateOutputs();
+    const ImageType::RegionType region = this->GetOutput()->GetRequestedRegion();
+    itk::ImageAlgorithm::Copy(this->GetInput(), this->GetOutput(), region, region);
+  }
+};
+
+
+using StreamingFilterType = itk::StreamingImageFilter<ImageType, ImageType>;
+
+// StreamingImageFilter streaming the pieces of an IndexImageSource, possibly
+// followed by a PaddingImageFilter, with a pipeline factory creating other
+// instances of this pipeline.
+struct StreamingPipeline
+{
+  StreamingPipeline(itk::SizeValueType paddingRadius = 0)
+  {
+    const auto makePipeline = [this, paddingRadius]() -> StreamingFilterType::PipelineInstance {
+      auto source = IndexImageSource::New();
+      source->m_Counter = &m_Counter;
+      if (paddingRadius == 0)
+      {
+        return { source->GetOutput(), { source } };
+      }
+      auto paddingFilter = PaddingImageFilter::New();
+      paddingFilter->SetInput(source->GetOutput());
+      paddingFilter->m_Radius = paddingRadius;
+      return { paddingFilter->GetOutput(), { source, paddingFilter } };
+    };
+
+    m_Pipeline = makePipeline();
+    m_Filter->SetInput(m_Pipeline.Output);
+    m_Filter->SetPipelineFactory(makePipeline);
+    m_Filter->SetNumberOfStreamDivisions(8);
+  }
+
+  ConcurrencyCounter                    m_Counter;
+  StreamingFilterType::PipelineInstance m_Pipeline;
+  const StreamingFilterType::Pointer    m_Filter{ StreamingFilterType::New() };
+};
+
+
+void
+ExpectIndexImage(const ImageType * image)
+{
+  EXPECT_EQ(image->GetBufferedRegion(), ImageType::RegionType(itk::MakeSize(64, 40)));
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    ASSERT_EQ(it.Get(), static_cast<float>(it.GetIndex()[0] + 1000 * it.GetIndex()[1]));
+  }
+}
+} // namespace
+
+
+TEST(StreamingImageFilter, SerialByDefault)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+  auto &            counter = pipeline.m_Counter;
+  EXPECT_EQ(filter->GetNumberOfConcurrentPieces(), 1u);
+  EXPECT_EQ(filter->GetMemoryBudget(), 0u);
+
+  filter->Update();
+
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_NumberOfPieces, 8u);
+  EXPECT_EQ(counter.m_Maximum, 1u);
+}
+
+
+TEST(StreamingImageFilter, ConcurrentPieces)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+  auto &            counter = pipeline.m_Counter;
+  filter->SetNumberOfConcurrentPieces(4);
+
+  filter->Update();
+
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_NumberOfPieces, 8u);
+  EXPECT_GT(counter.m_Maximum, 1u);
+  EXPECT_LE(counter.m_Maximum, 4u);
+}
+
+
+TEST(StreamingImageFilter, ConcurrentPiecesWithinMemoryBudget)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+  auto &            counter = pipeline.m_Counter;
+  filter->SetNumberOfConcurrentPieces(4);
+
+  // Each of the 8 pieces has 64x5 float pixels: the budget fits two of them.
+  filter->SetMemoryBudget(2 * 64 * 5 * sizeof(float) + 1);
+
+  filter->Update();
+
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_NumberOfPieces, 8u);
+  EXPECT_LE(counter.m_Maximum, 2u);
+
+  // A budget smaller than a piece still processes one piece at a time.
+  counter.m_Maximum = 0;
+  filter->SetMemoryBudget(1);
+  filter->Update();
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_Maximum, 1u);
+}
+
+
+TEST(StreamingImageFilter, NoConcurrencyWithoutPipelineFactory)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+  auto &            counter = pipeline.m_Counter;
+  filter->SetNumberOfConcurrentPieces(4);
+  filter->SetPipelineFactory(nullptr);
+
+  filter->Update();
+
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_Maximum, 1u);
+}
+
+
+TEST(StreamingImageFilter, ConcurrentPiecesRethrowException)
+{
+  auto filter = StreamingFilterType::New();
+  auto source = IndexImageSource::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetNumberOfStreamDivisions(8);
+  filter->SetNumberOfConcurrentPieces(2);
+  filter->SetPipelineFactory([]() { return StreamingFilterType::PipelineInstance{}; });
+
+  EXPECT_THROW(filter->Update(), itk::ExceptionObject);
+}
+
+
+TEST(StreamingImageFilter, EstimatePipelineMemory)
+{
+  auto source = IndexImageSource::New();
+  auto paddingFilter = PaddingImageFilter::New();
+  paddingFilter->SetInput(source->GetOutput());
+  paddingFilter->m_Radius = 3;
+  paddingFilter->UpdateOutputInformation();
+
+  // The output region plus the input region, padded by 3 rows on each side.
+  const ImageType::RegionType region(itk::MakeIndex(0, 10), itk::MakeSize(64, 5));
+  EXPECT_EQ(itk::PipelineMemory::EstimateMemorySize(paddingFilter->GetOutput(), region),
+            (64 * 5 + 64 * 11) * sizeof(float));
+  EXPECT_EQ(source->GetOutput()->GetRequestedRegion(),
+            ImageType::RegionType(itk::MakeIndex(0, 7), itk::MakeSize(64, 11)));
+
+  // At the border of the image, the padding is cropped.
+  const ImageType::RegionType borderRegion(itk::MakeIndex(0, 0), itk::MakeSize(64, 5));
+  EXPECT_EQ(itk::PipelineMemory::EstimateMemorySize(paddingFilter->GetOutput(), borderRegion),
+            (64 * 5 + 64 * 8) * sizeof(float));
+
+  // Images without source, already in memory, are not counted.
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(8, 8));
+  image->Allocate();
+  EXPECT_EQ(itk::PipelineMemory::EstimateRequestedRegionMemorySize(image), 0u);
+  EXPECT_EQ(image->GetRequestedRegionMemorySize(), 64 * sizeof(float));
+}
+
+
+TEST(StreamingImageFilter, PredictPeakMemory)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+
+  // The output image, plus one piece of 64x5 pixels.
+  constexpr itk::SizeValueType outputMemorySize = 64 * 40 * sizeof(float);
+  constexpr itk::SizeValueType pieceMemorySize = 64 * 5 * sizeof(float);
+  EXPECT_EQ(filter->PredictNumberOfStreamDivisions(), 8u);
+  EXPECT_EQ(filter->PredictPeakMemorySize(), outputMemorySize + pieceMemorySize);
+
+  filter->SetNumberOfConcurrentPieces(3);
+  EXPECT_EQ(filter->PredictPeakMemorySize(), outputMemorySize + 3 * pieceMemorySize);
+  filter->SetMemoryBudget(2 * pieceMemorySize);
+  EXPECT_EQ(filter->PredictPeakMemorySize(), outputMemorySize + 2 * pieceMemorySize);
+}
+
+
+TEST(StreamingImageFilter, AutomaticStreamDivisions)
+{
+  StreamingPipeline pipeline;
+  auto &            filter = pipeline.m_Filter;
+  auto &            counter = pipeline.m_Counter;
+  filter->AutomaticStreamDivisionsOn();
+
+  // Without a memory budget, NumberOfStreamDivisions is used.
+  EXPECT_EQ(filter->PredictNumberOfStreamDivisions(), 8u);
+
+  // Pieces of at most 64x10 pixels.
+  filter->SetMemoryBudget(64 * 10 * sizeof(float));
+  EXPECT_EQ(filter->PredictNumberOfStreamDivisions(), 4u);
+  EXPECT_LE(filter->PredictPeakMemorySize(), 64 * 40 * sizeof(float) + filter->GetMemoryBudget());
+
+  filter->Update();
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_NumberOfPieces, 4u);
+
+  // The budget is shared by the concurrent pieces.
+  filter->SetNumberOfConcurrentPieces(2);
+  EXPECT_EQ(filter->PredictNumberOfStreamDivisions(), 8u);
+  counter.m_NumberOfPieces = 0;
+  filter->Update();
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(counter.m_NumberOfPieces, 8u);
+}
+
+
+TEST(StreamingImageFilter, AutomaticStreamDivisionsShapePieces)
+{
+  // The slabs of the slow dimension splitter are padded by 8 rows on each
+  // side: 6 slabs are needed to fit in the budget, and fewer blocks.
+  StreamingPipeline pipeline(8);
+  auto &            filter = pipeline.m_Filter;
+  filter->AutomaticStreamDivisionsOn();
+  filter->SetMemoryBudget(2000 * sizeof(float));
+
+  constexpr itk::SizeValueType outputMemorySize = 64 * 40 * sizeof(float);
+  const unsigned int           numberOfDivisions = filter->PredictNumberOfStreamDivisions();
+  EXPECT_LT(numberOfDivisions, 6u);
+  EXPECT_LE(filter->PredictPeakMemorySize(), outputMemorySize + filter->GetMemoryBudget());
+
+  filter->AutomaticStreamDivisionsOff();
+  filter->SetNumberOfStreamDivisions(numberOfDivisions);
+  EXPECT_GT(filter->PredictPeakMemorySize(), outputMemorySize + filter->GetMemoryBudget());
+  filter->SetNumberOfStreamDivisions(6);
+  EXPECT_LE(filter->PredictPeakMemorySize(), outputMemorySize + filter->GetMemoryBudget());
+
+  filter->AutomaticStreamDivisionsOn();
+  filter->Update();
+  ExpectIndexImage(filter->GetOutput());
+  EXPECT_EQ(pipeline.m_Counter.m_NumberOfPieces, numberOfDivisions);
+}
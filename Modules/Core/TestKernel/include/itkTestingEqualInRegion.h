@@ -0,0 +1,53 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTestingEqualInRegion_h
+#define itkTestingEqualInRegion_h
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <iostream>
+
+namespace itk
+{
+namespace Testing
+{
+/** Returns whether the pixels of image in region are equal to the pixels of
+ * expected at the same indices. The first pixel which is not is reported on
+ * std::cerr. Unlike ComparisonImageFilter, the pixels may be vectors, and
+ * the images may have different buffered regions, both including region.
+ *
+ * \ingroup ITKTestKernel
+ */
+template <typename TImage>
+bool
+EqualInRegion(const TImage * expected, const TImage * image, const typename TImage::RegionType & region)
+{
+  for (ImageRegionConstIteratorWithIndex<TImage> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != expected->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " is " << it.Get() << " instead of "
+                << expected->GetPixel(it.GetIndex()) << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // end namespace Testing
+} // end namespace itk
+
+#endif
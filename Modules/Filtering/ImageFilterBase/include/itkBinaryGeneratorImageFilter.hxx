@@ -18,6 +18,7 @@
 #ifndef itkBinaryGeneratorImageFilter_hxx
 #define itkBinaryGeneratorImageFilter_hxx
 
+#include "itkGeneratorImageFilterDetail.h"
 #include "itkImageScanlineIterator.h"
 #include "itkTotalProgressReporter.h"
 
@@ -32,6 +33,8 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::BinaryGene
   this->InPlaceOff();
   this->DynamicMultiThreadingOn();
   this->ThreaderUpdateProgressOff();
+  // Point-wise functors take in the order of a nanosecond per pixel.
+  this->SetPixelCostHint(1.0);
 }
 
 template <typename TInputImage1, typename TInputImage2, typename TOutputImage>
@@ -186,7 +189,71 @@ BinaryGeneratorImageFilter<TInputImage1, TInputImage2, TOutputImage>::DynamicThr
 
   TotalProgressReporter progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
 
-  if (inputPtr1 && inputPtr2)
+  if constexpr (GeneratorImageFilterDetail::IsContiguousImage<TInputImage1> &&
+                GeneratorImageFilterDetail::IsContiguousImage<TInputImage2> &&
+                GeneratorImageFilterDetail::IsContiguousImage<TOutputImage>)
+  {
+    // The scanlines are processed as arrays of pixels.
+    const SizeValueType                 lineLength = outputRegionForThread.GetSize()[0];
+    ImageScanlineIterator<TOutputImage> outputIt(outputPtr, outputRegionForThread);
+
+    if (inputPtr1 && inputPtr2)
+    {
+      ImageScanlineConstIterator<TInputImage1> inputIt1(inputPtr1, outputRegionForThread);
+      ImageScanlineConstIterator<TInputImage2> inputIt2(inputPtr2, outputRegionForThread);
+
+      while (!outputIt.IsAtEnd())
+      {
+        GeneratorImageFilterDetail::ApplyToScanline(
+          functor, &outputIt.Value(), lineLength, &inputIt1.Value(), &inputIt2.Value());
+        inputIt1.NextLine();
+        inputIt2.NextLine();
+        outputIt.NextLine();
+        progress.Completed(lineLength);
+      }
+      return;
+    }
+    if (inputPtr1)
+    {
+      ImageScanlineConstIterator<TInputImage1> inputIt1(inputPtr1, outputRegionForThread);
+      const Input2ImagePixelType               input2Value = this->GetConstant2();
+
+      while (!outputIt.IsAtEnd())
+      {
+        const Input1ImagePixelType * const input1 = &inputIt1.Value();
+        OutputImagePixelType * const       output = &outputIt.Value();
+        for (SizeValueType i = 0; i < lineLength; ++i)
+        {
+          output[i] = functor(input1[i], input2Value);
+        }
+        inputIt1.NextLine();
+        outputIt.NextLine();
+        progress.Completed(lineLength);
+      }
+      return;
+    }
+    if (inputPtr2)
+    {
+      ImageScanlineConstIterator<TInputImage2> inputIt2(inputPtr2, outputRegionForThread);
+      const Input1ImagePixelType               input1Value = this->GetConstant1();
+
+      while (!outputIt.IsAtEnd())
+      {
+        const Input2ImagePixelType * const input2 = &inputIt2.Value();
+        OutputImagePixelType * const       output = &outputIt.Value();
+        for (SizeValueType i = 0; i < lineLength; ++i)
+        {
+          output[i] = functor(input1Value, input2[i]);
+        }
+        inputIt2.NextLine();
+        outputIt.NextLine();
+        progress.Completed(lineLength);
+      }
+      return;
+    }
+    itkGenericExceptionMacro(<< "At most one of the inputs can be a constant.");
+  }
+  else if (inputPtr1 && inputPtr2)
   {
     ImageScanlineConstIterator<TInputImage1> inputIt1(inputPtr1, outputRegionForThread);
     ImageScanlineConstIterator<TInputImage2> inputIt2(inputPtr2, outputRegionForThread);
@@ -0,0 +1,89 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkGeneratorImageFilterDetail_h
+#define itkGeneratorImageFilterDetail_h
+
+#include "itkImage.h"
+#include <type_traits>
+#include <utility>
+
+namespace itk
+{
+/** GeneratorImageFilterDetail namespace to house the scanline kernels shared
+ * by UnaryGeneratorImageFilter, BinaryGeneratorImageFilter and
+ * TernaryGeneratorImageFilter.
+ *
+ * When the images are plain itk::Image, each scanline of a region is a
+ * contiguous array of pixels in the buffer. The filters then evaluate the
+ * functor over raw pointers, in loops the compiler can vectorize, instead of
+ * going through the Get/Set accessors of the iterators.
+ *
+ * A functor may also process a whole scanline itself, with SIMD instructions
+ * for instance, by providing a const member function
+ * \code
+ *   void ApplySpan(const TInput1 * input1, ..., TOutput * output, SizeValueType length) const;
+ * \endcode
+ * which must give the same results as operator() applied to each pixel. As
+ * the filters may run in place, output may be the same array as an input.
+ */
+namespace GeneratorImageFilterDetail
+{
+/** True for the images whose scanlines are contiguous arrays of pixels:
+ * itk::Image, but neither image adaptors nor VectorImage. */
+template <typename TImage>
+constexpr bool IsContiguousImage = std::is_same_v<TImage, Image<typename TImage::PixelType, TImage::ImageDimension>>;
+
+template <typename TVoid, typename TFunctor, typename... TArguments>
+struct HasApplySpanImpl : std::false_type
+{};
+
+template <typename TFunctor, typename... TArguments>
+struct HasApplySpanImpl<std::void_t<decltype(std::declval<const TFunctor &>().ApplySpan(std::declval<TArguments>()...))>,
+                        TFunctor,
+                        TArguments...> : std::true_type
+{};
+
+/** True when the functor provides ApplySpan for these arguments. */
+template <typename TFunctor, typename... TArguments>
+constexpr bool HasApplySpan = HasApplySpanImpl<void, TFunctor, TArguments...>::value;
+
+/** Evaluates the functor on a scanline of length pixels, with ApplySpan when
+ * the functor provides it, or pixel by pixel otherwise. */
+template <typename TFunctor, typename TOutputPixel, typename... TInputPixels>
+inline void
+ApplyToScanline(const TFunctor &        functor,
+                TOutputPixel *          output,
+                const SizeValueType     length,
+                const TInputPixels *... inputs)
+{
+  if constexpr (HasApplySpan<TFunctor, const TInputPixels *..., TOutputPixel *, SizeValueType>)
+  {
+    functor.ApplySpan(inputs..., output, length);
+  }
+  else
+  {
+    for (SizeValueType i = 0; i < length; ++i)
+    {
+      output[i] = functor(inputs[i]...);
+    }
+  }
+}
+} // namespace GeneratorImageFilterDetail
+} // end namespace itk
+
+#endif
@@ -211,6 +211,11 @@ public:
    * must be concurrent thread-safe. The functor must have an
    * operator() method which accepts arguments of Input1ImagePixelType,
    * Input2ImagePixelType, and Input3ImagePixelType.
+   *
+   * When the images are itk::Image, the functor is evaluated over
+   * each scanline as an array of pixels. The functor may then process
+   * the whole scanline itself, by providing an ApplySpan method, as
+   * described in GeneratorImageFilterDetail.
    */
   template <typename TFunctor>
   void
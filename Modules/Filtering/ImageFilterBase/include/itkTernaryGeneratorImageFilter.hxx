@@ -18,6 +18,7 @@
 #ifndef itkTernaryGeneratorImageFilter_hxx
 #define itkTernaryGeneratorImageFilter_hxx
 
+#include "itkGeneratorImageFilterDetail.h"
 #include "itkImageScanlineIterator.h"
 #include "itkTotalProgressReporter.h"
 
@@ -30,6 +31,8 @@ TernaryGeneratorImageFilter<TInputImage1, TInputImage2, TInputImage3, TOutputIma
   this->InPlaceOff();
   this->DynamicMultiThreadingOn();
   this->ThreaderUpdateProgressOff();
+  // Point-wise functors take in the order of a nanosecond per pixel.
+  this->SetPixelCostHint(1.0);
 }
 
 template <typename TInputImage1, typename TInputImage2, typename TInputImage3, typename TOutputImage>
@@ -265,21 +268,42 @@ TernaryGeneratorImageFilter<TInputImage1, TInputImage2, TInputImage3, TOutputIma
     inputIt2 = std::make_unique<ImageScanlineConstIterator<TInputImage2>>(inputPtr2, outputRegionForThread);
     inputIt3 = std::make_unique<ImageScanlineConstIterator<TInputImage3>>(inputPtr3, outputRegionForThread);
 
-    while (!outputIt.IsAtEnd())
+    if constexpr (GeneratorImageFilterDetail::IsContiguousImage<TInputImage1> &&
+                  GeneratorImageFilterDetail::IsContiguousImage<TInputImage2> &&
+                  GeneratorImageFilterDetail::IsContiguousImage<TInputImage3> &&
+                  GeneratorImageFilterDetail::IsContiguousImage<TOutputImage>)
     {
-      while (!outputIt.IsAtEndOfLine())
+      // The scanlines are processed as arrays of pixels.
+      const SizeValueType lineLength = outputRegionForThread.GetSize()[0];
+      while (!outputIt.IsAtEnd())
       {
-        outputIt.Set(functor(inputIt1->Get(), inputIt2->Get(), inputIt3->Get()));
-        ++*inputIt1;
-        ++*inputIt2;
-        ++*inputIt3;
-        ++outputIt;
+        GeneratorImageFilterDetail::ApplyToScanline(
+          functor, &outputIt.Value(), lineLength, &inputIt1->Value(), &inputIt2->Value(), &inputIt3->Value());
+        inputIt1->NextLine();
+        inputIt2->NextLine();
+        inputIt3->NextLine();
+        outputIt.NextLine();
+        progress.Completed(lineLength);
+      }
+    }
+    else
+    {
+      while (!outputIt.IsAtEnd())
+      {
+        while (!outputIt.IsAtEndOfLine())
+        {
+          outputIt.Set(functor(inputIt1->Get(), inputIt2->Get(), inputIt3->Get()));
+          ++*inputIt1;
+          ++*inputIt2;
+          ++*inputIt3;
+          ++outputIt;
+        }
+        inputIt1->NextLine();
+        inputIt2->NextLine();
+        inputIt3->NextLine();
+        outputIt.NextLine();
+        progress.Completed(outputRegionForThread.GetSize()[0]);
       }
-      inputIt1->NextLine();
-      inputIt2->NextLine();
-      inputIt3->NextLine();
-      outputIt.NextLine();
-      progress.Completed(outputRegionForThread.GetSize()[0]);
     }
   }
   else
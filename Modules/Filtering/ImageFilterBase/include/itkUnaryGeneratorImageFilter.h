@@ -138,6 +138,11 @@ public:
    * the argument is created an used for all threads, so the functor
    * must be concurrent thread-safe. The functor must a have an
    * operator() method which accept arguments of InputImagePixelType.
+   *
+   * When the images are itk::Image, the functor is evaluated over
+   * each scanline as an array of pixels. The functor may then process
+   * the whole scanline itself, by providing an ApplySpan method, as
+   * described in GeneratorImageFilterDetail.
    */
   template <typename TFunctor>
   void
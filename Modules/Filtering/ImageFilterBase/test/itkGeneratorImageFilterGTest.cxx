@@ -21,8 +21,11 @@
 #include "itkTernaryGeneratorImageFilter.h"
 #include "itkImage.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTimeProbe.h"
 
 #include "itkGTest.h"
+#include <atomic>
 
 
 namespace
@@ -92,6 +95,132 @@ struct Utilities
 };
 
 
+// Functor which processes whole scanlines, counting the pixels it processes
+// that way.
+struct SpanFunctor
+{
+  std::atomic<itk::SizeValueType> * m_NumberOfSpanPixels;
+
+  float
+  operator()(const float & p) const
+  {
+    return 2 * p + 1;
+  }
+
+  float
+  operator()(const float & p1, const float & p2) const
+  {
+    return p1 - p2;
+  }
+
+  float
+  operator()(const float & p1, const float & p2, const float & p3) const
+  {
+    return p1 * p2 + p3;
+  }
+
+  void
+  ApplySpan(const float * input, float * output, itk::SizeValueType length) const
+  {
+    for (itk::SizeValueType i = 0; i < length; ++i)
+    {
+      output[i] = (*this)(input[i]);
+    }
+    *m_NumberOfSpanPixels += length;
+  }
+
+  void
+  ApplySpan(const float * input1, const float * input2, float * output, itk::SizeValueType length) const
+  {
+    for (itk::SizeValueType i = 0; i < length; ++i)
+    {
+      output[i] = (*this)(input1[i], input2[i]);
+    }
+    *m_NumberOfSpanPixels += length;
+  }
+
+  void
+  ApplySpan(const float * input1,
+            const float * input2,
+            const float * input3,
+            float *       output,
+            itk::SizeValueType length) const
+  {
+    for (itk::SizeValueType i = 0; i < length; ++i)
+    {
+      output[i] = (*this)(input1[i], input2[i], input3[i]);
+    }
+    *m_NumberOfSpanPixels += length;
+  }
+};
+
+
+template <typename TImage>
+typename TImage::Pointer
+CreateRampImage(const typename TImage::SizeType & size, double scale)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  double value = 0.0;
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>(value));
+    value = value < 1000.0 ? value + scale : 0.0;
+  }
+  return image;
+}
+
+
+// Checks the pixels of the requested region of the output against the functor
+// applied to the pixels of the inputs.
+template <typename TImage, typename TExpected>
+void
+ExpectRequestedRegionEquals(const TImage * output, const TExpected & expected)
+{
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(output, output->GetRequestedRegion()); !it.IsAtEnd(); ++it)
+  {
+    ASSERT_EQ(it.Get(), expected(it.GetIndex()));
+  }
+}
+
+
+// Reports the time taken to process a volume by a binary filter adding two
+// images, and by a unary filter scaling one.
+template <typename TPixel>
+void
+ReportGeneratorTime(const char * pixelName)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  const auto image1 = CreateRampImage<ImageType>(itk::MakeSize(256, 256, 128), 1.0);
+  const auto image2 = CreateRampImage<ImageType>(itk::MakeSize(256, 256, 128), 3.0);
+
+  auto binaryFilter = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>::New();
+  binaryFilter->SetInput1(image1);
+  binaryFilter->SetInput2(image2);
+  binaryFilter->SetFunctor([](const TPixel & p1, const TPixel & p2) { return static_cast<TPixel>(p1 + p2); });
+
+  auto unaryFilter = itk::UnaryGeneratorImageFilter<ImageType, ImageType>::New();
+  unaryFilter->SetInput(image1);
+  unaryFilter->SetFunctor([](const TPixel & p) { return static_cast<TPixel>(3 * p); });
+
+  itk::TimeProbe binaryProbe;
+  itk::TimeProbe unaryProbe;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    binaryFilter->Modified();
+    binaryProbe.Start();
+    binaryFilter->Update();
+    binaryProbe.Stop();
+
+    unaryFilter->Modified();
+    unaryProbe.Start();
+    unaryFilter->Update();
+    unaryProbe.Stop();
+  }
+  std::cout << "256x256x128 " << pixelName << " volume, binary addition: " << binaryProbe.GetMean() * 1000
+            << " ms, unary scaling: " << unaryProbe.GetMean() * 1000 << " ms" << std::endl;
+}
 } // namespace
 
 
@@ -444,3 +573,117 @@ TEST(TernaryGeneratorImageFilter, Constants)
 
   EXPECT_NEAR(103.0, outputImage->GetPixel(idx), 1e-8);
 }
+
+
+TEST(UnaryGeneratorImageFilter, ApplySpanOverRequestedRegion)
+{
+  using ImageType = itk::Image<float, 3>;
+  const auto image = CreateRampImage<ImageType>(itk::MakeSize(37, 11, 5), 0.5);
+
+  std::atomic<itk::SizeValueType> numberOfSpanPixels{ 0 };
+  const SpanFunctor               functor{ &numberOfSpanPixels };
+
+  auto filter = itk::UnaryGeneratorImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(image);
+  filter->SetFunctor(functor);
+
+  const ImageType::RegionType requestedRegion(itk::MakeIndex(3, 2, 1), itk::MakeSize(29, 7, 3));
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  EXPECT_NO_THROW(filter->Update());
+
+  ExpectRequestedRegionEquals(filter->GetOutput(),
+                              [&](const ImageType::IndexType & index) { return functor(image->GetPixel(index)); });
+  EXPECT_EQ(numberOfSpanPixels, requestedRegion.GetNumberOfPixels());
+}
+
+
+TEST(UnaryGeneratorImageFilter, ApplySpanInPlace)
+{
+  using ImageType = itk::Image<float, 2>;
+  const auto image = CreateRampImage<ImageType>(itk::MakeSize(45, 13), 0.25);
+  const auto expected = CreateRampImage<ImageType>(itk::MakeSize(45, 13), 0.25);
+
+  std::atomic<itk::SizeValueType> numberOfSpanPixels{ 0 };
+  const SpanFunctor               functor{ &numberOfSpanPixels };
+
+  auto filter = itk::UnaryGeneratorImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(image);
+  filter->SetFunctor(functor);
+  filter->InPlaceOn();
+  const float * const inputBuffer = image->GetBufferPointer();
+  EXPECT_NO_THROW(filter->Update());
+
+  EXPECT_EQ(filter->GetOutput()->GetBufferPointer(), inputBuffer);
+  ExpectRequestedRegionEquals(filter->GetOutput(),
+                              [&](const ImageType::IndexType & index) { return functor(expected->GetPixel(index)); });
+}
+
+
+TEST(BinaryGeneratorImageFilter, ApplySpanAndConstants)
+{
+  using ImageType = itk::Image<float, 3>;
+  const auto image1 = CreateRampImage<ImageType>(itk::MakeSize(19, 6, 4), 1.5);
+  const auto image2 = CreateRampImage<ImageType>(itk::MakeSize(19, 6, 4), 0.75);
+
+  std::atomic<itk::SizeValueType> numberOfSpanPixels{ 0 };
+  const SpanFunctor               functor{ &numberOfSpanPixels };
+
+  auto filter = itk::BinaryGeneratorImageFilter<ImageType, ImageType, ImageType>::New();
+  filter->SetInput1(image1);
+  filter->SetInput2(image2);
+  filter->SetFunctor(functor);
+
+  const ImageType::RegionType requestedRegion(itk::MakeIndex(1, 1, 0), itk::MakeSize(17, 5, 4));
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  EXPECT_NO_THROW(filter->Update());
+
+  ExpectRequestedRegionEquals(filter->GetOutput(), [&](const ImageType::IndexType & index) {
+    return functor(image1->GetPixel(index), image2->GetPixel(index));
+  });
+  EXPECT_EQ(numberOfSpanPixels, requestedRegion.GetNumberOfPixels());
+
+  // The constants are processed pixel by pixel.
+  filter->SetConstant2(4.0f);
+  EXPECT_NO_THROW(filter->Update());
+  ExpectRequestedRegionEquals(filter->GetOutput(),
+                              [&](const ImageType::IndexType & index) { return functor(image1->GetPixel(index), 4.0f); });
+
+  filter->SetConstant1(-2.0f);
+  filter->SetInput2(image2);
+  EXPECT_NO_THROW(filter->Update());
+  ExpectRequestedRegionEquals(filter->GetOutput(), [&](const ImageType::IndexType & index) {
+    return functor(-2.0f, image2->GetPixel(index));
+  });
+  EXPECT_EQ(numberOfSpanPixels, requestedRegion.GetNumberOfPixels());
+}
+
+
+TEST(TernaryGeneratorImageFilter, ApplySpan)
+{
+  using ImageType = itk::Image<float, 2>;
+  const auto image1 = CreateRampImage<ImageType>(itk::MakeSize(23, 9), 1.0);
+  const auto image2 = CreateRampImage<ImageType>(itk::MakeSize(23, 9), 0.5);
+  const auto image3 = CreateRampImage<ImageType>(itk::MakeSize(23, 9), 2.0);
+
+  std::atomic<itk::SizeValueType> numberOfSpanPixels{ 0 };
+  const SpanFunctor               functor{ &numberOfSpanPixels };
+
+  auto filter = itk::TernaryGeneratorImageFilter<ImageType, ImageType, ImageType, ImageType>::New();
+  filter->SetInput1(image1);
+  filter->SetInput2(image2);
+  filter->SetInput3(image3);
+  filter->SetFunctor(functor);
+  EXPECT_NO_THROW(filter->Update());
+
+  ExpectRequestedRegionEquals(filter->GetOutput(), [&](const ImageType::IndexType & index) {
+    return functor(image1->GetPixel(index), image2->GetPixel(index), image3->GetPixel(index));
+  });
+  EXPECT_EQ(numberOfSpanPixels, image1->GetLargestPossibleRegion().GetNumberOfPixels());
+}
+
+
+TEST(GeneratorImageFilter, ReportTime)
+{
+  ReportGeneratorTime<float>("float");
+  ReportGeneratorTime<unsigned short>("unsigned short");
+}
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferAllocationPolicy.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkResampleImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingMacros.h"
+#include <algorithm>
+
+// Compares ResampleImageFilter and DiscreteGaussianImageFilter with image
+// buffers allocated by new[] and by the other allocation policies. Every
+// output image is allocated with the global default policy.
+// Usage: itkImageBufferAllocationPolicyBenchmark [size [iterations]]
+// e.g. a size of 512 gives 512 MB outputs, which benefit from huge pages.
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+ImageType::Pointer
+MakeInput(itk::SizeValueType size)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(size));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>((index[0] * 7 + index[1] * 3 + index[2]) % 255));
+  }
+  return image;
+}
+
+ImageType::Pointer
+RunFilters(const ImageType *              input,
+           const std::string &            name,
+           unsigned int                   iterations,
+           itk::TimeProbesCollectorBase & collector)
+{
+  ImageType::Pointer smoothed;
+  ImageType::Pointer resampled;
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    auto gaussian = itk::DiscreteGaussianImageFilter<ImageType, ImageType>::New();
+    gaussian->SetInput(input);
+    gaussian->SetVariance(2.0);
+    collector.Start((name + " DiscreteGaussian").c_str());
+    gaussian->Update();
+    collector.Stop((name + " DiscreteGaussian").c_str());
+    smoothed = gaussian->GetOutput();
+
+    // Upsample by 1.5 in each direction: a larger output than input.
+    auto                   resample = itk::ResampleImageFilter<ImageType, ImageType>::New();
+    ImageType::SpacingType spacing;
+    spacing.Fill(1.0 / 1.5);
+    resample->SetInput(smoothed);
+    resample->SetOutputSpacing(spacing);
+    resample->SetSize(ImageType::SizeType::Filled(input->GetBufferedRegion().GetSize(0) * 3 / 2));
+    collector.Start((name + " Resample").c_str());
+    resample->Update();
+    collector.Stop((name + " Resample").c_str());
+    resampled = resample->GetOutput();
+  }
+  return resampled;
+}
+} // namespace
+
+int
+itkImageBufferAllocationPolicyBenchmark(int argc, char * argv[])
+{
+  const itk::SizeValueType size = argc > 1 ? std::stoul(argv[1]) : 64;
+  const unsigned int       iterations = argc > 2 ? std::stoul(argv[2]) : 1;
+
+  const itk::ImageBufferAllocationPolicy originalPolicy = itk::ImageBufferAllocationPolicy::GetGlobalDefault();
+
+  std::vector<std::pair<std::string, itk::ImageBufferAllocationPolicy>> policies;
+  policies.emplace_back("new[]", itk::ImageBufferAllocationPolicy());
+  itk::ImageBufferAllocationPolicy aligned;
+  aligned.SetAlignment(64);
+  policies.emplace_back("Aligned", aligned);
+  policies.emplace_back("AlignedHugePages", itk::ImageBufferAllocationPolicy::AlignedHugePages());
+  itk::ImageBufferAllocationPolicy firstTouch = itk::ImageBufferAllocationPolicy::AlignedHugePages();
+  firstTouch.SetParallelFirstTouch(true);
+  policies.emplace_back("AlignedHugePagesFirstTouch", firstTouch);
+
+  itk::TimeProbesCollectorBase collector;
+  ImageType::Pointer           reference;
+  bool                         success = true;
+  for (const auto & policy : policies)
+  {
+    itk::ImageBufferAllocationPolicy::SetGlobalDefault(policy.second);
+    const ImageType::Pointer input = MakeInput(size);
+    const ImageType::Pointer output = RunFilters(input, policy.first, iterations, collector);
+
+    // The allocation policy must not change the results.
+    if (reference.IsNull())
+    {
+      reference = output;
+    }
+    else if (!std::equal(reference->GetBufferPointer(),
+                         reference->GetBufferPointer() + reference->GetBufferedRegion().GetNumberOfPixels(),
+                         output->GetBufferPointer()))
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Different results with the " << policy.first << " allocation policy." << std::endl;
+      success = false;
+    }
+  }
+  itk::ImageBufferAllocationPolicy::SetGlobalDefault(originalPolicy);
+
+  std::cout << "Image size: " << size << "^3, iterations: " << iterations << std::endl;
+  collector.Report(std::cout);
+
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
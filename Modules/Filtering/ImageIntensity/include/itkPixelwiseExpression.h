@@ -0,0 +1,361 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPixelwiseExpression_h
+#define itkPixelwiseExpression_h
+
+#include "itkArithmeticOpsFunctors.h"
+#include "itkClampImageFilter.h"
+#include "itkUnaryGeneratorImageFilter.h"
+#include "itkBinaryGeneratorImageFilter.h"
+#include "itkTernaryGeneratorImageFilter.h"
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace itk
+{
+/** PixelwiseExpression namespace to house lazy expressions of pixel-wise
+ * operations, which are fused into a single filter.
+ *
+ * A chain such as AddImageFilter, MultiplyImageFilter, ClampImageFilter and
+ * CastImageFilter allocates an intermediate image and sweeps the memory once
+ * per filter. Written as an expression, the same chain is evaluated by one
+ * generator filter, in a single pass and without intermediate images:
+ * \code
+ *   using namespace itk::PixelwiseExpression;
+ *   const auto expression = Cast<unsigned char>(Clamp((Input<0> + Input<1>) * 0.5f, 0.0f, 255.0f));
+ *
+ *   auto filter = MakeFilter<FloatImageType, UCharImageType>(expression);
+ *   filter->SetInput1(image1);
+ *   filter->SetInput2(image2);
+ *   filter->Update();
+ * \endcode
+ *
+ * The fused filter is an UnaryGeneratorImageFilter, BinaryGeneratorImageFilter
+ * or TernaryGeneratorImageFilter, depending on the number of inputs used by
+ * the expression, so that it honors the requested region, runs multithreaded
+ * and may run in place like any other pixel-wise filter.
+ *
+ * The operators are evaluated with the functors of itkArithmeticOpsFunctors.h,
+ * so that, for instance, a division by zero gives the same result as
+ * DivideImageFilter. The intermediate values have the type of the
+ * corresponding C++ expression (int for the sum of two unsigned char, for
+ * instance) instead of the pixel type of an intermediate image, so that they
+ * neither overflow nor get rounded between the operations. Use Cast to
+ * reproduce the conversion done by an intermediate image when needed.
+ *
+ * \ingroup ITKImageIntensity
+ */
+namespace PixelwiseExpression
+{
+/** Base of all the expressions, used to select the overloaded operators. */
+struct ExpressionBase
+{};
+
+template <typename T>
+constexpr bool IsExpression = std::is_base_of_v<ExpressionBase, std::decay_t<T>>;
+
+/** Leaf expression giving the pixel of the input VIndex (0, 1 or 2). */
+template <unsigned int VIndex>
+struct InputPixel : ExpressionBase
+{
+  static constexpr unsigned int NumberOfInputs = VIndex + 1;
+
+  template <typename... TPixels>
+  inline decltype(auto)
+  operator()(const TPixels &... pixels) const
+  {
+    return std::get<VIndex>(std::forward_as_tuple(pixels...));
+  }
+};
+
+/** Leaf expression giving the same value for all the pixels. */
+template <typename TValue>
+struct ConstantValue : ExpressionBase
+{
+  static constexpr unsigned int NumberOfInputs = 0;
+
+  TValue m_Value;
+
+  template <typename... TPixels>
+  inline TValue
+  operator()(const TPixels &...) const
+  {
+    return m_Value;
+  }
+};
+
+/** Expression applying a functor to the values of its operands. */
+template <typename TFunctor, typename... TOperands>
+struct FunctorNode : ExpressionBase
+{
+  static constexpr unsigned int NumberOfInputs = std::max({ 0u, TOperands::NumberOfInputs... });
+
+  TFunctor                m_Functor;
+  std::tuple<TOperands...> m_Operands;
+
+  template <typename... TPixels>
+  inline auto
+  operator()(const TPixels &... pixels) const
+  {
+    return std::apply([&](const TOperands &... operands) { return m_Functor(operands(pixels...)...); }, m_Operands);
+  }
+};
+
+/** Value type of an expression evaluated on the given pixel types. */
+template <typename TExpression, typename... TPixels>
+using ValueType = std::decay_t<decltype(std::declval<const TExpression &>()(std::declval<const TPixels &>()...))>;
+
+/** Wraps a value as a ConstantValue, and leaves expressions unchanged. */
+template <typename T>
+inline auto
+MakeOperand(const T & value)
+{
+  if constexpr (IsExpression<T>)
+  {
+    return value;
+  }
+  else
+  {
+    return ConstantValue<T>{ {}, value };
+  }
+}
+
+/** Makes a FunctorNode from a functor and operands, each operand being an
+ * expression or a constant value. */
+template <typename TFunctor, typename... TOperands>
+inline auto
+Apply(const TFunctor & functor, const TOperands &... operands)
+{
+  return FunctorNode<TFunctor, decltype(MakeOperand(operands))...>{ {}, functor, { MakeOperand(operands)... } };
+}
+
+/** Adapts a binary functor of itkArithmeticOpsFunctors.h, templated over the
+ * types of its operands, to the value types of the operands of the node. */
+template <template <typename, typename, typename> class TFunctor, typename TResult>
+struct BinaryOperator
+{
+  template <typename TValue1, typename TValue2>
+  inline auto
+  operator()(const TValue1 & value1, const TValue2 & value2) const
+  {
+    using OutputType = std::decay_t<decltype(std::declval<TResult>()(value1, value2))>;
+    return TFunctor<TValue1, TValue2, OutputType>{}(value1, value2);
+  }
+};
+
+struct PlusResult
+{
+  template <typename T1, typename T2>
+  auto
+  operator()(const T1 & a, const T2 & b) const -> decltype(a + b);
+};
+struct MinusResult
+{
+  template <typename T1, typename T2>
+  auto
+  operator()(const T1 & a, const T2 & b) const -> decltype(a - b);
+};
+struct MultipliesResult
+{
+  template <typename T1, typename T2>
+  auto
+  operator()(const T1 & a, const T2 & b) const -> decltype(a * b);
+};
+struct DividesResult
+{
+  template <typename T1, typename T2>
+  auto
+  operator()(const T1 & a, const T2 & b) const -> decltype(a / b);
+};
+
+using Plus = BinaryOperator<Functor::Add2, PlusResult>;
+using Minus = BinaryOperator<Functor::Sub2, MinusResult>;
+using Multiplies = BinaryOperator<Functor::Mult, MultipliesResult>;
+using Divides = BinaryOperator<Functor::Div, DividesResult>;
+
+struct Negate
+{
+  template <typename TValue>
+  inline auto
+  operator()(const TValue & value) const
+  {
+    return Functor::UnaryMinus<TValue, std::decay_t<decltype(-value)>>{}(value);
+  }
+};
+
+/** Clamps a value with Functor::Clamp, as ClampImageFilter does. */
+template <typename TBound>
+struct ClampOperator
+{
+  Functor::Clamp<double, TBound> m_Clamp;
+
+  template <typename TValue>
+  inline TBound
+  operator()(const TValue & value) const
+  {
+    return m_Clamp(static_cast<double>(value));
+  }
+};
+
+template <typename TOutput>
+struct CastOperator
+{
+  template <typename TValue>
+  inline TOutput
+  operator()(const TValue & value) const
+  {
+    return static_cast<TOutput>(value);
+  }
+};
+
+/** The pixel of the input VIndex, as in `Input<0> + Input<1>`. */
+template <unsigned int VIndex>
+constexpr InputPixel<VIndex> Input{};
+
+/** Makes an expression giving the same value for all the pixels. */
+template <typename TValue>
+inline ConstantValue<TValue>
+Constant(const TValue & value)
+{
+  return { {}, value };
+}
+
+/** Operators combining expressions, or an expression and a constant value. */
+template <typename T1, typename T2, typename = std::enable_if_t<IsExpression<T1> || IsExpression<T2>>>
+inline auto
+operator+(const T1 & operand1, const T2 & operand2)
+{
+  return Apply(Plus{}, operand1, operand2);
+}
+
+template <typename T1, typename T2, typename = std::enable_if_t<IsExpression<T1> || IsExpression<T2>>>
+inline auto
+operator-(const T1 & operand1, const T2 & operand2)
+{
+  return Apply(Minus{}, operand1, operand2);
+}
+
+template <typename T1, typename T2, typename = std::enable_if_t<IsExpression<T1> || IsExpression<T2>>>
+inline auto
+operator*(const T1 & operand1, const T2 & operand2)
+{
+  return Apply(Multiplies{}, operand1, operand2);
+}
+
+template <typename T1, typename T2, typename = std::enable_if_t<IsExpression<T1> || IsExpression<T2>>>
+inline auto
+operator/(const T1 & operand1, const T2 & operand2)
+{
+  return Apply(Divides{}, operand1, operand2);
+}
+
+template <typename T, typename = std::enable_if_t<IsExpression<T>>>
+inline auto
+operator-(const T & operand)
+{
+  return Apply(Negate{}, operand);
+}
+
+/** Clamps the values of the expression to [lowerBound, upperBound], giving
+ * values of the type of the bounds. Throws an ExceptionObject when
+ * lowerBound is greater than upperBound. */
+template <typename TExpression, typename TBound, typename = std::enable_if_t<IsExpression<TExpression>>>
+inline auto
+Clamp(const TExpression & expression, const TBound lowerBound, const TBound upperBound)
+{
+  ClampOperator<TBound> clampOperator;
+  clampOperator.m_Clamp.SetBounds(lowerBound, upperBound);
+  return Apply(clampOperator, expression);
+}
+
+/** Converts the values of the expression to TOutput with a static_cast. */
+template <typename TOutput, typename TExpression, typename = std::enable_if_t<IsExpression<TExpression>>>
+inline auto
+Cast(const TExpression & expression)
+{
+  return Apply(CastOperator<TOutput>{}, expression);
+}
+
+/** Generator filter evaluating an expression of VNumberOfInputs inputs. */
+template <typename TInputImage, typename TOutputImage, unsigned int VNumberOfInputs>
+struct FilterTypeSelector;
+
+template <typename TInputImage, typename TOutputImage>
+struct FilterTypeSelector<TInputImage, TOutputImage, 1>
+{
+  using Type = UnaryGeneratorImageFilter<TInputImage, TOutputImage>;
+};
+
+template <typename TInputImage, typename TOutputImage>
+struct FilterTypeSelector<TInputImage, TOutputImage, 2>
+{
+  using Type = BinaryGeneratorImageFilter<TInputImage, TInputImage, TOutputImage>;
+};
+
+template <typename TInputImage, typename TOutputImage>
+struct FilterTypeSelector<TInputImage, TOutputImage, 3>
+{
+  using Type = TernaryGeneratorImageFilter<TInputImage, TInputImage, TInputImage, TOutputImage>;
+};
+
+template <typename TInputImage, typename TOutputImage, typename TExpression>
+using FilterType = typename FilterTypeSelector<TInputImage, TOutputImage, TExpression::NumberOfInputs>::Type;
+
+/** Makes the filter evaluating the expression on images of type TInputImage,
+ * which is an UnaryGeneratorImageFilter, a BinaryGeneratorImageFilter or a
+ * TernaryGeneratorImageFilter when the expression uses one, two or three
+ * inputs. The values of the expression are converted to the output pixel
+ * type with a static_cast. */
+template <typename TInputImage, typename TOutputImage, typename TExpression>
+auto
+MakeFilter(const TExpression & expression) -> typename FilterType<TInputImage, TOutputImage, TExpression>::Pointer
+{
+  static_assert(IsExpression<TExpression>, "MakeFilter requires an expression of PixelwiseExpression.");
+  static_assert(TExpression::NumberOfInputs >= 1 && TExpression::NumberOfInputs <= 3,
+                "The expression must use one, two or three inputs.");
+
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  auto filter = FilterType<TInputImage, TOutputImage, TExpression>::New();
+  if constexpr (TExpression::NumberOfInputs == 1)
+  {
+    filter->SetFunctor([expression](const InputPixelType & pixel) -> OutputPixelType {
+      return static_cast<OutputPixelType>(expression(pixel));
+    });
+  }
+  else if constexpr (TExpression::NumberOfInputs == 2)
+  {
+    filter->SetFunctor([expression](const InputPixelType & pixel1, const InputPixelType & pixel2) -> OutputPixelType {
+      return static_cast<OutputPixelType>(expression(pixel1, pixel2));
+    });
+  }
+  else
+  {
+    filter->SetFunctor(
+      [expression](const InputPixelType & pixel1, const InputPixelType & pixel2, const InputPixelType & pixel3)
+        -> OutputPixelType { return static_cast<OutputPixelType>(expression(pixel1, pixel2, pixel3)); });
+  }
+  return filter;
+}
+} // namespace PixelwiseExpression
+} // end namespace itk
+
+#endif
@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPixelwiseExpression.h"
+#include "itkAddImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkGTest.h"
+
+namespace
+{
+using FloatImageType = itk::Image<float, 3>;
+using UCharImageType = itk::Image<unsigned char, 3>;
+
+template <typename TImage>
+typename TImage::Pointer
+CreateRampImage(const typename TImage::SizeType & size, double scale)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  double value = 0.0;
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<typename TImage::PixelType>(value));
+    value = value < 300.0 ? value + scale : -20.0;
+  }
+  return image;
+}
+
+
+// Checks that the requested regions of both images have the same pixels.
+template <typename TImage>
+void
+ExpectRequestedRegionEquals(const TImage * output, const TImage * expected)
+{
+  ASSERT_EQ(output->GetRequestedRegion(), expected->GetRequestedRegion());
+  for (itk::ImageRegionConstIteratorWithIndex<TImage> it(output, output->GetRequestedRegion()); !it.IsAtEnd(); ++it)
+  {
+    ASSERT_EQ(it.Get(), expected->GetPixel(it.GetIndex())) << "at index " << it.GetIndex();
+  }
+}
+
+
+// The expression (input1 + input2) * 0.5, clamped to [0, 255] and cast to
+// unsigned char, as a chain of filters.
+struct ChainedFilters
+{
+  using AddFilterType = itk::AddImageFilter<FloatImageType>;
+  using MultiplyFilterType = itk::MultiplyImageFilter<FloatImageType>;
+  using ClampFilterType = itk::ClampImageFilter<FloatImageType, FloatImageType>;
+  using CastFilterType = itk::CastImageFilter<FloatImageType, UCharImageType>;
+
+  ChainedFilters(const FloatImageType * image1, const FloatImageType * image2)
+  {
+    m_AddFilter->SetInput1(image1);
+    m_AddFilter->SetInput2(image2);
+    m_MultiplyFilter->SetInput(m_AddFilter->GetOutput());
+    m_MultiplyFilter->SetConstant(0.5f);
+    m_ClampFilter->SetInput(m_MultiplyFilter->GetOutput());
+    m_ClampFilter->SetBounds(0.0f, 255.0f);
+    m_CastFilter->SetInput(m_ClampFilter->GetOutput());
+  }
+
+  const AddFilterType::Pointer      m_AddFilter{ AddFilterType::New() };
+  const MultiplyFilterType::Pointer m_MultiplyFilter{ MultiplyFilterType::New() };
+  const ClampFilterType::Pointer    m_ClampFilter{ ClampFilterType::New() };
+  const CastFilterType::Pointer     m_CastFilter{ CastFilterType::New() };
+};
+} // namespace
+
+
+TEST(PixelwiseExpression, EvaluatesOperators)
+{
+  using namespace itk::PixelwiseExpression;
+
+  EXPECT_EQ((Input<0> + Input<1>)(2, 3), 5);
+  EXPECT_EQ((Input<1> - Input<0>)(2, 3), 1);
+  EXPECT_EQ((2 * Input<0> + Input<2> / 4.0)(3, 100, 4), 7.0);
+  EXPECT_EQ((-Input<0>)(4.5f), -4.5f);
+  EXPECT_EQ(Cast<unsigned char>(Input<0> * 2)(100.6), 201);
+  EXPECT_EQ(Clamp(Input<0>, 0.0f, 1.0f)(2), 1.0f);
+  EXPECT_EQ(Clamp(Input<0>, 0.0f, 1.0f)(-1), 0.0f);
+  EXPECT_EQ(Clamp(Input<0>, 0.0f, 1.0f)(0.25), 0.25f);
+  EXPECT_EQ(Apply(itk::Functor::Modulus<int, int, int>{}, Input<0>, 7)(23), 2);
+
+  // Intermediate values have the type of the C++ expression, without the
+  // overflow of an intermediate image of unsigned char.
+  const unsigned char value = 200;
+  EXPECT_EQ((Input<0> + Input<1>)(value, value), 400);
+
+  // A division by zero gives the same result as DivideImageFilter.
+  EXPECT_EQ((Input<0> / Input<1>)(3.0f, 0.0f), itk::NumericTraits<float>::max());
+
+  static_assert(decltype(Input<0> + 1)::NumberOfInputs == 1);
+  static_assert(decltype(Input<0> * Input<2>)::NumberOfInputs == 3);
+  static_assert(std::is_same_v<ValueType<decltype(Input<0> + Input<1>), unsigned char, unsigned char>, int>);
+
+  EXPECT_THROW(Clamp(Input<0>, 1.0, 0.0), itk::ExceptionObject);
+}
+
+
+TEST(PixelwiseExpression, MatchesChainedFiltersOnRequestedRegion)
+{
+  using namespace itk::PixelwiseExpression;
+
+  const auto size = itk::MakeSize(41, 23, 7);
+  const auto image1 = CreateRampImage<FloatImageType>(size, 0.75);
+  const auto image2 = CreateRampImage<FloatImageType>(size, 2.5);
+
+  auto filter = MakeFilter<FloatImageType, UCharImageType>(
+    Cast<unsigned char>(Clamp((Input<0> + Input<1>) * 0.5f, 0.0f, 255.0f)));
+  filter->SetInput1(image1);
+  filter->SetInput2(image2);
+
+  const ChainedFilters chainedFilters(image1, image2);
+  UCharImageType *     expected = chainedFilters.m_CastFilter->GetOutput();
+
+  const FloatImageType::RegionType requestedRegion(itk::MakeIndex(3, 5, 1), itk::MakeSize(31, 13, 4));
+  filter->GetOutput()->SetRequestedRegion(requestedRegion);
+  expected->SetRequestedRegion(requestedRegion);
+  filter->SetNumberOfWorkUnits(4);
+  ASSERT_NO_THROW(filter->Update());
+  ASSERT_NO_THROW(chainedFilters.m_CastFilter->Update());
+
+  EXPECT_EQ(filter->GetOutput()->GetBufferedRegion(), requestedRegion);
+  ExpectRequestedRegionEquals(filter->GetOutput(), expected);
+}
+
+
+TEST(PixelwiseExpression, UnaryAndTernaryExpressions)
+{
+  using namespace itk::PixelwiseExpression;
+
+  const auto size = itk::MakeSize(17, 9, 3);
+  const auto image1 = CreateRampImage<FloatImageType>(size, 1.0);
+  const auto image2 = CreateRampImage<FloatImageType>(size, 0.5);
+  const auto image3 = CreateRampImage<FloatImageType>(size, 3.0);
+
+  auto unaryFilter = MakeFilter<FloatImageType, FloatImageType>(-Input<0> * 2.0f + 1.0f);
+  unaryFilter->SetInput(image1);
+  unaryFilter->Update();
+
+  auto ternaryFilter = MakeFilter<FloatImageType, FloatImageType>((Input<0> - Input<1>) * Input<2>);
+  ternaryFilter->SetInput1(image1);
+  ternaryFilter->SetInput2(image2);
+  ternaryFilter->SetInput3(image3);
+  ternaryFilter->Update();
+
+  for (itk::ImageRegionConstIteratorWithIndex<FloatImageType> it(image1, image1->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    const auto & index = it.GetIndex();
+    EXPECT_EQ(unaryFilter->GetOutput()->GetPixel(index), -it.Get() * 2.0f + 1.0f);
+    EXPECT_EQ(ternaryFilter->GetOutput()->GetPixel(index),
+              (it.Get() - image2->GetPixel(index)) * image3->GetPixel(index));
+  }
+}
+
+
+TEST(PixelwiseExpression, RunsInPlace)
+{
+  using namespace itk::PixelwiseExpression;
+
+  const auto image = CreateRampImage<FloatImageType>(itk::MakeSize(19, 11, 2), 1.5);
+  const auto expected = CreateRampImage<FloatImageType>(itk::MakeSize(19, 11, 2), 1.5);
+  const auto inputBuffer = image->GetBufferPointer();
+
+  auto filter = MakeFilter<FloatImageType, FloatImageType>(Clamp(Input<0> / 2.0f, 0.0f, 100.0f));
+  filter->SetInput(image);
+  filter->InPlaceOn();
+  filter->Update();
+
+  EXPECT_EQ(filter->GetOutput()->GetBufferPointer(), inputBuffer);
+  for (itk::ImageRegionConstIteratorWithIndex<FloatImageType> it(expected, expected->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    EXPECT_EQ(filter->GetOutput()->GetPixel(it.GetIndex()), std::clamp(it.Get() / 2.0f, 0.0f, 100.0f));
+  }
+}
+
+
+// Reports the time of the fused expression and of the chain of filters, to
+// compare both on the build machine.
+TEST(PixelwiseExpression, ReportTime)
+{
+  using namespace itk::PixelwiseExpression;
+
+  const auto size = itk::MakeSize(256, 256, 128);
+  const auto image1 = CreateRampImage<FloatImageType>(size, 0.75);
+  const auto image2 = CreateRampImage<FloatImageType>(size, 2.5);
+
+  auto filter = MakeFilter<FloatImageType, UCharImageType>(
+    Cast<unsigned char>(Clamp((Input<0> + Input<1>) * 0.5f, 0.0f, 255.0f)));
+  filter->SetInput1(image1);
+  filter->SetInput2(image2);
+
+  const ChainedFilters chainedFilters(image1, image2);
+
+  itk::TimeProbe fusedProbe;
+  itk::TimeProbe chainedProbe;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    image1->Modified();
+    fusedProbe.Start();
+    filter->Update();
+    fusedProbe.Stop();
+
+    image1->Modified();
+    chainedProbe.Start();
+    chainedFilters.m_CastFilter->Update();
+    chainedProbe.Stop();
+  }
+  std::cout << "256x256x128 float volumes, fused expression: " << fusedProbe.GetMean() * 1000
+            << " ms, chained filters: " << chainedProbe.GetMean() * 1000 << " ms" << std::endl;
+}
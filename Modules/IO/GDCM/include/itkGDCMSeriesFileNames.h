@@ -51,6 +51,13 @@ namespace itk
  *    DICOM objects, you may want to try calling SetUseSeriesDetails(true)
  *    prior to calling SetDirectory().
  *
+ * The files of the directory are scanned in parallel, using up to
+ * NumberOfWorkUnits threads, and only their header is read: reading stops at
+ * the Pixel Data element, and files without Pixel Data are ignored. The
+ * headers can also be kept in an index cache file (see
+ * SetIndexCacheFileName()), so that scanning the same directory again only
+ * reads the files that were added or modified since.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOGDCM
@@ -185,6 +192,16 @@ public:
   itkGetConstMacro(LoadPrivateTags, bool);
   itkBooleanMacro(LoadPrivateTags);
 
+  /** Set the name of the index cache file, in which the headers read while
+   * scanning the input directory are kept, along with the modification time
+   * and the size of their file. A file whose modification time and size did
+   * not change is not read again when a directory is scanned. The cache file
+   * is created or updated by the scan. An empty name, the default, disables
+   * the cache.
+   * Must be set before the call to SetInputDirectory(). */
+  itkSetStringMacro(IndexCacheFileName);
+  itkGetStringMacro(IndexCacheFileName);
+
 protected:
   GDCMSeriesFileNames();
   ~GDCMSeriesFileNames() override;
@@ -192,12 +209,20 @@ protected:
   PrintSelf(std::ostream & os, Indent indent) const override;
 
 private:
+  /** Reads the headers of the files of the input directory, and adds them to
+   * the series of m_SerieHelper. */
+  void
+  ScanInputDirectory();
+
   /** Contains the input directory where the DICOM series is found */
   std::string m_InputDirectory = "";
 
   /** Contains the output directory where the DICOM series should be written */
   std::string m_OutputDirectory = "";
 
+  /** Name of the file that caches the headers of the scanned files */
+  std::string m_IndexCacheFileName = "";
+
   /** Internal structure to keep the list of input/output filenames */
   FileNamesContainerType m_InputFileNames{};
   FileNamesContainerType m_OutputFileNames{};
@@ -18,12 +18,157 @@
 
 #include "itkGDCMSeriesFileNames.h"
 #include "itksys/SystemTools.hxx"
+#include "itkMultiThreaderBase.h"
 #include "itkProgressReporter.h"
 #include "itkPrintHelper.h"
+#include "gdcmDirectory.h"
+#include "gdcmReader.h"
 #include "gdcmSerieHelper.h"
+#include "gdcmWriter.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
 
 namespace itk
 {
+namespace
+{
+const char IndexCacheSignature[] = "ITKGDCMSeriesFileNamesIndexCache 1";
+
+// Gives access to gdcm::SerieHelper::AddFile, which is protected, to add the
+// headers read by GDCMSeriesFileNames to the series.
+class SerieHelperAccess : public gdcm::SerieHelper
+{
+public:
+  static bool
+  AddFileTo(gdcm::SerieHelper & serieHelper, gdcm::FileWithName & file)
+  {
+    return (serieHelper.*&SerieHelperAccess::AddFile)(file);
+  }
+};
+
+struct ScannedFile
+{
+  long int      modifiedTime{};
+  unsigned long length{};
+  // The header as written by gdcm::Writer. Empty for a file without Pixel
+  // Data, or when the header is not cached.
+  std::string header{};
+  // nullptr for a file without Pixel Data.
+  gdcm::SmartPointer<gdcm::FileWithName> file{};
+  bool                                   isImage{};
+  bool                                   isCached{};
+};
+
+// Reads the header of the DICOM file, up to its Pixel Data. Returns nullptr
+// if the file cannot be read, or has no Pixel Data.
+gdcm::SmartPointer<gdcm::FileWithName>
+ReadHeaderUpToPixelData(const std::string & fileName)
+{
+  std::ifstream stream(fileName, std::ios::in | std::ios::binary);
+  if (!stream)
+  {
+    return nullptr;
+  }
+  const gdcm::Tag pixelDataTag(0x7fe0, 0x0010);
+  gdcm::Reader    reader;
+  reader.SetStream(stream);
+  // The Pixel Data element is skipped: the stream is left at its value, and
+  // is only still good if the element was found.
+  if (!reader.ReadUpToTag(pixelDataTag, { pixelDataTag }) || !stream.good())
+  {
+    return nullptr;
+  }
+  gdcm::SmartPointer<gdcm::FileWithName> file = new gdcm::FileWithName(reader.GetFile());
+  file->filename = fileName;
+  return file;
+}
+
+// Reads a header written by WriteHeader. Returns nullptr on failure.
+gdcm::SmartPointer<gdcm::FileWithName>
+ReadHeader(const std::string & header, const std::string & fileName)
+{
+  std::istringstream stream(header);
+  gdcm::Reader       reader;
+  reader.SetStream(stream);
+  if (!reader.Read())
+  {
+    return nullptr;
+  }
+  gdcm::SmartPointer<gdcm::FileWithName> file = new gdcm::FileWithName(reader.GetFile());
+  file->filename = fileName;
+  return file;
+}
+
+// Writes the header to a string. Returns an empty string on failure.
+std::string
+WriteHeader(const gdcm::File & file)
+{
+  std::ostringstream stream;
+  gdcm::Writer       writer;
+  writer.SetStream(stream);
+  writer.SetFile(file);
+  writer.CheckFileMetaInformationOff();
+  return writer.Write() ? stream.str() : std::string();
+}
+
+// The index cache file starts with IndexCacheSignature, followed, for each
+// file, by a line with the length of its name, its modification time, its
+// length and the length of its header (0 for a file without Pixel Data), and
+// then by its name and its header.
+std::map<std::string, ScannedFile>
+ReadIndexCache(const std::string & cacheFileName)
+{
+  std::map<std::string, ScannedFile> cachedFiles;
+  std::ifstream                      stream(cacheFileName, std::ios::in | std::ios::binary);
+  std::string                        signature;
+  if (!std::getline(stream, signature) || signature != IndexCacheSignature)
+  {
+    return cachedFiles;
+  }
+  size_t      fileNameLength{};
+  ScannedFile cachedFile;
+  size_t      headerLength{};
+  while (stream >> fileNameLength >> cachedFile.modifiedTime >> cachedFile.length >> headerLength &&
+         stream.get() == '\n')
+  {
+    std::string fileName(fileNameLength, '\0');
+    cachedFile.header.resize(headerLength);
+    if (!stream.read(&fileName[0], fileNameLength) || !stream.read(&cachedFile.header[0], headerLength))
+    {
+      break;
+    }
+    cachedFile.isImage = headerLength > 0;
+    cachedFiles[fileName] = cachedFile;
+  }
+  return cachedFiles;
+}
+
+bool
+WriteIndexCache(const std::string &              cacheFileName,
+                const std::vector<std::string> & fileNames,
+                const std::vector<ScannedFile> & scannedFiles)
+{
+  std::ofstream stream(cacheFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  stream << IndexCacheSignature << '\n';
+  for (size_t i = 0; i < fileNames.size(); ++i)
+  {
+    const ScannedFile & scannedFile = scannedFiles[i];
+    // A file whose header could not be written is read again by the next scan.
+    if (scannedFile.isImage && scannedFile.header.empty())
+    {
+      continue;
+    }
+    stream << fileNames[i].size() << ' ' << scannedFile.modifiedTime << ' ' << scannedFile.length << ' '
+           << scannedFile.header.size() << '\n'
+           << fileNames[i] << scannedFile.header;
+  }
+  stream.close();
+  return !stream.fail();
+}
+} // namespace
+
 
 
 GDCMSeriesFileNames::GDCMSeriesFileNames()
@@ -72,11 +217,73 @@ GDCMSeriesFileNames::SetInputDirectory(std::string const & name)
   m_SerieHelper->Clear();
   m_SerieHelper->SetUseSeriesDetails(m_UseSeriesDetails);
   m_SerieHelper->SetLoadMode((m_LoadSequences ? 0 : gdcm::LD_NOSEQ) | (m_LoadPrivateTags ? 0 : gdcm::LD_NOSHADOW));
-  m_SerieHelper->SetDirectory(name, m_Recursive);
+  this->ScanInputDirectory();
   // as a side effect it also execute
   this->Modified();
 }
 
+void
+GDCMSeriesFileNames::ScanInputDirectory()
+{
+  gdcm::Directory directory;
+  directory.Load(m_InputDirectory, m_Recursive);
+  const gdcm::Directory::FilenamesType & fileNames = directory.GetFilenames();
+
+  const bool                               useIndexCache = !m_IndexCacheFileName.empty();
+  const std::map<std::string, ScannedFile> cachedFiles =
+    useIndexCache ? ReadIndexCache(m_IndexCacheFileName) : std::map<std::string, ScannedFile>();
+
+  // Only the headers are read, in parallel. The files are then added to the
+  // series in the order of the directory, as gdcm::SerieHelper does.
+  std::vector<ScannedFile> scannedFiles(fileNames.size());
+  MultiThreaderBase *      multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    static_cast<SizeValueType>(fileNames.size()),
+    [&fileNames, &cachedFiles, &scannedFiles, useIndexCache](SizeValueType i) {
+      const std::string & fileName = fileNames[i];
+      ScannedFile &       scannedFile = scannedFiles[i];
+      if (useIndexCache)
+      {
+        scannedFile.modifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+        scannedFile.length = itksys::SystemTools::FileLength(fileName);
+        const auto cachedFile = cachedFiles.find(fileName);
+        if (cachedFile != cachedFiles.end() && cachedFile->second.modifiedTime == scannedFile.modifiedTime &&
+            cachedFile->second.length == scannedFile.length)
+        {
+          scannedFile.isImage = cachedFile->second.isImage;
+          scannedFile.header = cachedFile->second.header;
+          scannedFile.file = scannedFile.isImage ? ReadHeader(scannedFile.header, fileName) : nullptr;
+          scannedFile.isCached = !scannedFile.isImage || scannedFile.file != nullptr;
+          if (scannedFile.isCached)
+          {
+            return;
+          }
+        }
+      }
+      scannedFile.file = ReadHeaderUpToPixelData(fileName);
+      scannedFile.isImage = scannedFile.file != nullptr;
+      scannedFile.header = useIndexCache && scannedFile.isImage ? WriteHeader(*scannedFile.file) : std::string();
+    },
+    this);
+
+  bool isIndexCacheUpToDate = cachedFiles.size() == scannedFiles.size();
+  for (ScannedFile & scannedFile : scannedFiles)
+  {
+    isIndexCacheUpToDate = isIndexCacheUpToDate && scannedFile.isCached;
+    if (scannedFile.file)
+    {
+      SerieHelperAccess::AddFileTo(*m_SerieHelper, *scannedFile.file);
+    }
+  }
+
+  if (useIndexCache && !isIndexCacheUpToDate && !WriteIndexCache(m_IndexCacheFileName, fileNames, scannedFiles))
+  {
+    itkWarningMacro(<< "Could not write the index cache file " << m_IndexCacheFileName);
+  }
+}
+
 const GDCMSeriesFileNames::SeriesUIDContainerType &
 GDCMSeriesFileNames::GetSeriesUIDs()
 {
@@ -271,6 +478,7 @@ GDCMSeriesFileNames::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "InputDirectory: " << m_InputDirectory << std::endl;
   os << indent << "OutputDirectory: " << m_OutputDirectory << std::endl;
+  os << indent << "IndexCacheFileName: " << m_IndexCacheFileName << std::endl;
 
   os << indent << "InputFileNames: " << m_InputFileNames << std::endl;
   os << indent << "OutputFileNames: " << m_OutputFileNames << std::endl;
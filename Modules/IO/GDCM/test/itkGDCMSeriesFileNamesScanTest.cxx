@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGDCMImageIO.h"
+#include "itkGDCMSeriesFileNames.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaDataObject.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <fstream>
+
+
+namespace
+{
+using ImageType = itk::Image<short, 2>;
+
+// Writes a slice of the series, at the given position along z.
+void
+WriteSlice(const std::string & fileName, const std::string & seriesUID, int instanceNumber, double z)
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 8, 6 } });
+  image->Allocate();
+  image->FillBuffer(static_cast<short>(instanceNumber));
+
+  itk::MetaDataDictionary & dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", seriesUID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", std::to_string(instanceNumber));
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", "0\\0\\" + std::to_string(z));
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", "1\\0\\0\\0\\1\\0");
+
+  auto imageIO = itk::GDCMImageIO::New();
+  imageIO->KeepOriginalUIDOn();
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(fileName);
+  writer->Update();
+}
+
+// Returns the file names of each series found in the directory, ordered by
+// series UID.
+std::vector<itk::FilenamesContainer>
+ScanSeries(const std::string & directory, const std::string & indexCacheFileName, itk::ThreadIdType numberOfWorkUnits)
+{
+  auto seriesFileNames = itk::GDCMSeriesFileNames::New();
+  seriesFileNames->SetIndexCacheFileName(indexCacheFileName);
+  seriesFileNames->SetNumberOfWorkUnits(numberOfWorkUnits);
+  seriesFileNames->SetInputDirectory(directory);
+
+  std::vector<itk::FilenamesContainer> series;
+  for (const std::string & seriesUID : seriesFileNames->GetSeriesUIDs())
+  {
+    series.push_back(seriesFileNames->GetFileNames(seriesUID));
+  }
+  return series;
+}
+} // namespace
+
+
+int
+itkGDCMSeriesFileNamesScanTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string directory = std::string(argv[1]) + "/itkGDCMSeriesFileNamesScanTest";
+  itksys::SystemTools::RemoveADirectory(directory);
+  itksys::SystemTools::MakeDirectory(directory);
+
+  // The names of the slices of the first series are in the reverse order of
+  // their position. Files that are not DICOM images are ignored.
+  itk::FilenamesContainer expectedSeries1;
+  for (int i = 0; i < 6; ++i)
+  {
+    expectedSeries1.push_back(directory + "/slice" + std::to_string(5 - i) + ".dcm");
+    WriteSlice(expectedSeries1.back(), "1.2.826.0.1.3680043.2.1125.1", i + 1, 2.5 * i);
+  }
+  itk::FilenamesContainer expectedSeries2;
+  for (int i = 0; i < 3; ++i)
+  {
+    expectedSeries2.push_back(directory + "/other" + std::to_string(i) + ".dcm");
+    WriteSlice(expectedSeries2.back(), "1.2.826.0.1.3680043.2.1125.2", i + 1, -1.0 * i);
+  }
+  std::reverse(expectedSeries2.begin(), expectedSeries2.end());
+  std::ofstream(directory + "/notes.txt") << "Not a DICOM file" << std::endl;
+
+  const std::vector<itk::FilenamesContainer> expectedSeries{ expectedSeries1, expectedSeries2 };
+  ITK_TEST_EXPECT_TRUE(ScanSeries(directory, "", 1) == expectedSeries);
+  ITK_TEST_EXPECT_TRUE(ScanSeries(directory, "", 4) == expectedSeries);
+
+  // The first scan writes the index cache, which is then read by the next one.
+  const std::string indexCacheFileName = std::string(argv[1]) + "/itkGDCMSeriesFileNamesScanTest.cache";
+  itksys::SystemTools::RemoveFile(indexCacheFileName);
+  ITK_TEST_EXPECT_TRUE(ScanSeries(directory, indexCacheFileName, 4) == expectedSeries);
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(indexCacheFileName, true));
+  ITK_TEST_EXPECT_TRUE(ScanSeries(directory, indexCacheFileName, 4) == expectedSeries);
+
+  // Files are not read again when their modification time and size are
+  // unchanged: a cache that records a slice of the second series as a file
+  // without Pixel Data excludes it from the series.
+  const auto writeIndexCache = [&indexCacheFileName](const std::string & fileName, unsigned long length) {
+    std::ofstream indexCache(indexCacheFileName, std::ios::out | std::ios::binary);
+    indexCache << "ITKGDCMSeriesFileNamesIndexCache 1\n"
+               << fileName.size() << ' ' << itksys::SystemTools::ModifiedTime(fileName) << ' ' << length << " 0\n"
+               << fileName;
+  };
+  const std::string excludedFileName = expectedSeries2.front();
+  writeIndexCache(excludedFileName, itksys::SystemTools::FileLength(excludedFileName));
+  const std::vector<itk::FilenamesContainer> series = ScanSeries(directory, indexCacheFileName, 4);
+  ITK_TEST_EXPECT_EQUAL(series.size(), 2);
+  ITK_TEST_EXPECT_TRUE(series[0] == expectedSeries1);
+  ITK_TEST_EXPECT_TRUE(series[1] == itk::FilenamesContainer(expectedSeries2.begin() + 1, expectedSeries2.end()));
+
+  // A file whose size changed is read again.
+  writeIndexCache(excludedFileName, itksys::SystemTools::FileLength(excludedFileName) + 1);
+  ITK_TEST_EXPECT_TRUE(ScanSeries(directory, indexCacheFileName, 4) == expectedSeries);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
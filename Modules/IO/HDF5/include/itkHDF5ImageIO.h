@@ -79,7 +79,14 @@ namespace itk
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
- *
+ * VoxelData is stored in chunks, by default one slice along the slowest
+ * moving dimension. SetChunkSize() sets blocks instead (e.g. 64x64x64
+ * pixels), so that reading a region only decompresses the chunks it
+ * intersects. When UseCompression is on, the chunks are compressed with the
+ * "DEFLATE" compressor (the default) or with "SHUFFLEDEFLATE", which shuffles
+ * the bytes of the pixel components before deflating them, at the given
+ * CompressionLevel (1 to 9). The chunks entirely covered by the written region
+ * are compressed in parallel and written directly to the file.
  */
 
 class ITKIOHDF5_EXPORT HDF5ImageIO : public StreamingImageIOBase
@@ -137,6 +144,17 @@ public:
   void
   Write(const void * buffer) override;
 
+  using ChunkSizeType = std::vector<SizeValueType>;
+
+  /** Set/Get the size of the chunks of the voxel data, in pixels, along each
+   * dimension of the image. A size of 0, or a missing size, spans the whole
+   * image along its dimension, and sizes larger than the image are clamped.
+   * When empty (the default), a chunk is a slice along the slowest moving
+   * dimension. */
+  void
+  SetChunkSize(const ChunkSizeType & chunkSize);
+  itkGetConstReferenceMacro(ChunkSize, ChunkSizeType);
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO() override;
@@ -147,6 +165,13 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Also copies the chunk size and the shuffling of the compressed chunks. */
+  LightObject::Pointer
+  InternalClone() const override;
+
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
 private:
   void
   WriteString(const std::string & path, const std::string & value);
@@ -203,6 +228,12 @@ private:
   void
   SetupStreaming(H5::DataSpace * imageSpace, H5::DataSpace * slabSpace);
 
+  /** Compresses the chunks of the voxel data covered by the IORegion in
+   * parallel, and writes them directly to the file. Returns false, without
+   * writing anything, when the IORegion does not cover whole chunks. */
+  bool
+  WriteCompressedChunks(const void * buffer);
+
   /* A convenience function to ensure that the
    * state of the HDF5ImageIO object is returned
    * to a state similar to constructing a new
@@ -216,6 +247,8 @@ private:
   H5::H5File *  m_H5File{ nullptr };
   H5::DataSet * m_VoxelDataSet{ nullptr };
   bool          m_ImageInformationWritten{ false };
+  ChunkSizeType m_ChunkSize{};
+  bool          m_ShuffleBeforeCompression{ false };
 };
 } // end namespace itk
 
@@ -8,6 +8,7 @@ itk_module(ITKIOHDF5
     ITKIOImageBase
   PRIVATE_DEPENDS
     ITKHDF5
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKImageSources
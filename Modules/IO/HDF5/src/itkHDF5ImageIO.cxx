@@ -22,6 +22,8 @@
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
 
 #include <algorithm>
 
@@ -42,6 +44,7 @@ HDF5ImageIO::HDF5ImageIO()
   }
   this->Self::SetMaximumCompressionLevel(9);
   this->Self::SetCompressionLevel(5);
+  this->Self::SetCompressor("");
 }
 
 HDF5ImageIO::~HDF5ImageIO()
@@ -49,12 +52,61 @@ HDF5ImageIO::~HDF5ImageIO()
   this->ResetToInitialState();
 }
 
+LightObject::Pointer
+HDF5ImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ChunkSize = m_ChunkSize;
+  rval->m_ShuffleBeforeCompression = m_ShuffleBeforeCompression;
+  return loPtr;
+}
+
 void
 HDF5ImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: [";
+  for (size_t i = 0; i < m_ChunkSize.size(); ++i)
+  {
+    os << (i == 0 ? "" : ", ") << m_ChunkSize[i];
+  }
+  os << ']' << std::endl;
+  os << indent << "ShuffleBeforeCompression: " << (m_ShuffleBeforeCompression ? "On" : "Off") << std::endl;
+}
+
+void
+HDF5ImageIO::SetChunkSize(const ChunkSizeType & chunkSize)
+{
+  if (m_ChunkSize != chunkSize)
+  {
+    m_ChunkSize = chunkSize;
+    this->Modified();
+  }
+}
+
+void
+HDF5ImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  if (_compressor.empty() || _compressor == "DEFLATE")
+  {
+    m_ShuffleBeforeCompression = false;
+  }
+  else if (_compressor == "SHUFFLEDEFLATE")
+  {
+    m_ShuffleBeforeCompression = true;
+  }
+  else
+  {
+    this->Superclass::InternalSetCompressor(_compressor);
+  }
 }
 
 //
@@ -1082,14 +1134,30 @@ HDF5ImageIO::WriteImageInformation()
     H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
 
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
+    // unless a chunk size is given, set the chunk size to be
+    // the N-1 dimension region
     H5::DSetCreatPropList plist;
+    if (this->GetUseCompression())
+    {
+      if (m_ShuffleBeforeCompression)
+      {
+        plist.setShuffle();
+      }
+      plist.setDeflate(this->GetCompressionLevel());
+    }
 
-    // we have implicit compression enabled here?
-    plist.setDeflate(this->GetCompressionLevel());
-
-    dims[0] = 1;
+    const int numImageDims = this->GetNumberOfDimensions();
+    if (m_ChunkSize.empty())
+    {
+      dims[0] = 1;
+    }
+    for (int i = 0; i < numImageDims && i < static_cast<int>(m_ChunkSize.size()); ++i)
+    {
+      if (m_ChunkSize[i] > 0)
+      {
+        dims[numImageDims - 1 - i] = std::min<hsize_t>(dims[numImageDims - 1 - i], m_ChunkSize[i]);
+      }
+    }
     plist.setChunk(numDims, dims.get());
     dims.reset();
 
@@ -1290,12 +1358,20 @@ HDF5ImageIO::Write(const void * buffer)
       dims[numDims] = numComponents;
       ++numDims;
     }
+    if (this->GetUseCompression() && this->WriteCompressedChunks(buffer))
+    {
+      return;
+    }
     H5::DataSpace imageSpace(numDims, dims.get());
     H5::PredType  dataType = ComponentToPredType(this->GetComponentType());
     H5::DataSpace dspace;
     this->SetupStreaming(&imageSpace, &dspace);
     this->m_VoxelDataSet->write(buffer, dataType, dspace, imageSpace);
   }
+  catch (const ExceptionObject &)
+  {
+    throw;
+  }
   // catch failure caused by the H5File operations
   catch (const H5::FileIException & error)
   {
@@ -1326,6 +1402,152 @@ HDF5ImageIO::Write(const void * buffer)
   // this->ResetToInitialState();
 }
 
+bool
+HDF5ImageIO::WriteCompressedChunks(const void * buffer)
+{
+#if H5_VERSION_GE(1, 10, 3)
+  const unsigned int  numDims = this->GetNumberOfDimensions();
+  const unsigned int  numComponents = this->GetNumberOfComponents();
+  const ImageIORegion regionToWrite = this->GetIORegion();
+
+  // the chunk dimensions, in HDF5 order, include the pixel components
+  const H5::DSetCreatPropList plist = this->m_VoxelDataSet->getCreatePlist();
+  const int                   HDFDim = plist.getChunk(0, nullptr);
+  const auto                  chunkDims = make_unique_for_overwrite<hsize_t[]>(HDFDim);
+  plist.getChunk(HDFDim, chunkDims.get());
+
+  // the region, the chunk size and the range of chunks, in ITK order
+  std::vector<SizeValueType> start(numDims);
+  std::vector<SizeValueType> size(numDims);
+  std::vector<SizeValueType> chunkSize(numDims);
+  std::vector<SizeValueType> firstChunk(numDims);
+  std::vector<SizeValueType> numberOfChunks(numDims);
+  SizeValueType              totalNumberOfChunks = 1;
+  SizeValueType              chunkLength = 1;
+  for (unsigned int i = 0; i < numDims; ++i)
+  {
+    start[i] = i < regionToWrite.GetImageDimension() ? regionToWrite.GetIndex(i) : 0;
+    size[i] = i < regionToWrite.GetImageDimension() ? regionToWrite.GetSize(i) : 1;
+    chunkSize[i] = chunkDims[numDims - 1 - i];
+    const SizeValueType end = start[i] + size[i];
+    if (start[i] % chunkSize[i] != 0 || (end % chunkSize[i] != 0 && end != this->GetDimensions(i)))
+    {
+      return false;
+    }
+    firstChunk[i] = start[i] / chunkSize[i];
+    numberOfChunks[i] = (size[i] + chunkSize[i] - 1) / chunkSize[i];
+    totalNumberOfChunks *= numberOfChunks[i];
+    chunkLength *= chunkSize[i];
+  }
+  const SizeValueType        componentSize = this->GetComponentSize();
+  const SizeValueType        pixelSize = componentSize * numComponents;
+  const SizeValueType        chunkBytes = chunkLength * pixelSize;
+  std::vector<SizeValueType> regionStride(numDims, 1);
+  std::vector<SizeValueType> chunkStride(numDims, 1);
+  for (unsigned int i = 1; i < numDims; ++i)
+  {
+    regionStride[i] = regionStride[i - 1] * size[i - 1];
+    chunkStride[i] = chunkStride[i - 1] * chunkSize[i - 1];
+  }
+
+  // compress the chunks in parallel, the HDF5 library is not thread safe
+  std::vector<std::vector<Bytef>> compressedChunks(totalNumberOfChunks);
+  const auto *                    inputBuffer = static_cast<const char *>(buffer);
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    totalNumberOfChunks,
+    [&](SizeValueType chunkIndex) {
+      // copy the part of the region in the chunk, the rest of edge chunks
+      // is filled with zeros
+      std::vector<SizeValueType> chunkStart(numDims);
+      std::vector<SizeValueType> chunkExtent(numDims);
+      SizeValueType              remainder = chunkIndex;
+      for (unsigned int i = 0; i < numDims; ++i)
+      {
+        chunkStart[i] = (firstChunk[i] + remainder % numberOfChunks[i]) * chunkSize[i];
+        chunkExtent[i] = std::min(chunkSize[i], start[i] + size[i] - chunkStart[i]);
+        remainder /= numberOfChunks[i];
+      }
+      SizeValueType numberOfLines = 1;
+      for (unsigned int i = 1; i < numDims; ++i)
+      {
+        numberOfLines *= chunkExtent[i];
+      }
+      std::vector<char> chunk(chunkBytes);
+      for (SizeValueType lineIndex = 0; lineIndex < numberOfLines; ++lineIndex)
+      {
+        SizeValueType chunkOffset = 0;
+        SizeValueType regionOffset = chunkStart[0] - start[0];
+        SizeValueType lineRemainder = lineIndex;
+        for (unsigned int i = 1; i < numDims; ++i)
+        {
+          const SizeValueType position = lineRemainder % chunkExtent[i];
+          lineRemainder /= chunkExtent[i];
+          chunkOffset += position * chunkStride[i];
+          regionOffset += (chunkStart[i] - start[i] + position) * regionStride[i];
+        }
+        std::copy_n(
+          inputBuffer + regionOffset * pixelSize, chunkExtent[0] * pixelSize, chunk.data() + chunkOffset * pixelSize);
+      }
+
+      const char *      data = chunk.data();
+      std::vector<char> shuffledChunk;
+      if (m_ShuffleBeforeCompression && componentSize > 1)
+      {
+        // the same byte layout as the HDF5 shuffle filter
+        shuffledChunk.resize(chunkBytes);
+        const SizeValueType numberOfElements = chunkBytes / componentSize;
+        for (SizeValueType b = 0; b < componentSize; ++b)
+        {
+          for (SizeValueType e = 0; e < numberOfElements; ++e)
+          {
+            shuffledChunk[b * numberOfElements + e] = chunk[e * componentSize + b];
+          }
+        }
+        data = shuffledChunk.data();
+      }
+
+      std::vector<Bytef> & compressedChunk = compressedChunks[chunkIndex];
+      auto                 compressedLength = static_cast<uLongf>(compressBound(static_cast<uLong>(chunkBytes)));
+      compressedChunk.resize(compressedLength);
+      if (compress2(compressedChunk.data(),
+                    &compressedLength,
+                    reinterpret_cast<const Bytef *>(data),
+                    static_cast<uLong>(chunkBytes),
+                    this->GetCompressionLevel()) != Z_OK)
+      {
+        itkExceptionMacro(<< "Failed to compress a chunk of " << this->GetFileName());
+      }
+      compressedChunk.resize(compressedLength);
+    },
+    nullptr);
+
+  const auto offset = make_unique_for_overwrite<hsize_t[]>(HDFDim);
+  std::fill_n(offset.get(), HDFDim, 0);
+  for (SizeValueType chunkIndex = 0; chunkIndex < totalNumberOfChunks; ++chunkIndex)
+  {
+    SizeValueType remainder = chunkIndex;
+    for (unsigned int i = 0; i < numDims; ++i)
+    {
+      offset[numDims - 1 - i] = (firstChunk[i] + remainder % numberOfChunks[i]) * chunkSize[i];
+      remainder /= numberOfChunks[i];
+    }
+    const std::vector<Bytef> & compressedChunk = compressedChunks[chunkIndex];
+    if (H5Dwrite_chunk(
+          this->m_VoxelDataSet->getId(), H5P_DEFAULT, 0, offset.get(), compressedChunk.size(), compressedChunk.data()) <
+        0)
+    {
+      itkExceptionMacro(<< "Failed to write a chunk of " << this->GetFileName());
+    }
+    std::vector<Bytef>().swap(compressedChunks[chunkIndex]);
+  }
+  return true;
+#else
+  (void)buffer;
+  return false;
+#endif
+}
+
 //
 // GetHeaderSize -- return 0
 ImageIOBase::SizeType
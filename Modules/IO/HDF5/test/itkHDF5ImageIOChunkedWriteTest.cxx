@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHDF5ImageIO.h"
+#include "itkHDF5ImageIOFactory.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiThreaderBase.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+
+namespace
+{
+using PixelType = itk::Vector<short, 2>;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Streams the image from inputFileName to fileName, in the given number of
+// pieces, with the given chunk size and compressor, then reads the whole image
+// and regions of it.
+int
+TestChunkedWrite(const ImageType *                       image,
+                 const std::string &                     inputFileName,
+                 const std::string &                     fileName,
+                 const itk::HDF5ImageIO::ChunkSizeType & chunkSize,
+                 const std::string &                     compressor,
+                 unsigned int                            numberOfStreamDivisions)
+{
+  std::cout << "Writing " << fileName << " in " << numberOfStreamDivisions << " pieces, with " << compressor
+            << std::endl;
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto imageIO = itk::HDF5ImageIO::New();
+  imageIO->SetChunkSize(chunkSize);
+  imageIO->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->UseCompressionOn();
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+  writer = nullptr;
+
+  const ImageType::Pointer writtenImage = itk::ReadImage<ImageType>(fileName);
+  ITK_TEST_EXPECT_EQUAL(writtenImage->GetBufferedRegion(), image->GetBufferedRegion());
+  if (!itk::Testing::EqualInRegion<ImageType>(image, writtenImage, image->GetBufferedRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  for (const ImageType::RegionType & region : { ImageType::RegionType{ { { 0, 0, 6 } }, { { 21, 12, 2 } } },
+                                                ImageType::RegionType{ { { 4, 3, 1 } }, { { 9, 1, 7 } } },
+                                                ImageType::RegionType{ { { 20, 11, 8 } }, { { 1, 1, 1 } } } })
+  {
+    auto regionReader = itk::ImageFileReader<ImageType>::New();
+    regionReader->SetFileName(fileName);
+    regionReader->UseStreamingOn();
+    regionReader->UpdateOutputInformation();
+    regionReader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(regionReader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<ImageType>(image, regionReader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkHDF5ImageIOChunkedWriteTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ObjectFactoryBase::RegisterFactory(itk::HDF5ImageIOFactory::New());
+
+  const std::string prefix = std::string(argv[1]) + "/itkHDF5ImageIOChunkedWriteTest";
+
+  auto imageIO = itk::HDF5ImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize().empty());
+  ITK_TEST_SET_GET_VALUE(std::string(""), imageIO->GetCompressor());
+  const itk::HDF5ImageIO::ChunkSizeType chunkSize{ 8, 8, 4 };
+  imageIO->SetChunkSize(chunkSize);
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize() == chunkSize);
+  imageIO->SetCompressor("ShuffleDeflate");
+  ITK_TEST_SET_GET_VALUE(std::string("ShuffleDeflate"), imageIO->GetCompressor());
+  imageIO->SetCompressor("Unknown");
+  ITK_TEST_SET_GET_VALUE(std::string(""), imageIO->GetCompressor());
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 21, 12, 9 } });
+  image->Allocate();
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Value()[0] = static_cast<short>(index[0] + 10 * index[1] + 100 * index[2]);
+    it.Value()[1] = static_cast<short>(-1000 * index[2]);
+  }
+  const std::string inputFileName = prefix + "Input.h5";
+  itk::WriteImage(image, inputFileName);
+
+  int testStatus = EXIT_SUCCESS;
+  for (const itk::ThreadIdType numberOfThreads : { 1, 4 })
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+    for (const char * compressor : { "Deflate", "ShuffleDeflate" })
+    {
+      const std::string name = prefix + compressor + std::to_string(numberOfThreads);
+
+      // Blocks covered by the whole image, or by the slices of each piece.
+      testStatus |= TestChunkedWrite(image, inputFileName, name + "Blocks.h5", { 8, 8, 4 }, compressor, 1);
+      testStatus |= TestChunkedWrite(image, inputFileName, name + "Slices.h5", { 8, 8, 1 }, compressor, 5);
+
+      // Pieces that only cover parts of the chunks, and chunks clamped to the
+      // image, or spanning a whole dimension.
+      testStatus |= TestChunkedWrite(image, inputFileName, name + "Pieces.h5", { 8, 8, 4 }, compressor, 5);
+      testStatus |= TestChunkedWrite(image, inputFileName, name + "Clamped.h5", { 0, 64 }, compressor, 1);
+    }
+  }
+
+  // The chunks are compressed.
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileLength(prefix + "Deflate1Blocks.h5") <
+                       itksys::SystemTools::FileLength(inputFileName));
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
@@ -167,6 +167,13 @@ protected:
                                  OutputPixelType *      outputData,
                                  size_t                 size);
 
+  /** Returns the output buffer as an array of components, when the output
+   * pixels consist only of their components, or nullptr otherwise. The
+   * conversions that preserve the components cast them through this array, in
+   * SIMD or vectorized loops. */
+  static OutputComponentType *
+  GetContiguousOutputComponents(OutputPixelType * outputData);
+
   /** the most common case, where InputComponentType == unsigned
    *  char, the alpha is in the range 0..255. I presume in the
    *  mythical world of rgba<X> for all integral scalar types X, alpha
@@ -20,11 +20,103 @@
 
 #include "itkRGBPixel.h"
 #include "itkDefaultConvertPixelTraits.h"
+#include <algorithm>
 #include <cstddef>
 
+#if !defined(ITK_WRAPPING_PARSER)
+#  if defined(ITK_COMPILER_SUPPORTS_SSE2_32) || defined(ITK_COMPILER_SUPPORTS_SSE2_64)
+#    include <emmintrin.h>
+#    define ITK_CONVERTPIXELBUFFER_USE_SSE2
+#  elif defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define ITK_CONVERTPIXELBUFFER_USE_NEON
+#  endif
+#endif
+
 
 namespace itk
 {
+namespace ConvertPixelBufferDetail
+{
+// Casts num components in a plain loop, that the compiler vectorizes, or with
+// SIMD instructions for the 16 bit integers converted to float. Components of
+// the same type are copied.
+template <typename TInput, typename TOutput>
+inline void
+CastComponents(const TInput * input, TOutput * output, size_t num)
+{
+  if constexpr (std::is_same_v<TInput, TOutput>)
+  {
+    std::copy_n(input, num, output);
+  }
+  else
+  {
+    size_t i = 0;
+    if constexpr (std::is_same_v<TOutput, float> &&
+                  (std::is_same_v<TInput, short> || std::is_same_v<TInput, unsigned short>))
+    {
+#if defined(ITK_CONVERTPIXELBUFFER_USE_SSE2)
+      for (; i + 8 <= num; i += 8)
+      {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        __m128i       low;
+        __m128i       high;
+        if constexpr (std::is_signed_v<TInput>)
+        {
+          // Sign extended by an arithmetic shift of the values duplicated in both halves.
+          low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+          high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+        }
+        else
+        {
+          low = _mm_unpacklo_epi16(values, _mm_setzero_si128());
+          high = _mm_unpackhi_epi16(values, _mm_setzero_si128());
+        }
+        _mm_storeu_ps(output + i, _mm_cvtepi32_ps(low));
+        _mm_storeu_ps(output + i + 4, _mm_cvtepi32_ps(high));
+      }
+#elif defined(ITK_CONVERTPIXELBUFFER_USE_NEON)
+      for (; i + 8 <= num; i += 8)
+      {
+        if constexpr (std::is_signed_v<TInput>)
+        {
+          const int16x8_t values = vld1q_s16(input + i);
+          vst1q_f32(output + i, vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))));
+          vst1q_f32(output + i + 4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))));
+        }
+        else
+        {
+          const uint16x8_t values = vld1q_u16(input + i);
+          vst1q_f32(output + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(values))));
+          vst1q_f32(output + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(values))));
+        }
+      }
+#endif
+    }
+    for (; i < num; ++i)
+    {
+      output[i] = static_cast<TOutput>(input[i]);
+    }
+  }
+}
+} // namespace ConvertPixelBufferDetail
+
+template <typename InputPixelType, typename OutputPixelType, typename OutputConvertTraits>
+auto
+ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::GetContiguousOutputComponents(
+  OutputPixelType * outputData) -> OutputComponentType *
+{
+  if constexpr (std::is_same_v<OutputConvertTraits, DefaultConvertPixelTraits<OutputPixelType>>)
+  {
+    // Pixels made of their components only, as scalars, RGBPixel, Vector or
+    // std::complex. VariableLengthVector reports no component here.
+    if (sizeof(OutputPixelType) == OutputConvertTraits::GetNumberOfComponents() * sizeof(OutputComponentType))
+    {
+      return reinterpret_cast<OutputComponentType *>(outputData);
+    }
+  }
+  return nullptr;
+}
 
 template <typename InputPixelType, typename OutputPixelType, typename OutputConvertTraits>
 template <typename UComponentType>
@@ -169,6 +261,11 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   OutputPixelType *      outputData,
   size_t                 size)
 {
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, size);
+    return;
+  }
   const InputPixelType * endInput = inputData + size;
 
   while (inputData != endInput)
@@ -315,6 +412,11 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   OutputPixelType *      outputData,
   size_t                 size)
 {
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, size * 3);
+    return;
+  }
   const InputPixelType * endInput = inputData + size * 3;
 
   while (inputData != endInput)
@@ -336,6 +438,17 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
 {
   const InputPixelType * endInput = inputData + size * 4;
 
+  if (OutputComponentType * outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    // Plain loop over the components, that the compiler vectorizes.
+    for (; inputData != endInput; inputData += 4, outputComponents += 3)
+    {
+      outputComponents[0] = static_cast<OutputComponentType>(inputData[0]);
+      outputComponents[1] = static_cast<OutputComponentType>(inputData[1]);
+      outputComponents[2] = static_cast<OutputComponentType>(inputData[2]);
+    }
+    return;
+  }
   while (inputData != endInput)
   {
     OutputConvertTraits::SetNthComponent(0, *outputData, static_cast<OutputComponentType>(*inputData));
@@ -438,6 +551,11 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   OutputPixelType *      outputData,
   size_t                 size)
 {
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, size * 4);
+    return;
+  }
   const InputPixelType * endInput = inputData + size * 4;
 
   while (inputData != endInput)
@@ -500,6 +618,16 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   int outputNumberOfComponents = OutputConvertTraits::GetNumberOfComponents();
   int componentCount = std::min(inputNumberOfComponents, outputNumberOfComponents);
 
+  if (inputNumberOfComponents == outputNumberOfComponents)
+  {
+    if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+    {
+      ConvertPixelBufferDetail::CastComponents(
+        inputData, outputComponents, size * static_cast<size_t>(inputNumberOfComponents));
+      return;
+    }
+  }
+
   for (size_t i = 0; i < size; ++i)
   {
     for (int c = 0; c < componentCount; ++c)
@@ -523,6 +651,11 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   OutputPixelType *      outputData,
   size_t                 size)
 {
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, size * 6);
+    return;
+  }
   for (size_t i = 0; i < size; ++i)
   {
     OutputConvertTraits::SetNthComponent(0, *outputData, static_cast<OutputComponentType>(*inputData));
@@ -563,6 +696,11 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
   OutputPixelType *      outputData,
   size_t                 size)
 {
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, size * 2);
+    return;
+  }
   const InputPixelType * endInput = inputData + size * 2;
 
   while (inputData != endInput)
@@ -623,6 +761,12 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
 {
   size_t length = size * static_cast<size_t>(inputNumberOfComponents);
 
+  if (OutputComponentType * const outputComponents = GetContiguousOutputComponents(outputData))
+  {
+    ConvertPixelBufferDetail::CastComponents(inputData, outputComponents, length);
+    return;
+  }
+
   for (size_t i = 0; i < length; ++i)
   {
     OutputConvertTraits::SetNthComponent(0, *outputData, static_cast<OutputComponentType>(*inputData));
@@ -632,4 +776,7 @@ ConvertPixelBuffer<InputPixelType, OutputPixelType, OutputConvertTraits>::Conver
 }
 } // end namespace itk
 
+#undef ITK_CONVERTPIXELBUFFER_USE_SSE2
+#undef ITK_CONVERTPIXELBUFFER_USE_NEON
+
 #endif
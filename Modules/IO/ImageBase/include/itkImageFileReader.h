@@ -22,12 +22,16 @@
 #include "ITKIOImageBaseExport.h"
 
 #include "itkImageIOBase.h"
+#include "itkMemoryMappedFile.h"
 #include "itkImageSource.h"
 #include "itkMacro.h"
 #include "itkImageRegion.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
 
+#include <future>
+#include <memory>
+
 namespace itk
 {
 
@@ -46,6 +50,9 @@ namespace itk
  * then specified by TOutputImage, than this filter converts data
  * between the file type and the external expected type.  The
  * `ConvertPixelTraits` template parameter is used to do the conversion.
+ * When the converted pixels are not smaller than those of the file, the
+ * file is read into the output buffer and converted there, block by block,
+ * so that no buffer of the size of the image is needed.
  *
  * A Pluggable factory pattern is used this allows different kinds of readers
  * to be registered (even at run time) without having to modify the
@@ -118,9 +125,40 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the output buffer is memory mapped from the file,
+   * instead of read, when possible: when the ImageIO supports it for the file
+   * (see ImageIOBase::CanMemoryMapRead()), the whole image is read, its
+   * pixels need no conversion, and they are aligned in the file (which is
+   * typically the case with a detached header, or a NIfTI file). The pixels
+   * are then only read from the disk when accessed. Off by default.
+   * \sa MemoryMappedImageContainer */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get the access mode of the memory mapped output buffer.
+   * CopyOnWrite (the default) allows the output to be modified, for instance
+   * by a filter running in place, without modifying the file. ReadOnly
+   * requires the output not to be modified: writing to it is a segmentation
+   * fault. */
+  itkSetEnumMacro(MemoryMappingAccessMode, MemoryMappedFileEnums::AccessMode);
+  itkGetEnumMacro(MemoryMappingAccessMode, MemoryMappedFileEnums::AccessMode);
+
+  /** Set/Get whether, when the output is streamed, the region expected to be
+   * requested next is read ahead by a background thread, with a clone of the
+   * ImageIO, while the current one is processed downstream, so that reading
+   * the file overlaps with the computation. The next region is predicted
+   * from the last ones, as advancing along a single dimension, like the
+   * pieces of ImageRegionSplitterSlowDimension (used by StreamingImageFilter
+   * and by ImageFileWriter). A requested region that is not inside the region
+   * read ahead is read as usual. Off by default. */
+  itkSetMacro(UsePrefetching, bool);
+  itkGetConstMacro(UsePrefetching, bool);
+  itkBooleanMacro(UsePrefetching);
+
 protected:
   ImageFileReader();
-  ~ImageFileReader() override = default;
+  ~ImageFileReader() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -128,6 +166,11 @@ protected:
   void
   DoConvertBuffer(const void * inputData, size_t numberOfPixels);
 
+  /** Convert a block of pixels from one type to another, into the output
+   * buffer starting at its pixel firstOutputPixel. */
+  void
+  DoConvertBuffer(const void * inputData, size_t numberOfPixels, size_t firstOutputPixel);
+
   /** Test whether the given filename exist and it is readable, this
    * is intended to be called before attempting to use  ImageIO
    * classes for actually reading the file. If the file doesn't exist
@@ -153,6 +196,11 @@ protected:
   void
   GenerateData() override;
 
+  /** Map the output buffer from the file, if UseMemoryMapping is on and the
+   * pixels can be mapped. Returns whether the output was mapped. */
+  bool
+  MemoryMapOutput();
+
   ImageIOBase::Pointer m_ImageIO{};
 
   bool m_UserSpecifiedImageIO{}; // keep track whether the
@@ -160,12 +208,40 @@ protected:
 
   bool m_UseStreaming{};
 
+  bool                              m_UseMemoryMapping{ false };
+  MemoryMappedFileEnums::AccessMode m_MemoryMappingAccessMode{ MemoryMappedFileEnums::AccessMode::CopyOnWrite };
+
+  bool m_UsePrefetching{ false };
+
 private:
+  /** Read the m_ActualIORegion into the buffer, copying it from the pixels
+   * read ahead when they contain it. */
+  void
+  ReadActualIORegion(void * buffer);
+
+  /** Start reading ahead the region predicted to be requested after the
+   * m_ActualIORegion. */
+  void
+  StartPrefetching();
+
+  /** Wait for the region being read ahead, if any. Its pixels are discarded
+   * when the reading failed. */
+  void
+  WaitForPrefetching();
+
   std::string m_ExceptionMessage{};
 
   // The region that the ImageIO class will return when we ask to
   // produce the requested region.
   ImageIORegion m_ActualIORegion{};
+
+  // The region read before the m_ActualIORegion, and the region read ahead,
+  // into m_PrefetchBuffer, by m_Prefetching.
+  ImageIORegion           m_PreviousIORegion{};
+  ImageIORegion           m_PrefetchedIORegion{};
+  std::unique_ptr<char[]> m_PrefetchBuffer{};
+  size_t                  m_PrefetchBufferSize{ 0 };
+  std::future<void>       m_Prefetching{};
 };
 
 
@@ -24,6 +24,7 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
 #include "itkMakeUniqueForOverwrite.h"
@@ -40,6 +41,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::ImageFileReader()
   m_UseStreaming = true;
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+ImageFileReader<TOutputImage, ConvertPixelTraits>::~ImageFileReader()
+{
+  this->WaitForPrefetching();
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os, Indent indent) const
@@ -50,9 +57,13 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   os << indent << "UserSpecifiedImageIO: " << (m_UserSpecifiedImageIO ? "On" : "Off") << std::endl;
   os << indent << "UseStreaming: " << (m_UseStreaming ? "On" : "Off") << std::endl;
+  os << indent << "UseMemoryMapping: " << (m_UseMemoryMapping ? "On" : "Off") << std::endl;
+  os << indent << "MemoryMappingAccessMode: " << m_MemoryMappingAccessMode << std::endl;
+  os << indent << "UsePrefetching: " << (m_UsePrefetching ? "On" : "Off") << std::endl;
 
   os << indent << "ExceptionMessage: " << m_ExceptionMessage << std::endl;
   os << indent << "ActualIORegion: " << m_ActualIORegion << std::endl;
+  os << indent << "PrefetchedIORegion: " << m_PrefetchedIORegion << std::endl;
 }
 
 template <typename TOutputImage, typename ConvertPixelTraits>
@@ -76,6 +87,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateOutputInformation()
 
   itkDebugMacro(<< "Reading file for GenerateOutputInformation()" << this->GetFileName());
 
+  // The file, or the ImageIO, may have changed since the pixels were read
+  // ahead.
+  this->WaitForPrefetching();
+  m_PrefetchedIORegion = ImageIORegion();
+  m_PreviousIORegion = ImageIORegion();
+
   // Check to see if we can read the file given the name or prefix
   //
   if (this->GetFileName().empty())
@@ -305,6 +322,9 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::EnlargeOutputRequestedRegion(
 
   ImageIOAdaptor::Convert(imageRequestedRegion, ioRequestedRegion, largestRegion.GetIndex());
 
+  // The ImageIO may be reading ahead.
+  this->WaitForPrefetching();
+
   // Tell the IO if we should use streaming while reading
   m_ImageIO->SetUseStreamedReading(m_UseStreaming);
 
@@ -359,6 +379,12 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << '\n');
 
+  if (m_UseMemoryMapping && this->MemoryMapOutput())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
   // allocated the output image to the size of the enlarge requested region
   this->AllocateOutputs();
 
@@ -379,6 +405,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   }
 
   // Tell the ImageIO to read the file
+  this->WaitForPrefetching();
   m_ImageIO->SetFileName(this->GetFileName().c_str());
 
   itkDebugMacro(<< "Setting imageIO IORegion to: " << m_ActualIORegion);
@@ -402,12 +429,46 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
                   << ConvertPixelTraits::GetNumberOfComponents() << " m_ImageIO->NumComponents "
                   << m_ImageIO->GetNumberOfComponents());
 
-    const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
-
     // See note below as to why the buffered region is needed and
     // not actualIORegion
-    this->DoConvertBuffer(static_cast<void *>(loadBuffer.get()), output->GetBufferedRegion().GetNumberOfPixels());
+    const size_t numberOfPixels = output->GetBufferedRegion().GetNumberOfPixels();
+    const size_t sizeOfOutputBuffer =
+      output->GetPixelContainer()->Size() * sizeof(typename TOutputImage::PixelContainer::Element);
+
+    if (std::is_trivially_copyable<OutputImagePixelType>::value && numberOfPixels > 0 &&
+        m_ActualIORegion.GetNumberOfPixels() == numberOfPixels && sizeOfActualIORegion <= sizeOfOutputBuffer)
+    {
+      itkDebugMacro(<< "Converting the pixels in place, in the output buffer");
+
+      // The file pixels are read into the output buffer, where they are
+      // converted in cache sized blocks, from the last one: as the converted
+      // pixels are not smaller than the file pixels, a converted block only
+      // overwrites the file pixels of the block itself, copied beforehand,
+      // and those of the following blocks, already converted.
+      char * const     outputBytes = reinterpret_cast<char *>(output->GetPixelContainer()->GetBufferPointer());
+      const size_t     sizeOfInputPixel = sizeOfActualIORegion / numberOfPixels;
+      constexpr size_t sizeOfBlock = 256 * 1024;
+      const size_t     pixelsPerBlock = std::max(sizeOfBlock / sizeOfInputPixel, size_t{ 1 });
+      const auto       blockBuffer = make_unique_for_overwrite<char[]>(pixelsPerBlock * sizeOfInputPixel);
+
+      this->ReadActualIORegion(static_cast<void *>(outputBytes));
+      for (size_t blockEnd = numberOfPixels; blockEnd > 0;)
+      {
+        const size_t blockStart = blockEnd - std::min(blockEnd, pixelsPerBlock);
+        std::copy_n(outputBytes + blockStart * sizeOfInputPixel,
+                    (blockEnd - blockStart) * sizeOfInputPixel,
+                    blockBuffer.get());
+        this->DoConvertBuffer(static_cast<void *>(blockBuffer.get()), blockEnd - blockStart, blockStart);
+        blockEnd = blockStart;
+      }
+    }
+    else
+    {
+      const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
+      this->ReadActualIORegion(static_cast<void *>(loadBuffer.get()));
+
+      this->DoConvertBuffer(static_cast<void *>(loadBuffer.get()), numberOfPixels);
+    }
   }
   else if (m_ActualIORegion.GetNumberOfPixels() != output->GetBufferedRegion().GetNumberOfPixels())
   {
@@ -421,7 +482,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
 
     const auto loadBuffer = make_unique_for_overwrite<char[]>(sizeOfActualIORegion);
-    m_ImageIO->Read(static_cast<void *>(loadBuffer.get()));
+    this->ReadActualIORegion(static_cast<void *>(loadBuffer.get()));
 
     // we use std::copy_n here as it should be optimized to memcpy for
     // plain old data, but still is object oriented programming
@@ -434,19 +495,245 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
     itkDebugMacro(<< "No buffer conversion required.");
 
     OutputImagePixelType * outputBuffer = output->GetPixelContainer()->GetBufferPointer();
-    m_ImageIO->Read(outputBuffer);
+    this->ReadActualIORegion(outputBuffer);
   }
 
+  if (m_UsePrefetching)
+  {
+    this->StartPrefetching();
+  }
+  m_PreviousIORegion = m_ActualIORegion;
+
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MemoryMapOutput()
+{
+  using PixelContainerType = typename TOutputImage::PixelContainer;
+  using MemoryMappedContainerType =
+    MemoryMappedImageContainer<typename PixelContainerType::ElementIdentifier, typename PixelContainerType::Element>;
+
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // Only the whole image can be mapped, when its pixels need no conversion.
+  for (unsigned int i = 0; i < m_ActualIORegion.GetImageDimension(); ++i)
+  {
+    if (m_ActualIORegion.GetIndex(i) != 0 || m_ActualIORegion.GetSize(i) != m_ImageIO->GetDimensions(i))
+    {
+      return false;
+    }
+  }
+  if (m_ActualIORegion.GetNumberOfPixels() != output->GetRequestedRegion().GetNumberOfPixels())
+  {
+    return false;
+  }
+  const bool isVectorImage(strcmp(output->GetNameOfClass(), "VectorImage") == 0);
+  if (m_ImageIO->GetComponentType() != ImageIOBase::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType ||
+      (m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents() &&
+       !(isVectorImage && m_ImageIO->GetNumberOfComponents() == output->GetNumberOfComponentsPerPixel())))
+  {
+    return false;
+  }
+
+  std::string   dataFileName;
+  SizeValueType dataOffset = 0;
+  if (!m_ImageIO->CanMemoryMapRead(dataFileName, dataOffset) ||
+      dataOffset % alignof(typename PixelContainerType::Element) != 0)
+  {
+    return false;
+  }
+
+  const SizeValueType numberOfBytes =
+    m_ActualIORegion.GetNumberOfPixels() * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+
+  itkDebugMacro(<< "Memory mapping " << numberOfBytes << " bytes at offset " << dataOffset << " of " << dataFileName);
+
+  auto container = MemoryMappedContainerType::New();
+  container->MapFile(dataFileName,
+                     dataOffset,
+                     numberOfBytes / sizeof(typename PixelContainerType::Element),
+                     m_MemoryMappingAccessMode);
+  output->SetBufferedRegion(output->GetRequestedRegion());
+  output->SetPixelContainer(container);
+  return true;
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::ReadActualIORegion(void * buffer)
+{
+  const ImageIORegion prefetchedRegion = m_PrefetchedIORegion;
+  m_PrefetchedIORegion = ImageIORegion();
+
+  const unsigned int dimension = m_ActualIORegion.GetImageDimension();
+  if (dimension == 0 || prefetchedRegion.GetImageDimension() != dimension ||
+      !prefetchedRegion.IsInside(m_ActualIORegion))
+  {
+    m_ImageIO->Read(buffer);
+    return;
+  }
+
+  itkDebugMacro(<< "Copying " << m_ActualIORegion << " from the pixels read ahead");
+
+  // Copy the region line by line, along the first dimension.
+  const size_t pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  const size_t lineSize = m_ActualIORegion.GetSize(0) * pixelSize;
+  const size_t numberOfLines =
+    m_ActualIORegion.GetNumberOfPixels() / std::max(m_ActualIORegion.GetSize(0), SizeValueType{ 1 });
+  char * const destination = static_cast<char *>(buffer);
+  for (size_t line = 0; line < numberOfLines; ++line)
+  {
+    size_t offset = 0;
+    size_t stride = 1;
+    size_t remainder = line;
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      const size_t position = i == 0 ? 0 : remainder % m_ActualIORegion.GetSize(i);
+      if (i > 0)
+      {
+        remainder /= m_ActualIORegion.GetSize(i);
+      }
+      offset += (static_cast<size_t>(m_ActualIORegion.GetIndex(i) - prefetchedRegion.GetIndex(i)) + position) * stride;
+      stride *= prefetchedRegion.GetSize(i);
+    }
+    std::copy_n(m_PrefetchBuffer.get() + offset * pixelSize, lineSize, destination + line * lineSize);
+  }
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::StartPrefetching()
+{
+  const unsigned int dimension = m_ActualIORegion.GetImageDimension();
+  const auto         getImageSize = [this](unsigned int i) -> SizeValueType {
+    return i < m_ImageIO->GetNumberOfDimensions() ? m_ImageIO->GetDimensions(i) : 1;
+  };
+
+  // The region requested next is predicted to advance along the dimension
+  // along which the last region advanced from the previous one, by as much.
+  // After a first region, it is predicted to follow it along the last
+  // dimension that it does not span.
+  unsigned int   advancingDimension = dimension;
+  IndexValueType startStep = 0;
+  IndexValueType endStep = 0;
+  if (m_PreviousIORegion.GetImageDimension() == dimension)
+  {
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      if (m_ActualIORegion.GetIndex(i) != m_PreviousIORegion.GetIndex(i) ||
+          m_ActualIORegion.GetSize(i) != m_PreviousIORegion.GetSize(i))
+      {
+        advancingDimension = advancingDimension == dimension ? i : dimension + 1;
+      }
+    }
+  }
+  if (advancingDimension < dimension)
+  {
+    const unsigned int i = advancingDimension;
+    startStep = m_ActualIORegion.GetIndex(i) - m_PreviousIORegion.GetIndex(i);
+    endStep = startStep + static_cast<IndexValueType>(m_ActualIORegion.GetSize(i)) -
+              static_cast<IndexValueType>(m_PreviousIORegion.GetSize(i));
+  }
+  else
+  {
+    advancingDimension = dimension;
+    for (unsigned int i = dimension; i-- > 0;)
+    {
+      if (m_ActualIORegion.GetSize(i) != getImageSize(i))
+      {
+        advancingDimension = i;
+        startStep = static_cast<IndexValueType>(m_ActualIORegion.GetSize(i));
+        endStep = startStep;
+        break;
+      }
+    }
+  }
+  if (advancingDimension >= dimension || startStep < 0 || endStep <= 0)
+  {
+    return;
+  }
+
+  const unsigned int   i = advancingDimension;
+  const IndexValueType imageEnd = static_cast<IndexValueType>(getImageSize(i));
+  const IndexValueType lastEnd =
+    m_ActualIORegion.GetIndex(i) + static_cast<IndexValueType>(m_ActualIORegion.GetSize(i));
+  const IndexValueType start = m_ActualIORegion.GetIndex(i) + startStep;
+  const IndexValueType end = std::min(lastEnd + endStep, imageEnd);
+  if (start >= end)
+  {
+    return;
+  }
+  ImageIORegion predictedRegion = m_ActualIORegion;
+  predictedRegion.SetIndex(i, start);
+  predictedRegion.SetSize(i, static_cast<SizeValueType>(end - start));
+  const ImageIORegion prefetchedRegion = m_ImageIO->GenerateStreamableReadRegionFromRequestedRegion(predictedRegion);
+
+  const size_t numberOfBytes =
+    prefetchedRegion.GetNumberOfPixels() * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  if (m_PrefetchBufferSize < numberOfBytes)
+  {
+    m_PrefetchBuffer = make_unique_for_overwrite<char[]>(numberOfBytes);
+    m_PrefetchBufferSize = numberOfBytes;
+  }
+
+  itkDebugMacro(<< "Reading ahead " << prefetchedRegion);
+
+  // The region is read ahead by a clone of the ImageIO, so that the IO region
+  // of the ImageIO remains the region read last, and that the ImageIO can be
+  // used while reading ahead.
+  m_PrefetchedIORegion = prefetchedRegion;
+  const LightObject::Pointer imageIO = m_ImageIO->Clone();
+  const std::string          fileName = this->GetFileName();
+  char * const               buffer = m_PrefetchBuffer.get();
+  m_Prefetching = std::async(std::launch::async, [imageIO, fileName, buffer, prefetchedRegion] {
+    auto * const prefetchingImageIO = static_cast<ImageIOBase *>(imageIO.GetPointer());
+    prefetchingImageIO->SetFileName(fileName);
+    prefetchingImageIO->ReadImageInformation();
+    prefetchingImageIO->SetIORegion(prefetchedRegion);
+    prefetchingImageIO->Read(buffer);
+  });
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::WaitForPrefetching()
+{
+  if (!m_Prefetching.valid())
+  {
+    return;
+  }
+  try
+  {
+    m_Prefetching.get();
+  }
+  catch (const std::exception & error)
+  {
+    // The region is read again, and the error reported, when it is requested.
+    itkDebugMacro(<< "Reading ahead failed: " << error.what());
+    m_PrefetchedIORegion = ImageIORegion();
+  }
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData, size_t numberOfPixels)
 {
+  this->DoConvertBuffer(inputData, numberOfPixels, 0);
+}
+
+template <typename TOutputImage, typename ConvertPixelTraits>
+void
+ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(const void * inputData,
+                                                                   size_t       numberOfPixels,
+                                                                   size_t       firstOutputPixel)
+{
+  bool isVectorImage(strcmp(this->GetOutput()->GetNameOfClass(), "VectorImage") == 0);
   // get the pointer to the destination buffer
-  OutputImagePixelType * outputData = this->GetOutput()->GetPixelContainer()->GetBufferPointer();
-  bool                   isVectorImage(strcmp(this->GetOutput()->GetNameOfClass(), "VectorImage") == 0);
+  OutputImagePixelType * outputData =
+    this->GetOutput()->GetPixelContainer()->GetBufferPointer() +
+    firstOutputPixel * (isVectorImage ? this->GetOutput()->GetNumberOfComponentsPerPixel() : 1);
   // TODO:
   // Pass down the PixelType (RGB, VECTOR, etc.) so that any vector to
   // scalar conversion be type specific. i.e. RGB to scalar would use
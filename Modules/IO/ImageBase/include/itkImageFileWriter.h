@@ -24,6 +24,8 @@
 #include "itkMacro.h"
 #include "itkMetaProgrammingLibrary.h"
 
+#include <future>
+
 namespace itk
 {
 /** \brief Base exception class for IO problems during writing.
@@ -170,6 +172,15 @@ public:
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get the memory budget, in bytes, of the upstream pipeline. When it
+   * is not 0, the number of pieces is chosen automatically, instead of
+   * NumberOfStreamDivisions, as the smallest number supported by the ImageIO
+   * whose pieces fit in the budget. The memory of a piece is estimated by
+   * propagating its region upstream, as explained in PipelineMemory.
+   * Defaults to 0. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
   /** Aliased to the Write() method to be consistent with the rest of the
    * pipeline. */
   void
@@ -211,6 +222,28 @@ public:
   itkGetConstReferenceMacro(UseInputMetaDataDictionary, bool);
   itkBooleanMacro(UseInputMetaDataDictionary);
 
+  /** Write the input asynchronously. The input is updated by the caller, and
+   * its pixels are snapshot; the image is then encoded and written by the
+   * thread of the ImageWriteExecutor, while the caller goes on. The returned
+   * future is ready when the file is written, and rethrows the exception of
+   * the write, if any. The call blocks while the queue of the executor is
+   * full.
+   *
+   * The settings of this writer are those of the write. The ImageIO, when
+   * it is set, is cloned with its current options: the write does not use
+   * it, and changing it afterwards does not affect the writes queued. */
+#if !defined(ITK_WRAPPING_PARSER)
+  std::future<void>
+  WriteAsync();
+#endif
+
+  /** Set/Get whether WriteAsync() copies the pixels of the input. When off,
+   * the write shares the pixel buffer of the input, which must then not be
+   * modified until the write is finished. On by default. */
+  itkSetMacro(CopyInputForAsynchronousWrite, bool);
+  itkGetConstReferenceMacro(CopyInputForAsynchronousWrite, bool);
+  itkBooleanMacro(CopyInputForAsynchronousWrite);
+
 protected:
   ImageFileWriter() = default;
   ~ImageFileWriter() override = default;
@@ -222,6 +255,12 @@ protected:
   GenerateData() override;
 
 private:
+  /** Returns the smallest number of pieces of pasteIORegion, supported by
+   * the ImageIO, whose pieces fit in the memory budget. */
+  unsigned int
+  ComputeNumberOfStreamDivisionsForMemoryBudget(const ImageIORegion & pasteIORegion,
+                                                const ImageIORegion & largestIORegion);
+
   std::string m_FileName{};
 
   ImageIOBase::Pointer m_ImageIO{};
@@ -229,12 +268,14 @@ private:
 
   ImageIORegion m_PasteIORegion{ TInputImage::ImageDimension };
   unsigned int  m_NumberOfStreamDivisions{ 1 };
+  SizeValueType m_MemoryBudget{ 0 };
   bool          m_UserSpecifiedIORegion{ false };
 
   bool m_FactorySpecifiedImageIO{ false }; // did factory mechanism set the ImageIO?
   bool m_UseCompression{ false };
   int  m_CompressionLevel{ -1 };
   bool m_UseInputMetaDataDictionary{ true };
+  bool m_CopyInputForAsynchronousWrite{ true };
 };
 
 
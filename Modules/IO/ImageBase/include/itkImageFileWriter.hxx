@@ -31,6 +31,8 @@
 #include "itkDiffusionTensor3D.h"
 #include "itkMatrix.h"
 #include "itkImageAlgorithm.h"
+#include "itkImageWriteExecutor.h"
+#include "itkPipelineMemory.h"
 #include <complex>
 
 namespace itk
@@ -219,7 +221,7 @@ ImageFileWriter<TInputImage>::Write()
   // Notify start event observers
   this->InvokeEvent(StartEvent());
 
-  if (m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion)
+  if (m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion || m_MemoryBudget > 0)
   {
     m_ImageIO->SetUseStreamedWriting(true);
   }
@@ -251,8 +253,15 @@ ImageFileWriter<TInputImage>::Write()
   unsigned int numDivisions;
 
   // this may fail and throw an exception if the configuration is not supported
-  numDivisions =
-    m_ImageIO->GetActualNumberOfSplitsForWriting(m_NumberOfStreamDivisions, pasteIORegion, largestIORegion);
+  if (m_MemoryBudget > 0)
+  {
+    numDivisions = this->ComputeNumberOfStreamDivisionsForMemoryBudget(pasteIORegion, largestIORegion);
+  }
+  else
+  {
+    numDivisions =
+      m_ImageIO->GetActualNumberOfSplitsForWriting(m_NumberOfStreamDivisions, pasteIORegion, largestIORegion);
+  }
 
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
@@ -323,6 +332,116 @@ ImageFileWriter<TInputImage>::Write()
   this->ReleaseInputs();
 }
 
+//---------------------------------------------------------
+template <typename TInputImage>
+unsigned int
+ImageFileWriter<TInputImage>::ComputeNumberOfStreamDivisionsForMemoryBudget(const ImageIORegion & pasteIORegion,
+                                                                            const ImageIORegion & largestIORegion)
+{
+  auto *                     nonConstInput = const_cast<InputImageType *>(this->GetInput());
+  const InputImageRegionType largestRegion = nonConstInput->GetLargestPossibleRegion();
+
+  const auto pieceMemorySize = [&](const unsigned int piece, const unsigned int numberOfDivisions) {
+    const ImageIORegion streamIORegion =
+      m_ImageIO->GetSplitRegionForWriting(piece, numberOfDivisions, pasteIORegion, largestIORegion);
+    InputImageRegionType streamRegion;
+    ImageIORegionAdaptor<TInputImage::ImageDimension>::Convert(streamIORegion, streamRegion, largestRegion.GetIndex());
+    return PipelineMemory::EstimateMemorySize(nonConstInput, streamRegion);
+  };
+  const auto fitsInBudget = [&](const unsigned int numberOfDivisions) {
+    const SizeValueType memorySize = PipelineMemory::EstimateLargestPieceMemorySize(
+      numberOfDivisions, [&](const unsigned int piece) { return pieceMemorySize(piece, numberOfDivisions); });
+    return memorySize <= m_MemoryBudget;
+  };
+  const auto numberOfDivisions = [&](const unsigned int numberOfRequestedDivisions) {
+    return m_ImageIO->GetActualNumberOfSplitsForWriting(numberOfRequestedDivisions, pasteIORegion, largestIORegion);
+  };
+
+  const unsigned int numberOfDivisionsInBudget =
+    PipelineMemory::SearchSmallestNumberOfDivisions(numberOfDivisions, fitsInBudget);
+  if (numberOfDivisionsInBudget == 0)
+  {
+    const unsigned int maximumNumberOfDivisions = numberOfDivisions(NumericTraits<unsigned int>::max());
+    itkWarningMacro(<< "No division of the image fits in the memory budget of " << m_MemoryBudget
+                    << " bytes: writing it in " << maximumNumberOfDivisions << " pieces.");
+    return maximumNumberOfDivisions;
+  }
+  return numberOfDivisionsInBudget;
+}
+
+//---------------------------------------------------------
+template <typename TInputImage>
+std::future<void>
+ImageFileWriter<TInputImage>::WriteAsync()
+{
+  const InputImageType * input = this->GetInput();
+  if (input == nullptr)
+  {
+    itkExceptionMacro(<< "No input to writer!");
+  }
+  if (m_FileName.empty())
+  {
+    itkExceptionMacro(<< "No filename was specified");
+  }
+
+  // The input is updated here, as a whole, since the pipeline that produces
+  // it is not thread safe.
+  auto * nonConstInput = const_cast<InputImageType *>(input);
+  if (nonConstInput->GetSource())
+  {
+    nonConstInput->UpdateOutputInformation();
+    nonConstInput->SetRequestedRegionToLargestPossibleRegion();
+    nonConstInput->Update();
+  }
+
+  // The snapshot of the input holds a copy of its pixels, or shares them.
+  auto snapshot = InputImageType::New();
+  snapshot->CopyInformation(input);
+  snapshot->SetBufferedRegion(input->GetBufferedRegion());
+  snapshot->SetRequestedRegion(input->GetBufferedRegion());
+  snapshot->SetMetaDataDictionary(input->GetMetaDataDictionary());
+  if (m_CopyInputForAsynchronousWrite)
+  {
+    const auto   container = InputImageType::PixelContainer::New();
+    const size_t size = nonConstInput->GetPixelContainer()->Size();
+    container->Reserve(size);
+    std::copy_n(nonConstInput->GetPixelContainer()->GetBufferPointer(), size, container->GetBufferPointer());
+    snapshot->SetPixelContainer(container);
+  }
+  else
+  {
+    snapshot->SetPixelContainer(nonConstInput->GetPixelContainer());
+  }
+
+  // The write has its own writer, with the settings of this one.
+  const auto writer = Self::New();
+  writer->SetInput(snapshot);
+  writer->SetFileName(m_FileName);
+  if (m_ImageIO && !m_FactorySpecifiedImageIO)
+  {
+    // An ImageIO is not thread safe: the write has its own clone, with the
+    // current options, which later changes to the ImageIO do not affect.
+    const LightObject::Pointer imageIO = m_ImageIO->Clone();
+    auto *                     clonedImageIO = dynamic_cast<ImageIOBase *>(imageIO.GetPointer());
+    if (!m_UseInputMetaDataDictionary)
+    {
+      clonedImageIO->SetMetaDataDictionary(m_ImageIO->GetMetaDataDictionary());
+    }
+    writer->SetImageIO(clonedImageIO);
+  }
+  if (m_UserSpecifiedIORegion)
+  {
+    writer->SetIORegion(m_PasteIORegion);
+  }
+  writer->SetNumberOfStreamDivisions(m_NumberOfStreamDivisions);
+  writer->SetMemoryBudget(m_MemoryBudget);
+  writer->SetUseCompression(m_UseCompression);
+  writer->SetCompressionLevel(m_CompressionLevel);
+  writer->SetUseInputMetaDataDictionary(m_UseInputMetaDataDictionary);
+
+  return ImageWriteExecutor::GetInstance()->Submit([writer] { writer->Write(); });
+}
+
 //---------------------------------------------------------
 template <typename TInputImage>
 void
@@ -347,7 +466,7 @@ ImageFileWriter<TInputImage>::GenerateData()
   // before this test, bad stuff would happened when they don't match
   if (bufferedRegion != ioRegion)
   {
-    if (m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion)
+    if (m_NumberOfStreamDivisions > 1 || m_UserSpecifiedIORegion || m_MemoryBudget > 0)
     {
       itkDebugMacro("Requested stream region does not match generated output");
       itkDebugMacro("input filter may not support streaming well");
@@ -391,6 +510,7 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "IO Region: " << m_PasteIORegion << '\n';
   os << indent << "Number of Stream Divisions: " << m_NumberOfStreamDivisions << '\n';
+  os << indent << "MemoryBudget: " << m_MemoryBudget << '\n';
   os << indent << "CompressionLevel: " << m_CompressionLevel << '\n';
 
   if (m_UseCompression)
@@ -411,6 +531,8 @@ ImageFileWriter<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
     os << indent << "UseInputMetaDataDictionary: Off\n";
   }
 
+  os << indent << "CopyInputForAsynchronousWrite: " << (m_CopyInputForAsynchronousWrite ? "On" : "Off") << '\n';
+
   if (m_FactorySpecifiedImageIO)
   {
     os << indent << "FactorySpecifiedmageIO: On\n";
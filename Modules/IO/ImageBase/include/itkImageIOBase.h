@@ -431,6 +431,19 @@ public:
     return false;
   }
 
+  /** Determine if the pixels of the file, as described by the last call to
+   * ReadImageInformation(), are stored contiguously, uncompressed, in native
+   * byte order and with the layout of the buffer filled by Read(), so that
+   * they can be memory mapped instead of read. If so, dataFileName and
+   * dataOffset are set to the name of the file holding the pixels, and the
+   * offset in bytes of the first one. Default is false.
+   * \sa MemoryMappedImageContainer */
+  virtual bool
+  CanMemoryMapRead(std::string & itkNotUsed(dataFileName), SizeValueType & itkNotUsed(dataOffset))
+  {
+    return false;
+  }
+
   /** Read the spacing and dimensions of the image.
    * Assumes SetFileName has been called with a valid file name. */
   virtual void
@@ -683,6 +696,11 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Creates an ImageIO of the same type, with the same reading and writing
+   * options, but without the information of any file. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   virtual const ImageRegionSplitterBase *
   GetImageRegionSplitter() const;
 
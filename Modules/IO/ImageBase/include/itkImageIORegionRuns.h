@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageIORegionRuns_h
+#define itkImageIORegionRuns_h
+
+#include "itkImageIORegion.h"
+
+namespace itk
+{
+/** Calls runFunction(offset, length) for each of the contiguous runs of
+ * pixels of a region of an image, whose size along each dimension of the
+ * region is imageSize[d], in increasing order of their offset in the image,
+ * in pixels, until it returns false. Returns whether all the calls returned
+ * true.
+ *
+ * The leading dimensions that the region covers entirely are in one run,
+ * along with the first one that it does not, so that the pixels of the whole
+ * image are a single run.
+ *
+ * \ingroup ITKIOImageBase
+ */
+template <typename TImageSize, typename TRunFunction>
+bool
+ForEachImageIORegionRun(const ImageIORegion & region, const TImageSize & imageSize, TRunFunction runFunction)
+{
+  const unsigned int dimension = region.GetImageDimension();
+
+  unsigned int  runDimensions = 0;
+  SizeValueType runLength = 1;
+  while (runDimensions < dimension)
+  {
+    runLength *= region.GetSize(runDimensions);
+    const unsigned int d = runDimensions++;
+    if (region.GetIndex(d) != 0 || region.GetSize(d) != static_cast<SizeValueType>(imageSize[d]))
+    {
+      break;
+    }
+  }
+
+  ImageIORegion::IndexType index = region.GetIndex();
+  while (true)
+  {
+    SizeValueType offset = 0;
+    SizeValueType stride = 1;
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      offset += static_cast<SizeValueType>(index[d]) * stride;
+      stride *= static_cast<SizeValueType>(imageSize[d]);
+    }
+    if (!runFunction(offset, runLength))
+    {
+      return false;
+    }
+
+    unsigned int d = runDimensions;
+    for (; d < dimension; ++d)
+    {
+      if (++index[d] < region.GetIndex(d) + static_cast<IndexValueType>(region.GetSize(d)))
+      {
+        break;
+      }
+      index[d] = region.GetIndex(d);
+    }
+    if (d == dimension)
+    {
+      return true;
+    }
+  }
+}
+} // end namespace itk
+
+#endif
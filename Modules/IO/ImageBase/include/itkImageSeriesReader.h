@@ -35,6 +35,13 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * With UseParallelReading on, the files are read concurrently on the
+ * threads of the multi-threader, each directly into its slab of the output
+ * buffer when the ImageIO reads whole slices. At most one file per work unit
+ * is read at a time. A set ImageIO is not thread safe, so the files are read
+ * with clones of it, from ImageIOBase::Clone(), except for the last file,
+ * which is read by the ImageIO itself, as when reading sequentially.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -173,6 +180,12 @@ public:
   itkSetMacro(SpacingWarningRelThreshold, double);
   itkGetConstMacro(SpacingWarningRelThreshold, double);
 
+  /** Set/Get whether the files are read in parallel, on up to
+   * NumberOfWorkUnits threads. Off by default. */
+  itkSetMacro(UseParallelReading, bool);
+  itkGetConstMacro(UseParallelReading, bool);
+  itkBooleanMacro(UseParallelReading);
+
 protected:
   ImageSeriesReader()
     : m_ImageIO(nullptr)
@@ -215,12 +228,19 @@ protected:
 
   double m_SpacingWarningRelThreshold{ 1e-4 };
 
+  bool m_UseParallelReading{ false };
+
 private:
   using ReaderType = ImageFileReader<TOutputImage>;
 
   int
   ComputeMovingDimensionIndex(ReaderType * reader);
 
+  /** Reads the slice of the i-th file of the series with the reader, into
+   * its slab of the output buffer when the reader reads the whole slice. */
+  void
+  ReadSlice(ReaderType * reader, int i, const ImageRegionType & sliceRegionToRequest, const SizeType & validSize);
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime{};
 
@@ -25,8 +25,10 @@
 #include "itkMath.h"
 #include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
 #include <cstddef> // For ptrdiff_t.
 #include <iomanip>
+#include <memory>
 
 namespace itk
 {
@@ -55,6 +57,7 @@ ImageSeriesReader<TOutputImage>::PrintSelf(std::ostream & os, Indent indent) con
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "ForceOrthogonalDirection: " << m_ForceOrthogonalDirection << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "UseParallelReading: " << m_UseParallelReading << std::endl;
 
   itkPrintSelfObjectMacro(ImageIO);
 
@@ -291,15 +294,77 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   bool needToUpdateMetaDataDictionaryArray =
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime && m_MetaDataDictionaryArrayUpdate;
 
-  typename TOutputImage::InternalPixelType * outputBuffer = output->GetBufferPointer();
-  IndexType                                  sliceStartIndex = requestedRegion.GetIndex();
-  const auto                                 numberOfFiles = static_cast<int>(m_FileNames.size());
+  IndexType  sliceStartIndex = requestedRegion.GetIndex();
+  const auto numberOfFiles = static_cast<int>(m_FileNames.size());
 
   typename TOutputImage::PointType   prevSliceOrigin = output->GetOrigin();
   typename TOutputImage::SpacingType outputSpacing = output->GetSpacing();
   double                             maxSpacingDeviation = 0.0;
   bool                               prevSliceIsValid = false;
 
+  const auto isInsideRequestedRegion = [this, &requestedRegion](int i) {
+    IndexType index = requestedRegion.GetIndex();
+    if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+    {
+      index[this->m_NumberOfDimensionsInImage] = i;
+    }
+    return requestedRegion.IsInside(index);
+  };
+  const auto createReader = [this, &sliceRegionToRequest](int iFileName, ImageIOBase * imageIO) {
+    auto reader = ReaderType::New();
+    reader->SetFileName(m_FileNames[iFileName].c_str());
+    if (imageIO)
+    {
+      reader->SetImageIO(imageIO);
+    }
+    reader->SetUseStreaming(m_UseStreaming);
+    reader->GetOutput()->SetRequestedRegion(sliceRegionToRequest);
+    return reader;
+  };
+
+  // In parallel, the slices inside the requested region are read first, and
+  // their origins and dictionaries are checked in order below.
+  std::vector<typename TOutputImage::PointType> readSliceOrigins;
+  std::vector<std::unique_ptr<DictionaryType>>  readSliceDictionaries;
+  if (m_UseParallelReading)
+  {
+    readSliceOrigins.resize(numberOfFiles);
+    readSliceDictionaries.resize(numberOfFiles);
+    int lastSliceToRead = numberOfFiles - 1;
+    while (lastSliceToRead >= 0 && !isInsideRequestedRegion(lastSliceToRead))
+    {
+      --lastSliceToRead;
+    }
+
+    this->GetMultiThreader()->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfFiles,
+      [&](SizeValueType slice) {
+        const auto i = static_cast<int>(slice);
+        if (!isInsideRequestedRegion(i))
+        {
+          return;
+        }
+        // The ImageIO cannot read several files at once.
+        LightObject::Pointer imageIO = m_ImageIO.GetPointer();
+        if (m_ImageIO && i != lastSliceToRead)
+        {
+          imageIO = m_ImageIO->Clone();
+        }
+        const auto reader =
+          createReader(m_ReverseOrder ? numberOfFiles - i - 1 : i, dynamic_cast<ImageIOBase *>(imageIO.GetPointer()));
+        this->ReadSlice(reader, i, sliceRegionToRequest, validSize);
+
+        readSliceOrigins[i] = reader->GetOutput()->GetOrigin();
+        if (needToUpdateMetaDataDictionaryArray)
+        {
+          readSliceDictionaries[i] = std::make_unique<DictionaryType>(reader->GetImageIO()->GetMetaDataDictionary());
+        }
+      },
+      this);
+  }
+
   for (int i = 0; i != numberOfFiles; ++i)
   {
     if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
@@ -318,18 +383,13 @@ ImageSeriesReader<TOutputImage>::GenerateData()
       continue;
     }
 
-    // configure reader
-    auto reader = ReaderType::New();
-    reader->SetFileName(m_FileNames[iFileName].c_str());
-
-    TOutputImage * readerOutput = reader->GetOutput();
-
-    if (m_ImageIO)
+    // configure reader, unless the slice has already been read in parallel
+    const bool                   sliceIsRead = m_UseParallelReading && insideRequestedRegion;
+    typename ReaderType::Pointer reader;
+    if (!sliceIsRead)
     {
-      reader->SetImageIO(m_ImageIO);
+      reader = createReader(iFileName, m_ImageIO);
     }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
 
     // update the data or info
     if (!insideRequestedRegion)
@@ -338,90 +398,18 @@ ImageSeriesReader<TOutputImage>::GenerateData()
     }
     else
     {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
-
-      // propagate the requested region to determine what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
-
-      // check that the size of each slice is the same
-      if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
-      {
-        itkExceptionMacro(<< "Size mismatch! The size of  " << m_FileNames[iFileName].c_str() << " is "
-                          << readerOutput->GetLargestPossibleRegion().GetSize()
-                          << " and does not match the required size " << validSize << " from file "
-                          << m_FileNames[m_ReverseOrder ? numberOfFiles - 1 : 0].c_str());
-      }
-
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
-
-      if (readSize == sliceRegionToRequest.GetSize())
-      {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
-
-        const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
-
-        using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
-        const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
-
-
-        const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
-                                        ? (i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
-                                        : 0;
-
-        const ptrdiff_t numberOfPixelComponentsUpToSlice =
-          numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool bufferDelete = false;
-
-        typename TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
-
-        if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
-        {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer,
-            static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
-            bufferDelete);
-        }
-        else
-        {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer(
-            outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
-        }
-        readerOutput->UpdateOutputData();
-      }
-      else
+      if (!sliceIsRead)
       {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
-
-        reader->Update();
-
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex(sliceStartIndex);
-
-        // set the moving dimension to a size of 1
-        if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
-        {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-        }
-
-        ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
+        this->ReadSlice(reader, i, sliceRegionToRequest, validSize);
       }
+      const typename TOutputImage::PointType sliceOrigin =
+        sliceIsRead ? readSliceOrigins[i] : reader->GetOutput()->GetOrigin();
 
       // verify that slice spacing is the expected one
       // since we can be skipping some slices because they are outside of requested region
       // I am using additional variable
       if (prevSliceIsValid)
       {
-        typename TOutputImage::PointType sliceOrigin = readerOutput->GetOrigin();
         using SpacingScalarType = typename TOutputImage::SpacingValueType;
         Vector<SpacingScalarType, TOutputImage::ImageDimension> dirN;
         for (size_t j = 0; j < TOutputImage::ImageDimension; ++j)
@@ -448,25 +436,44 @@ ImageSeriesReader<TOutputImage>::GenerateData()
       }
       else
       {
-        prevSliceOrigin = readerOutput->GetOrigin();
+        prevSliceOrigin = sliceOrigin;
         prevSliceIsValid = true;
       }
 
-      // report progress for read slices
-      progress.CompletedPixel();
+      // report progress for read slices, the parallel reading reports its own
+      if (!sliceIsRead)
+      {
+        progress.CompletedPixel();
+      }
     } // end !insideRequestedRegion
 
     // Deep copy the MetaDataDictionary into the array
-    if (reader->GetImageIO() && needToUpdateMetaDataDictionaryArray)
+    if (needToUpdateMetaDataDictionaryArray)
     {
-      auto newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      if (nonUniformSampling)
+      std::unique_ptr<DictionaryType> newDictionary;
+      if (sliceIsRead)
+      {
+        newDictionary = std::move(readSliceDictionaries[i]);
+        if (!newDictionary)
+        {
+          // The array only needs to be updated since a non uniform sampling was detected.
+          reader = createReader(iFileName, m_ImageIO);
+          reader->UpdateOutputInformation();
+        }
+      }
+      if (!newDictionary && reader->GetImageIO())
       {
-        // slice-specific information
-        EncapsulateMetaData<double>(*newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
+        newDictionary = std::make_unique<DictionaryType>(reader->GetImageIO()->GetMetaDataDictionary());
+      }
+      if (newDictionary)
+      {
+        if (nonUniformSampling)
+        {
+          // slice-specific information
+          EncapsulateMetaData<double>(*newDictionary, "ITK_non_uniform_sampling_deviation", spacingDeviation);
+        }
+        m_MetaDataDictionaryArray.push_back(newDictionary.release());
       }
-      m_MetaDataDictionaryArray.push_back(newDictionary);
     }
   } // end per slice loop
 
@@ -492,6 +499,104 @@ ImageSeriesReader<TOutputImage>::GenerateData()
   }
 }
 
+template <typename TOutputImage>
+void
+ImageSeriesReader<TOutputImage>::ReadSlice(ReaderType *            reader,
+                                           int                     i,
+                                           const ImageRegionType & sliceRegionToRequest,
+                                           const SizeType &        validSize)
+{
+  TOutputImage *        output = this->GetOutput();
+  const ImageRegionType requestedRegion = output->GetRequestedRegion();
+  TOutputImage *        readerOutput = reader->GetOutput();
+  const auto            numberOfFiles = static_cast<int>(m_FileNames.size());
+  const int             iFileName = (m_ReverseOrder ? numberOfFiles - i - 1 : i);
+
+  // read the meta data information
+  readerOutput->UpdateOutputInformation();
+
+  // propagate the requested region to determine what the region
+  // will actually be read
+  readerOutput->PropagateRequestedRegion();
+
+  // check that the size of each slice is the same
+  if (readerOutput->GetLargestPossibleRegion().GetSize() != validSize)
+  {
+    itkExceptionMacro(<< "Size mismatch! The size of  " << m_FileNames[iFileName].c_str() << " is "
+                      << readerOutput->GetLargestPossibleRegion().GetSize()
+                      << " and does not match the required size " << validSize << " from file "
+                      << m_FileNames[m_ReverseOrder ? numberOfFiles - 1 : 0].c_str());
+  }
+
+  // get the size of the region to be read
+  SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+
+  if (readSize == sliceRegionToRequest.GetSize())
+  {
+    // if the buffer of the ImageReader is going to match that of
+    // ourselves, then set the ImageReader's buffer to a section
+    // of ours
+
+    const size_t numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+    using AccessorFunctorType = typename TOutputImage::AccessorFunctorType;
+    const size_t numberOfInternalComponentsPerPixel = AccessorFunctorType::GetVectorLength(output);
+
+
+    const ptrdiff_t sliceOffset = (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+                                    ? (i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage))
+                                    : 0;
+
+    const ptrdiff_t numberOfPixelComponentsUpToSlice =
+      numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+    const bool bufferDelete = false;
+
+    typename TOutputImage::InternalPixelType * outputSliceBuffer =
+      output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+    if (strcmp(output->GetNameOfClass(), "VectorImage") == 0)
+    {
+      // if the input image type is a vector image then the number
+      // of components needs to be set for the size
+      readerOutput->GetPixelContainer()->SetImportPointer(
+        outputSliceBuffer,
+        static_cast<unsigned long>(numberOfPixelsInSlice * numberOfInternalComponentsPerPixel),
+        bufferDelete);
+    }
+    else
+    {
+      // otherwise the actual number of pixels needs to be passed
+      readerOutput->GetPixelContainer()->SetImportPointer(
+        outputSliceBuffer, static_cast<unsigned long>(numberOfPixelsInSlice), bufferDelete);
+    }
+    readerOutput->UpdateOutputData();
+  }
+  else
+  {
+    // the read region isn't going to match exactly what we need
+    // to update to buffer created by the reader, then copy
+
+    reader->Update();
+
+    // output of buffer copy
+    ImageRegionType outRegion = requestedRegion;
+    IndexType       sliceStartIndex = requestedRegion.GetIndex();
+    if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+    {
+      sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
+    outRegion.SetIndex(sliceStartIndex);
+
+    // set the moving dimension to a size of 1
+    if (TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage)
+    {
+      outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+    }
+
+    ImageAlgorithm::Copy(readerOutput, output, sliceRegionToRequest, outRegion);
+  }
+}
+
 template <typename TOutputImage>
 auto
 ImageSeriesReader<TOutputImage>::GetMetaDataDictionaryArray() const -> DictionaryArrayRawPointer
@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageWriteExecutor_h
+#define itkImageWriteExecutor_h
+
+#include "ITKIOImageBaseExport.h"
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace itk
+{
+
+/**
+ * \class ImageWriteExecutor
+ * \brief Process-wide executor of the asynchronous writes of ImageFileWriter.
+ *
+ * The writes submitted by ImageFileWriter::WriteAsync() are run, in the
+ * order of their submission, by a dedicated thread, so that encoding and
+ * writing files does not hold the threads of the caller. The queue of the
+ * writes that are not started yet is bounded: Submit() blocks while it holds
+ * MaximumNumberOfQueuedWrites writes, which bounds the memory held by the
+ * images waiting to be written.
+ *
+ * The thread is started by the first write, and joined, after the last
+ * queued write, when the executor is destroyed at exit.
+ *
+ * \sa ImageFileWriter
+ * \ingroup ITKIOImageBase
+ */
+
+struct ImageWriteExecutorGlobals;
+
+class ITKIOImageBase_EXPORT ImageWriteExecutor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageWriteExecutor);
+
+  /** Standard class type aliases. */
+  using Self = ImageWriteExecutor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageWriteExecutor, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the ImageWriteExecutor */
+  static Pointer
+  GetInstance();
+
+  /** Set/Get the maximum number of writes waiting to be started. Default
+   * is 4. */
+  void
+  SetMaximumNumberOfQueuedWrites(SizeValueType maximumNumberOfQueuedWrites);
+  SizeValueType
+  GetMaximumNumberOfQueuedWrites() const;
+
+  /** Number of writes submitted and not finished yet. */
+  SizeValueType
+  GetNumberOfPendingWrites() const;
+
+  /** Queue the write, blocking while the queue is full. The returned future
+   * is ready when the write is finished, and rethrows its exception, if
+   * any. */
+  std::future<void>
+  Submit(std::function<void()> write);
+
+  /** Block until all the submitted writes are finished. */
+  void
+  WaitForAll();
+
+protected:
+  ImageWriteExecutor();
+  ~ImageWriteExecutor() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(ImageWriteExecutorGlobals, PimplGlobals);
+
+  /** Runs the queued writes, until the executor is destroyed. */
+  void
+  Run();
+
+  mutable std::mutex      m_Mutex;
+  std::condition_variable m_Condition;
+
+  /** Writes not started yet, in the order of their submission. */
+  std::deque<std::packaged_task<void()>> m_Queue;
+
+  SizeValueType m_MaximumNumberOfQueuedWrites{ 4 };
+  SizeValueType m_NumberOfRunningWrites{ 0 };
+  bool          m_Stopping{ false };
+  std::thread   m_Thread;
+
+  static ImageWriteExecutorGlobals * m_PimplGlobals;
+};
+
+} // namespace itk
+
+#endif
@@ -0,0 +1,60 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZlibBlockCompression_h
+#define itkZlibBlockCompression_h
+#include "ITKIOImageBaseExport.h"
+
+#include "itkIntTypes.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ZlibBlockCompression
+ * \brief Deflates and inflates the blocks of the files compressed in
+ * independent blocks.
+ *
+ * Each block of such a file is a raw deflate stream, compressed
+ * independently of the other blocks. All the blocks but the last one end
+ * with a sync flush, so that their concatenation is a single deflate stream,
+ * which any decoder reads, while the blocks can be compressed and
+ * decompressed in parallel, and a region of the data decompressed without
+ * the blocks before it.
+ *
+ * \ingroup ITKIOImageBase
+ */
+struct ITKIOImageBase_EXPORT ZlibBlockCompression
+{
+  /** Deflates the length bytes of data into compressed, which is resized to
+   * the length of the block, ended by a sync flush unless it is the last
+   * block. The compression level is a zlib level. Returns false if the
+   * block cannot be deflated. */
+  static bool
+  Deflate(const void *                 data,
+          SizeValueType                length,
+          int                          compressionLevel,
+          bool                         lastBlock,
+          std::vector<unsigned char> & compressed);
+
+  /** Inflates a block into output, which the block must fill. Returns false
+   * if the block cannot be inflated. */
+  static bool
+  Inflate(const void * compressed, SizeValueType compressedLength, void * output, SizeValueType length);
+};
+} // end namespace itk
+
+#endif
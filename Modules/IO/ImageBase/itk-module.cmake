@@ -11,10 +11,15 @@ itk_module(ITKIOImageBase
   ENABLE_SHARED
   DEPENDS
     ITKCommon
+  PRIVATE_DEPENDS
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKIOGDCM
     ITKIOMeta
+    ITKIONIFTI
+    ITKIONRRD
+    ITKIOTIFF
     ITKImageIntensity
   DESCRIPTION
     "${DOCUMENTATION}"
@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageWriteExecutor.h"
+#include "itkSingleton.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+struct ImageWriteExecutorGlobals
+{
+  ImageWriteExecutorGlobals() = default;
+
+  // To allow singleton creation of ImageWriteExecutor.
+  std::once_flag m_ExecutorOnceFlag;
+
+  // The singleton instance of ImageWriteExecutor.
+  ImageWriteExecutor::Pointer m_ExecutorInstance;
+};
+
+itkGetGlobalSimpleMacro(ImageWriteExecutor, ImageWriteExecutorGlobals, PimplGlobals);
+
+ImageWriteExecutor::Pointer
+ImageWriteExecutor::New()
+{
+  return Self::GetInstance();
+}
+
+
+ImageWriteExecutor::Pointer
+ImageWriteExecutor::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  // Create a singleton ImageWriteExecutor.
+  std::call_once(m_PimplGlobals->m_ExecutorOnceFlag, []() {
+    m_PimplGlobals->m_ExecutorInstance = ObjectFactory<Self>::Create();
+    if (m_PimplGlobals->m_ExecutorInstance.IsNull())
+    {
+      new ImageWriteExecutor(); // constructor sets m_PimplGlobals->m_ExecutorInstance
+    }
+  });
+
+  return m_PimplGlobals->m_ExecutorInstance;
+}
+
+ImageWriteExecutor::ImageWriteExecutor()
+{
+  // Construction only occurs via GetInstance which is protected by call_once.
+  m_PimplGlobals->m_ExecutorInstance = this;        // like the thread pools
+  m_PimplGlobals->m_ExecutorInstance->UnRegister(); // Remove extra reference
+}
+
+ImageWriteExecutor::~ImageWriteExecutor()
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+  if (m_Thread.joinable())
+  {
+    m_Thread.join();
+  }
+}
+
+void
+ImageWriteExecutor::SetMaximumNumberOfQueuedWrites(SizeValueType maximumNumberOfQueuedWrites)
+{
+  {
+    const std::lock_guard<std::mutex> lock(m_Mutex);
+    maximumNumberOfQueuedWrites = std::max(maximumNumberOfQueuedWrites, SizeValueType{ 1 });
+    if (m_MaximumNumberOfQueuedWrites == maximumNumberOfQueuedWrites)
+    {
+      return;
+    }
+    m_MaximumNumberOfQueuedWrites = maximumNumberOfQueuedWrites;
+  }
+  m_Condition.notify_all();
+  this->Modified();
+}
+
+SizeValueType
+ImageWriteExecutor::GetMaximumNumberOfQueuedWrites() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumNumberOfQueuedWrites;
+}
+
+SizeValueType
+ImageWriteExecutor::GetNumberOfPendingWrites() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Queue.size() + m_NumberOfRunningWrites;
+}
+
+std::future<void>
+ImageWriteExecutor::Submit(std::function<void()> write)
+{
+  std::packaged_task<void()> task(std::move(write));
+  std::future<void>          future = task.get_future();
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return m_Queue.size() < m_MaximumNumberOfQueuedWrites; });
+    m_Queue.push_back(std::move(task));
+    if (!m_Thread.joinable())
+    {
+      m_Thread = std::thread(&Self::Run, this);
+    }
+  }
+  m_Condition.notify_all();
+  return future;
+}
+
+void
+ImageWriteExecutor::WaitForAll()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_Condition.wait(lock, [this] { return m_Queue.empty() && m_NumberOfRunningWrites == 0; });
+}
+
+void
+ImageWriteExecutor::Run()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_Condition.wait(lock, [this] { return m_Stopping || !m_Queue.empty(); });
+    if (m_Queue.empty())
+    {
+      return;
+    }
+    std::packaged_task<void()> task = std::move(m_Queue.front());
+    m_Queue.pop_front();
+    ++m_NumberOfRunningWrites;
+    lock.unlock();
+    m_Condition.notify_all();
+
+    // The exception of a write, if any, is stored in its future.
+    task();
+
+    lock.lock();
+    --m_NumberOfRunningWrites;
+    m_Condition.notify_all();
+  }
+}
+
+void
+ImageWriteExecutor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumNumberOfQueuedWrites: " << this->GetMaximumNumberOfQueuedWrites() << std::endl;
+  os << indent << "NumberOfPendingWrites: " << this->GetNumberOfPendingWrites() << std::endl;
+}
+
+ImageWriteExecutorGlobals * ImageWriteExecutor::m_PimplGlobals;
+
+} // namespace itk
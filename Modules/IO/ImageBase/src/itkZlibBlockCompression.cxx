@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZlibBlockCompression.h"
+#include "itk_zlib.h"
+
+#include <limits>
+
+namespace itk
+{
+
+bool
+ZlibBlockCompression::Deflate(const void *                 data,
+                              SizeValueType                length,
+                              int                          compressionLevel,
+                              bool                         lastBlock,
+                              std::vector<unsigned char> & compressed)
+{
+  // A block is deflated by a single call.
+  if (length > std::numeric_limits<uInt>::max())
+  {
+    return false;
+  }
+  z_stream stream{};
+  if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+  // The sync flush takes a few bytes more than deflateBound.
+  compressed.resize(deflateBound(&stream, static_cast<uLong>(length)) + 16);
+  if (compressed.size() > std::numeric_limits<uInt>::max())
+  {
+    deflateEnd(&stream);
+    return false;
+  }
+  stream.next_in = static_cast<Bytef *>(const_cast<void *>(data));
+  stream.avail_in = static_cast<uInt>(length);
+  stream.next_out = compressed.data();
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  const int result = deflate(&stream, lastBlock ? Z_FINISH : Z_SYNC_FLUSH);
+  // A sync flush which fills the output may not be complete.
+  const bool deflated = result == (lastBlock ? Z_STREAM_END : Z_OK) && stream.avail_in == 0 && stream.avail_out != 0;
+  compressed.resize(compressed.size() - stream.avail_out);
+  deflateEnd(&stream);
+  return deflated;
+}
+
+bool
+ZlibBlockCompression::Inflate(const void *  compressed,
+                              SizeValueType compressedLength,
+                              void *        output,
+                              SizeValueType length)
+{
+  if (compressedLength > std::numeric_limits<uInt>::max() || length > std::numeric_limits<uInt>::max())
+  {
+    return false;
+  }
+  z_stream stream{};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = static_cast<Bytef *>(const_cast<void *>(compressed));
+  stream.avail_in = static_cast<uInt>(compressedLength);
+  stream.next_out = static_cast<Bytef *>(output);
+  stream.avail_out = static_cast<uInt>(length);
+  const int  result = inflate(&stream, Z_SYNC_FLUSH);
+  const bool inflated = (result == Z_OK || result == Z_STREAM_END) && stream.avail_out == 0;
+  inflateEnd(&stream);
+  return inflated;
+}
+} // end namespace itk
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkConvertPixelBuffer.h"
+#include "itkRGBAPixel.h"
+#include "itkRGBPixel.h"
+#include "itkTimeProbe.h"
+#include "itkVector.h"
+#include <gtest/gtest.h>
+#include <complex>
+#include <vector>
+
+namespace
+{
+template <typename TInput>
+std::vector<TInput>
+MakeComponents(size_t numberOfComponents)
+{
+  std::vector<TInput> components(numberOfComponents);
+  for (size_t i = 0; i < numberOfComponents; ++i)
+  {
+    // Covers the whole range of the 8 and 16 bit types, negative values included.
+    components[i] = static_cast<TInput>(i * 7919 + 13);
+  }
+  return components;
+}
+
+
+// Converts pixels of the given number of components, for numbers of pixels
+// around the widths of the SIMD registers, and checks that the first output
+// components are the input ones, cast.
+template <typename TInput, typename TOutputPixel>
+void
+Expect_conversion_casts_components(int inputNumberOfComponents, unsigned int numberOfComparedComponents)
+{
+  using ConvertTraits = itk::DefaultConvertPixelTraits<TOutputPixel>;
+  using OutputComponentType = typename ConvertTraits::ComponentType;
+
+  for (size_t numberOfPixels = 0; numberOfPixels <= 40; ++numberOfPixels)
+  {
+    const std::vector<TInput> input = MakeComponents<TInput>(numberOfPixels * inputNumberOfComponents);
+    std::vector<TOutputPixel> output(numberOfPixels);
+    itk::ConvertPixelBuffer<TInput, TOutputPixel, ConvertTraits>::Convert(
+      input.data(), inputNumberOfComponents, output.data(), numberOfPixels);
+
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      for (unsigned int c = 0; c < numberOfComparedComponents; ++c)
+      {
+        EXPECT_EQ(ConvertTraits::GetNthComponent(c, output[i]),
+                  static_cast<OutputComponentType>(input[i * inputNumberOfComponents + c]));
+      }
+    }
+  }
+}
+
+
+// Reports the time taken to convert 16 Mi pixels.
+template <typename TInput, typename TOutputPixel>
+void
+ReportConversionTime(int inputNumberOfComponents, const char * description)
+{
+  using ConvertTraits = itk::DefaultConvertPixelTraits<TOutputPixel>;
+
+  constexpr size_t          numberOfPixels = size_t{ 1 } << 24;
+  const std::vector<TInput> input = MakeComponents<TInput>(numberOfPixels * inputNumberOfComponents);
+  std::vector<TOutputPixel> output(numberOfPixels);
+  itk::TimeProbe            probe;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    probe.Start();
+    itk::ConvertPixelBuffer<TInput, TOutputPixel, ConvertTraits>::Convert(
+      input.data(), inputNumberOfComponents, output.data(), numberOfPixels);
+    probe.Stop();
+  }
+  std::cout << "Conversion of 16 Mi pixels, " << description << ": " << probe.GetMean() * 1000 << " ms" << std::endl;
+}
+} // namespace
+
+
+TEST(ConvertPixelBuffer, GrayToGrayCastsComponents)
+{
+  Expect_conversion_casts_components<short, float>(1, 1);
+  Expect_conversion_casts_components<unsigned short, float>(1, 1);
+  Expect_conversion_casts_components<unsigned char, float>(1, 1);
+  Expect_conversion_casts_components<int, double>(1, 1);
+  Expect_conversion_casts_components<double, int>(1, 1);
+  Expect_conversion_casts_components<unsigned short, unsigned short>(1, 1);
+}
+
+
+TEST(ConvertPixelBuffer, ColorConversionsCastComponents)
+{
+  Expect_conversion_casts_components<short, itk::RGBPixel<float>>(3, 3);
+  Expect_conversion_casts_components<unsigned char, itk::RGBPixel<unsigned char>>(3, 3);
+  Expect_conversion_casts_components<unsigned char, itk::RGBAPixel<unsigned char>>(4, 4);
+  Expect_conversion_casts_components<unsigned short, itk::RGBAPixel<float>>(4, 4);
+
+  // The alpha component is dropped.
+  Expect_conversion_casts_components<unsigned char, itk::RGBPixel<unsigned char>>(4, 3);
+  Expect_conversion_casts_components<unsigned short, itk::RGBPixel<float>>(4, 3);
+}
+
+
+TEST(ConvertPixelBuffer, VectorAndComplexConversionsCastComponents)
+{
+  Expect_conversion_casts_components<float, itk::Vector<double, 5>>(5, 5);
+  Expect_conversion_casts_components<short, itk::Vector<float, 7>>(7, 7);
+
+  const std::vector<float>          input = MakeComponents<float>(2 * 19);
+  std::vector<std::complex<double>> output(19);
+  itk::ConvertPixelBuffer<float, std::complex<double>, itk::DefaultConvertPixelTraits<std::complex<double>>>::Convert(
+    input.data(), 2, output.data(), 19);
+
+  for (size_t i = 0; i < output.size(); ++i)
+  {
+    EXPECT_EQ(output[i], std::complex<double>(input[2 * i], input[2 * i + 1]));
+  }
+}
+
+
+TEST(ConvertPixelBuffer, ConvertVectorImageCastsComponents)
+{
+  const std::vector<short> input = MakeComponents<short>(3 * 21);
+  std::vector<float>       output(input.size());
+  itk::ConvertPixelBuffer<short, float, itk::DefaultConvertPixelTraits<float>>::ConvertVectorImage(
+    input.data(), 3, output.data(), 21);
+
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    EXPECT_EQ(output[i], static_cast<float>(input[i]));
+  }
+}
+
+
+TEST(ConvertPixelBuffer, ReportConversionTime)
+{
+  ReportConversionTime<short, float>(1, "short to float");
+  ReportConversionTime<unsigned char, unsigned char>(1, "unsigned char to unsigned char");
+  ReportConversionTime<unsigned char, unsigned char>(3, "RGB unsigned char to gray unsigned char");
+  ReportConversionTime<unsigned char, itk::RGBPixel<unsigned char>>(4, "RGBA to RGB unsigned char");
+  ReportConversionTime<float, itk::Vector<double, 3>>(3, "float vector to double vector");
+}
@@ -0,0 +1,267 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAbsImageFilter.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkVectorImage.h"
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <fstream>
+
+#define STRING(s) #s
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using ContainerType = itk::MemoryMappedImageContainer<itk::SizeValueType, float>;
+using AccessModeEnum = itk::MemoryMappedFileEnums::AccessMode;
+
+struct ITKImageFileReaderMemoryMappingTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(STRING(ITK_TEST_OUTPUT_DIR_STR));
+  }
+
+  static ImageType::Pointer
+  MakeImage()
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 17, 9, 5 } });
+    image->Allocate();
+    float * const buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+    {
+      buffer[i] = 0.5f * static_cast<float>(i + 1);
+    }
+    return image;
+  }
+
+  // Reads the file, returning whether its buffer was memory mapped.
+  template <typename TImage = ImageType>
+  static bool
+  ReadWithMemoryMapping(const std::string & fileName, typename TImage::Pointer & image, AccessModeEnum accessMode)
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->UseMemoryMappingOn();
+    reader->SetMemoryMappingAccessMode(accessMode);
+    reader->Update();
+    image = reader->GetOutput();
+    using MappedContainerType =
+      itk::MemoryMappedImageContainer<itk::SizeValueType, typename TImage::PixelContainer::Element>;
+    const auto * container = dynamic_cast<const MappedContainerType *>(image->GetPixelContainer());
+    return container != nullptr && container->IsMapped();
+  }
+};
+} // namespace
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, ContainerMapsFileRange)
+{
+  const std::string fileName = "itkMemoryMappedImageContainer.raw";
+  {
+    std::ofstream file(fileName.c_str(), std::ios::binary);
+    const char    header[12] = "12345678901";
+    file.write(header, sizeof(header));
+    for (float value = 0.0f; value < 1000.0f; value += 1.0f)
+    {
+      file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+  }
+
+  auto container = ContainerType::New();
+  container->MapFile(fileName, 12, 1000);
+  ASSERT_TRUE(container->IsMapped());
+  EXPECT_EQ(container->Size(), 1000u);
+  EXPECT_FALSE(container->GetContainerManageMemory());
+  EXPECT_EQ((*container)[0], 0.0f);
+  EXPECT_EQ((*container)[999], 999.0f);
+
+  // Writes to a copy-on-write mapping are private.
+  container->MapFile(fileName, 12, 1000, AccessModeEnum::CopyOnWrite);
+  (*container)[10] = -1.0f;
+  EXPECT_EQ((*container)[10], -1.0f);
+  auto other = ContainerType::New();
+  other->MapFile(fileName, 12, 1000);
+  EXPECT_EQ((*other)[10], 10.0f);
+
+  // Releasing or reallocating the buffer releases the mapping.
+  other->Initialize();
+  EXPECT_FALSE(other->IsMapped());
+  container->Reserve(2000);
+  EXPECT_FALSE(container->IsMapped());
+  EXPECT_EQ((*container)[10], -1.0f);
+  EXPECT_EQ((*container)[999], 999.0f);
+
+  // Misaligned offsets and ranges beyond the end of the file are refused.
+  EXPECT_THROW(container->MapFile(fileName, 13, 10), itk::ExceptionObject);
+  EXPECT_THROW(container->MapFile(fileName, 12, 1001), itk::ExceptionObject);
+  EXPECT_THROW(container->MapFile("itkMemoryMappedImageContainerMissing.raw", 0, 1), itk::ExceptionObject);
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, RawFormatsAreMapped)
+{
+  const ImageType::Pointer image = MakeImage();
+
+  for (const std::string fileName : { "itkImageFileReaderMemoryMapping.mhd",
+                                      "itkImageFileReaderMemoryMapping.nhdr",
+                                      "itkImageFileReaderMemoryMapping.nii",
+                                      "itkImageFileReaderMemoryMapping.hdr" })
+  {
+    itk::WriteImage(image, fileName);
+
+    ImageType::Pointer readImage;
+    EXPECT_TRUE(ReadWithMemoryMapping(fileName, readImage, AccessModeEnum::ReadOnly)) << fileName;
+    EXPECT_EQ(readImage->GetBufferedRegion(), image->GetLargestPossibleRegion()) << fileName;
+    EXPECT_EQ(*readImage, *image) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, AttachedDataAreMappedWhenAligned)
+{
+  // Single byte pixels are always aligned.
+  using CharImageType = itk::Image<unsigned char, 3>;
+  auto image = CharImageType::New();
+  image->SetRegions(CharImageType::SizeType{ { 17, 9, 5 } });
+  image->Allocate();
+  for (unsigned int i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<unsigned char>(i);
+  }
+
+  for (const std::string fileName :
+       { "itkImageFileReaderMemoryMappingAttached.mha", "itkImageFileReaderMemoryMappingAttached.nrrd" })
+  {
+    itk::WriteImage(image, fileName);
+
+    CharImageType::Pointer readImage;
+    EXPECT_TRUE(ReadWithMemoryMapping<CharImageType>(fileName, readImage, AccessModeEnum::ReadOnly)) << fileName;
+    EXPECT_EQ(*readImage, *image) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, UnmappableFilesAreRead)
+{
+  const ImageType::Pointer image = MakeImage();
+
+  // Compressed data, and float pixels at odd offsets after attached headers.
+  for (const std::string fileName : { "itkImageFileReaderMemoryMappingCompressed.mha",
+                                      "itkImageFileReaderMemoryMappingCompressed.nrrd",
+                                      "itkImageFileReaderMemoryMappingCompressed.nii.gz" })
+  {
+    itk::WriteImage(image, fileName, true);
+
+    ImageType::Pointer readImage;
+    EXPECT_FALSE(ReadWithMemoryMapping(fileName, readImage, AccessModeEnum::ReadOnly)) << fileName;
+    EXPECT_EQ(*readImage, *image) << fileName;
+  }
+  for (const std::string fileName :
+       { "itkImageFileReaderMemoryMappingUnaligned.mha", "itkImageFileReaderMemoryMappingUnaligned.nrrd" })
+  {
+    itk::WriteImage(image, fileName);
+
+    ImageType::Pointer readImage;
+    ReadWithMemoryMapping(fileName, readImage, AccessModeEnum::ReadOnly);
+    EXPECT_EQ(*readImage, *image) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, ConvertedPixelsAreRead)
+{
+  const std::string fileName = "itkImageFileReaderMemoryMappingConverted.mha";
+  itk::WriteImage(MakeImage(), fileName);
+
+  using DoubleImageType = itk::Image<double, 3>;
+  DoubleImageType::Pointer readImage;
+  EXPECT_FALSE(ReadWithMemoryMapping<DoubleImageType>(fileName, readImage, AccessModeEnum::ReadOnly));
+  EXPECT_EQ(readImage->GetPixel({ { 16, 8, 4 } }), 382.5);
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, CopyOnWriteLeavesFileUnchanged)
+{
+  const std::string fileName = "itkImageFileReaderMemoryMappingCopyOnWrite.nhdr";
+  const auto        image = MakeImage();
+  itk::WriteImage(image, fileName);
+
+  ImageType::Pointer readImage;
+  ASSERT_TRUE(ReadWithMemoryMapping(fileName, readImage, AccessModeEnum::CopyOnWrite));
+  readImage->FillBuffer(-1.0f);
+  EXPECT_EQ(readImage->GetPixel({ { 3, 2, 1 } }), -1.0f);
+
+  EXPECT_EQ(*itk::ReadImage<ImageType>(fileName), *image);
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, InPlaceFiltersRunOnDefaultMapping)
+{
+  const std::string fileName = "itkImageFileReaderMemoryMappingInPlace.nhdr";
+  auto              image = MakeImage();
+  image->FillBuffer(-2.0f);
+  itk::WriteImage(image, fileName);
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  EXPECT_EQ(reader->GetMemoryMappingAccessMode(), AccessModeEnum::CopyOnWrite);
+
+  // The filter writes into the mapped buffer of its input.
+  auto filter = itk::AbsImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(reader->GetOutput());
+  filter->InPlaceOn();
+  filter->Update();
+  const auto * container = dynamic_cast<const ContainerType *>(filter->GetOutput()->GetPixelContainer());
+  ASSERT_NE(container, nullptr);
+  EXPECT_TRUE(container->IsMapped());
+  EXPECT_EQ(filter->GetOutput()->GetPixel({ { 3, 2, 1 } }), 2.0f);
+
+  EXPECT_EQ(*itk::ReadImage<ImageType>(fileName), *image);
+}
+
+
+TEST_F(ITKImageFileReaderMemoryMappingTest, VectorImagesAreMapped)
+{
+  using VectorImageType = itk::VectorImage<float, 2>;
+  auto image = VectorImageType::New();
+  image->SetRegions(VectorImageType::SizeType{ { 7, 5 } });
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+  for (unsigned int i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<float>(i);
+  }
+
+  const std::string fileName = "itkImageFileReaderMemoryMappingVector.mhd";
+  itk::WriteImage(image, fileName);
+
+  VectorImageType::Pointer readImage;
+  EXPECT_TRUE(ReadWithMemoryMapping<VectorImageType>(fileName, readImage, AccessModeEnum::ReadOnly));
+  EXPECT_EQ(readImage->GetNumberOfComponentsPerPixel(), 3u);
+  EXPECT_EQ(readImage->GetPixel({ { 6, 4 } })[2], 104.0f);
+}
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkTimeProbe.h"
+#include "itkVectorImage.h"
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#define STRING(s) #s
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+// Value of a field of /proc/self/status, in bytes, or 0 when not available.
+size_t
+GetProcessStatusBytes(const std::string & field)
+{
+  std::ifstream status("/proc/self/status");
+  std::string   line;
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, field.size() + 1, field + ':') == 0)
+    {
+      return std::stoul(line.substr(field.size() + 1)) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Resets the peak resident memory of the process to its current resident
+// memory, returning whether it could be reset (Linux only).
+bool
+ResetPeakMemory()
+{
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+  clearRefs.close();
+  return clearRefs.good() && GetProcessStatusBytes("VmHWM") > 0;
+}
+
+struct ITKImageFileReaderPeakMemoryTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(STRING(ITK_TEST_OUTPUT_DIR_STR));
+  }
+
+  static ImageType::Pointer
+  MakeImage()
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 256, 256, 64 } });
+    image->Allocate();
+    float * const buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+    {
+      buffer[i] = 0.25f * static_cast<float>(i + 1);
+    }
+    return image;
+  }
+
+  // Reads the file, checking that the memory used by the reader, in addition
+  // to its output, is at most a quarter of the size of the output.
+  template <typename TImage>
+  static typename TImage::Pointer
+  ReadWithinMemoryBudget(const std::string & fileName)
+  {
+    const bool   canMeasure = ResetPeakMemory();
+    const size_t residentMemory = GetProcessStatusBytes("VmRSS");
+
+    itk::TimeProbe probe;
+    probe.Start();
+    const typename TImage::Pointer image = itk::ReadImage<TImage>(fileName);
+    probe.Stop();
+
+    const size_t sizeOfOutput = image->GetPixelContainer()->Size() * sizeof(typename TImage::InternalPixelType);
+    std::cout << fileName << ": read in " << probe.GetTotal() << ' ' << probe.GetUnit();
+    if (canMeasure)
+    {
+      const size_t peakMemory = GetProcessStatusBytes("VmHWM") - residentMemory;
+      std::cout << ", peak memory " << peakMemory << " bytes for an output of " << sizeOfOutput << " bytes";
+      EXPECT_LE(peakMemory, sizeOfOutput + sizeOfOutput / 4) << fileName;
+    }
+    std::cout << std::endl;
+    return image;
+  }
+
+  static const std::vector<std::string> &
+  GetFileNames()
+  {
+    static const std::vector<std::string> fileNames{ "itkImageFileReaderPeakMemory.nii",
+                                                     "itkImageFileReaderPeakMemory.nrrd",
+                                                     "itkImageFileReaderPeakMemory.mha",
+                                                     "itkImageFileReaderPeakMemory.tif" };
+    return fileNames;
+  }
+};
+} // namespace
+
+
+TEST_F(ITKImageFileReaderPeakMemoryTest, PixelsAreReadIntoTheOutput)
+{
+  const ImageType::Pointer image = MakeImage();
+
+  for (const auto & fileName : GetFileNames())
+  {
+    itk::WriteImage(image, fileName);
+
+    // Only the pixels are compared: TIFF does not store the 3D geometry exactly.
+    const ImageType::Pointer readImage = ReadWithinMemoryBudget<ImageType>(fileName);
+    EXPECT_TRUE(std::equal(image->GetBufferPointer(),
+                           image->GetBufferPointer() + image->GetPixelContainer()->Size(),
+                           readImage->GetBufferPointer()))
+      << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderPeakMemoryTest, PixelsAreConvertedInTheOutput)
+{
+  using DoubleImageType = itk::Image<double, 3>;
+  const ImageType::Pointer image = MakeImage();
+
+  for (const auto & fileName : GetFileNames())
+  {
+    itk::WriteImage(image, fileName);
+
+    const DoubleImageType::Pointer readImage = ReadWithinMemoryBudget<DoubleImageType>(fileName);
+    EXPECT_EQ(readImage->GetPixel({ { 0, 0, 0 } }), 0.25) << fileName;
+    EXPECT_EQ(readImage->GetPixel({ { 255, 255, 63 } }), 0.25 * image->GetPixelContainer()->Size()) << fileName;
+    EXPECT_EQ(readImage->GetPixel({ { 17, 3, 40 } }), static_cast<double>(image->GetPixel({ { 17, 3, 40 } })))
+      << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderPeakMemoryTest, VectorPixelsAreConvertedInTheOutput)
+{
+  using CharVectorImageType = itk::VectorImage<unsigned char, 2>;
+  auto image = CharVectorImageType::New();
+  image->SetRegions(CharVectorImageType::SizeType{ { 701, 257 } });
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+  for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<unsigned char>(i % 251);
+  }
+  const std::string fileName = "itkImageFileReaderPeakMemoryVector.nrrd";
+  itk::WriteImage(image, fileName);
+
+  // The pixels are converted in place, in several blocks.
+  const auto vectorImage = itk::ReadImage<itk::VectorImage<double, 2>>(fileName);
+  const auto fixedImage = itk::ReadImage<itk::Image<itk::Vector<float, 3>, 2>>(fileName);
+  for (const itk::Index<2> index :
+       { itk::Index<2>{ { 0, 0 } }, itk::Index<2>{ { 700, 256 } }, itk::Index<2>{ { 123, 200 } } })
+  {
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      EXPECT_EQ(vectorImage->GetPixel(index)[c], image->GetPixel(index)[c]) << index;
+      EXPECT_EQ(fixedImage->GetPixel(index)[c], image->GetPixel(index)[c]) << index;
+    }
+  }
+}
@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkTimeProbe.h"
+#include "itkGTest.h"
+#include "itkTestingEqualInRegion.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <algorithm>
+#include <iostream>
+
+#define STRING(s) #s
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+struct ITKImageFileReaderPrefetchTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(STRING(ITK_TEST_OUTPUT_DIR_STR));
+  }
+
+  static ImageType::Pointer
+  MakeImage(float offset)
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 128, 96, 48 } });
+    image->Allocate();
+    float * const buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+    {
+      buffer[i] = offset + 0.25f * static_cast<float>(i % 100003);
+    }
+    return image;
+  }
+
+  // Streams the file through a pixel-wise filter into outputFileName, in the
+  // given number of pieces, returning the time taken.
+  static double
+  StreamPipeline(const std::string & fileName,
+                 const std::string & outputFileName,
+                 unsigned int        numberOfStreamDivisions,
+                 bool                usePrefetching)
+  {
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->SetUsePrefetching(usePrefetching);
+
+    auto filter = itk::ShiftScaleImageFilter<ImageType, ImageType>::New();
+    filter->SetInput(reader->GetOutput());
+    filter->SetShift(1.0);
+    filter->SetScale(2.0);
+
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(filter->GetOutput());
+    writer->SetFileName(outputFileName);
+    writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    writer->Update();
+    probe.Stop();
+    return probe.GetTotal();
+  }
+};
+} // namespace
+
+
+TEST_F(ITKImageFileReaderPrefetchTest, StreamedPipelineOutputIsUnchanged)
+{
+  const ImageType::Pointer image = MakeImage(0.0f);
+  const double             megabytes = image->GetPixelContainer()->Size() * sizeof(float) / 1e6;
+
+  for (const std::string fileName : { "itkImageFileReaderPrefetch.mha",
+                                      "itkImageFileReaderPrefetch.nrrd",
+                                      "itkImageFileReaderPrefetch.nii",
+                                      "itkImageFileReaderPrefetchCompressed.nrrd" })
+  {
+    itk::WriteImage(image, fileName, fileName.find("Compressed") != std::string::npos);
+
+    const double time = StreamPipeline(fileName, "itkImageFileReaderPrefetchOutput.mha", 12, false);
+    const ImageType::Pointer expected = itk::ReadImage<ImageType>("itkImageFileReaderPrefetchOutput.mha");
+    const double prefetchingTime = StreamPipeline(fileName, "itkImageFileReaderPrefetchOutput.mha", 12, true);
+    const ImageType::Pointer output = itk::ReadImage<ImageType>("itkImageFileReaderPrefetchOutput.mha");
+    EXPECT_EQ(*output, *expected) << fileName;
+    EXPECT_EQ(output->GetPixel({ { 5, 7, 11 } }), (image->GetPixel({ { 5, 7, 11 } }) + 1.0f) * 2.0f) << fileName;
+
+    std::cout << fileName << ": streamed at " << megabytes / time << " MB/s, and at " << megabytes / prefetchingTime
+              << " MB/s when prefetching" << std::endl;
+  }
+}
+
+
+TEST_F(ITKImageFileReaderPrefetchTest, OverlappingAndUnpredictedRegionsAreRead)
+{
+  const ImageType::Pointer image = MakeImage(0.0f);
+  const std::string        fileName = "itkImageFileReaderPrefetchRegions.mha";
+  itk::WriteImage(image, fileName);
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->UsePrefetchingOn();
+  EXPECT_TRUE(reader->GetUsePrefetching());
+  reader->UpdateOutputInformation();
+
+  // Pieces padded by two slices, as requested by a neighborhood filter, then
+  // pieces in the reverse order, which are not predicted.
+  std::vector<ImageType::RegionType> regions;
+  for (itk::IndexValueType slice = 0; slice < 48; slice += 8)
+  {
+    ImageType::RegionType region{ { { 0, 0, slice - 2 } }, { { 128, 96, 12 } } };
+    region.Crop(image->GetLargestPossibleRegion());
+    regions.push_back(region);
+  }
+  for (itk::IndexValueType slice = 40; slice >= 0; slice -= 8)
+  {
+    regions.push_back(ImageType::RegionType{ { { 0, 0, slice } }, { { 128, 96, 8 } } });
+  }
+  regions.push_back(ImageType::RegionType{ { { 3, 4, 5 } }, { { 50, 20, 10 } } });
+  regions.push_back(ImageType::RegionType{ { { 3, 4, 15 } }, { { 50, 20, 10 } } });
+
+  for (const ImageType::RegionType & region : regions)
+  {
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->Update();
+    EXPECT_TRUE(reader->GetOutput()->GetBufferedRegion().IsInside(region)) << region;
+    EXPECT_TRUE(itk::Testing::EqualInRegion<ImageType>(image, reader->GetOutput(), region)) << region;
+
+    // The IO region of the ImageIO is the region read last, not the region
+    // read ahead.
+    const itk::ImageIORegion & ioRegion = reader->GetImageIO()->GetIORegion();
+    for (unsigned int i = 0; i < ImageType::ImageDimension; ++i)
+    {
+      EXPECT_LE(ioRegion.GetIndex(i), region.GetIndex(i)) << region;
+      EXPECT_GE(ioRegion.GetIndex(i) + static_cast<itk::IndexValueType>(ioRegion.GetSize(i)),
+                region.GetIndex(i) + static_cast<itk::IndexValueType>(region.GetSize(i)))
+        << region;
+    }
+  }
+
+  // The pixels read ahead are discarded when the file changes.
+  const ImageType::Pointer otherImage = MakeImage(1000.0f);
+  itk::WriteImage(otherImage, "itkImageFileReaderPrefetchOther.mha");
+  const ImageType::RegionType region{ { { 3, 4, 25 } }, { { 50, 20, 10 } } };
+  reader->SetFileName("itkImageFileReaderPrefetchOther.mha");
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  EXPECT_TRUE(itk::Testing::EqualInRegion<ImageType>(otherImage, reader->GetOutput(), region));
+}
+
+
+TEST_F(ITKImageFileReaderPrefetchTest, ConvertedPixelsAreStreamed)
+{
+  const ImageType::Pointer image = MakeImage(0.0f);
+  const std::string        fileName = "itkImageFileReaderPrefetchConverted.nrrd";
+  itk::WriteImage(image, fileName);
+
+  using DoubleImageType = itk::Image<double, 3>;
+  auto reader = itk::ImageFileReader<DoubleImageType>::New();
+  reader->SetFileName(fileName);
+  reader->UsePrefetchingOn();
+  reader->UpdateOutputInformation();
+  for (itk::IndexValueType slice = 0; slice < 48; slice += 5)
+  {
+    DoubleImageType::RegionType region{ { { 0, 0, slice } }, { { 128, 96, 5 } } };
+    region.Crop(reader->GetOutput()->GetLargestPossibleRegion());
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->Update();
+    const DoubleImageType::IndexType index{ { 127, 95, slice } };
+    EXPECT_EQ(reader->GetOutput()->GetPixel(index), static_cast<double>(image->GetPixel(index))) << slice;
+  }
+}
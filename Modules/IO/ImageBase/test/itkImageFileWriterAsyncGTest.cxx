@@ -0,0 +1,250 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageWriteExecutor.h"
+#include "itkMetaImageIO.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#define STRING(s) #s
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+struct ITKImageFileWriterAsyncTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(STRING(ITK_TEST_OUTPUT_DIR_STR));
+  }
+
+  static ImageType::Pointer
+  MakeImage(float offset)
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 64, 48, 32 } });
+    image->SetSpacing(itk::MakeVector(0.5, 1.0, 2.5));
+    image->Allocate();
+    float * const buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+    {
+      buffer[i] = offset + static_cast<float>(i % 1009);
+    }
+    return image;
+  }
+};
+} // namespace
+
+
+TEST_F(ITKImageFileWriterAsyncTest, InputIsSnapshot)
+{
+  const ImageType::Pointer image = MakeImage(0.0f);
+  const ImageType::Pointer expected = MakeImage(0.0f);
+
+  for (const std::string fileName :
+       { "itkImageFileWriterAsync.mha", "itkImageFileWriterAsync.nrrd", "itkImageFileWriterAsync.nii.gz" })
+  {
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->UseCompressionOn();
+    EXPECT_TRUE(writer->GetCopyInputForAsynchronousWrite());
+    std::future<void> written = writer->WriteAsync();
+
+    // Modifying the input does not modify the pixels written.
+    image->FillBuffer(-1.0f);
+    ASSERT_NO_THROW(written.get()) << fileName;
+    const ImageType::Pointer readImage = itk::ReadImage<ImageType>(fileName);
+    EXPECT_EQ(*readImage, *expected) << fileName;
+    EXPECT_EQ(readImage->GetSpacing(), expected->GetSpacing()) << fileName;
+    image->Graft(MakeImage(0.0f));
+  }
+}
+
+
+TEST_F(ITKImageFileWriterAsyncTest, PipelineIsUpdatedAndBufferShared)
+{
+  itk::WriteImage(MakeImage(0.0f), "itkImageFileWriterAsyncInput.mha");
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName("itkImageFileWriterAsyncInput.mha");
+  auto filter = itk::ShiftScaleImageFilter<ImageType, ImageType>::New();
+  filter->SetInput(reader->GetOutput());
+  filter->SetShift(3.0);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(filter->GetOutput());
+  writer->SetFileName("itkImageFileWriterAsyncPipeline.nrrd");
+  writer->CopyInputForAsynchronousWriteOff();
+  writer->SetNumberOfStreamDivisions(4);
+  ASSERT_NO_THROW(writer->WriteAsync().get());
+
+  const ImageType::Pointer readImage = itk::ReadImage<ImageType>("itkImageFileWriterAsyncPipeline.nrrd");
+  EXPECT_EQ(*readImage, *filter->GetOutput());
+  EXPECT_EQ(readImage->GetPixel({ { 63, 47, 31 } }), MakeImage(3.0f)->GetPixel({ { 63, 47, 31 } }));
+}
+
+
+TEST_F(ITKImageFileWriterAsyncTest, QueueIsBounded)
+{
+  const auto executor = itk::ImageWriteExecutor::GetInstance();
+  EXPECT_EQ(executor, itk::ImageWriteExecutor::New());
+  const itk::SizeValueType maximumNumberOfQueuedWrites = executor->GetMaximumNumberOfQueuedWrites();
+  executor->SetMaximumNumberOfQueuedWrites(2);
+  EXPECT_EQ(executor->GetMaximumNumberOfQueuedWrites(), 2u);
+
+  // A write blocking the thread of the executor, then as many writes as the
+  // queue holds.
+  std::promise<void>             unblock;
+  std::shared_future<void>       unblocked = unblock.get_future().share();
+  std::atomic<int>               numberOfWrites{ 0 };
+  std::vector<std::future<void>> futures;
+  futures.push_back(executor->Submit([unblocked, &numberOfWrites] {
+    unblocked.wait();
+    ++numberOfWrites;
+  }));
+  while (executor->GetNumberOfPendingWrites() != 1 || numberOfWrites != 0)
+  {
+    std::this_thread::yield();
+  }
+  for (int i = 0; i < 2; ++i)
+  {
+    futures.push_back(executor->Submit([&numberOfWrites] { ++numberOfWrites; }));
+  }
+  EXPECT_EQ(executor->GetNumberOfPendingWrites(), 3u);
+
+  // The next write waits for a write to be started.
+  std::future<std::future<void>> blocked = std::async(std::launch::async, [&executor, &numberOfWrites] {
+    return executor->Submit([&numberOfWrites] { ++numberOfWrites; });
+  });
+  EXPECT_EQ(blocked.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+  unblock.set_value();
+  futures.push_back(blocked.get());
+
+  executor->WaitForAll();
+  EXPECT_EQ(numberOfWrites, 4);
+  EXPECT_EQ(executor->GetNumberOfPendingWrites(), 0u);
+  for (auto & future : futures)
+  {
+    EXPECT_NO_THROW(future.get());
+  }
+  executor->SetMaximumNumberOfQueuedWrites(maximumNumberOfQueuedWrites);
+}
+
+
+TEST_F(ITKImageFileWriterAsyncTest, QueuedWritesHaveTheirOwnImageIO)
+{
+  const ImageType::Pointer image = MakeImage(0.0f);
+
+  // Blocks the thread of the executor, so that both writes are queued when
+  // the ImageIO is changed.
+  const auto         executor = itk::ImageWriteExecutor::GetInstance();
+  std::promise<void> unblock;
+  std::future<void>  blocking = executor->Submit([unblocked = unblock.get_future().share()] { unblocked.wait(); });
+
+  auto imageIO = itk::MetaImageIO::New();
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(imageIO);
+  writer->UseCompressionOn();
+
+  imageIO->SetCompressionBlockSize(4096);
+  writer->SetFileName("itkImageFileWriterAsyncBlocks.mha");
+  std::future<void> blocksWritten = writer->WriteAsync();
+
+  imageIO->SetCompressionBlockSize(0);
+  writer->SetFileName("itkImageFileWriterAsyncSingleStream.mha");
+  std::future<void> singleStreamWritten = writer->WriteAsync();
+
+  unblock.set_value();
+  ASSERT_NO_THROW(blocking.get());
+  ASSERT_NO_THROW(blocksWritten.get());
+  ASSERT_NO_THROW(singleStreamWritten.get());
+
+  // Each write used the options of the ImageIO when it was queued, and left
+  // the ImageIO of the writer unchanged.
+  EXPECT_EQ(writer->GetImageIO(), imageIO.GetPointer());
+  EXPECT_EQ(imageIO->GetCompressionBlockSize(), 0u);
+  const auto readHeader = [](const char * fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    std::string   contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return contents.substr(0, contents.find("ElementDataFile"));
+  };
+  EXPECT_NE(readHeader("itkImageFileWriterAsyncBlocks.mha").find("CompressedDataBlockSize = 4096"), std::string::npos);
+  EXPECT_EQ(readHeader("itkImageFileWriterAsyncSingleStream.mha").find("CompressedDataBlockSize"), std::string::npos);
+
+  for (const char * fileName : { "itkImageFileWriterAsyncBlocks.mha", "itkImageFileWriterAsyncSingleStream.mha" })
+  {
+    const ImageType::Pointer readImage = itk::ReadImage<ImageType>(fileName);
+    EXPECT_EQ(*readImage, *image) << fileName;
+  }
+}
+
+
+TEST_F(ITKImageFileWriterAsyncTest, ExceptionsAreReportedByTheFuture)
+{
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(MakeImage(0.0f));
+  writer->SetFileName("itkImageFileWriterAsyncMissingDirectory/image.mha");
+  std::future<void> written = writer->WriteAsync();
+  EXPECT_THROW(written.get(), itk::ExceptionObject);
+
+  writer->SetFileName("itkImageFileWriterAsync.unknownextension");
+  written = writer->WriteAsync();
+  EXPECT_THROW(written.get(), itk::ImageFileWriterException);
+
+  // Errors of the arguments are reported by WriteAsync() itself.
+  writer->SetFileName("");
+  EXPECT_THROW(writer->WriteAsync(), itk::ExceptionObject);
+}
+
+
+TEST_F(ITKImageFileWriterAsyncTest, VectorImagesAreWritten)
+{
+  using VectorImageType = itk::VectorImage<short, 2>;
+  auto image = VectorImageType::New();
+  image->SetRegions(VectorImageType::SizeType{ { 9, 7 } });
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+  for (unsigned int i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<short>(i);
+  }
+
+  auto writer = itk::ImageFileWriter<VectorImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName("itkImageFileWriterAsyncVector.mha");
+  ASSERT_NO_THROW(writer->WriteAsync().get());
+
+  const auto readImage = itk::ReadImage<VectorImageType>("itkImageFileWriterAsyncVector.mha");
+  EXPECT_EQ(readImage->GetNumberOfComponentsPerPixel(), 3u);
+  EXPECT_EQ(readImage->GetPixel({ { 8, 6 } })[2], 188);
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkGTest.h"
+#include "itksys/SystemTools.hxx"
+#include "itkTestDriverIncludeRequiredFactories.h"
+
+#define STRING(s) #s
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using ShiftScaleFilterType = itk::ShiftScaleImageFilter<ImageType, ImageType>;
+
+struct ITKImageFileWriterMemoryBudgetTest : public ::testing::Test
+{
+  void
+  SetUp() override
+  {
+    RegisterRequiredFactories();
+    itksys::SystemTools::ChangeDirectory(STRING(ITK_TEST_OUTPUT_DIR_STR));
+  }
+
+  static ImageType::Pointer
+  MakeImage()
+  {
+    auto image = ImageType::New();
+    image->SetRegions(ImageType::SizeType{ { 64, 48, 32 } });
+    image->Allocate();
+    float * const buffer = image->GetBufferPointer();
+    for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+    {
+      buffer[i] = static_cast<float>(i % 1009);
+    }
+    return image;
+  }
+};
+} // namespace
+
+
+TEST_F(ITKImageFileWriterMemoryBudgetTest, StreamsWithinBudget)
+{
+  const ImageType::Pointer image = MakeImage();
+
+  auto filter = ShiftScaleFilterType::New();
+  filter->SetInput(image);
+  filter->SetShift(1.0);
+  unsigned int numberOfExecutions = 0;
+  filter->AddObserver(itk::StartEvent(), [&numberOfExecutions](const itk::EventObject &) { ++numberOfExecutions; });
+
+  // A budget of a quarter of the image: the writer streams the output of the
+  // filter in at least 4 pieces.
+  const itk::SizeValueType budget = image->GetLargestPossibleRegion().GetNumberOfPixels() * sizeof(float) / 4;
+  auto                     writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(filter->GetOutput());
+  writer->SetFileName("itkImageFileWriterMemoryBudget.mha");
+  writer->SetMemoryBudget(budget);
+  EXPECT_EQ(writer->GetMemoryBudget(), budget);
+  ASSERT_NO_THROW(writer->Update());
+
+  EXPECT_GE(numberOfExecutions, 4u);
+  EXPECT_LE(filter->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(float), budget);
+
+  const ImageType::Pointer written = itk::ReadImage<ImageType>("itkImageFileWriterMemoryBudget.mha");
+  ASSERT_EQ(written->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+  const float * const writtenBuffer = written->GetBufferPointer();
+  const float * const imageBuffer = image->GetBufferPointer();
+  for (size_t i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    ASSERT_EQ(writtenBuffer[i], imageBuffer[i] + 1.0f) << "at offset " << i;
+  }
+}
+
+
+TEST_F(ITKImageFileWriterMemoryBudgetTest, NoBudgetWritesInOnePiece)
+{
+  const ImageType::Pointer image = MakeImage();
+
+  auto filter = ShiftScaleFilterType::New();
+  filter->SetInput(image);
+  unsigned int numberOfExecutions = 0;
+  filter->AddObserver(itk::StartEvent(), [&numberOfExecutions](const itk::EventObject &) { ++numberOfExecutions; });
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(filter->GetOutput());
+  writer->SetFileName("itkImageFileWriterMemoryBudgetOnePiece.mha");
+  EXPECT_EQ(writer->GetMemoryBudget(), 0u);
+  ASSERT_NO_THROW(writer->Update());
+
+  EXPECT_EQ(numberOfExecutions, 1u);
+  EXPECT_EQ(filter->GetOutput()->GetBufferedRegion(), image->GetLargestPossibleRegion());
+}
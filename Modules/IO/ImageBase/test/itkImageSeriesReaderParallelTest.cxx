@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageSeriesReader.h"
+#include "itkMetaImageIO.h"
+#include "itkNiftiImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkVectorImage.h"
+
+#include <algorithm>
+
+
+namespace
+{
+// Reads the series sequentially and in parallel, checking that both read the
+// same pixels and dictionaries.
+template <typename TImage>
+int
+TestParallelReading(const std::vector<std::string> & fileNames,
+                    bool                             reverseOrder,
+                    const itk::ImageIOBase::Pointer & imageIO,
+                    unsigned int                     firstSlice,
+                    unsigned int                     numberOfSlices)
+{
+  std::cout << "Reading " << fileNames.size() << " files" << (reverseOrder ? " in reverse order" : "")
+            << (imageIO ? " with an ImageIO" : "") << ", slices " << firstSlice << " to "
+            << firstSlice + numberOfSlices - 1 << std::endl;
+
+  typename TImage::Pointer                         images[2];
+  std::vector<const itk::MetaDataDictionary *>     dictionaries[2];
+  typename itk::ImageSeriesReader<TImage>::Pointer readers[2];
+  for (const bool parallel : { false, true })
+  {
+    auto reader = itk::ImageSeriesReader<TImage>::New();
+    reader->SetFileNames(fileNames);
+    reader->SetReverseOrder(reverseOrder);
+    reader->SetImageIO(imageIO);
+    reader->SetUseParallelReading(parallel);
+    reader->SetNumberOfWorkUnits(4);
+    ITK_TEST_SET_GET_VALUE(parallel, reader->GetUseParallelReading());
+    reader->UpdateOutputInformation();
+    auto region = reader->GetOutput()->GetLargestPossibleRegion();
+    region.SetIndex(2, firstSlice);
+    region.SetSize(2, numberOfSlices);
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    images[parallel] = reader->GetOutput();
+    ITK_TEST_EXPECT_EQUAL(images[parallel]->GetBufferedRegion(), region);
+    dictionaries[parallel].assign(reader->GetMetaDataDictionaryArray()->begin(),
+                                  reader->GetMetaDataDictionaryArray()->end());
+    readers[parallel] = reader;
+  }
+
+  const size_t size = images[0]->GetPixelContainer()->Size();
+  ITK_TEST_EXPECT_EQUAL(images[1]->GetPixelContainer()->Size(), size);
+  if (!std::equal(images[0]->GetBufferPointer(), images[0]->GetBufferPointer() + size, images[1]->GetBufferPointer()))
+  {
+    std::cerr << "The pixels read in parallel differ from the pixels read sequentially." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ITK_TEST_EXPECT_EQUAL(dictionaries[1].size(), dictionaries[0].size());
+  for (size_t i = 0; i < std::min(dictionaries[0].size(), dictionaries[1].size()); ++i)
+  {
+    double deviations[2] = { 0.0, 0.0 };
+    for (unsigned int parallel = 0; parallel < 2; ++parallel)
+    {
+      itk::ExposeMetaData<double>(
+        *dictionaries[parallel][i], "ITK_non_uniform_sampling_deviation", deviations[parallel]);
+    }
+    ITK_TEST_EXPECT_EQUAL(deviations[1], deviations[0]);
+  }
+
+  double deviations[2] = { 0.0, 0.0 };
+  for (unsigned int parallel = 0; parallel < 2; ++parallel)
+  {
+    itk::ExposeMetaData<double>(
+      images[parallel]->GetMetaDataDictionary(), "ITK_non_uniform_sampling_deviation", deviations[parallel]);
+  }
+  ITK_TEST_EXPECT_EQUAL(deviations[1], deviations[0]);
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkImageSeriesReaderParallelTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using PixelType = unsigned short;
+  using ImageType = itk::Image<PixelType, 3>;
+  using VectorImageType = itk::VectorImage<PixelType, 3>;
+
+  // Slices of a single pixel thickness, 2 apart, with a missing slice.
+  constexpr unsigned int   numberOfFiles = 13;
+  std::vector<std::string> fileNames;
+  std::vector<std::string> uniformFileNames;
+  for (unsigned int f = 0; f < numberOfFiles + 1; ++f)
+  {
+    auto slice = ImageType::New();
+    slice->SetRegions(ImageType::SizeType{ { 23, 17, 1 } });
+    slice->SetSpacing(itk::MakeVector(1.0, 1.0, 2.0));
+    slice->SetOrigin(itk::MakePoint(0.0, 0.0, 2.0 * f));
+    slice->Allocate();
+    PixelType value = 0;
+    for (itk::ImageRegionIterator<ImageType> it(slice, slice->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      it.Set(static_cast<PixelType>(1000 * f + value++));
+    }
+    const std::string fileName =
+      std::string(argv[1]) + "/itkImageSeriesReaderParallelTest" + std::to_string(f) + ".mha";
+    itk::WriteImage(slice, fileName);
+    if (f < numberOfFiles)
+    {
+      uniformFileNames.push_back(fileName);
+    }
+    if (f != 7)
+    {
+      fileNames.push_back(fileName);
+    }
+  }
+
+  int testStatus = EXIT_SUCCESS;
+  for (const bool reverseOrder : { false, true })
+  {
+    testStatus |= TestParallelReading<ImageType>(uniformFileNames, reverseOrder, nullptr, 0, numberOfFiles);
+    testStatus |= TestParallelReading<ImageType>(fileNames, reverseOrder, nullptr, 0, numberOfFiles);
+    testStatus |= TestParallelReading<ImageType>(fileNames, reverseOrder, itk::MetaImageIO::New(), 3, 6);
+    testStatus |= TestParallelReading<VectorImageType>(fileNames, reverseOrder, nullptr, 2, 9);
+  }
+
+  // The reading options of the ImageIO apply to the files read in parallel:
+  // the vectors of NIfTI files are converted from RAS to LPS.
+  using FloatVectorImageType = itk::VectorImage<float, 3>;
+  std::vector<std::string> vectorFileNames;
+  for (unsigned int f = 0; f < 5; ++f)
+  {
+    auto slice = FloatVectorImageType::New();
+    slice->SetRegions(FloatVectorImageType::SizeType{ { 7, 5, 1 } });
+    slice->SetOrigin(itk::MakePoint(0.0, 0.0, 1.0 * f));
+    slice->SetNumberOfComponentsPerPixel(3);
+    slice->Allocate();
+    float value = 1.0f;
+    for (itk::ImageRegionIterator<FloatVectorImageType> it(slice, slice->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      const float pixel[3] = { value, value + 0.25f, value + 0.5f };
+      it.Set(itk::VariableLengthVector<float>(const_cast<float *>(pixel), 3));
+      value += 1.0f;
+    }
+    vectorFileNames.push_back(std::string(argv[1]) + "/itkImageSeriesReaderParallelTestVector" + std::to_string(f) +
+                              ".nii");
+    itk::WriteImage(slice, vectorFileNames.back());
+  }
+  auto niftiImageIO = itk::NiftiImageIO::New();
+  niftiImageIO->ConvertRASVectorsOn();
+  testStatus |= TestParallelReading<FloatVectorImageType>(vectorFileNames, false, niftiImageIO.GetPointer(), 0, 5);
+
+  auto vectorReader = itk::ImageSeriesReader<FloatVectorImageType>::New();
+  vectorReader->SetFileNames(vectorFileNames);
+  vectorReader->SetImageIO(niftiImageIO);
+  vectorReader->SetUseParallelReading(true);
+  vectorReader->SetNumberOfWorkUnits(4);
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorReader->Update());
+  const float * const vectorBuffer = vectorReader->GetOutput()->GetBufferPointer();
+  ITK_TEST_EXPECT_EQUAL(vectorBuffer[0], -1.0f);
+  ITK_TEST_EXPECT_EQUAL(vectorBuffer[1], -1.25f);
+  ITK_TEST_EXPECT_EQUAL(vectorBuffer[2], 1.5f);
+
+  // The files are read with clones of the ImageIO, which have its options.
+  auto imageIO = itk::MetaImageIO::New();
+  imageIO->SetUseCompression(true);
+  imageIO->SetCompressionLevel(7);
+  const itk::LightObject::Pointer clone = imageIO->Clone();
+  const auto *                    clonedImageIO = dynamic_cast<itk::MetaImageIO *>(clone.GetPointer());
+  ITK_TEST_EXPECT_TRUE(clonedImageIO != nullptr && clonedImageIO != imageIO.GetPointer());
+  ITK_TEST_EXPECT_TRUE(clonedImageIO->GetUseCompression());
+  ITK_TEST_EXPECT_EQUAL(clonedImageIO->GetCompressionLevel(), 7);
+
+  niftiImageIO->SetCompressionBlockSize(4096);
+  niftiImageIO->SetUseBlockCompression(false);
+  const itk::LightObject::Pointer niftiClone = niftiImageIO->Clone();
+  const auto *                    clonedNiftiImageIO = dynamic_cast<itk::NiftiImageIO *>(niftiClone.GetPointer());
+  ITK_TEST_EXPECT_TRUE(clonedNiftiImageIO != nullptr);
+  ITK_TEST_EXPECT_TRUE(clonedNiftiImageIO->GetConvertRASVectors());
+  ITK_TEST_EXPECT_TRUE(!clonedNiftiImageIO->GetUseBlockCompression());
+  ITK_TEST_EXPECT_EQUAL(clonedNiftiImageIO->GetCompressionBlockSize(), 4096u);
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
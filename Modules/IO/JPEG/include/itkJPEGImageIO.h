@@ -74,6 +74,13 @@ public:
   itkGetConstMacro(CMYKtoRGB, bool);
   itkBooleanMacro(CMYKtoRGB);
 
+  /** Decode with the fast integer inverse DCT of libjpeg, and without the
+   * smoothing of upsampled chroma components: faster, but less accurate.
+   * Default is false. */
+  itkSetMacro(UseFastDecoding, bool);
+  itkGetConstMacro(UseFastDecoding, bool);
+  itkBooleanMacro(UseFastDecoding);
+
   /*-------- This part of the interface deals with reading data. ------ */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -116,6 +123,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Also copies the options of the JPEG decoding and encoding. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   WriteSlice(std::string & fileName, const void * const buffer);
 
@@ -124,6 +135,8 @@ protected:
   bool m_CMYKtoRGB{ true };
 
   bool m_IsCMYK{ false };
+
+  bool m_UseFastDecoding{ false };
 };
 } // end namespace itk
 
@@ -204,6 +204,12 @@ JPEGImageIO::Read(void * buffer)
   // so has to be used here too
   jpeg_calc_output_dimensions(&cinfo);
 
+  if (m_UseFastDecoding)
+  {
+    cinfo.dct_method = JDCT_IFAST;
+    cinfo.do_fancy_upsampling = FALSE;
+  }
+
   // prepare to read the bulk data
   jpeg_start_decompress(&cinfo);
 
@@ -318,6 +324,22 @@ JPEGImageIO::JPEGImageIO()
 
 JPEGImageIO::~JPEGImageIO() = default;
 
+LightObject::Pointer
+JPEGImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_Progressive = m_Progressive;
+  rval->m_CMYKtoRGB = m_CMYKtoRGB;
+  rval->m_UseFastDecoding = m_UseFastDecoding;
+  return loPtr;
+}
+
 void
 JPEGImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -326,6 +348,7 @@ JPEGImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Progressive : " << m_Progressive << '\n';
   os << indent << "CMYK to RGB : " << m_CMYKtoRGB << '\n';
   os << indent << "IsCMYK : " << m_IsCMYK << '\n';
+  os << indent << "UseFastDecoding : " << m_UseFastDecoding << '\n';
 }
 
 void
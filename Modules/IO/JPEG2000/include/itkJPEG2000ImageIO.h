@@ -73,6 +73,10 @@ extern ITKIOJPEG2000_EXPORT std::ostream &
  *  JPEG2000 offers a large collection of interesting features including:
  *  compression (lossless and lossy), streaming, multi-channel images.
  *
+ *  The tiles intersecting the region read are decoded concurrently, in bands
+ *  of tiles that each have their own decoder. A reduced resolution of the
+ *  image can be read by setting a reduce factor.
+ *
  *
  * This code was contributed in the Insight Journal paper:
  * "Support for Streaming the JPEG2000 File Format"
@@ -141,6 +145,16 @@ public:
   SizeType
   GetHeaderSize() const override;
 
+  /** Set/Get the reduce factor used when reading: the image is read at its
+   * resolution divided by 2^ReduceFactor in each dimension, and only the
+   * wavelet resolution levels needed for it are decoded. The factor must be
+   * less than the number of resolution levels of the code-stream. The spacing
+   * and the origin of the image are those of the reduced pixels. The default,
+   * 0, reads the full resolution. Must be set before ReadImageInformation().
+   */
+  itkSetMacro(ReduceFactor, unsigned int);
+  itkGetConstMacro(ReduceFactor, unsigned int);
+
   /** Define the tile size to use when writing out an image. */
   void
   SetTileSize(int x, int y);
@@ -160,6 +174,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Also copies the reduce factor read and the tile size written. */
+  LightObject::Pointer
+  InternalClone() const override;
+
 private:
   std::unique_ptr<JPEG2000ImageIOInternal> m_Internal;
 
@@ -167,7 +185,12 @@ private:
   using IndexValueType = ImageIORegion::IndexValueType;
 
   void
-  ComputeRegionInTileBoundaries(unsigned int dimension, SizeValueType tileSize, ImageIORegion & streamableRegion) const;
+  ComputeRegionInTileBoundaries(unsigned int    dimension,
+                                SizeValueType   tileStart,
+                                SizeValueType   tileSize,
+                                ImageIORegion & streamableRegion) const;
+
+  unsigned int m_ReduceFactor{ 0 };
 };
 } // end namespace itk
 
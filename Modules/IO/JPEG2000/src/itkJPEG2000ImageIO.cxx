@@ -17,8 +17,13 @@
  *=========================================================================*/
 
 #include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
 #include "itksys/SystemTools.hxx"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 // for memset
 // for malloc
 
@@ -69,6 +74,211 @@ public:
 };
 
 
+namespace
+{
+// Returns the coordinate, at the resolution reduced by 2^reduceFactor, of the
+// given coordinate at the full resolution.
+OPJ_INT32
+ReduceCoordinate(OPJ_INT32 coordinate, unsigned int reduceFactor)
+{
+  return (coordinate + (OPJ_INT32{ 1 } << reduceFactor) - 1) >> reduceFactor;
+}
+
+// Decodes tiles of a file, with its own stream and codec, so that separate
+// areas of the file can be decoded concurrently.
+class JPEG2000TileDecoder
+{
+public:
+  JPEG2000TileDecoder() = default;
+  ITK_DISALLOW_COPY_AND_MOVE(JPEG2000TileDecoder);
+
+  ~JPEG2000TileDecoder()
+  {
+    if (m_Image)
+    {
+      opj_image_destroy(m_Image);
+    }
+    if (m_Codec)
+    {
+      opj_destroy_codec(m_Codec);
+    }
+    if (m_Stream)
+    {
+      opj_stream_destroy(m_Stream);
+    }
+    if (m_File)
+    {
+      fclose(m_File);
+    }
+  }
+
+  // Opens the file and reads the main header of its code-stream. Returns the
+  // reason of the failure, or an empty string.
+  std::string
+  Open(const std::string & fileName, opj_dparameters_t & parameters)
+  {
+    m_File = fopen(fileName.c_str(), "rb");
+    if (!m_File)
+    {
+      return itksys::SystemTools::GetLastSystemError();
+    }
+    m_Stream = opj_stream_create_default_file_stream(m_File, true);
+    if (!m_Stream)
+    {
+      return "opj_stream_create_default_file_stream returns nullptr";
+    }
+    switch (parameters.decod_format)
+    {
+      case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::J2K_CFMT):
+        m_Codec = opj_create_decompress(CODEC_J2K);
+        break;
+      case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JP2_CFMT):
+        m_Codec = opj_create_decompress(CODEC_JP2);
+        break;
+      case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JPT_CFMT):
+        m_Codec = opj_create_decompress(CODEC_JPT);
+        break;
+      default:
+        return "Unknown decode format: " + std::to_string(parameters.decod_format);
+    }
+    if (!m_Codec)
+    {
+      return "opj_create_decompress returns nullptr";
+    }
+    if (!opj_setup_decoder(m_Codec, &parameters))
+    {
+      return "opj_setup_decoder returns false";
+    }
+    OPJ_INT32  tileX0;
+    OPJ_INT32  tileY0;
+    OPJ_UINT32 tileWidth;
+    OPJ_UINT32 tileHeight;
+    OPJ_UINT32 numberOfTilesInX;
+    OPJ_UINT32 numberOfTilesInY;
+    if (!opj_read_header(m_Codec,
+                         &m_Image,
+                         &tileX0,
+                         &tileY0,
+                         &tileWidth,
+                         &tileHeight,
+                         &numberOfTilesInX,
+                         &numberOfTilesInY,
+                         m_Stream) ||
+        !m_Image)
+    {
+      return "opj_read_header returns false";
+    }
+    return {};
+  }
+
+  // Decodes the tiles intersecting the area, given at the full resolution, and
+  // copies their pixels that are within the region, given at the reduced
+  // resolution, to the buffer holding the region. Returns the reason of the
+  // failure, or an empty string.
+  std::string
+  DecodeArea(const OPJ_INT32       areaStart[2],
+             const OPJ_INT32       areaEnd[2],
+             const ImageIORegion & region,
+             unsigned int          numberOfComponents,
+             unsigned int          reduceFactor,
+             unsigned char *       buffer)
+  {
+    if (!opj_set_decode_area(m_Codec, areaStart[0], areaStart[1], areaEnd[0], areaEnd[1]))
+    {
+      return "opj_set_decode_area returns false";
+    }
+
+    const auto regionX0 = static_cast<OPJ_INT32>(region.GetIndex(0));
+    const auto regionY0 = static_cast<OPJ_INT32>(region.GetIndex(1));
+    const auto regionX1 = static_cast<OPJ_INT32>(region.GetIndex(0) + region.GetSize(0));
+    const auto regionY1 = static_cast<OPJ_INT32>(region.GetIndex(1) + region.GetSize(1));
+
+    std::vector<OPJ_BYTE> data;
+    bool                  goOn = true;
+    while (goOn)
+    {
+      OPJ_UINT32 tileIndex;
+      OPJ_UINT32 dataSize;
+      OPJ_INT32  tileX0;
+      OPJ_INT32  tileY0;
+      OPJ_INT32  tileX1;
+      OPJ_INT32  tileY1;
+      OPJ_UINT32 numberOfTileComponents;
+      if (!opj_read_tile_header(m_Codec,
+                                &tileIndex,
+                                &dataSize,
+                                &tileX0,
+                                &tileY0,
+                                &tileX1,
+                                &tileY1,
+                                &numberOfTileComponents,
+                                &goOn,
+                                m_Stream))
+      {
+        return "opj_read_tile_header returns false";
+      }
+      if (!goOn)
+      {
+        break;
+      }
+      data.resize(std::max<size_t>(data.size(), dataSize));
+      if (!opj_decode_tile_data(m_Codec, tileIndex, data.data(), dataSize, m_Stream))
+      {
+        return "opj_decode_tile_data returns false";
+      }
+
+      // The tile data holds each component in turn, at the reduced resolution.
+      tileX0 = ReduceCoordinate(tileX0, reduceFactor);
+      tileY0 = ReduceCoordinate(tileY0, reduceFactor);
+      tileX1 = ReduceCoordinate(tileX1, reduceFactor);
+      tileY1 = ReduceCoordinate(tileY1, reduceFactor);
+      const size_t    tileWidth = tileX1 - tileX0;
+      const size_t    tileHeight = tileY1 - tileY0;
+      const OPJ_INT32 x0 = std::max(tileX0, regionX0);
+      const OPJ_INT32 x1 = std::min(tileX1, regionX1);
+      const OPJ_INT32 y0 = std::max(tileY0, regionY0);
+      const OPJ_INT32 y1 = std::min(tileY1, regionY1);
+      if (x0 >= x1 || y0 >= y1)
+      {
+        continue;
+      }
+      const size_t componentSize = dataSize / (tileWidth * tileHeight * numberOfComponents);
+      const size_t pixelSize = componentSize * numberOfComponents;
+      for (unsigned int k = 0; k < numberOfComponents; ++k)
+      {
+        for (OPJ_INT32 y = y0; y < y1; ++y)
+        {
+          const OPJ_BYTE * source =
+            data.data() + ((k * tileHeight + (y - tileY0)) * tileWidth + (x0 - tileX0)) * componentSize;
+          unsigned char * destination =
+            buffer + (static_cast<size_t>(y - regionY0) * region.GetSize(0) + (x0 - regionX0)) * pixelSize +
+            k * componentSize;
+          for (OPJ_INT32 x = x0; x < x1; ++x)
+          {
+            std::memcpy(destination, source, componentSize);
+            source += componentSize;
+            destination += pixelSize;
+          }
+        }
+      }
+    }
+
+    if (!opj_end_decompress(m_Codec, m_Stream))
+    {
+      return "opj_end_decompress returns false";
+    }
+    return {};
+  }
+
+private:
+  FILE *         m_File{ nullptr };
+  opj_stream_t * m_Stream{ nullptr };
+  opj_codec_t *  m_Codec{ nullptr };
+  opj_image_t *  m_Image{ nullptr };
+};
+} // namespace
+
+
 JPEG2000ImageIO::JPEG2000ImageIO()
   : m_Internal(new JPEG2000ImageIOInternal)
 {
@@ -100,10 +310,28 @@ JPEG2000ImageIO::JPEG2000ImageIO()
 
 JPEG2000ImageIO::~JPEG2000ImageIO() = default;
 
+LightObject::Pointer
+JPEG2000ImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ReduceFactor = m_ReduceFactor;
+  rval->m_Internal->m_TileWidth = m_Internal->m_TileWidth;
+  rval->m_Internal->m_TileHeight = m_Internal->m_TileHeight;
+  return loPtr;
+}
+
 void
 JPEG2000ImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "ReduceFactor: " << m_ReduceFactor << std::endl;
 }
 
 bool
@@ -152,6 +380,7 @@ JPEG2000ImageIO::ReadImageInformation()
 
   /* set decoding parameters to default values */
   opj_set_default_decoder_parameters(&(this->m_Internal->m_DecompressionParameters));
+  this->m_Internal->m_DecompressionParameters.cp_reduce = static_cast<int>(this->m_ReduceFactor);
 
   opj_stream_t * cio = opj_stream_create_default_file_stream(l_file, true);
 
@@ -341,11 +570,17 @@ JPEG2000ImageIO::ReadImageInformation()
   itkDebugMacro(<< "image->x1 = " << l_image->x1);
   itkDebugMacro(<< "image->y1 = " << l_image->y1);
 
-  this->SetDimensions(0, l_image->x1);
-  this->SetDimensions(1, l_image->y1);
+  // A reduced resolution pixel covers 2^ReduceFactor pixels of the full
+  // resolution in each dimension, starting at the first one.
+  const double reductionScale = static_cast<double>(OPJ_INT32{ 1 } << this->m_ReduceFactor);
+  this->SetDimensions(0, ReduceCoordinate(l_image->x1, this->m_ReduceFactor));
+  this->SetDimensions(1, ReduceCoordinate(l_image->y1, this->m_ReduceFactor));
+
+  this->SetSpacing(0, reductionScale); // FIXME : Get the real pixel resolution.
+  this->SetSpacing(1, reductionScale); // FIXME : Get the real pixel resolution.
 
-  this->SetSpacing(0, 1.0); // FIXME : Get the real pixel resolution.
-  this->SetSpacing(1, 1.0); // FIXME : Get the real pixel resolution.
+  this->SetOrigin(0, 0.5 * (reductionScale - 1.0));
+  this->SetOrigin(1, 0.5 * (reductionScale - 1.0));
 
   /* close the byte stream */
   opj_stream_destroy(cio);
@@ -368,327 +603,78 @@ JPEG2000ImageIO::Read(void * buffer)
 {
   itkDebugMacro(<< "JPEG2000ImageIO::Read() Begin");
 
-  FILE * l_file = fopen(this->m_FileName.c_str(), "rb");
-
-  if (!l_file)
-  {
-    itkExceptionMacro("JPEG2000ImageIO failed to open file for reading: " << this->GetFileName() << std::endl
-                                                                          << "Reason: "
-                                                                          << itksys::SystemTools::GetLastSystemError());
-  }
-
-  opj_stream_t * l_stream = opj_stream_create_default_file_stream(l_file, true);
-  if (!l_stream)
+  const ImageIORegion regionToRead = this->GetIORegion();
+  // The reduce factor used by ReadImageInformation(), to which the region
+  // and the dimensions apply.
+  const auto reduceFactor = static_cast<unsigned int>(this->m_Internal->m_DecompressionParameters.cp_reduce);
+
+  // The tiles intersecting the region, at the full resolution.
+  const OPJ_INT32 tileStart[2] = { static_cast<OPJ_INT32>(this->m_Internal->m_TileStartX),
+                                   static_cast<OPJ_INT32>(this->m_Internal->m_TileStartY) };
+  const OPJ_INT32 tileSize[2] = { static_cast<OPJ_INT32>(this->m_Internal->m_TileWidth),
+                                  static_cast<OPJ_INT32>(this->m_Internal->m_TileHeight) };
+  const OPJ_INT32 numberOfTiles[2] = { static_cast<OPJ_INT32>(this->m_Internal->m_NumberOfTilesInX),
+                                       static_cast<OPJ_INT32>(this->m_Internal->m_NumberOfTilesInY) };
+  OPJ_INT32       firstTile[2];
+  OPJ_INT32       endTile[2];
+  for (unsigned int d = 0; d < 2; ++d)
   {
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                      << this->GetFileName() << std::endl
-                      << "Reason: opj_stream_create_default_file_stream returns nullptr");
+    const auto areaStart = static_cast<OPJ_INT32>(regionToRead.GetIndex(d) << reduceFactor);
+    const auto areaEnd = static_cast<OPJ_INT32>((regionToRead.GetIndex(d) + regionToRead.GetSize(d)) << reduceFactor);
+    firstTile[d] = std::max((areaStart - tileStart[d]) / tileSize[d], 0);
+    endTile[d] = std::min((areaEnd - tileStart[d] + tileSize[d] - 1) / tileSize[d], numberOfTiles[d]);
   }
 
-  this->m_Internal->m_Dinfo = nullptr; /* handle to a decompressor */
-
-  opj_image_t * l_image = nullptr;
-
-  /* decode the code-stream */
-  /* ---------------------- */
-  switch (this->m_Internal->m_DecompressionParameters.decod_format)
-  {
-    case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::J2K_CFMT):
-    {
-      /* JPEG-2000 codestream */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_J2K);
-      if (!this->m_Internal->m_Dinfo)
-      {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_J2K) returns nullptr");
-      }
-      break;
-    }
-    case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JP2_CFMT):
-    {
-      /* JPEG 2000 compressed image data */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_JP2);
-      if (!this->m_Internal->m_Dinfo)
-      {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_JP2) returns nullptr");
-      }
-      break;
-    }
-    case static_cast<int>(JPEG2000ImageIOInternal::DecodingFormatEnum::JPT_CFMT):
+  // The tiles are decoded in bands of whole tiles, each with its own decoder,
+  // concurrently when there is more than one band. The bands are split along
+  // the dimension that has the most tiles.
+  const auto         multiThreader = MultiThreaderBase::New();
+  const unsigned int splitDimension = (endTile[1] - firstTile[1] >= endTile[0] - firstTile[0]) ? 1 : 0;
+  const OPJ_INT32    numberOfTilesToSplit = std::max(endTile[splitDimension] - firstTile[splitDimension], 0);
+  const auto         numberOfBands = static_cast<SizeValueType>(
+    std::min(numberOfTilesToSplit, static_cast<OPJ_INT32>(multiThreader->GetNumberOfWorkUnits())));
+
+  const auto decodeBand = [&, this](SizeValueType band) {
+    OPJ_INT32 areaStart[2];
+    OPJ_INT32 areaEnd[2];
+    for (unsigned int d = 0; d < 2; ++d)
     {
-      /* JPEG 2000, JPIP */
-      /* get a decoder handle */
-      this->m_Internal->m_Dinfo = opj_create_decompress(CODEC_JPT);
-      if (!this->m_Internal->m_Dinfo)
+      OPJ_INT32 bandFirstTile = firstTile[d];
+      OPJ_INT32 bandEndTile = endTile[d];
+      if (d == splitDimension)
       {
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                          << this->GetFileName() << std::endl
-                          << "Reason: opj_create_decompress(CODEC_JPT) returns nullptr");
+        bandFirstTile += static_cast<OPJ_INT32>(band * numberOfTilesToSplit / numberOfBands);
+        bandEndTile = firstTile[d] + static_cast<OPJ_INT32>((band + 1) * numberOfTilesToSplit / numberOfBands);
       }
-      break;
+      areaStart[d] = tileStart[d] + bandFirstTile * tileSize[d];
+      areaEnd[d] = tileStart[d] + bandEndTile * tileSize[d];
     }
-    default:
-      fclose(l_file);
-      itkExceptionMacro("JPEG2000ImageIO failed to read file: "
-                        << this->GetFileName() << std::endl
-                        << "Reason: "
-                        << "Unknown decode format: " << this->m_Internal->m_DecompressionParameters.decod_format);
-  }
-  /* catch events using our callbacks and give a local context */
-
-  /* setup the decoder decoding parameters using user parameters */
-  if (!opj_setup_decoder(this->m_Internal->m_Dinfo, &(this->m_Internal->m_DecompressionParameters)))
-  {
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: opj_setup_decoder returns false");
-  }
-
-  OPJ_INT32 l_tile_x0, l_tile_y0;
-
-  OPJ_UINT32 l_tile_width;
-  OPJ_UINT32 l_tile_height;
-  OPJ_UINT32 l_nb_tiles_x;
-  OPJ_UINT32 l_nb_tiles_y;
-
-  bool bResult = opj_read_header(this->m_Internal->m_Dinfo,
-                                 &l_image,
-                                 &l_tile_x0,
-                                 &l_tile_y0,
-                                 &l_tile_width,
-                                 &l_tile_height,
-                                 &l_nb_tiles_x,
-                                 &l_nb_tiles_y,
-                                 l_stream);
-
-  if (!bResult)
-  {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: opj_read_header returns false");
-  }
-
-  ImageIORegion regionToRead = this->GetIORegion();
-
-  ImageIORegion::SizeType  size = regionToRead.GetSize();
-  ImageIORegion::IndexType start = regionToRead.GetIndex();
-
-  const unsigned int sizex = size[0];
-  const unsigned int sizey = size[1];
-  // const unsigned int sizez = size[2];
 
-  const unsigned int startx = start[0];
-  const unsigned int starty = start[1];
-  // const unsigned int startz = start[2];
-
-  auto p_start_x = static_cast<OPJ_INT32>(startx);
-  auto p_start_y = static_cast<OPJ_INT32>(starty);
-  auto p_end_x = static_cast<OPJ_INT32>(startx + sizex);
-  auto p_end_y = static_cast<OPJ_INT32>(starty + sizey);
-
-  itkDebugMacro(<< "opj_set_decode_area() before");
-  itkDebugMacro(<< "p_start_x = " << p_start_x);
-  itkDebugMacro(<< "p_start_y = " << p_start_y);
-  itkDebugMacro(<< "p_end_x = " << p_end_x);
-  itkDebugMacro(<< "p_end_y = " << p_end_y);
-
-  bResult = opj_set_decode_area(this->m_Internal->m_Dinfo, p_start_x, p_start_y, p_end_x, p_end_y);
-
-  itkDebugMacro(<< "opj_set_decode_area() after");
-
-  if (!bResult)
-  {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: opj_set_decode_area returns false");
-  }
-
-  OPJ_INT32 l_current_tile_x0;
-  OPJ_INT32 l_current_tile_y0;
-  OPJ_INT32 l_current_tile_x1;
-  OPJ_INT32 l_current_tile_y1;
-
-  OPJ_UINT32 l_tile_index;
-  OPJ_UINT32 l_data_size;
-
-  OPJ_UINT32 l_nb_comps;
-
-  OPJ_UINT32 l_max_data_size = 1000;
-
-  bool l_go_on = true;
-
-  auto * l_data = (OPJ_BYTE *)malloc(1000);
-
-  while (l_go_on)
-  {
-    bool tileHeaderRead = opj_read_tile_header(this->m_Internal->m_Dinfo,
-                                               &l_tile_index,
-                                               &l_data_size,
-                                               &l_current_tile_x0,
-                                               &l_current_tile_y0,
-                                               &l_current_tile_x1,
-                                               &l_current_tile_y1,
-                                               &l_nb_comps,
-                                               &l_go_on,
-                                               l_stream);
-
-    if (!tileHeaderRead)
+    JPEG2000TileDecoder decoder;
+    std::string         failure = decoder.Open(this->GetFileName(), this->m_Internal->m_DecompressionParameters);
+    if (failure.empty())
     {
-      free(l_data);
-      opj_stream_destroy(l_stream);
-      fclose(l_file);
-      opj_destroy_codec(this->m_Internal->m_Dinfo);
-      opj_image_destroy(l_image);
-      itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                                << "Reason: opj_read_tile_header returns false");
+      failure = decoder.DecodeArea(areaStart,
+                                   areaEnd,
+                                   regionToRead,
+                                   this->GetNumberOfComponents(),
+                                   reduceFactor,
+                                   static_cast<unsigned char *>(buffer));
     }
-
-    itkDebugMacro(<< "l_tile_index " << l_tile_index);
-    itkDebugMacro(<< "l_data_size " << l_data_size);
-    itkDebugMacro(<< "l_current_tile_x0 " << l_current_tile_x0);
-    itkDebugMacro(<< "l_current_tile_y0 " << l_current_tile_y0);
-    itkDebugMacro(<< "l_current_tile_x1 " << l_current_tile_x1);
-    itkDebugMacro(<< "l_current_tile_y1 " << l_current_tile_y1);
-    itkDebugMacro(<< "l_nb_comps " << l_nb_comps);
-    itkDebugMacro(<< "l_go_on " << l_go_on);
-
-    if (l_go_on)
+    if (!failure.empty())
     {
-      if (l_data_size > l_max_data_size)
-      {
-        l_data = (OPJ_BYTE *)realloc(l_data, l_data_size);
-
-        if (!l_data)
-        {
-          opj_stream_destroy(l_stream);
-          fclose(l_file);
-          opj_destroy_codec(this->m_Internal->m_Dinfo);
-          opj_image_destroy(l_image);
-          itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                                    << "Reason: Error reallocating memory");
-        }
-
-        itkDebugMacro(<< "reallocated for " << l_data_size);
-
-        l_max_data_size = l_data_size;
-      }
-
-      bool decodeTileData =
-        opj_decode_tile_data(this->m_Internal->m_Dinfo, l_tile_index, l_data, l_data_size, l_stream);
-
-      if (!decodeTileData)
-      {
-        free(l_data);
-        opj_stream_destroy(l_stream);
-        fclose(l_file);
-        opj_destroy_codec(this->m_Internal->m_Dinfo);
-        opj_image_destroy(l_image);
-        itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                                  << "Reason: opj_decode_tile_data returns false");
-      }
-
-      OPJ_BYTE * l_data_ptr = l_data;
-
-      const SizeValueType tsizex = l_current_tile_x1 - l_current_tile_x0;
-      const SizeValueType tsizey = l_current_tile_y1 - l_current_tile_y0;
-      const SizeValueType numberOfPixels = tsizex * tsizey;
-      const SizeValueType numberOfComponents = this->GetNumberOfComponents();
-      const SizeValueType sizePerComponentInBytes = l_data_size / (numberOfPixels * numberOfComponents);
-      const SizeValueType sizePerChannelInBytes = l_data_size / (numberOfComponents);
-
-      itkDebugMacro(<< "sizePerComponentInBytes: " << sizePerComponentInBytes);
-      itkDebugMacro(<< "sizePerChannelInBytes:   " << sizePerChannelInBytes);
-
-      const SizeValueType sizePerStrideXInBytes = sizePerChannelInBytes / tsizey;
-      const SizeValueType initialStrideInBytes =
-        (l_current_tile_y0 - p_start_y) * sizex * sizePerComponentInBytes * numberOfComponents;
-      const SizeValueType priorStrideInBytes =
-        (l_current_tile_x0 - p_start_x) * sizePerComponentInBytes * numberOfComponents;
-      const SizeValueType postStrideInBytes =
-        (p_end_x - l_current_tile_x1) * sizePerComponentInBytes * numberOfComponents;
-
-      itkDebugMacro(<< "sizePerStrideYInBytes:   " << sizePerChannelInBytes / tsizex);
-      itkDebugMacro(<< "sizePerStrideXInBytes:   " << sizePerStrideXInBytes);
-      itkDebugMacro(<< "initialStrideInBytes:    " << initialStrideInBytes);
-      itkDebugMacro(<< "priorStrideInBytes:      " << priorStrideInBytes);
-      itkDebugMacro(<< "postStrideInBytes:       " << postStrideInBytes);
-
-
-      // TODO: Read the void buffer within the tile ROI. How do we specify the
-      // tile ROI iteration
-      for (unsigned int k = 0; k < numberOfComponents; ++k)
-      {
-        auto * charBuffer = (unsigned char *)buffer;
-        charBuffer += k * sizePerComponentInBytes;
-
-        charBuffer += initialStrideInBytes;
-
-        for (SizeValueType m = 0; m < tsizey; ++m)
-        {
-          charBuffer += priorStrideInBytes;
-          for (SizeValueType j = 0; j < sizePerStrideXInBytes; ++j)
-          {
-            *charBuffer = static_cast<unsigned char>(*l_data_ptr++);
-            charBuffer += numberOfComponents;
-          }
-          charBuffer += postStrideInBytes;
-        }
-      }
+      itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
+                                                                << "Reason: " << failure);
     }
-    //       l_go_on = 0;
-  }
+  };
 
-  //  l_image = opj_decode( this->m_Dinfo, l_stream );
-
-  if (!opj_end_decompress(this->m_Internal->m_Dinfo, l_stream))
+  if (numberOfBands > 1)
   {
-    free(l_data);
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    opj_image_destroy(l_image);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: opj_end_decompress returns false");
+    multiThreader->ParallelizeArray(0, numberOfBands, decodeBand, nullptr);
   }
-
-  if (!l_image)
+  else if (numberOfBands == 1)
   {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-    opj_stream_destroy(l_stream);
-    fclose(l_file);
-    itkExceptionMacro("JPEG2000ImageIO failed to read file: " << this->GetFileName() << std::endl
-                                                              << "Reason: error whle reading image");
-  }
-
-  /* close the byte stream */
-  opj_stream_destroy(l_stream);
-  fclose(l_file);
-
-  if (this->m_Internal->m_Dinfo)
-  {
-    opj_destroy_codec(this->m_Internal->m_Dinfo);
-    this->m_Internal->m_Dinfo = nullptr;
-  }
-
-  if (l_image)
-  {
-    opj_image_destroy(l_image);
-  }
-
-  if (l_data)
-  {
-    free(l_data);
+    decodeBand(0);
   }
 
   itkDebugMacro(<< "JPEG2000ImageIO::Read() End");
@@ -821,11 +807,16 @@ JPEG2000ImageIO::Write(const void * buffer)
 
   // Compute the proper number of resolutions to use.
   // This is mostly done for images smaller than 64 pixels
-  // along any dimension.
+  // along any dimension, or written in small tiles.
   unsigned int numberOfResolutions = 0;
 
   int tw = w >> 1;
   int th = h >> 1;
+  if (this->m_Internal->m_TileWidth > 0)
+  {
+    tw = std::min(w, static_cast<int>(this->m_Internal->m_TileWidth)) >> 1;
+    th = std::min(h, static_cast<int>(this->m_Internal->m_TileHeight)) >> 1;
+  }
 
   while (tw && th)
   {
@@ -1080,8 +1071,10 @@ JPEG2000ImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORe
     // Compute the required set of tiles that fully contain the requested region
     streamableRegion = requestedRegion;
 
-    this->ComputeRegionInTileBoundaries(0, this->m_Internal->m_TileWidth, streamableRegion);
-    this->ComputeRegionInTileBoundaries(1, this->m_Internal->m_TileHeight, streamableRegion);
+    this->ComputeRegionInTileBoundaries(
+      0, this->m_Internal->m_TileStartX, this->m_Internal->m_TileWidth, streamableRegion);
+    this->ComputeRegionInTileBoundaries(
+      1, this->m_Internal->m_TileStartY, this->m_Internal->m_TileHeight, streamableRegion);
   }
 
   itkDebugMacro(<< "Streamable region = " << streamableRegion);
@@ -1091,33 +1084,30 @@ JPEG2000ImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORe
 
 void
 JPEG2000ImageIO::ComputeRegionInTileBoundaries(unsigned int    dimension,
+                                               SizeValueType   tileStart,
                                                SizeValueType   tileSize,
                                                ImageIORegion & streamableRegion) const
 {
-  SizeValueType  requestedSize = streamableRegion.GetSize(dimension);
-  IndexValueType requestedIndex = streamableRegion.GetIndex(dimension);
-
-  IndexValueType startQuantizedInTileSize = requestedIndex - (requestedIndex % tileSize);
-  IndexValueType requestedEnd = requestedIndex + requestedSize;
-  SizeValueType  extendedSize = requestedEnd - startQuantizedInTileSize;
-  SizeValueType  tileRemanent = extendedSize % tileSize;
-
-  SizeValueType sizeQuantizedInTileSize = extendedSize;
-
-  if (tileRemanent)
-  {
-    sizeQuantizedInTileSize += tileSize - tileRemanent;
-  }
-
-  IndexValueType endQuantizedInTileSize = startQuantizedInTileSize + sizeQuantizedInTileSize - 1;
-
-  if (endQuantizedInTileSize > static_cast<int>(this->GetDimensions(dimension)))
-  {
-    sizeQuantizedInTileSize = this->GetDimensions(dimension) - startQuantizedInTileSize;
-  }
-
-  streamableRegion.SetSize(dimension, sizeQuantizedInTileSize);
-  streamableRegion.SetIndex(dimension, startQuantizedInTileSize);
+  // The tile boundaries are at the full resolution, while the region is at the
+  // resolution reduced by the decompression parameters.
+  const auto reduceFactor = static_cast<unsigned int>(this->m_Internal->m_DecompressionParameters.cp_reduce);
+
+  const IndexValueType requestedIndex = streamableRegion.GetIndex(dimension);
+  const IndexValueType requestedEnd = requestedIndex + streamableRegion.GetSize(dimension);
+
+  const SizeValueType fullResolutionIndex = static_cast<SizeValueType>(requestedIndex) << reduceFactor;
+  const SizeValueType fullResolutionEnd = static_cast<SizeValueType>(requestedEnd) << reduceFactor;
+  const SizeValueType firstTile = (std::max(fullResolutionIndex, tileStart) - tileStart) / tileSize;
+  const SizeValueType endTile = (fullResolutionEnd - tileStart + tileSize - 1) / tileSize;
+
+  const auto startInTiles = std::min<IndexValueType>(
+    ReduceCoordinate(static_cast<OPJ_INT32>(tileStart + firstTile * tileSize), reduceFactor), requestedIndex);
+  const auto endInTiles = std::min<IndexValueType>(
+    ReduceCoordinate(static_cast<OPJ_INT32>(tileStart + endTile * tileSize), reduceFactor),
+    static_cast<IndexValueType>(this->GetDimensions(dimension)));
+
+  streamableRegion.SetSize(dimension, std::max(endInTiles, requestedEnd) - startInTiles);
+  streamableRegion.SetIndex(dimension, startInTiles);
 }
 
 bool
@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkJPEG2000ImageIO.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRGBPixel.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+// Returns the image read from the file, or the given region of it, at the
+// given reduce factor.
+template <typename TImage>
+typename TImage::Pointer
+ReadJPEG2000(const std::string & fileName, unsigned int reduceFactor, const typename TImage::RegionType * region)
+{
+  auto imageIO = itk::JPEG2000ImageIO::New();
+  imageIO->SetReduceFactor(reduceFactor);
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(imageIO);
+  if (region)
+  {
+    reader->UseStreamingOn();
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(*region);
+  }
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Writes a tiled image with the given pixel type, and reads it back, whole and
+// in regions, at several reduce factors and numbers of threads.
+template <typename TImage>
+int
+TestTileDecoding(const std::string & fileName)
+{
+  std::cout << "Decoding the tiles of " << fileName << std::endl;
+
+  using RegionType = typename TImage::RegionType;
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 203, 157 } });
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto value = static_cast<double>(it.GetIndex()[0] + it.GetIndex()[1]) / 2;
+    typename TImage::PixelType pixel;
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      PixelTraits::SetNthComponent(
+        static_cast<int>(c), pixel, static_cast<typename PixelTraits::ComponentType>(value + c));
+    }
+    it.Set(pixel);
+  }
+
+  auto imageIO = itk::JPEG2000ImageIO::New();
+  imageIO->SetTileSize(64, 48);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const RegionType regions[] = { RegionType{ { { 70, 50 } }, { { 100, 60 } } },
+                                 RegionType{ { { 0, 150 } }, { { 203, 7 } } },
+                                 RegionType{ { { 202, 0 } }, { { 1, 1 } } } };
+
+  for (const itk::ThreadIdType numberOfThreads : { 1, 3, 8 })
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+
+    // The compression is lossless.
+    const typename TImage::Pointer readImage = ReadJPEG2000<TImage>(fileName, 0, nullptr);
+    ITK_TEST_EXPECT_EQUAL(readImage->GetBufferedRegion(), image->GetBufferedRegion());
+    if (!itk::Testing::EqualInRegion<TImage>(image, readImage, image->GetBufferedRegion()))
+    {
+      return EXIT_FAILURE;
+    }
+    for (const RegionType & region : regions)
+    {
+      const typename TImage::Pointer regionImage = ReadJPEG2000<TImage>(fileName, 0, &region);
+      ITK_TEST_EXPECT_TRUE(regionImage->GetBufferedRegion().IsInside(region));
+      if (!itk::Testing::EqualInRegion<TImage>(image, regionImage, region))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    // At a reduced resolution, the pixels of this smooth image are close to
+    // those of the full resolution at the same physical point.
+    for (const unsigned int reduceFactor : { 1, 2 })
+    {
+      const unsigned int             scale = 1u << reduceFactor;
+      const typename TImage::Pointer reducedImage = ReadJPEG2000<TImage>(fileName, reduceFactor, nullptr);
+      ITK_TEST_EXPECT_EQUAL(reducedImage->GetBufferedRegion().GetSize()[0], (203 + scale - 1) / scale);
+      ITK_TEST_EXPECT_EQUAL(reducedImage->GetBufferedRegion().GetSize()[1], (157 + scale - 1) / scale);
+      ITK_TEST_EXPECT_EQUAL(reducedImage->GetSpacing()[0], static_cast<double>(scale));
+      ITK_TEST_EXPECT_EQUAL(reducedImage->GetOrigin()[0], 0.5 * (scale - 1));
+      for (itk::ImageRegionConstIteratorWithIndex<TImage> it(reducedImage, reducedImage->GetBufferedRegion());
+           !it.IsAtEnd();
+           ++it)
+      {
+        const typename TImage::IndexType fullIndex{ { it.GetIndex()[0] * scale, it.GetIndex()[1] * scale } };
+        const auto reducedValue = static_cast<double>(PixelTraits::GetNthComponent(0, it.Get()));
+        const auto value = static_cast<double>(PixelTraits::GetNthComponent(0, image->GetPixel(fullIndex)));
+        if (std::abs(reducedValue - value) > scale)
+        {
+          std::cerr << "Reduced pixel " << it.GetIndex() << " is " << reducedValue << " instead of about " << value
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // Regions of the reduced image are the same as the whole reduced image.
+      const RegionType reducedRegion{ { { 20, 9 } }, { { 21, 15 } } };
+      const typename TImage::Pointer reducedRegionImage =
+        ReadJPEG2000<TImage>(fileName, reduceFactor, &reducedRegion);
+      ITK_TEST_EXPECT_TRUE(reducedRegionImage->GetBufferedRegion().IsInside(reducedRegion));
+      if (!itk::Testing::EqualInRegion<TImage>(reducedImage, reducedRegionImage, reducedRegion))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The reduce factor must be less than the number of resolution levels.
+  ITK_TRY_EXPECT_EXCEPTION(ReadJPEG2000<TImage>(fileName, 6, nullptr));
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkJPEG2000ImageIOTileDecodingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkJPEG2000ImageIOTileDecodingTest";
+
+  auto imageIO = itk::JPEG2000ImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0, imageIO->GetReduceFactor());
+
+  int testStatus = EXIT_SUCCESS;
+  testStatus |= TestTileDecoding<itk::Image<unsigned char, 2>>(prefix + "UChar.j2k");
+  testStatus |= TestTileDecoding<itk::Image<unsigned short, 2>>(prefix + "UShort.jp2");
+  testStatus |= TestTileDecoding<itk::Image<itk::RGBPixel<unsigned char>, 2>>(prefix + "RGB.j2k");
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
@@ -37,6 +37,17 @@ namespace itk
  *  For a detailed description of using this format, please see
  *  https://www.itk.org/Wiki/ITK/MetaIO/Documentation
  *
+ *  When compression is used and CompressionBlockSize is not zero, the pixels
+ *  are compressed in blocks of that many bytes, on the threads of the
+ *  multi-threader. Each block is deflated independently, and the blocks are
+ *  concatenated into a single zlib stream, which any MetaImage reader can
+ *  inflate. The header records the block size in a CompressedDataBlockSize
+ *  field, and the offsets of the blocks in the compressed data follow the
+ *  CompressedDataSize bytes of compressed data, as little endian 64 bit
+ *  integers. This MetaIO extension allows the blocks to be inflated in
+ *  parallel, and a region of the image to be read by inflating only the
+ *  blocks it overlaps, so such files can be streamed.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIOMeta
  */
@@ -82,6 +93,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The pixels can be memory mapped when they are stored uncompressed, in
+   * binary form, in native byte order, in a single file (the header file
+   * itself for ElementDataFile = LOCAL), without subsampling. */
+  bool
+  CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   MetaImage *
   GetMetaImagePointer();
 
@@ -134,12 +151,12 @@ public:
                            const ImageIORegion & largestPossibleRegion) override;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
-   *  CanRead must be called prior to this function. */
+   *  file. Compressed data can only be streamed when it is compressed in
+   *  blocks. CanRead must be called prior to this function. */
   bool
   CanStreamRead() override
   {
-    if (m_MetaImage.CompressedData())
+    if (m_MetaImage.CompressedData() && m_CompressedDataBlockSize == 0)
     {
       return false;
     }
@@ -167,6 +184,13 @@ public:
   itkSetMacro(SubSamplingFactor, unsigned int);
   itkGetConstMacro(SubSamplingFactor, unsigned int);
 
+  /** Set/Get the number of bytes of pixels compressed in each block, when
+   * compression is used. Zero, the default, writes the pixels as a single
+   * compressed block, without a block offset table, like other MetaImage
+   * writers. */
+  itkSetMacro(CompressionBlockSize, SizeValueType);
+  itkGetConstMacro(CompressionBlockSize, SizeValueType);
+
   /**
    * Set the default precision when writing out the MetaImage header.
    * MetaImage header contains values stored in memory as double,
@@ -187,18 +211,66 @@ protected:
   ~MetaImageIO() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Also copies the sub-sampling factor, the compression block size and the
+   * precision of the numbers written. */
+  LightObject::Pointer
+  InternalClone() const override;
   template <unsigned int VNRows, unsigned int VNColumns = VNRows>
   bool
   WriteMatrixInMetaData(std::ostringstream & strs, const MetaDataDictionary & metaDict, const std::string & metaString);
 
 private:
+  /** MetaImage that writes the header of pixels compressed in blocks by
+   * MetaImageIO, and gives access to the size of the compressed data. */
+  class BlockCompressedMetaImage : public MetaImage
+  {
+  public:
+    std::streamoff
+    GetCompressedDataSize() const
+    {
+      return m_CompressedDataSize;
+    }
+
+    /** Header fields to write for pixels compressed in blocks. When the
+     * block size is zero, the header of the pixels is written by MetaImage. */
+    void
+    SetCompressedDataBlocks(std::streamoff compressedDataSize, SizeValueType blockSize)
+    {
+      m_BlockCompressedDataSize = compressedDataSize;
+      m_BlockSize = blockSize;
+    }
+
+  protected:
+    void
+    M_SetupWriteFields() override;
+
+  private:
+    std::streamoff m_BlockCompressedDataSize{};
+    SizeValueType  m_BlockSize{};
+  };
+
+  /** Writes the pixels, compressed in blocks. */
+  void
+  WriteCompressedBlocks(const void * buffer);
+
+  /** Reads the pixels of m_IORegion by inflating the blocks they overlap.
+   * Returns false when the blocks cannot be located in the file. */
+  bool
+  ReadCompressedBlocks(void * buffer);
+
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
-  MetaImage m_MetaImage{};
+  BlockCompressedMetaImage m_MetaImage{};
 
   unsigned int m_SubSamplingFactor{};
 
+  SizeValueType m_CompressionBlockSize{ 0 };
+
+  /** Block size of the compressed pixels of the file read, or zero. */
+  SizeValueType m_CompressedDataBlockSize{};
+
   static unsigned int * m_DefaultDoublePrecision;
 };
 
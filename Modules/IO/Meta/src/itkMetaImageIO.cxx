@@ -19,13 +19,40 @@
 #include "itkMetaImageIO.h"
 #include "itkSpatialOrientationAdapter.h"
 #include "itkIOCommon.h"
+#include "itkByteSwapper.h"
 #include "itksys/SystemTools.hxx"
 #include "itkMath.h"
 #include "itkSingleton.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkImageIORegionRuns.h"
+#include "itkMultiThreaderBase.h"
+#include "itkZlibBlockCompression.h"
+#include "itk_zlib.h"
+#include <atomic>
+#include <cstdlib>
 
 namespace itk
 {
+namespace
+{
+constexpr char CompressedDataBlockSizeFieldName[] = "CompressedDataBlockSize";
+
+// Like MetaImage::Read, the data file is relative to the directory of the header.
+std::string
+GetDataFileNameRelativeToHeader(const std::string & headerFileName, const std::string & elementDataFileName)
+{
+  if (!itksys::SystemTools::FileIsFullPath(elementDataFileName))
+  {
+    const std::string headerPath = itksys::SystemTools::GetFilenamePath(headerFileName);
+    if (!headerPath.empty())
+    {
+      return headerPath + '/' + elementDataFileName;
+    }
+  }
+  return elementDataFileName;
+}
+} // namespace
+
 // Explicitly set std::numeric_limits<double>::max_digits10 this will provide
 // better accuracy when writing out floating point number in MetaImage header.
 itkGetGlobalValueMacro(MetaImageIO, unsigned int, DefaultDoublePrecision, 17);
@@ -61,12 +88,52 @@ MetaImageIO::MetaImageIO()
 
 MetaImageIO::~MetaImageIO() = default;
 
+LightObject::Pointer
+MetaImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_SubSamplingFactor = m_SubSamplingFactor;
+  rval->m_CompressionBlockSize = m_CompressionBlockSize;
+  rval->m_MetaImage.SetDoublePrecision(m_MetaImage.GetDoublePrecision());
+  return loPtr;
+}
+
 void
 MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << '\n';
+  os << indent << "CompressionBlockSize: " << m_CompressionBlockSize << '\n';
+  os << indent << "CompressedDataBlockSize: " << m_CompressedDataBlockSize << '\n';
+}
+
+void
+MetaImageIO::BlockCompressedMetaImage::M_SetupWriteFields()
+{
+  if (m_BlockSize == 0)
+  {
+    MetaImage::M_SetupWriteFields();
+    return;
+  }
+
+  // The pixels are compressed by MetaImageIO: MetaImage only describes them.
+  m_CompressedData = true;
+  m_CompressedDataSize = m_BlockCompressedDataSize;
+  MetaImage::M_SetupWriteFields();
+  m_CompressedData = false;
+  m_CompressedDataSize = 0;
+
+  // ElementDataFile must remain the last field of the header.
+  auto * mF = new MET_FieldRecordType;
+  MET_InitWriteField(mF, CompressedDataBlockSizeFieldName, MET_ULONG_LONG, static_cast<double>(m_BlockSize));
+  m_Fields.insert(m_Fields.end() - 1, mF);
 }
 
 void
@@ -101,6 +168,7 @@ MetaImageIO::ReadImageInformation()
     itkExceptionMacro("File cannot be read: " << this->GetFileName() << " for reading." << std::endl
                                               << "Reason: " << itksys::SystemTools::GetLastSystemError());
   }
+  m_CompressedDataBlockSize = 0;
 
   if (m_MetaImage.BinaryData())
   {
@@ -412,6 +480,15 @@ MetaImageIO::ReadImageInformation()
   {
     std::string key(m_MetaImage.GetAdditionalReadFieldName(f));
     std::string value(m_MetaImage.GetAdditionalReadFieldValue(f));
+    if (key == CompressedDataBlockSizeFieldName)
+    {
+      // Describes the compressed pixels, not the image.
+      if (m_MetaImage.BinaryData() && m_MetaImage.CompressedData())
+      {
+        m_CompressedDataBlockSize = std::strtoull(value.c_str(), nullptr, 10);
+      }
+      continue;
+    }
     EncapsulateMetaData<std::string>(thisMetaDict, key, value);
   }
 
@@ -435,6 +512,13 @@ MetaImageIO::ReadImageInformation()
 void
 MetaImageIO::Read(void * buffer)
 {
+  if (m_CompressedDataBlockSize > 0 && m_SubSamplingFactor == 1 && this->ReadCompressedBlocks(buffer))
+  {
+    m_MetaImage.ElementData(buffer, false);
+    m_MetaImage.ElementByteOrderFix(m_IORegion.GetNumberOfPixels());
+    return;
+  }
+
   const unsigned int nDims = this->GetNumberOfDimensions();
 
   // this will check to see if we are actually streaming
@@ -489,6 +573,218 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::ReadCompressedBlocks(void * buffer)
+{
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if (elementDataFileName.substr(0, 4) == "LIST" || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false;
+  }
+  const std::string dataFileName = itksys::SystemTools::UpperCase(elementDataFileName) == "LOCAL"
+                                     ? m_FileName
+                                     : GetDataFileNameRelativeToHeader(m_FileName, elementDataFileName);
+
+  const SizeValueType blockSize = m_CompressedDataBlockSize;
+  const SizeValueType dataSize = this->GetImageSizeInBytes();
+  const SizeValueType numberOfBlocks = std::max<SizeValueType>((dataSize + blockSize - 1) / blockSize, 1);
+  const auto          compressedDataSize = static_cast<SizeValueType>(m_MetaImage.GetCompressedDataSize());
+  const SizeValueType tableSize = numberOfBlocks * sizeof(uint64_t);
+  const SizeValueType fileSize = itksys::SystemTools::FileLength(dataFileName);
+  if (compressedDataSize < 6 || fileSize < compressedDataSize + tableSize)
+  {
+    return false;
+  }
+
+  // The offsets of the blocks follow the compressed data, at the end of the file.
+  const SizeValueType   dataOffset = fileSize - compressedDataSize - tableSize;
+  std::ifstream         file(dataFileName.c_str(), std::ios::in | std::ios::binary);
+  unsigned char         zlibHeader[2];
+  std::vector<uint64_t> blockOffsets(numberOfBlocks + 1);
+  file.seekg(static_cast<std::streamoff>(dataOffset));
+  file.read(reinterpret_cast<char *>(zlibHeader), sizeof(zlibHeader));
+  file.seekg(static_cast<std::streamoff>(dataOffset + compressedDataSize));
+  file.read(reinterpret_cast<char *>(blockOffsets.data()), static_cast<std::streamsize>(tableSize));
+  if (!file || (zlibHeader[0] & 0x0F) != Z_DEFLATED || (zlibHeader[0] * 256 + zlibHeader[1]) % 31 != 0)
+  {
+    return false;
+  }
+  ByteSwapper<uint64_t>::SwapRangeFromSystemToLittleEndian(blockOffsets.data(), numberOfBlocks);
+  // The last block is followed by the Adler-32 checksum of the pixels.
+  blockOffsets[numberOfBlocks] = compressedDataSize - 4;
+  if (blockOffsets[0] != sizeof(zlibHeader))
+  {
+    return false;
+  }
+  for (SizeValueType b = 0; b < numberOfBlocks; ++b)
+  {
+    if (blockOffsets[b + 1] <= blockOffsets[b])
+    {
+      return false;
+    }
+  }
+
+  // The runs of contiguous bytes of the pixels of the region in the file,
+  // and the blocks they overlap.
+  struct Run
+  {
+    SizeValueType fileOffset;
+    SizeValueType bufferOffset;
+    SizeValueType length;
+  };
+  const unsigned int nDims = this->GetNumberOfDimensions();
+  ImageIORegion      region(nDims);
+  for (unsigned int i = 0; i < nDims; ++i)
+  {
+    region.SetIndex(i, i < m_IORegion.GetImageDimension() ? m_IORegion.GetIndex(i) : 0);
+    region.SetSize(i, i < m_IORegion.GetImageDimension() ? m_IORegion.GetSize(i) : 1);
+  }
+  const SizeValueType pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+  std::vector<Run>    runs;
+  std::vector<bool>   blockIsRead(numberOfBlocks, false);
+  SizeValueType       bufferOffset = 0;
+  ForEachImageIORegionRun(region, m_Dimensions, [&](SizeValueType offset, SizeValueType length) {
+    const SizeValueType fileOffset = offset * pixelSize;
+    runs.push_back({ fileOffset, bufferOffset, length * pixelSize });
+    bufferOffset += length * pixelSize;
+    for (SizeValueType b = fileOffset / blockSize; b <= (fileOffset + length * pixelSize - 1) / blockSize; ++b)
+    {
+      blockIsRead[b] = true;
+    }
+    return true;
+  });
+
+  // The whole image is inflated in the buffer, a region is inflated block by
+  // block. The blocks are read in batches, so that their inflation on several
+  // threads only holds a bounded number of compressed blocks in memory.
+  auto * const        output = static_cast<unsigned char *>(buffer);
+  const bool          inflateInBuffer = runs.size() == 1 && runs.front().length == dataSize;
+  const auto          multiThreader = MultiThreaderBase::New();
+  const SizeValueType blocksPerBatch =
+    std::min(std::max<SizeValueType>((SizeValueType{ 64 } << 20) / blockSize, multiThreader->GetNumberOfWorkUnits()),
+             numberOfBlocks);
+  std::unique_ptr<unsigned char[]> inflatedBlocks;
+  if (!inflateInBuffer)
+  {
+    inflatedBlocks = make_unique_for_overwrite<unsigned char[]>(blocksPerBatch * blockSize);
+  }
+  std::vector<unsigned char> compressedBlocks;
+  size_t                     firstRun = 0;
+  for (SizeValueType firstBlock = 0; firstBlock < numberOfBlocks;)
+  {
+    if (!blockIsRead[firstBlock])
+    {
+      ++firstBlock;
+      continue;
+    }
+    SizeValueType lastBlock = firstBlock + 1;
+    while (lastBlock < numberOfBlocks && lastBlock - firstBlock < blocksPerBatch && blockIsRead[lastBlock])
+    {
+      ++lastBlock;
+    }
+
+    compressedBlocks.resize(blockOffsets[lastBlock] - blockOffsets[firstBlock]);
+    file.seekg(static_cast<std::streamoff>(dataOffset + blockOffsets[firstBlock]));
+    file.read(reinterpret_cast<char *>(compressedBlocks.data()), static_cast<std::streamsize>(compressedBlocks.size()));
+    if (!file)
+    {
+      itkExceptionMacro("File cannot be read: " << dataFileName << " for reading." << std::endl
+                                                << "Reason: " << itksys::SystemTools::GetLastSystemError());
+    }
+
+    unsigned char * const inflated = inflateInBuffer ? output + firstBlock * blockSize : inflatedBlocks.get();
+    std::atomic<bool>     inflatedAll{ true };
+    multiThreader->ParallelizeArray(
+      firstBlock,
+      lastBlock,
+      [&](SizeValueType b) {
+        const SizeValueType offset = b * blockSize;
+        if (!ZlibBlockCompression::Inflate(compressedBlocks.data() + (blockOffsets[b] - blockOffsets[firstBlock]),
+                                           blockOffsets[b + 1] - blockOffsets[b],
+                                           inflated + (offset - firstBlock * blockSize),
+                                           std::min(blockSize, dataSize - offset)))
+        {
+          inflatedAll = false;
+        }
+      },
+      nullptr);
+    if (!inflatedAll)
+    {
+      itkExceptionMacro("Compressed pixels cannot be inflated: " << dataFileName);
+    }
+
+    if (!inflateInBuffer)
+    {
+      const SizeValueType batchBegin = firstBlock * blockSize;
+      const SizeValueType batchEnd = std::min(lastBlock * blockSize, dataSize);
+      while (runs[firstRun].fileOffset + runs[firstRun].length <= batchBegin)
+      {
+        ++firstRun;
+      }
+      for (size_t r = firstRun; r < runs.size() && runs[r].fileOffset < batchEnd; ++r)
+      {
+        const SizeValueType begin = std::max(runs[r].fileOffset, batchBegin);
+        const SizeValueType end = std::min(runs[r].fileOffset + runs[r].length, batchEnd);
+        std::copy_n(inflated + (begin - batchBegin),
+                    end - begin,
+                    output + runs[r].bufferOffset + (begin - runs[r].fileOffset));
+      }
+    }
+    firstBlock = lastBlock;
+  }
+  return true;
+}
+
+bool
+MetaImageIO::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  if (!m_MetaImage.BinaryData() || m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 ||
+      m_MetaImage.BinaryDataByteOrderMSB() != ByteSwapper<int>::SystemIsBigEndian())
+  {
+    return false;
+  }
+
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if (itksys::SystemTools::UpperCase(elementDataFileName) == "LOCAL")
+  {
+    dataFileName = m_FileName;
+  }
+  else if (elementDataFileName.substr(0, 4) == "LIST" || elementDataFileName.find('%') != std::string::npos)
+  {
+    // The pixels are spread over several files.
+    return false;
+  }
+  else
+  {
+    dataFileName = GetDataFileNameRelativeToHeader(m_FileName, elementDataFileName);
+  }
+  if (!itksys::SystemTools::FileExists(dataFileName, true))
+  {
+    return false;
+  }
+
+  const SizeValueType fileSize = itksys::SystemTools::FileLength(dataFileName);
+  const SizeValueType dataSize = this->GetImageSizeInBytes();
+  if (fileSize < dataSize)
+  {
+    return false;
+  }
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    dataOffset = static_cast<SizeValueType>(m_MetaImage.HeaderSize());
+  }
+  else if (m_MetaImage.HeaderSize() == -1 || dataFileName == m_FileName)
+  {
+    // The pixels are at the end of the file.
+    dataOffset = fileSize - dataSize;
+  }
+  else
+  {
+    dataOffset = 0;
+  }
+  return dataOffset + dataSize <= fileSize;
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -548,7 +844,7 @@ MetaImageIO::WriteImageInformation()
   std::vector<std::string>::const_iterator keyIt;
   for (keyIt = keys.begin(); keyIt != keys.end(); ++keyIt)
   {
-    if (*keyIt == ITK_ExperimentDate || *keyIt == ITK_VoxelUnits)
+    if (*keyIt == ITK_ExperimentDate || *keyIt == ITK_VoxelUnits || *keyIt == CompressedDataBlockSizeFieldName)
     {
       continue;
     }
@@ -1061,7 +1357,10 @@ MetaImageIO::Write(const void * buffer)
     free(transformMatrix);
   }
 
-  m_MetaImage.CompressedData(m_UseCompression);
+  // Pixels compressed in blocks are compressed by WriteCompressedBlocks.
+  const bool compressInBlocks = m_UseCompression && binaryData && m_CompressionBlockSize > 0 &&
+                                std::string(m_MetaImage.ElementDataFileName()).find('%') == std::string::npos;
+  m_MetaImage.CompressedData(m_UseCompression && !compressInBlocks);
   m_MetaImage.CompressionLevel(this->GetCompressionLevel());
 
   // this is a check to see if we are actually streaming
@@ -1096,6 +1395,10 @@ MetaImageIO::Write(const void * buffer)
                                                        << "Reason: " << itksys::SystemTools::GetLastSystemError());
     }
   }
+  else if (compressInBlocks)
+  {
+    this->WriteCompressedBlocks(buffer);
+  }
   else
   {
     if (!m_MetaImage.Write(m_FileName.c_str()))
@@ -1106,6 +1409,102 @@ MetaImageIO::Write(const void * buffer)
   }
 }
 
+void
+MetaImageIO::WriteCompressedBlocks(const void * buffer)
+{
+  const auto * const  pixels = static_cast<const unsigned char *>(buffer);
+  const SizeValueType dataSize = this->GetImageSizeInBytes();
+  // A block is deflated by a single call, so its size must fit in an uInt.
+  const SizeValueType blockSize = std::min(m_CompressionBlockSize, SizeValueType{ 1 } << 30);
+  const SizeValueType numberOfBlocks = std::max<SizeValueType>((dataSize + blockSize - 1) / blockSize, 1);
+  const int           compressionLevel = this->GetCompressionLevel();
+
+  // The blocks are deflated in parallel, and concatenated in a single
+  // deflate stream.
+  std::vector<std::vector<unsigned char>> blocks(numberOfBlocks);
+  std::vector<uLong>                      checksums(numberOfBlocks);
+  std::atomic<bool>                       deflatedAll{ true };
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType b) {
+      const SizeValueType offset = b * blockSize;
+      const auto          length = static_cast<uInt>(std::min(blockSize, dataSize - offset));
+      if (!ZlibBlockCompression::Deflate(pixels + offset, length, compressionLevel, b + 1 == numberOfBlocks, blocks[b]))
+      {
+        deflatedAll = false;
+      }
+      checksums[b] = adler32(adler32(0, nullptr, 0), pixels + offset, length);
+    },
+    nullptr);
+  if (!deflatedAll)
+  {
+    itkExceptionMacro("Pixels cannot be compressed for: " << m_FileName);
+  }
+
+  // The blocks are preceded by a zlib header, and followed by the Adler-32
+  // checksum of the pixels, then by the table of the offsets of the blocks.
+  constexpr unsigned char zlibHeader[] = { 0x78, 0x9C };
+  std::vector<uint64_t>   blockOffsets(numberOfBlocks);
+  SizeValueType           compressedDataSize = sizeof(zlibHeader);
+  uLong                   checksum = checksums[0];
+  for (SizeValueType b = 0; b < numberOfBlocks; ++b)
+  {
+    blockOffsets[b] = compressedDataSize;
+    compressedDataSize += blocks[b].size();
+    if (b > 0)
+    {
+      const SizeValueType length = std::min(blockSize, dataSize - b * blockSize);
+      checksum = adler32_combine(checksum, checksums[b], static_cast<z_off_t>(length));
+    }
+  }
+  const unsigned char checksumBytes[] = { static_cast<unsigned char>(checksum >> 24),
+                                          static_cast<unsigned char>(checksum >> 16),
+                                          static_cast<unsigned char>(checksum >> 8),
+                                          static_cast<unsigned char>(checksum) };
+  compressedDataSize += sizeof(checksumBytes);
+  ByteSwapper<uint64_t>::SwapRangeFromSystemToLittleEndian(blockOffsets.data(), numberOfBlocks);
+
+  // Like MetaImage::Write, the pixels of a .mha file follow its header.
+  std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool  userDataFileName = !elementDataFileName.empty();
+  if (!userDataFileName)
+  {
+    const std::string extension = itksys::SystemTools::GetFilenameLastExtension(m_FileName);
+    elementDataFileName =
+      extension == ".mha" ? "LOCAL" : m_FileName.substr(0, m_FileName.size() - extension.size()) + ".zraw";
+  }
+  m_MetaImage.SetCompressedDataBlocks(static_cast<std::streamoff>(compressedDataSize), blockSize);
+  const bool headerIsWritten =
+    m_MetaImage.Write(m_FileName.c_str(), userDataFileName ? nullptr : elementDataFileName.c_str(), false);
+  m_MetaImage.SetCompressedDataBlocks(0, 0);
+  if (!headerIsWritten)
+  {
+    itkExceptionMacro("File cannot be written: " << this->GetFileName() << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+
+  const bool        local = elementDataFileName == "LOCAL";
+  const std::string dataFileName =
+    local ? m_FileName
+          : (userDataFileName ? GetDataFileNameRelativeToHeader(m_FileName, m_MetaImage.ElementDataFileName())
+                              : elementDataFileName);
+  std::ofstream file(dataFileName.c_str(), std::ios::binary | (local ? std::ios::app : std::ios::trunc));
+  file.write(reinterpret_cast<const char *>(zlibHeader), sizeof(zlibHeader));
+  for (const auto & block : blocks)
+  {
+    file.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+  }
+  file.write(reinterpret_cast<const char *>(checksumBytes), sizeof(checksumBytes));
+  file.write(reinterpret_cast<const char *>(blockOffsets.data()),
+             static_cast<std::streamsize>(numberOfBlocks * sizeof(uint64_t)));
+  if (!file)
+  {
+    itkExceptionMacro("File cannot be written: " << dataFileName << std::endl
+                                                 << "Reason: " << itksys::SystemTools::GetLastSystemError());
+  }
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
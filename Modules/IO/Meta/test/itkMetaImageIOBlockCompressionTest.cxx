@@ -0,0 +1,162 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMetaImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+#include "metaImage.h"
+
+#include <cstring>
+
+
+namespace
+{
+using PixelType = itk::Vector<short, 3>;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Writes the image compressed in blocks of blockSize bytes, then reads it
+// with MetaImage, whole, by regions, and in pieces.
+int
+TestBlockCompression(const ImageType * image, const std::string & fileName, itk::SizeValueType blockSize)
+{
+  std::cout << "Writing " << fileName << " in blocks of " << blockSize << " bytes" << std::endl;
+
+  auto imageIO = itk::MetaImageIO::New();
+  imageIO->SetCompressionBlockSize(blockSize);
+  ITK_TEST_SET_GET_VALUE(blockSize, imageIO->GetCompressionBlockSize());
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // The compressed pixels are a single zlib stream, which MetaImage inflates.
+  MetaImage metaImage;
+  ITK_TEST_EXPECT_TRUE(metaImage.Read(fileName.c_str()));
+  ITK_TEST_EXPECT_TRUE(metaImage.CompressedData());
+  ITK_TEST_EXPECT_TRUE(std::memcmp(metaImage.ElementData(),
+                                   image->GetBufferPointer(),
+                                   image->GetPixelContainer()->Size() * sizeof(PixelType)) == 0);
+
+  const ImageType::Pointer readImage = itk::ReadImage<ImageType>(fileName);
+  if (!itk::Testing::EqualInRegion<ImageType>(image, readImage, image->GetLargestPossibleRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+  // The block size describes the pixels of the file, not the image.
+  ITK_TEST_EXPECT_TRUE(!readImage->GetMetaDataDictionary().HasKey("CompressedDataBlockSize"));
+
+  for (const ImageType::RegionType & region : { ImageType::RegionType{ { { 0, 0, 3 } }, { { 17, 13, 2 } } },
+                                                ImageType::RegionType{ { { 4, 2, 1 } }, { { 9, 1, 6 } } },
+                                                ImageType::RegionType{ { { 16, 12, 7 } }, { { 1, 1, 1 } } } })
+  {
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->UseStreamingOn();
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(reader->GetImageIO()->CanStreamRead(), blockSize > 0);
+    if (blockSize > 0)
+    {
+      ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    }
+    if (!itk::Testing::EqualInRegion<ImageType>(image, reader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (blockSize > 0)
+  {
+    constexpr unsigned int numberOfStreamDivisions = 4;
+
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->UseStreamingOn();
+
+    auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+    monitor->SetInput(reader->GetOutput());
+
+    auto streamWriter = itk::ImageFileWriter<ImageType>::New();
+    streamWriter->SetInput(monitor->GetOutput());
+    streamWriter->SetFileName(fileName + ".mha");
+    streamWriter->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+    ITK_TRY_EXPECT_NO_EXCEPTION(streamWriter->Update());
+
+    ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+    if (!itk::Testing::EqualInRegion<ImageType>(image, itk::ReadImage<ImageType>(fileName + ".mha"), image->GetLargestPossibleRegion()))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkMetaImageIOBlockCompressionTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkMetaImageIOBlockCompressionTest";
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 17, 13, 8 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    // Repeated values, so that the blocks are actually compressed.
+    it.Value()[0] = static_cast<short>(value / 7);
+    it.Value()[1] = static_cast<short>(-value);
+    it.Value()[2] = 42;
+    ++value;
+  }
+
+  auto imageIO = itk::MetaImageIO::New();
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetCompressionBlockSize(), 0);
+
+  int testStatus = EXIT_SUCCESS;
+  for (const char * extension : { ".mha", ".mhd" })
+  {
+    // A block of 1000 bytes is not a whole number of pixels, or of lines.
+    for (const itk::SizeValueType blockSize : { 1000, 4096, 1024 * 1024, 0 })
+    {
+      const std::string fileName = prefix + std::to_string(blockSize) + extension;
+      testStatus |= TestBlockCompression(image, fileName, blockSize);
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
@@ -149,6 +149,12 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The pixels can be memory mapped when the image file is uncompressed,
+   * in native byte order, and needs neither rescaling, nor reordering of the
+   * components of vector pixels, nor RAS to LPS conversion. */
+  bool
+  CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   //-------- This part of the interfaces deals with writing data. -----
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -177,6 +183,18 @@ public:
   ImageIORegion
   GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
 
+  /** Any region of the image can be read: the voxels of the region are read
+   * run by run, seeking between them in an uncompressed file. In a
+   * compressed file (.nii.gz) seeking forward decompresses the data skipped,
+   * so that reading a region costs decompressing the file up to its end,
+   * unless the file was written in blocks (see UseBlockCompression), of which
+   * only those covering the region are decompressed. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
   /** Set the slope and intercept for voxel value rescaling. */
   itkSetMacro(RescaleSlope, double);
   itkSetMacro(RescaleIntercept, double);
@@ -219,12 +237,32 @@ public:
   itkGetConstMacro(ConvertRASDisplacementVectors, bool);
   itkBooleanMacro(ConvertRASDisplacementVectors);
 
+  /** Set/Get whether single file compressed images (.nii.gz) are written in
+   * blocks that are compressed independently, in parallel. The file is still
+   * a standard gzip file, whose header holds the index of the blocks in its
+   * extra field, so that the blocks are also decompressed in parallel when
+   * the file is read. Other gzip files are decompressed serially. On by
+   * default. */
+  itkSetMacro(UseBlockCompression, bool);
+  itkGetConstMacro(UseBlockCompression, bool);
+  itkBooleanMacro(UseBlockCompression);
+
+  /** Set/Get the number of uncompressed bytes of the blocks written when
+   * UseBlockCompression is on. Blocks are enlarged for images that would
+   * have too many of them to be indexed. Default is 1 MiB. */
+  itkSetClampMacro(CompressionBlockSize, SizeValueType, 1024, SizeValueType{ 1 } << 30);
+  itkGetConstMacro(CompressionBlockSize, SizeValueType);
+
 protected:
   NiftiImageIO();
   ~NiftiImageIO() override;
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Also copies the options of the NIfTI reading and writing. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   virtual bool
   GetUseLegacyModeForTwoFileWriting() const
   {
@@ -273,6 +311,9 @@ private:
   bool m_ConvertRASVectors{ false };
   bool m_ConvertRASDisplacementVectors{ true };
 
+  bool          m_UseBlockCompression{ true };
+  SizeValueType m_CompressionBlockSize{ SizeValueType{ 1 } << 20 };
+
   IOComponentEnum m_OnDiskComponentType{ IOComponentEnum::UNKNOWNCOMPONENTTYPE };
 
   NiftiImageIOEnums::Analyze75Flavor m_LegacyAnalyze75Mode{};
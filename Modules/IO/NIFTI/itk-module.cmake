@@ -8,10 +8,12 @@ itk_module(ITKIONIFTI
   PRIVATE_DEPENDS
     ITKTransform
     ITKNIFTI
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKNIFTI
     ITKTransform
+    ITKZLIB
   FACTORY_NAMES
     ImageIO::Nifti
   DESCRIPTION
@@ -21,7 +21,17 @@
 #include "itkSpatialOrientationAdapter.h"
 #include <nifti1_io.h>
 #include "itkNiftiImageIOConfigurePrivate.h"
+#include "itkImageIORegionRuns.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include "itkMultiThreaderBase.h"
+#include "itkZlibBlockCompression.h"
+#include "itk_zlib.h"
+#include "itksys/SystemTools.hxx"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
 
 namespace itk
 {
@@ -467,6 +477,24 @@ NiftiImageIO::~NiftiImageIO()
   nifti_image_free(this->m_NiftiImage);
 }
 
+LightObject::Pointer
+NiftiImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_LegacyAnalyze75Mode = m_LegacyAnalyze75Mode;
+  rval->m_ConvertRASVectors = m_ConvertRASVectors;
+  rval->m_ConvertRASDisplacementVectors = m_ConvertRASDisplacementVectors;
+  rval->m_UseBlockCompression = m_UseBlockCompression;
+  rval->m_CompressionBlockSize = m_CompressionBlockSize;
+  return loPtr;
+}
+
 void
 NiftiImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -481,6 +509,8 @@ NiftiImageIO::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "ConvertRASDisplacementVectors: " << (m_ConvertRASDisplacementVectors ? "On" : "Off") << std::endl;
   os << indent << "OnDiskComponentType: " << m_OnDiskComponentType << std::endl;
   os << indent << "LegacyAnalyze75Mode: " << m_LegacyAnalyze75Mode << std::endl;
+  os << indent << "UseBlockCompression: " << (m_UseBlockCompression ? "On" : "Off") << std::endl;
+  os << indent << "CompressionBlockSize: " << m_CompressionBlockSize << std::endl;
 }
 
 bool
@@ -556,13 +586,421 @@ ConvertRASToFromLPS_XYZTC(TBuffer * buffer, size_t size)
     buffer[i] *= -1;
   }
 }
+
+// Block compressed .nii.gz files are single member gzip files, readable by
+// any gzip decoder, whose deflate stream is the concatenation of blocks of
+// the uncompressed file, compressed independently of each other, all but the
+// last one ended by a sync flush (like the files of "pigz --independent").
+// The extra field of the gzip header holds the index of the blocks, as an
+// "IK" subfield of little endian integers:
+//   uint32 number of uncompressed bytes of each block, but the last one
+//   uint64 number of uncompressed bytes of the file
+//   uint32 number of compressed bytes of each block
+constexpr size_t gzipHeaderLength = 10;
+constexpr size_t gzipIndexHeaderLength = 12;
+constexpr size_t maximumNumberOfGzipBlocks = (65535 - 4 - gzipIndexHeaderLength) / 4;
+
+struct GzipBlockIndex
+{
+  uint64_t blockSize{ 0 };
+  uint64_t uncompressedSize{ 0 };
+  // The offset of each block in the file, followed by the end of the last
+  // block.
+  std::vector<uint64_t> blockOffsets;
+};
+
+void
+EncodeLittleEndian(uint64_t value, size_t numberOfBytes, unsigned char * bytes)
+{
+  for (size_t i = 0; i < numberOfBytes; ++i)
+  {
+    bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+uint64_t
+DecodeLittleEndian(const unsigned char * bytes, size_t numberOfBytes)
+{
+  uint64_t value = 0;
+  for (size_t i = numberOfBytes; i-- > 0;)
+  {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+// Reads the index of a block compressed gzip file. Returns false for any
+// other file, which is then read serially.
+bool
+ReadGzipBlockIndex(std::istream & file, uint64_t fileLength, GzipBlockIndex & index)
+{
+  unsigned char header[gzipHeaderLength + 2];
+  // The FEXTRA flag must be the only one set.
+  if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != 0x1f || header[1] != 0x8b ||
+      header[2] != Z_DEFLATED || header[3] != 0x04)
+  {
+    return false;
+  }
+  const auto                 extraLength = static_cast<size_t>(DecodeLittleEndian(header + gzipHeaderLength, 2));
+  std::vector<unsigned char> extra(extraLength);
+  if (!file.read(reinterpret_cast<char *>(extra.data()), extraLength))
+  {
+    return false;
+  }
+  for (size_t position = 0; position + 4 <= extraLength;)
+  {
+    const auto   subfieldLength = static_cast<size_t>(DecodeLittleEndian(&extra[position + 2], 2));
+    const size_t data = position + 4;
+    if (extra[position] != 'I' || extra[position + 1] != 'K')
+    {
+      position = data + subfieldLength;
+      continue;
+    }
+    if (subfieldLength < gzipIndexHeaderLength || (subfieldLength - gzipIndexHeaderLength) % 4 != 0 ||
+        data + subfieldLength > extraLength)
+    {
+      return false;
+    }
+    index.blockSize = DecodeLittleEndian(&extra[data], 4);
+    index.uncompressedSize = DecodeLittleEndian(&extra[data + 4], 8);
+    const size_t numberOfBlocks = (subfieldLength - gzipIndexHeaderLength) / 4;
+    if (index.blockSize == 0 || numberOfBlocks != (index.uncompressedSize + index.blockSize - 1) / index.blockSize)
+    {
+      return false;
+    }
+    index.blockOffsets.resize(numberOfBlocks + 1);
+    index.blockOffsets[0] = sizeof(header) + extraLength;
+    for (size_t i = 0; i < numberOfBlocks; ++i)
+    {
+      index.blockOffsets[i + 1] =
+        index.blockOffsets[i] + DecodeLittleEndian(&extra[data + gzipIndexHeaderLength + 4 * i], 4);
+    }
+    // The blocks are followed by the CRC-32 and the size of the data.
+    return index.blockOffsets.back() + 8 == fileLength;
+  }
+  return false;
+}
+
+// Writes a single file NIfTI image, whose data are in nim->data, as a block
+// compressed gzip file. The blocks are compressed in parallel, batch by
+// batch, so that only the compressed blocks of a batch are held in memory.
+bool
+WriteGzipBlocks(nifti_image * nim, uint64_t blockSize)
+{
+  // The header is followed by an empty extender, then by the data, at an
+  // offset aligned on 16 bytes.
+  nifti_set_iname_offset(nim);
+  const nifti_1_header header = nifti_convert_nim2nhdr(nim);
+  std::vector<char>    prefix(static_cast<size_t>(nim->iname_offset));
+  std::copy_n(reinterpret_cast<const char *>(&header), sizeof(header), prefix.data());
+
+  const auto *   data = static_cast<const char *>(nim->data);
+  const uint64_t uncompressedSize = prefix.size() + static_cast<uint64_t>(nim->nbyper) * nim->nvox;
+  while ((uncompressedSize + blockSize - 1) / blockSize > maximumNumberOfGzipBlocks)
+  {
+    blockSize *= 2;
+  }
+  const auto numberOfBlocks = static_cast<size_t>((uncompressedSize + blockSize - 1) / blockSize);
+
+  std::ofstream file(nim->fname, std::ios::out | std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+  const size_t               indexLength = gzipIndexHeaderLength + 4 * numberOfBlocks;
+  std::vector<unsigned char> gzipHeader(gzipHeaderLength + 6 + indexLength);
+  unsigned char * const      bytes = gzipHeader.data();
+  // No modification time, nor compression flags, and an unknown OS.
+  bytes[0] = 0x1f;
+  bytes[1] = 0x8b;
+  bytes[2] = Z_DEFLATED;
+  bytes[3] = 0x04;
+  bytes[9] = 0xff;
+  EncodeLittleEndian(4 + indexLength, 2, bytes + gzipHeaderLength);
+  bytes[gzipHeaderLength + 2] = 'I';
+  bytes[gzipHeaderLength + 3] = 'K';
+  EncodeLittleEndian(indexLength, 2, bytes + gzipHeaderLength + 4);
+  unsigned char * const index = bytes + gzipHeaderLength + 6;
+  EncodeLittleEndian(blockSize, 4, index);
+  EncodeLittleEndian(uncompressedSize, 8, index + 4);
+  // The compressed sizes of the blocks are filled in at the end.
+  file.write(reinterpret_cast<const char *>(bytes), static_cast<std::streamsize>(gzipHeader.size()));
+
+  const auto                              multiThreader = MultiThreaderBase::New();
+  const size_t                            batchSize = 2 * static_cast<size_t>(multiThreader->GetNumberOfWorkUnits());
+  std::vector<std::vector<unsigned char>> compressedBlocks(batchSize);
+  std::vector<uLong>                      crcs(batchSize);
+  std::atomic<bool>                       failed{ false };
+  uLong                                   crc = crc32(0, nullptr, 0);
+  for (size_t batchStart = 0; batchStart < numberOfBlocks && !failed; batchStart += batchSize)
+  {
+    const size_t batchEnd = std::min(batchStart + batchSize, numberOfBlocks);
+    multiThreader->ParallelizeArray(
+      batchStart,
+      batchEnd,
+      [&](SizeValueType block) {
+        const uint64_t    blockStart = block * blockSize;
+        const auto        length = static_cast<uInt>(std::min(blockSize, uncompressedSize - blockStart));
+        std::vector<char> blockWithPrefix;
+        const char *      input = nullptr;
+        if (blockStart < prefix.size())
+        {
+          blockWithPrefix.assign(prefix.cbegin() + static_cast<ptrdiff_t>(blockStart), prefix.cend());
+          blockWithPrefix.insert(blockWithPrefix.cend(), data, data + (blockStart + length - prefix.size()));
+          input = blockWithPrefix.data();
+        }
+        else
+        {
+          input = data + (blockStart - prefix.size());
+        }
+
+        if (!ZlibBlockCompression::Deflate(
+              input, length, Z_DEFAULT_COMPRESSION, block + 1 == numberOfBlocks, compressedBlocks[block - batchStart]))
+        {
+          failed = true;
+        }
+        crcs[block - batchStart] = crc32(0, reinterpret_cast<const Bytef *>(input), length);
+      },
+      nullptr);
+
+    for (size_t block = batchStart; block < batchEnd && !failed; ++block)
+    {
+      const std::vector<unsigned char> & compressed = compressedBlocks[block - batchStart];
+      file.write(reinterpret_cast<const char *>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+      EncodeLittleEndian(compressed.size(), 4, index + gzipIndexHeaderLength + 4 * block);
+      const auto length = static_cast<z_off_t>(std::min(blockSize, uncompressedSize - block * blockSize));
+      crc = crc32_combine(crc, crcs[block - batchStart], length);
+    }
+  }
+
+  unsigned char trailer[8];
+  EncodeLittleEndian(crc, 4, trailer);
+  EncodeLittleEndian(uncompressedSize, 4, trailer + 4);
+  file.write(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+  file.seekp(static_cast<std::streamoff>(gzipHeaderLength + 6 + gzipIndexHeaderLength));
+  file.write(reinterpret_cast<const char *>(index + gzipIndexHeaderLength),
+             static_cast<std::streamsize>(4 * numberOfBlocks));
+  file.close();
+  if (failed || !file)
+  {
+    return false;
+  }
+  nim->byteorder = nifti_short_order();
+  return true;
+}
+
+// Writes the image as nifti_image_write_status() does, returning 0 on
+// success. Single file compressed images are written block compressed when
+// blockSize is not zero.
+int
+WriteImageFile(nifti_image * nim, uint64_t blockSize)
+{
+  if (blockSize != 0 && nim->nifti_type == NIFTI_FTYPE_NIFTI1_1 && nim->num_ext == 0 && nim->data != nullptr &&
+      nifti_validfilename(nim->fname) && nifti_is_gzfile(nim->fname))
+  {
+    return WriteGzipBlocks(nim, blockSize) ? 0 : 1;
+  }
+  return nifti_image_write_status(nim);
+}
+
+// Replaces the values that are not finite by zero, as nifti_read_buffer()
+// does.
+template <typename T>
+void
+ZeroNonFiniteValues(void * buffer, size_t numberOfBytes)
+{
+  T * const values = static_cast<T *>(buffer);
+  for (size_t i = 0; i < numberOfBytes / sizeof(T); ++i)
+  {
+    if (!std::isfinite(values[i]))
+    {
+      values[i] = 0;
+    }
+  }
+}
+
+// Reads the runs of the data of a block compressed gzip file, decompressing
+// in parallel the blocks that they cover. The byte offsets of the runs in the
+// uncompressed file are in increasing order, and their bytes are read one run
+// after the other in the buffer. Like nifti_read_buffer(), swaps the bytes if
+// needed, and zeroes the values that are not finite.
+bool
+ReadGzipBlocks(std::ifstream &               file,
+               const GzipBlockIndex &        index,
+               const std::vector<uint64_t> & runOffsets,
+               size_t                        runBytes,
+               nifti_image *                 nim,
+               void *                        buffer)
+{
+  if (runOffsets.back() + runBytes > index.uncompressedSize)
+  {
+    return false;
+  }
+  char * const      output = static_cast<char *>(buffer);
+  std::mutex        fileMutex;
+  std::atomic<bool> failed{ false };
+  MultiThreaderBase::New()->ParallelizeArray(
+    runOffsets.front() / index.blockSize,
+    (runOffsets.back() + runBytes - 1) / index.blockSize + 1,
+    [&](SizeValueType block) {
+      const uint64_t blockStart = block * index.blockSize;
+      const uint64_t blockEnd = std::min(blockStart + index.blockSize, index.uncompressedSize);
+      auto           run = static_cast<size_t>(
+        std::partition_point(runOffsets.cbegin(),
+                             runOffsets.cend(),
+                             [blockStart, runBytes](uint64_t offset) { return offset + runBytes <= blockStart; }) -
+        runOffsets.cbegin());
+      if (run == runOffsets.size() || runOffsets[run] >= blockEnd)
+      {
+        return;
+      }
+
+      std::vector<Bytef> compressed(static_cast<size_t>(index.blockOffsets[block + 1] - index.blockOffsets[block]));
+      {
+        const std::lock_guard<std::mutex> lock(fileMutex);
+        file.seekg(static_cast<std::streamoff>(index.blockOffsets[block]));
+        if (!file.read(reinterpret_cast<char *>(compressed.data()), static_cast<std::streamsize>(compressed.size())))
+        {
+          failed = true;
+          return;
+        }
+      }
+
+      // A block within a single run is decompressed in place.
+      const auto        length = static_cast<size_t>(blockEnd - blockStart);
+      const bool        inPlace = runOffsets[run] <= blockStart && runOffsets[run] + runBytes >= blockEnd;
+      std::vector<char> decompressed(inPlace ? 0 : length);
+      char * const      destination =
+        inPlace ? output + run * runBytes + (blockStart - runOffsets[run]) : decompressed.data();
+
+      if (!ZlibBlockCompression::Inflate(compressed.data(), compressed.size(), destination, length))
+      {
+        failed = true;
+        return;
+      }
+
+      for (; !inPlace && run < runOffsets.size() && runOffsets[run] < blockEnd; ++run)
+      {
+        const uint64_t start = std::max(runOffsets[run], blockStart);
+        const uint64_t end = std::min(runOffsets[run] + runBytes, blockEnd);
+        std::copy(decompressed.cbegin() + static_cast<ptrdiff_t>(start - blockStart),
+                  decompressed.cbegin() + static_cast<ptrdiff_t>(end - blockStart),
+                  output + run * runBytes + (start - runOffsets[run]));
+      }
+    },
+    nullptr);
+  if (failed)
+  {
+    return false;
+  }
+
+  const size_t numberOfBytes = runOffsets.size() * runBytes;
+  if (nim->swapsize > 1 && nim->byteorder != nifti_short_order())
+  {
+    nifti_swap_Nbytes(numberOfBytes / nim->swapsize, nim->swapsize, buffer);
+  }
+  switch (nim->datatype)
+  {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ZeroNonFiniteValues<float>(buffer, numberOfBytes);
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ZeroNonFiniteValues<double>(buffer, numberOfBytes);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+// Internal function to read the voxels of a region of the image directly into
+// the buffer, where they are byte swapped in place if needed, as
+// nifti_read_buffer() does. Unlike nifti_image_load() and
+// nifti_read_collapsed_image(), this never frees the buffer on failure.
+bool
+ReadRegionIntoBuffer(nifti_image * nim, const int origin[7], const int size[7], void * buffer)
+{
+  char * const imageFileName = nifti_findimgname(nim->iname, nim->nifti_type);
+  if (imageFileName == nullptr)
+  {
+    return false;
+  }
+  const std::string fileName = imageFileName;
+  free(imageFileName);
+  const int isCompressed = nifti_is_gzfile(fileName.c_str());
+
+  // A negative offset means that the data are at the end of the file.
+  long dataOffset = nim->iname_offset;
+  if (dataOffset < 0)
+  {
+    const long fileSize = isCompressed ? 0 : nifti_get_filesize(nim->iname);
+    const auto dataSize = static_cast<long>(nifti_get_volsize(nim));
+    if (fileSize <= 0)
+    {
+      return false;
+    }
+    dataOffset = fileSize > dataSize ? fileSize - dataSize : 0;
+  }
+
+  ImageIORegion              region(7);
+  std::vector<SizeValueType> dims(7);
+  for (unsigned int d = 0; d < 7; ++d)
+  {
+    region.SetIndex(d, origin[d]);
+    region.SetSize(d, static_cast<SizeValueType>(size[d]));
+    dims[d] = (static_cast<int>(d) < nim->ndim) ? static_cast<SizeValueType>(nim->dim[d + 1]) : 1;
+  }
+
+  // The offsets of the runs in the file, in increasing order.
+  std::vector<uint64_t> runOffsets;
+  size_t                runBytes = 0;
+  ForEachImageIORegionRun(region, dims, [&](SizeValueType offset, SizeValueType length) {
+    runOffsets.push_back(static_cast<uint64_t>(dataOffset) + offset * nim->nbyper);
+    runBytes = length * static_cast<size_t>(nim->nbyper);
+    return true;
+  });
+  if (runBytes == 0)
+  {
+    return true;
+  }
+
+  // The blocks of a block compressed file are decompressed in parallel.
+  if (isCompressed)
+  {
+    std::ifstream  file(fileName, std::ios::in | std::ios::binary);
+    GzipBlockIndex blockIndex;
+    if (file && ReadGzipBlockIndex(file, itksys::SystemTools::FileLength(fileName), blockIndex))
+    {
+      return ReadGzipBlocks(file, blockIndex, runOffsets, runBytes, nim, buffer);
+    }
+  }
+
+  znzFile file = znzopen(fileName.c_str(), "rb", isCompressed);
+  if (znz_isnull(file))
+  {
+    return false;
+  }
+  char * output = static_cast<char *>(buffer);
+  for (const uint64_t runOffset : runOffsets)
+  {
+    if (znzseek(file, static_cast<znz_off_t>(runOffset), SEEK_SET) < 0 ||
+        nifti_read_buffer(file, output, runBytes, nim) != runBytes)
+    {
+      znzclose(file);
+      return false;
+    }
+    output += runBytes;
+  }
+  znzclose(file);
+  return true;
+}
 } // namespace
 
 void
 NiftiImageIO::Read(void * buffer)
 {
-  void * data = nullptr;
-
   ImageIORegion            regionToRead = this->GetIORegion();
   ImageIORegion::SizeType  size = regionToRead.GetSize();
   ImageIORegion::IndexType start = regionToRead.GetIndex();
@@ -586,14 +1024,26 @@ NiftiImageIO::Read(void * buffer)
 
   unsigned int numComponents = this->GetNumberOfComponents();
   //
+  // if single or complex, nifti layout == itk layout
+  const bool sameLayout = numComponents == 1 || this->GetPixelType() == IOPixelEnum::COMPLEX ||
+                          this->GetPixelType() == IOPixelEnum::RGB || this->GetPixelType() == IOPixelEnum::RGBA;
+  //
+  // unless the pixels are promoted to float to be rescaled, read them
+  // directly into the buffer.
+  const bool mustPromote = this->MustRescale() && this->m_ComponentType != this->m_OnDiskComponentType;
+  const bool readDirectly = sameLayout && !mustPromote;
+  //
   // special case for images of vector pixels
-  if (numComponents > 1 && this->GetPixelType() != IOPixelEnum::COMPLEX)
+  if (!sameLayout)
   {
     // nifti always sticks vec size in dim 4, so have to shove
     // other dims out of the way
+    _origin[6] = _origin[5];
+    _origin[5] = _origin[4];
     _size[6] = _size[5];
     _size[5] = _size[4];
     // sizes = x y z t vecsize
+    _origin[4] = 0;
     _size[4] = numComponents;
   }
   // Free memory if any was occupied already (incase of re-using the IO filter).
@@ -607,172 +1057,148 @@ NiftiImageIO::Read(void * buffer)
     itkExceptionMacro(<< "nifti_image_read (just header) failed for file: " << this->GetFileName());
   }
 
-  //
-  // decide whether to read whole region or subregion, by stepping
-  // thru dims and comparing them to requested sizes
-  for (i = 0; i < this->GetNumberOfDimensions(); ++i)
+  if (readDirectly)
   {
-    if (this->m_NiftiImage->dim[i + 1] != _size[i])
+    if (!ReadRegionIntoBuffer(this->m_NiftiImage, _origin, _size, buffer))
     {
-      break;
+      itkExceptionMacro(<< "Reading the image data failed for file: " << this->GetFileName());
     }
   }
-  // if all dimensions match requested size, just read in
-  // all data as a block
-  if (i == this->GetNumberOfDimensions())
-  {
-    if (nifti_image_load(this->m_NiftiImage) == -1)
-    {
-      itkExceptionMacro(<< "nifti_image_load failed for file: " << this->GetFileName());
-    }
-    data = this->m_NiftiImage->data;
-  }
   else
   {
-    // read in a subregion
-    if (nifti_read_subregion_image(this->m_NiftiImage, _origin, _size, &data) == -1)
+    //
+    // read the region, with the components in nifti order, into a
+    // temporary buffer
+    size_t dataSize = this->m_NiftiImage->nbyper;
+    for (i = 0; i < 7; ++i)
     {
-      itkExceptionMacro(<< "nifti_read_subregion_image failed for file: " << this->GetFileName());
+      dataSize *= static_cast<size_t>(_size[i]);
     }
-  }
-  unsigned int pixelSize = this->m_NiftiImage->nbyper;
-  //
-  // if we're going to have to rescale pixels, and the on-disk
-  // pixel type is different than the pixel type reported to
-  // ImageFileReader, we have to up-promote the data to float
-  // before doing the rescale.
-  //
-  if (this->MustRescale() && this->m_ComponentType != this->m_OnDiskComponentType)
-  {
-    pixelSize = static_cast<unsigned int>(this->GetNumberOfComponents()) * static_cast<unsigned int>(sizeof(float));
-
-    // allocate new buffer for floats. Malloc instead of new to
-    // be consistent with allocation used in niftilib
-    auto * _data = static_cast<float *>(malloc(numElts * sizeof(float)));
-    switch (this->m_OnDiskComponentType)
+    const auto regionData = make_unique_for_overwrite<char[]>(dataSize);
+    if (!ReadRegionIntoBuffer(this->m_NiftiImage, _origin, _size, regionData.get()))
     {
-      case IOComponentEnum::CHAR:
-        CastCopy<char>(_data, data, numElts);
-        break;
-      case IOComponentEnum::UCHAR:
-        CastCopy<unsigned char>(_data, data, numElts);
-        break;
-      case IOComponentEnum::SHORT:
-        CastCopy<short>(_data, data, numElts);
-        break;
-      case IOComponentEnum::USHORT:
-        CastCopy<unsigned short>(_data, data, numElts);
-        break;
-      case IOComponentEnum::INT:
-        CastCopy<int>(_data, data, numElts);
-        break;
-      case IOComponentEnum::UINT:
-        CastCopy<unsigned int>(_data, data, numElts);
-        break;
-      case IOComponentEnum::LONG:
-        CastCopy<long>(_data, data, numElts);
-        break;
-      case IOComponentEnum::ULONG:
-        CastCopy<unsigned long>(_data, data, numElts);
-        break;
-      case IOComponentEnum::LONGLONG:
-        CastCopy<long long>(_data, data, numElts);
-        break;
-      case IOComponentEnum::ULONGLONG:
-        CastCopy<unsigned long long>(_data, data, numElts);
-        break;
-      case IOComponentEnum::FLOAT:
-        itkExceptionMacro(<< "FLOAT pixels do not need Casting to float");
-      case IOComponentEnum::DOUBLE:
-        itkExceptionMacro(<< "DOUBLE pixels do not need Casting to float");
-      case IOComponentEnum::LDOUBLE:
-        itkExceptionMacro(<< "LDOUBLE pixels do not need Casting to float");
-      case IOComponentEnum::UNKNOWNCOMPONENTTYPE:
-        itkExceptionMacro(<< "Bad OnDiskComponentType UNKNOWNCOMPONENTTYPE");
+      itkExceptionMacro(<< "Reading the image data failed for file: " << this->GetFileName());
     }
+    void * data = regionData.get();
+
+    unsigned int pixelSize = this->m_NiftiImage->nbyper;
     //
-    // we're replacing the data pointer, so if it was allocated
-    // in nifti_read_subregion_image, free the old data here
-    if (data != this->m_NiftiImage->data)
-    {
-      free(data);
-    }
-    data = _data;
-  }
-  //
-  // if single or complex, nifti layout == itk layout
-  if (numComponents == 1 || this->GetPixelType() == IOPixelEnum::COMPLEX || this->GetPixelType() == IOPixelEnum::RGB ||
-      this->GetPixelType() == IOPixelEnum::RGBA)
-  {
-    const size_t NumBytes = numElts * pixelSize;
-    memcpy(buffer, data, NumBytes);
+    // if we're going to have to rescale pixels, and the on-disk
+    // pixel type is different than the pixel type reported to
+    // ImageFileReader, we have to up-promote the data to float
+    // before doing the rescale.
     //
-    // if read_subregion was called it allocates a buffer that needs to be
-    // freed.
-    if (data != this->m_NiftiImage->data)
+    std::unique_ptr<float[]> promotedData;
+    if (mustPromote)
     {
-      free(data);
+      // the components of vector pixels are reordered one by one below
+      pixelSize = (sameLayout ? numComponents : 1) * static_cast<unsigned int>(sizeof(float));
+
+      const size_t numberOfValues = dataSize / this->m_NiftiImage->nbyper;
+      promotedData = make_unique_for_overwrite<float[]>(numberOfValues);
+      float * const _data = promotedData.get();
+      switch (this->m_OnDiskComponentType)
+      {
+        case IOComponentEnum::CHAR:
+          CastCopy<char>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::UCHAR:
+          CastCopy<unsigned char>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::SHORT:
+          CastCopy<short>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::USHORT:
+          CastCopy<unsigned short>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::INT:
+          CastCopy<int>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::UINT:
+          CastCopy<unsigned int>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::LONG:
+          CastCopy<long>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::ULONG:
+          CastCopy<unsigned long>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::LONGLONG:
+          CastCopy<long long>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::ULONGLONG:
+          CastCopy<unsigned long long>(_data, data, numberOfValues);
+          break;
+        case IOComponentEnum::FLOAT:
+          itkExceptionMacro(<< "FLOAT pixels do not need Casting to float");
+        case IOComponentEnum::DOUBLE:
+          itkExceptionMacro(<< "DOUBLE pixels do not need Casting to float");
+        case IOComponentEnum::LDOUBLE:
+          itkExceptionMacro(<< "LDOUBLE pixels do not need Casting to float");
+        case IOComponentEnum::UNKNOWNCOMPONENTTYPE:
+          itkExceptionMacro(<< "Bad OnDiskComponentType UNKNOWNCOMPONENTTYPE");
+      }
+      data = _data;
     }
-  }
-  else
-  {
-    // otherwise nifti is x y z t vec l m 0, itk is
-    // vec x y z t l m o
-    const auto * niftibuf = (const char *)data;
-    auto *       itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
-    //
-    // as per ITK bug 0007485
-    // NIfTI is lower triangular, ITK is upper triangular.
-    int * vecOrder;
-    if (this->GetPixelType() == IOPixelEnum::DIFFUSIONTENSOR3D ||
-        this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR)
+    if (sameLayout)
     {
-      //      vecOrder = LowerToUpperOrder(SymMatDim(numComponents));
-      vecOrder = UpperToLowerOrder(SymMatDim(numComponents));
+      const size_t NumBytes = numElts * pixelSize;
+      memcpy(buffer, data, NumBytes);
     }
     else
     {
-      vecOrder = new int[numComponents];
-      for (i = 0; i < numComponents; ++i)
+      // otherwise nifti is x y z t vec l m 0, itk is
+      // vec x y z t l m o
+      const auto * niftibuf = (const char *)data;
+      auto *       itkbuf = (char *)buffer;
+      const size_t rowdist = _size[0];
+      const size_t slicedist = rowdist * _size[1];
+      const size_t volumedist = slicedist * _size[2];
+      const size_t seriesdist = volumedist * _size[3];
+      //
+      // as per ITK bug 0007485
+      // NIfTI is lower triangular, ITK is upper triangular.
+      int * vecOrder;
+      if (this->GetPixelType() == IOPixelEnum::DIFFUSIONTENSOR3D ||
+          this->GetPixelType() == IOPixelEnum::SYMMETRICSECONDRANKTENSOR)
       {
-        vecOrder[i] = i;
+        //      vecOrder = LowerToUpperOrder(SymMatDim(numComponents));
+        vecOrder = UpperToLowerOrder(SymMatDim(numComponents));
       }
-    }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; ++t)
-    {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; ++z)
+      else
       {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; ++y)
+        vecOrder = new int[numComponents];
+        for (i = 0; i < numComponents; ++i)
         {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; ++x)
+          vecOrder[i] = i;
+        }
+      }
+      for (int t = 0; t < _size[3]; ++t)
+      {
+        for (int z = 0; z < _size[2]; ++z)
+        {
+          for (int y = 0; y < _size[1]; ++y)
           {
-            for (unsigned int c = 0; c < numComponents; ++c)
+            for (int x = 0; x < _size[0]; ++x)
             {
-              const size_t nifti_index =
-                (c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x) * pixelSize;
-              const size_t itk_index =
-                ((volumedist * t + slicedist * z + rowdist * y + x) * numComponents + vecOrder[c]) * pixelSize;
-              for (unsigned int b = 0; b < pixelSize; ++b)
+              for (unsigned int c = 0; c < numComponents; ++c)
               {
-                itkbuf[itk_index + b] = niftibuf[nifti_index + b];
+                const size_t nifti_index =
+                  (c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x) * pixelSize;
+                const size_t itk_index =
+                  ((volumedist * t + slicedist * z + rowdist * y + x) * numComponents + vecOrder[c]) * pixelSize;
+                for (unsigned int b = 0; b < pixelSize; ++b)
+                {
+                  itkbuf[itk_index + b] = niftibuf[nifti_index + b];
+                }
               }
             }
           }
         }
       }
-    }
-    delete[] vecOrder;
-    dumpdata(data);
-    dumpdata(buffer);
-    // if read_subregion was called it allocates a buffer that needs to be
-    // freed.
-    if (data != this->m_NiftiImage->data)
-    {
-      free(data);
+      delete[] vecOrder;
+      dumpdata(data);
+      dumpdata(buffer);
     }
   }
 
@@ -851,6 +1277,33 @@ NiftiImageIO::Read(void * buffer)
   }
 }
 
+bool
+NiftiImageIO::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  if (this->MustRescale() || this->m_ConvertRAS ||
+      (this->GetNumberOfComponents() > 1 && this->GetPixelType() != IOPixelEnum::COMPLEX &&
+       this->GetPixelType() != IOPixelEnum::RGB && this->GetPixelType() != IOPixelEnum::RGBA))
+  {
+    return false;
+  }
+
+  // The header read by ReadImageInformation() is not kept: read it again.
+  nifti_image * header = nifti_image_read(this->GetFileName(), false);
+  if (header == nullptr)
+  {
+    return false;
+  }
+  const bool canMemoryMap = header->iname != nullptr && nifti_is_gzfile(header->iname) == 0 &&
+                            header->byteorder == nifti_short_order() && header->iname_offset >= 0;
+  if (canMemoryMap)
+  {
+    dataFileName = header->iname;
+    dataOffset = static_cast<SizeValueType>(header->iname_offset);
+  }
+  nifti_image_free(header);
+  return canMemoryMap;
+}
+
 NiftiImageIOEnums::NiftiFileEnum
 NiftiImageIO::DetermineFileType(const char * FileNameToRead)
 {
@@ -2331,7 +2784,8 @@ NiftiImageIO::Write(const void * buffer)
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
     this->m_NiftiImage->data = const_cast<void *>(buffer);
-    const int nifti_write_status = nifti_image_write_status(this->m_NiftiImage);
+    const int nifti_write_status =
+      WriteImageFile(this->m_NiftiImage, this->m_UseBlockCompression ? this->m_CompressionBlockSize : 0);
     this->m_NiftiImage->data = nullptr; // Must free before throwing exception.
                                         // if left pointing to data buffer
                                         // nifti_image_free inside Destructor of ITKNiftiIO
@@ -2440,7 +2894,8 @@ NiftiImageIO::Write(const void * buffer)
     // Need a const cast here so that we don't have to copy the memory for
     // writing.
     this->m_NiftiImage->data = static_cast<void *>(nifti_buf.get());
-    const int nifti_write_status = nifti_image_write_status(this->m_NiftiImage);
+    const int nifti_write_status =
+      WriteImageFile(this->m_NiftiImage, this->m_UseBlockCompression ? this->m_CompressionBlockSize : 0);
     this->m_NiftiImage->data = nullptr; // if left pointing to data buffer
     if (nifti_write_status)
     {
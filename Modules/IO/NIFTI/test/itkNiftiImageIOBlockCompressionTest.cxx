@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
+#include "itkNiftiImageIO.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+#include "itkTimeProbe.h"
+#include "itk_zlib.h"
+
+#include <fstream>
+#include <iterator>
+
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using VectorImageType = itk::Image<itk::Vector<short, 3>, 3>;
+
+template <typename TImage>
+void
+WriteNifti(const TImage * image, const std::string & fileName, bool useBlockCompression, itk::SizeValueType blockSize)
+{
+  auto imageIO = itk::NiftiImageIO::New();
+  imageIO->SetUseBlockCompression(useBlockCompression);
+  imageIO->SetCompressionBlockSize(blockSize);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->Update();
+}
+
+// Reads the image written to fileName, whole and in regions.
+template <typename TImage>
+int
+TestRead(const TImage * image, const std::string & fileName)
+{
+  const typename TImage::Pointer readImage = itk::ReadImage<TImage>(fileName);
+  ITK_TEST_EXPECT_EQUAL(readImage->GetBufferedRegion(), image->GetBufferedRegion());
+  if (!itk::Testing::EqualInRegion<TImage>(image, readImage, image->GetBufferedRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  using RegionType = typename TImage::RegionType;
+  for (const RegionType & region : { RegionType{ { { 0, 0, 9 } }, { { 61, 43, 4 } } },
+                                     RegionType{ { { 5, 7, 1 } }, { { 30, 2, 17 } } },
+                                     RegionType{ { { 60, 42, 18 } }, { { 1, 1, 1 } } } })
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<TImage>(image, reader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+std::string
+ReadFile(const std::string & fileName)
+{
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+// Decompresses the file with the gzip decoder of zlib.
+std::string
+Gunzip(const std::string & fileName)
+{
+  std::string data;
+  gzFile      file = gzopen(fileName.c_str(), "rb");
+  char        buffer[65536];
+  int         length;
+  while ((length = gzread(file, buffer, sizeof(buffer))) > 0)
+  {
+    data.append(buffer, static_cast<size_t>(length));
+  }
+  gzclose(file);
+  return data;
+}
+
+ImageType::Pointer
+MakeImage()
+{
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 61, 43, 19 } });
+  image->SetSpacing(itk::MakeVector(0.5, 0.75, 2.0));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<float>(index[0] % 7 + 3 * index[1] - 0.25 * index[2]));
+  }
+  return image;
+}
+} // namespace
+
+
+int
+itkNiftiImageIOBlockCompressionTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkNiftiImageIOBlockCompressionTest";
+
+  auto imageIO = itk::NiftiImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->GetUseBlockCompression());
+  ITK_TEST_SET_GET_VALUE(1u << 20, imageIO->GetCompressionBlockSize());
+  imageIO->SetCompressionBlockSize(1);
+  ITK_TEST_SET_GET_VALUE(1024u, imageIO->GetCompressionBlockSize());
+
+  const ImageType::Pointer image = MakeImage();
+  auto                     vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(image->GetBufferedRegion());
+  vectorImage->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<VectorImageType> it(vectorImage, vectorImage->GetBufferedRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    const auto &               index = it.GetIndex();
+    VectorImageType::PixelType pixel;
+    pixel[0] = static_cast<short>(index[0]);
+    pixel[1] = static_cast<short>(-index[1]);
+    pixel[2] = static_cast<short>(100 * index[2]);
+    it.Set(pixel);
+  }
+  WriteNifti(image.GetPointer(), prefix + ".nii", false, 1024);
+
+  int testStatus = EXIT_SUCCESS;
+  for (const itk::ThreadIdType numberOfThreads : { 1, 4 })
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+    for (const itk::SizeValueType blockSize : { 1024, 5000, 1 << 20 })
+    {
+      const std::string fileName = prefix + std::to_string(blockSize) + ".nii.gz";
+      std::cout << "Writing " << fileName << " with " << numberOfThreads << " threads" << std::endl;
+      WriteNifti(image.GetPointer(), fileName, true, blockSize);
+      testStatus |= TestRead<ImageType>(image, fileName);
+
+      // The file is a standard gzip file, holding the same file as the
+      // uncompressed one.
+      ITK_TEST_EXPECT_TRUE(Gunzip(fileName) == ReadFile(prefix + ".nii"));
+
+      const std::string vectorFileName = prefix + "Vector" + std::to_string(blockSize) + ".nii.gz";
+      WriteNifti(vectorImage.GetPointer(), vectorFileName, true, blockSize);
+      testStatus |= TestRead<VectorImageType>(vectorImage, vectorFileName);
+    }
+  }
+
+  // Files that are not block compressed are read serially.
+  WriteNifti(image.GetPointer(), prefix + "Serial.nii.gz", false, 1024);
+  testStatus |= TestRead<ImageType>(image, prefix + "Serial.nii.gz");
+  ITK_TEST_EXPECT_TRUE(Gunzip(prefix + "Serial.nii.gz") == ReadFile(prefix + ".nii"));
+
+  // The compression of a larger image, written then read with a block
+  // compressed file, or a single gzip stream.
+  auto largeImage = ImageType::New();
+  largeImage->SetRegions(ImageType::SizeType{ { 256, 256, 128 } });
+  largeImage->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(largeImage, largeImage->GetBufferedRegion()); !it.IsAtEnd();
+       ++it)
+  {
+    it.Set(static_cast<float>((it.GetIndex()[0] * it.GetIndex()[1]) % 251));
+  }
+  for (const bool useBlockCompression : { false, true })
+  {
+    const std::string fileName = prefix + "Large" + (useBlockCompression ? "Blocks" : "Serial") + ".nii.gz";
+    itk::TimeProbe    writeProbe;
+    writeProbe.Start();
+    WriteNifti(largeImage.GetPointer(), fileName, useBlockCompression, 1 << 20);
+    writeProbe.Stop();
+    itk::TimeProbe readProbe;
+    readProbe.Start();
+    const ImageType::Pointer readImage = itk::ReadImage<ImageType>(fileName);
+    readProbe.Stop();
+    ITK_TEST_EXPECT_TRUE(*readImage == *largeImage);
+    std::cout << fileName << ": " << itksys::SystemTools::FileLength(fileName) << " bytes, written in "
+              << writeProbe.GetTotal() << " s, read in " << readProbe.GetTotal() << " s" << std::endl;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
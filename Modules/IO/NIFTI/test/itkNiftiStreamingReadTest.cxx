@@ -0,0 +1,132 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkNiftiImageIO.h"
+#include "itkStreamingImageFilter.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage()
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+  using ComponentType = typename PixelTraits::ComponentType;
+
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 19, 14, 11 } });
+  image->Allocate();
+  ComponentType value{};
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    auto & pixel = it.Value();
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      PixelTraits::SetNthComponent(static_cast<int>(c), pixel, value);
+      ++value;
+    }
+  }
+  return image;
+}
+
+// Reads regions of the image written to fileName, checking that only the
+// requested region is read, and that the whole image is read in pieces.
+template <typename TImage>
+int
+TestStreamingRead(const std::string & fileName)
+{
+  std::cout << "Reading regions of " << fileName << std::endl;
+
+  const typename TImage::Pointer image = MakeImage<TImage>();
+  itk::WriteImage(image, fileName);
+
+  using RegionType = typename TImage::RegionType;
+  for (const RegionType & region : { RegionType{ { { 0, 0, 4 } }, { { 19, 14, 3 } } },
+                                     RegionType{ { { 3, 5, 2 } }, { { 7, 1, 6 } } },
+                                     RegionType{ { { 18, 13, 10 } }, { { 1, 1, 1 } } } })
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(itk::NiftiImageIO::New());
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<TImage>(image, reader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+  reader->UseStreamingOn();
+
+  auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(reader->GetOutput());
+  streamer->SetNumberOfStreamDivisions(5);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamer->Update());
+
+  ITK_TEST_EXPECT_TRUE(reader->GetImageIO()->CanStreamRead());
+  ITK_TEST_EXPECT_TRUE(reader->GetOutput()->GetBufferedRegion() != image->GetBufferedRegion());
+  if (!itk::Testing::EqualInRegion<TImage>(image, streamer->GetOutput(), image->GetBufferedRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkNiftiStreamingReadTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkNiftiStreamingReadTest";
+
+  using ScalarImageType = itk::Image<short, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+  using TensorImageType = itk::Image<itk::SymmetricSecondRankTensor<float, 3>, 3>;
+
+  int testStatus = EXIT_SUCCESS;
+  for (const char * extension : { ".nii", ".nii.gz", ".img" })
+  {
+    testStatus |= TestStreamingRead<ScalarImageType>(prefix + "Scalar" + extension);
+    testStatus |= TestStreamingRead<VectorImageType>(prefix + "Vector" + extension);
+    testStatus |= TestStreamingRead<TensorImageType>(prefix + "Tensor" + extension);
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
@@ -20,7 +20,7 @@
 #include "ITKIONRRDExport.h"
 
 
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <fstream>
 
 struct NrrdEncoding_t;
@@ -38,24 +38,31 @@ namespace itk
  * "bzip2".  Only the "gzip" compressor support the compression level
  * in the range 0-9.
  *
+ * Regions of the image can be read and written (streamed) when the
+ * pixels are stored in a single file, attached to the header or detached
+ * from it, with the raw or the gzip encoding. A region of gzip encoded
+ * pixels is read by decompressing the data up to its end, and the regions
+ * of a compressed image can only be written in order, each one as a gzip
+ * member of its own, so that compressed images cannot be pasted into.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
-class ITKIONRRD_EXPORT NrrdImageIO : public ImageIOBase
+class ITKIONRRD_EXPORT NrrdImageIO : public StreamingImageIOBase
 {
 public:
   ITK_DISALLOW_COPY_AND_MOVE(NrrdImageIO);
 
   /** Standard class type aliases. */
   using Self = NrrdImageIO;
-  using Superclass = ImageIOBase;
+  using Superclass = StreamingImageIOBase;
   using Pointer = SmartPointer<Self>;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(NrrdImageIO, ImageIOBase);
+  itkTypeMacro(NrrdImageIO, StreamingImageIOBase);
 
   /** The different types of ImageIO's can support data of varying
    * dimensionality. For example, some file formats are strictly 2D
@@ -78,6 +85,18 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Regions can be read when the pixels are stored with the raw or gzip
+   * encoding, in a single file, with the components of non-scalar pixels on
+   * the fastest axis, as found by ReadImageInformation(). */
+  bool
+  CanStreamRead() override;
+
+  /** The pixels can be memory mapped when they are stored with the raw
+   * encoding, in native byte order, in a single file, with the components of
+   * non-scalar pixels on the fastest axis, as found by ReadImageInformation(). */
+  bool
+  CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset) override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -92,6 +111,16 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Regions can be written with the raw encoding, or compressed with gzip. */
+  bool
+  CanStreamWrite() override;
+
+  /** Reimplemented to refuse pasting into a compressed image. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
 protected:
   NrrdImageIO();
   ~NrrdImageIO() override;
@@ -109,7 +138,44 @@ protected:
   IOComponentEnum
   NrrdToITKComponentType(const int) const;
 
+  /** The offset of the pixels in the file holding them, which is the size of
+   * the header when they are attached to it. */
+  SizeType
+  GetHeaderSize() const override;
+
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+private:
+  /** The encoding of the data written: gzip or bzip2 when compressing, raw,
+   * or ascii. */
+  const NrrdEncoding_t *
+  GetWriteEncoding() const;
+
+  /** Writes the header, with the data unless headerOnly is set, in which case
+   * the location of the data to write is recorded, as when reading. */
+  void
+  SaveNrrd(const void * buffer, bool headerOnly);
+
+  /** Reads or writes the IORegion of gzip encoded pixels. */
+  void
+  ReadCompressedRegion(void * buffer);
+  void
+  WriteCompressedRegion(const void * buffer);
+
+  /** Where ReadImageInformation() found the pixels, raw or gzip encoded:
+   * the file name is empty when they can neither be streamed nor memory
+   * mapped. A negative offset counts from the end of the file. */
+  std::string m_DataFileName{};
+  long int    m_DataOffset{ 0 };
+  bool        m_DataIsCompressed{ false };
+
+  /** The number of bytes of pixels already compressed by the regions
+   * written in order. */
+  SizeType m_NumberOfCompressedBytesWritten{ 0 };
+
+  /** Whether the SYMMETRICSECONDRANKTENSOR pixels found by
+   * ReadImageInformation() have a mask component, which Read() crops out. */
+  bool m_MaskedSymmetricMatrix{ false };
 };
 } // end namespace itk
 
@@ -21,14 +21,219 @@
 
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
+#include "itkByteSwapper.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkImageIORegionRuns.h"
+#include "itkMakeUniqueForOverwrite.h"
+#include "itk_zlib.h"
 
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
 #include <sstream>
 
 namespace itk
 {
 #define KEY_PREFIX "NRRD_"
 
+namespace
+{
+// Offset of the data attached to a NRRD header: the header ends with the
+// first empty line. Returns -1 when no such line is found.
+long int
+NrrdAttachedDataOffset(const std::string & fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string   line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line == "\r")
+    {
+      return static_cast<long int>(file.tellg());
+    }
+  }
+  return -1;
+}
+
+// Swaps the bytes of the components between the byte order of the system
+// and the given one, when they differ.
+template <typename T>
+void
+SwapRange(void * buffer, SizeValueType numberOfComponents, IOByteOrderEnum byteOrder)
+{
+  if (byteOrder == IOByteOrderEnum::BigEndian)
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToBigEndian(static_cast<T *>(buffer), numberOfComponents);
+  }
+  else if (byteOrder == IOByteOrderEnum::LittleEndian)
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(static_cast<T *>(buffer), numberOfComponents);
+  }
+}
+
+void
+SwapComponentBytes(void *          buffer,
+                   SizeValueType   numberOfComponents,
+                   SizeValueType   componentSize,
+                   IOByteOrderEnum byteOrder)
+{
+  switch (componentSize)
+  {
+    case 2:
+      SwapRange<uint16_t>(buffer, numberOfComponents, byteOrder);
+      break;
+    case 4:
+      SwapRange<uint32_t>(buffer, numberOfComponents, byteOrder);
+      break;
+    case 8:
+      SwapRange<uint64_t>(buffer, numberOfComponents, byteOrder);
+      break;
+    default:
+      break;
+  }
+}
+
+bool
+IsSystemByteOrder(IOByteOrderEnum byteOrder)
+{
+  return byteOrder == (ByteSwapper<uint16_t>::SystemIsBigEndian() ? IOByteOrderEnum::BigEndian
+                                                                   : IOByteOrderEnum::LittleEndian);
+}
+
+// Decompresses sequentially the gzip members, or zlib stream, read from a
+// file, so that the data can be read in increasing order of position.
+class GzipDataReader
+{
+public:
+  explicit GzipDataReader(std::istream & file)
+    : m_File(file)
+  {
+    m_ZStream.zalloc = Z_NULL;
+    m_ZStream.zfree = Z_NULL;
+    m_ZStream.opaque = Z_NULL;
+    m_ZStream.next_in = Z_NULL;
+    m_ZStream.avail_in = 0;
+    // Detect the gzip or zlib header.
+    m_Initialized = inflateInit2(&m_ZStream, 15 + 32) == Z_OK;
+  }
+
+  ~GzipDataReader()
+  {
+    if (m_Initialized)
+    {
+      inflateEnd(&m_ZStream);
+    }
+  }
+
+  ITK_DISALLOW_COPY_AND_MOVE(GzipDataReader);
+
+  // Reads size bytes of the decompressed data, at a position that does not
+  // precede the end of the previous ones read, skipping those in between.
+  bool
+  Read(SizeValueType position, char * buffer, SizeValueType size)
+  {
+    if (!m_Initialized || position < m_Position)
+    {
+      return false;
+    }
+    while (m_Position < position)
+    {
+      const SizeValueType skipped = std::min<SizeValueType>(position - m_Position, BlockSize);
+      if (!this->Inflate(m_SkippedData.get(), skipped))
+      {
+        return false;
+      }
+    }
+    return this->Inflate(buffer, size);
+  }
+
+private:
+  static constexpr SizeValueType BlockSize = 256 * 1024;
+
+  bool
+  Inflate(char * output, SizeValueType size)
+  {
+    while (size > 0)
+    {
+      if (m_ZStream.avail_in == 0)
+      {
+        m_File.read(m_CompressedData.get(), BlockSize);
+        if (m_File.gcount() <= 0)
+        {
+          return false;
+        }
+        m_ZStream.next_in = reinterpret_cast<Bytef *>(m_CompressedData.get());
+        m_ZStream.avail_in = static_cast<uInt>(m_File.gcount());
+      }
+      const auto outputSize = static_cast<uInt>(std::min<SizeValueType>(size, 1024 * 1024 * 1024));
+      m_ZStream.next_out = reinterpret_cast<Bytef *>(output);
+      m_ZStream.avail_out = outputSize;
+      const int status = inflate(&m_ZStream, Z_NO_FLUSH);
+      if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+      {
+        return false;
+      }
+      const SizeValueType decompressedSize = outputSize - m_ZStream.avail_out;
+      output += decompressedSize;
+      size -= decompressedSize;
+      m_Position += decompressedSize;
+      // Continue with the next gzip member, if any.
+      if (status == Z_STREAM_END && inflateReset(&m_ZStream) != Z_OK)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::istream &                m_File;
+  z_stream                      m_ZStream{};
+  bool                          m_Initialized{ false };
+  SizeValueType                 m_Position{ 0 };
+  const std::unique_ptr<char[]> m_CompressedData{ make_unique_for_overwrite<char[]>(BlockSize) };
+  const std::unique_ptr<char[]> m_SkippedData{ make_unique_for_overwrite<char[]>(BlockSize) };
+};
+
+// Appends the data compressed as a gzip member to a file.
+bool
+AppendGzipMember(std::ostream & file, const char * data, SizeValueType size, int compressionLevel)
+{
+  z_stream zStream{};
+  zStream.zalloc = Z_NULL;
+  zStream.zfree = Z_NULL;
+  zStream.opaque = Z_NULL;
+  // Write a gzip header and trailer.
+  if (deflateInit2(&zStream, compressionLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+
+  constexpr SizeValueType       blockSize = 256 * 1024;
+  const std::unique_ptr<char[]> compressedData = make_unique_for_overwrite<char[]>(blockSize);
+  int                           status = Z_OK;
+  while (status != Z_STREAM_END)
+  {
+    if (zStream.avail_in == 0 && size > 0)
+    {
+      zStream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+      zStream.avail_in = static_cast<uInt>(std::min<SizeValueType>(size, 1024 * 1024 * 1024));
+      data += zStream.avail_in;
+      size -= zStream.avail_in;
+    }
+    zStream.next_out = reinterpret_cast<Bytef *>(compressedData.get());
+    zStream.avail_out = static_cast<uInt>(blockSize);
+    status = deflate(&zStream, (size == 0) ? Z_FINISH : Z_NO_FLUSH);
+    if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+    {
+      break;
+    }
+    file.write(compressedData.get(), static_cast<std::streamsize>(blockSize - zStream.avail_out));
+  }
+  deflateEnd(&zStream);
+  return status == Z_STREAM_END && !file.fail();
+}
+} // namespace
+
 NrrdImageIO::NrrdImageIO()
 {
   this->SetNumberOfDimensions(3);
@@ -67,6 +272,11 @@ NrrdImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
 
   os << indent << "NrrdCompressionEncoding: " << m_NrrdCompressionEncoding << std::endl;
+  os << indent << "DataFileName: " << m_DataFileName << std::endl;
+  os << indent << "DataOffset: " << m_DataOffset << std::endl;
+  os << indent << "DataIsCompressed: " << (m_DataIsCompressed ? "On" : "Off") << std::endl;
+  os << indent << "NumberOfCompressedBytesWritten: " << m_NumberOfCompressedBytesWritten << std::endl;
+  os << indent << "MaskedSymmetricMatrix: " << (m_MaskedSymmetricMatrix ? "On" : "Off") << std::endl;
 }
 
 void
@@ -415,9 +625,11 @@ NrrdImageIO::ReadImageInformation()
           // IOPixelEnum::DIFFFUSIONTENSOR3D is a subclass
           this->SetPixelType(IOPixelEnum::SYMMETRICSECONDRANKTENSOR);
           this->SetNumberOfComponents(size);
+          m_MaskedSymmetricMatrix = false;
           break;
         case nrrdKind3DMaskedSymMatrix:
           this->SetPixelType(IOPixelEnum::SYMMETRICSECONDRANKTENSOR);
+          m_MaskedSymmetricMatrix = true;
           // NOTE: we will crop out the mask in Read() below; this is the
           // one case where NumberOfComponents != size
           this->SetNumberOfComponents(size - 1);
@@ -699,6 +911,40 @@ NrrdImageIO::ReadImageInformation()
       EncapsulateMetaData<std::vector<std::vector<double>>>(thisDic, std::string(key), msrFrame);
     }
 
+    // Find out where the pixels are, for CanStreamRead() and
+    // CanMemoryMapRead(): in a single file, raw or gzip encoded, with the
+    // components of non-scalar pixels on the fastest axis.
+    m_DataFileName.clear();
+    m_DataOffset = 0;
+    m_DataIsCompressed = false;
+    if (nio->format == nrrdFormatNRRD &&
+        (nio->encoding == nrrdEncodingRaw || (nio->encoding == nrrdEncodingGzip && nio->byteSkip == 0)) &&
+        nio->dataFNFormat == nullptr && nio->dataFNArr->len <= 1 && nio->lineSkip == 0 &&
+        (0 == rangeAxisNum || (0 == rangeAxisIdx[0] && nrrdKind3DMaskedSymMatrix != nrrd->axis[0].kind)))
+    {
+      m_DataIsCompressed = (nio->encoding == nrrdEncodingGzip);
+      if (nio->dataFNArr->len == 0)
+      {
+        // The data are attached to the header.
+        const long int headerSize = NrrdAttachedDataOffset(this->GetFileName());
+        if (headerSize >= 0)
+        {
+          m_DataFileName = this->GetFileName();
+          m_DataOffset = (nio->byteSkip >= 0) ? headerSize + nio->byteSkip : -1;
+        }
+      }
+      else if (strcmp(nio->dataFN[0], "-") != 0)
+      {
+        // Like nrrdIoStateDataFileIterNext: relative to the header.
+        m_DataFileName = nio->dataFN[0];
+        if (!itksys::SystemTools::FileIsFullPath(m_DataFileName) && airStrlen(nio->path))
+        {
+          m_DataFileName = std::string(nio->path) + '/' + m_DataFileName;
+        }
+        m_DataOffset = nio->byteSkip;
+      }
+    }
+
     nrrd = nrrdNix(nrrd);
     nio = nrrdIoStateNix(nio);
   }
@@ -716,17 +962,37 @@ NrrdImageIO::ReadImageInformation()
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (this->RequestedToStream() && this->CanStreamRead())
+  {
+    // Read the pixels of the IORegion only.
+    if (m_DataIsCompressed)
+    {
+      this->ReadCompressedRegion(buffer);
+    }
+    else
+    {
+      std::ifstream file;
+      this->OpenFileForReading(file, m_DataFileName);
+      this->StreamReadBufferAsBinary(file, buffer);
+    }
+    SwapComponentBytes(buffer,
+                       m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents(),
+                       this->GetComponentSize(),
+                       this->GetByteOrder());
+    return;
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
   // NOTE the main reason the logic becomes complicated here is that
   // ITK has to be the one to allocate the data segment ("buffer")
 
-  if (IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType())
+  if (IOPixelEnum::SYMMETRICSECONDRANKTENSOR == this->GetPixelType() && m_MaskedSymmetricMatrix)
   {
-    // It may be that this is coming from a nrrdKind3DMaskedSymMatrix,
-    // in which case ITK's buffer has not been allocated for the
-    // actual size of the data.  The data will be allocated by nrrdLoad.
+    // This is coming from a nrrdKind3DMaskedSymMatrix, in which case
+    // ITK's buffer has not been allocated for the actual size of the
+    // data.  The data will be allocated by nrrdLoad.
     nrrdAllocated = true;
   }
   else
@@ -851,6 +1117,65 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+bool
+NrrdImageIO::CanMemoryMapRead(std::string & dataFileName, SizeValueType & dataOffset)
+{
+  if (m_DataFileName.empty() || m_DataIsCompressed ||
+      (this->GetComponentSize() > 1 && !IsSystemByteOrder(this->GetByteOrder())) ||
+      !itksys::SystemTools::FileExists(m_DataFileName, true))
+  {
+    return false;
+  }
+  const SizeValueType fileSize = itksys::SystemTools::FileLength(m_DataFileName);
+  const SizeValueType dataSize = this->GetImageSizeInBytes();
+  if (fileSize < dataSize)
+  {
+    return false;
+  }
+  dataOffset = this->GetHeaderSize();
+  dataFileName = m_DataFileName;
+  return dataOffset + dataSize <= fileSize;
+}
+
+bool
+NrrdImageIO::CanStreamRead()
+{
+  return !m_DataFileName.empty();
+}
+
+NrrdImageIO::SizeType
+NrrdImageIO::GetHeaderSize() const
+{
+  // A byte skip of -1 means that the data are at the end of the file.
+  if (m_DataOffset < 0)
+  {
+    const auto fileSize = static_cast<SizeType>(itksys::SystemTools::FileLength(m_DataFileName));
+    return std::max<SizeType>(fileSize - static_cast<SizeType>(this->GetImageSizeInBytes()), 0);
+  }
+  return m_DataOffset;
+}
+
+void
+NrrdImageIO::ReadCompressedRegion(void * buffer)
+{
+  std::ifstream file;
+  this->OpenFileForReading(file, m_DataFileName);
+  file.seekg(static_cast<std::streamoff>(this->GetHeaderSize()), std::ios::beg);
+
+  // The data are decompressed up to the end of the region.
+  GzipDataReader      reader(file);
+  const SizeValueType pixelSize = this->GetPixelSize();
+  auto *              output = static_cast<char *>(buffer);
+  if (!ForEachImageIORegionRun(m_IORegion, m_Dimensions, [&](SizeValueType offset, SizeValueType length) {
+        const bool read = reader.Read(offset * pixelSize, output, length * pixelSize);
+        output += length * pixelSize;
+        return read;
+      }))
+  {
+    itkExceptionMacro("Read: Error decompressing the data of " << this->GetFileName() << " in " << m_DataFileName);
+  }
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -885,8 +1210,156 @@ _dump_metadata_to_stream(MetaDataDictionary & thisDic, const std::string & key,
   return false;
 }
 
+const NrrdEncoding_t *
+NrrdImageIO::GetWriteEncoding() const
+{
+  // compressed (raw), (uncompressed) raw, or ascii
+  if (this->GetUseCompression() == true && this->m_NrrdCompressionEncoding != nullptr &&
+      this->m_NrrdCompressionEncoding->available())
+  {
+    return this->m_NrrdCompressionEncoding;
+  }
+  switch (this->GetFileType())
+  {
+    default:
+    case IOFileEnum::TypeNotApplicable:
+    case IOFileEnum::Binary:
+      return nrrdEncodingRaw;
+    case IOFileEnum::ASCII:
+      return nrrdEncodingAscii;
+  }
+}
+
+bool
+NrrdImageIO::CanStreamWrite()
+{
+  const NrrdEncoding * encoding = this->GetWriteEncoding();
+  return encoding == nrrdEncodingRaw || encoding == nrrdEncodingGzip;
+}
+
+unsigned int
+NrrdImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  if (pasteRegion != largestPossibleRegion && this->GetWriteEncoding() == nrrdEncodingGzip)
+  {
+    itkExceptionMacro("Pasting is not supported with compression! Can't write: " << this->GetFileName());
+  }
+  return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+}
+
 void
 NrrdImageIO::Write(const void * buffer)
+{
+  if (!this->RequestedToStream())
+  {
+    this->SaveNrrd(buffer, false);
+    return;
+  }
+
+  // Write the pixels of the IORegion only, after the header unless it has
+  // been written with a previous region, or the region is pasted into an
+  // existing file. GetActualNumberOfSplitsForWriting() removes the file when
+  // a new header needs to be written.
+  IOByteOrderEnum byteOrder = this->GetByteOrder();
+  if (!itksys::SystemTools::FileExists(m_FileName.c_str()))
+  {
+    this->SaveNrrd(buffer, true);
+    m_NumberOfCompressedBytesWritten = 0;
+
+    std::ofstream file;
+    if (m_DataFileName != m_FileName)
+    {
+      this->OpenFileForWriting(file, m_DataFileName, true);
+    }
+    if (!m_DataIsCompressed)
+    {
+      // Allocate the raw data, by writing their last byte, without writing
+      // them all when sparse files are supported.
+      if (!file.is_open())
+      {
+        this->OpenFileForWriting(file, m_DataFileName, false);
+      }
+      file.seekp(static_cast<std::streamoff>(this->GetHeaderSize() + this->GetImageSizeInBytes() - 1), std::ios::beg);
+      file.write("\0", 1);
+    }
+  }
+  else
+  {
+    const auto existingImageIO = Self::New();
+    existingImageIO->SetFileName(m_FileName);
+    existingImageIO->ReadImageInformation();
+    if (existingImageIO->m_DataFileName.empty() ||
+        (existingImageIO->m_DataIsCompressed && this->GetWriteEncoding() != nrrdEncodingGzip))
+    {
+      itkExceptionMacro("Write: Cannot write a region of " << m_FileName
+                                                           << ", whose pixels are not raw or gzip encoded in one file");
+    }
+    m_DataFileName = existingImageIO->m_DataFileName;
+    m_DataOffset = existingImageIO->m_DataOffset;
+    m_DataIsCompressed = existingImageIO->m_DataIsCompressed;
+    byteOrder = existingImageIO->GetByteOrder();
+  }
+
+  // The data are written in the byte order of the file.
+  const void *            data = buffer;
+  std::unique_ptr<char[]> swappedData;
+  if (this->GetComponentSize() > 1 && byteOrder != IOByteOrderEnum::OrderNotApplicable &&
+      !IsSystemByteOrder(byteOrder))
+  {
+    const SizeValueType numberOfComponents = m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+    swappedData = make_unique_for_overwrite<char[]>(numberOfComponents * this->GetComponentSize());
+    std::copy_n(static_cast<const char *>(buffer), numberOfComponents * this->GetComponentSize(), swappedData.get());
+    SwapComponentBytes(swappedData.get(), numberOfComponents, this->GetComponentSize(), byteOrder);
+    data = swappedData.get();
+  }
+
+  if (m_DataIsCompressed)
+  {
+    this->WriteCompressedRegion(data);
+  }
+  else
+  {
+    std::ofstream file;
+    this->OpenFileForWriting(file, m_DataFileName, false);
+    this->StreamWriteBufferAsBinary(file, data);
+  }
+}
+
+void
+NrrdImageIO::WriteCompressedRegion(const void * buffer)
+{
+  // Each region is compressed as a gzip member, appended to the previous
+  // ones: the region must be contiguous, and follow them.
+  const SizeValueType pixelSize = this->GetPixelSize();
+  SizeValueType       regionOffset = 0;
+  unsigned int        numberOfRuns = 0;
+  ForEachImageIORegionRun(m_IORegion, m_Dimensions, [&](SizeValueType offset, SizeValueType) {
+    regionOffset = offset * pixelSize;
+    return ++numberOfRuns == 1;
+  });
+  if (numberOfRuns != 1 || regionOffset != static_cast<SizeValueType>(m_NumberOfCompressedBytesWritten))
+  {
+    itkExceptionMacro("Write: The regions of the compressed file " << m_FileName
+                                                                   << " must be contiguous, and written in order");
+  }
+
+  std::ofstream file(m_DataFileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+  if (!file.is_open())
+  {
+    itkExceptionMacro("Write: Cannot open " << m_DataFileName);
+  }
+  const SizeValueType regionSize = m_IORegion.GetNumberOfPixels() * pixelSize;
+  if (!AppendGzipMember(file, static_cast<const char *>(buffer), regionSize, this->GetCompressionLevel()))
+  {
+    itkExceptionMacro("Write: Error compressing the data of " << m_FileName << " in " << m_DataFileName);
+  }
+  m_NumberOfCompressedBytesWritten += static_cast<SizeType>(regionSize);
+}
+
+void
+NrrdImageIO::SaveNrrd(const void * buffer, bool headerOnly)
 {
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
@@ -1099,28 +1572,12 @@ NrrdImageIO::Write(const void * buffer)
   }
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
-  if (this->GetUseCompression() == true && this->m_NrrdCompressionEncoding != nullptr &&
-      this->m_NrrdCompressionEncoding->available())
+  nio->encoding = this->GetWriteEncoding();
+  if (nio->encoding->isCompression)
   {
-    nio->encoding = this->m_NrrdCompressionEncoding;
     nio->zlibLevel = this->GetCompressionLevel();
     // nio->zlibStrategy = default
   }
-  else
-  {
-    Superclass::IOFileEnum fileType = this->GetFileType();
-    switch (fileType)
-    {
-      default:
-      case IOFileEnum::TypeNotApplicable:
-      case IOFileEnum::Binary:
-        nio->encoding = nrrdEncodingRaw;
-        break;
-      case IOFileEnum::ASCII:
-        nio->encoding = nrrdEncodingAscii;
-        break;
-    }
-  }
 
   // set desired endianness of output
   Superclass::IOByteOrderEnum byteOrder = this->GetByteOrder();
@@ -1139,12 +1596,33 @@ NrrdImageIO::Write(const void * buffer)
   }
 
   // Write the nrrd to file.
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, headerOnly);
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
     char * err = biffGetDone(NRRD); // would be nice to free(err)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (headerOnly)
+  {
+    // Record where the data are to be written, as ReadImageInformation().
+    m_DataIsCompressed = (nio->encoding == nrrdEncodingGzip);
+    if (nio->dataFNArr->len == 0)
+    {
+      m_DataFileName = this->GetFileName();
+      m_DataOffset = NrrdAttachedDataOffset(m_DataFileName);
+    }
+    else
+    {
+      m_DataFileName = nio->dataFN[0];
+      if (!itksys::SystemTools::FileIsFullPath(m_DataFileName) && airStrlen(nio->path))
+      {
+        m_DataFileName = std::string(nio->path) + '/' + m_DataFileName;
+      }
+      m_DataOffset = 0;
+    }
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
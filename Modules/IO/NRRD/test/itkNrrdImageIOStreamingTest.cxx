@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkNrrdImageIO.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+
+
+namespace
+{
+using PixelType = itk::Vector<short, 2>;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Streams the image from inputFileName to fileName, in pieces, then reads
+// regions of fileName.
+int
+TestStreaming(const ImageType * image,
+              const std::string & inputFileName,
+              const std::string & fileName,
+              bool                useCompression,
+              bool                bigEndian)
+{
+  std::cout << "Streaming " << fileName << (useCompression ? ", compressed" : "")
+            << (bigEndian ? ", big endian" : "") << std::endl;
+
+  constexpr unsigned int numberOfStreamDivisions = 5;
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto imageIO = itk::NrrdImageIO::New();
+  if (bigEndian)
+  {
+    imageIO->SetByteOrderToBigEndian();
+  }
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->SetUseCompression(useCompression);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Both the reader and the writer stream.
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+
+  const ImageType::Pointer writtenImage = itk::ReadImage<ImageType>(fileName);
+  if (!itk::Testing::EqualInRegion<ImageType>(image, writtenImage, image->GetLargestPossibleRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  for (const ImageType::RegionType & region : { ImageType::RegionType{ { { 0, 0, 6 } }, { { 21, 12, 2 } } },
+                                                ImageType::RegionType{ { { 4, 3, 1 } }, { { 9, 1, 7 } } },
+                                                ImageType::RegionType{ { { 20, 11, 8 } }, { { 1, 1, 1 } } } })
+  {
+    auto regionReader = itk::ImageFileReader<ImageType>::New();
+    regionReader->SetFileName(fileName);
+    regionReader->UseStreamingOn();
+    regionReader->UpdateOutputInformation();
+    regionReader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->Update());
+
+    ITK_TEST_EXPECT_TRUE(regionReader->GetImageIO()->CanStreamRead());
+    ITK_TEST_EXPECT_EQUAL(regionReader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<ImageType>(image, regionReader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkNrrdImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkNrrdImageIOStreamingTest";
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 21, 12, 9 } });
+  image->Allocate();
+  short value = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Value()[0] = value++;
+    it.Value()[1] = static_cast<short>(-value);
+  }
+  const std::string inputFileName = prefix + "Input.nrrd";
+  itk::WriteImage(image, inputFileName);
+
+  int testStatus = EXIT_SUCCESS;
+  for (const char * extension : { ".nrrd", ".nhdr" })
+  {
+    for (const bool useCompression : { false, true })
+    {
+      for (const bool bigEndian : { false, true })
+      {
+        const std::string fileName = prefix + (useCompression ? "Compressed" : "") + (bigEndian ? "BigEndian" : "") +
+                                     extension;
+        testStatus |= TestStreaming(image, inputFileName, fileName, useCompression, bigEndian);
+      }
+    }
+  }
+
+  // A region can be pasted into a raw file, but not into a compressed one.
+  const ImageType::RegionType pasteRegion{ { { 2, 3, 4 } }, { { 5, 6, 2 } } };
+  auto                        zeroImage = ImageType::New();
+  zeroImage->SetRegions(image->GetLargestPossibleRegion());
+  zeroImage->Allocate(true);
+  itk::WriteImage(zeroImage, prefix + "Zero.nrrd");
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(prefix + "Zero.nrrd");
+  reader->UseStreamingOn();
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(prefix + ".nhdr");
+  writer->SetImageIO(itk::NrrdImageIO::New());
+  itk::ImageIORegion pasteIORegion(3);
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    pasteIORegion.SetIndex(d, pasteRegion.GetIndex(d));
+    pasteIORegion.SetSize(d, pasteRegion.GetSize(d));
+  }
+  writer->SetIORegion(pasteIORegion);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const ImageType::Pointer pastedImage = itk::ReadImage<ImageType>(prefix + ".nhdr");
+  ITK_TEST_EXPECT_TRUE(itk::Testing::EqualInRegion<ImageType>(zeroImage, pastedImage, pasteRegion));
+  ITK_TEST_EXPECT_EQUAL(pastedImage->GetPixel({ { 1, 3, 4 } }), image->GetPixel({ { 1, 3, 4 } }));
+  ITK_TEST_EXPECT_EQUAL(pastedImage->GetPixel({ { 2, 3, 6 } }), image->GetPixel({ { 2, 3, 6 } }));
+
+  writer->SetFileName(prefix + "Compressed.nhdr");
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
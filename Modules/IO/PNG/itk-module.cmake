@@ -7,6 +7,7 @@ itk_module(ITKIOPNG
     ITKIOImageBase
   PRIVATE_DEPENDS
     ITKPNG
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
   FACTORY_NAMES
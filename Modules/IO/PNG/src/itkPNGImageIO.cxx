@@ -17,8 +17,11 @@
  *=========================================================================*/
 #include "itkPNGImageIO.h"
 #include "itk_png.h"
+#include "itk_zlib.h"
 #include "itksys/SystemTools.hxx"
+#include "itkByteSwapper.h"
 #include "itkMakeUniqueForOverwrite.h"
+#include <algorithm>
 #include <string>
 #include <csetjmp>
 
@@ -209,13 +212,6 @@ PNGImageIO::Read(void * buffer)
     png_set_tRNS_to_alpha(png_ptr);
   }
 
-  if (bitDepth > 8)
-  {
-#ifndef ITK_WORDS_BIGENDIAN
-    png_set_swap(png_ptr);
-#endif
-  }
-
 #if (PNG_LIBPNG_VER_MAJOR < 2 && PNG_LIBPNG_VER_MINOR < 5)
   if (info_ptr->valid & PNG_INFO_sBIT)
   {
@@ -252,6 +248,14 @@ PNGImageIO::Read(void * buffer)
   // close the file
   png_read_end(png_ptr, nullptr);
   png_destroy_read_struct(&png_ptr, &info_ptr, &end_info);
+
+  // The samples of more than 8 bits, big endian in the file, are swapped
+  // here, over the whole image, rather than row by row by libpng.
+  if (bitDepth > 8)
+  {
+    ByteSwapper<unsigned short>::SwapRangeFromSystemToBigEndian(static_cast<unsigned short *>(buffer),
+                                                                rowbytes * height / 2);
+  }
 }
 
 PNGImageIO::PNGImageIO()
@@ -287,12 +291,30 @@ PNGImageIO::PNGImageIO()
 
 PNGImageIO::~PNGImageIO() = default;
 
+LightObject::Pointer
+PNGImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ColorPalette = m_ColorPalette;
+  rval->m_RowFilter = m_RowFilter;
+  rval->m_CompressionStrategy = m_CompressionStrategy;
+  return loPtr;
+}
+
 void
 PNGImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 
   os << indent << "CompressionLevel: " << this->GetCompressionLevel() << std::endl;
+  os << indent << "RowFilter: " << m_RowFilter << std::endl;
+  os << indent << "CompressionStrategy: " << m_CompressionStrategy << std::endl;
   if (!m_ColorPalette.empty())
   {
     os << indent << "ColorPalette:" << std::endl;
@@ -666,6 +688,45 @@ PNGImageIO::WriteSlice(const std::string & fileName, const void * const buffer)
   {
     // Set the image compression level.
     png_set_compression_level(png_ptr, this->GetCompressionLevel());
+
+    switch (m_CompressionStrategy)
+    {
+      case PNGImageIOEnums::CompressionStrategy::Default:
+        break;
+      case PNGImageIOEnums::CompressionStrategy::Filtered:
+        png_set_compression_strategy(png_ptr, Z_FILTERED);
+        break;
+      case PNGImageIOEnums::CompressionStrategy::HuffmanOnly:
+        png_set_compression_strategy(png_ptr, Z_HUFFMAN_ONLY);
+        break;
+      case PNGImageIOEnums::CompressionStrategy::RLE:
+        png_set_compression_strategy(png_ptr, Z_RLE);
+        break;
+      case PNGImageIOEnums::CompressionStrategy::Fixed:
+        png_set_compression_strategy(png_ptr, Z_FIXED);
+        break;
+    }
+  }
+
+  switch (m_RowFilter)
+  {
+    case PNGImageIOEnums::RowFilter::Default:
+      break;
+    case PNGImageIOEnums::RowFilter::None:
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+      break;
+    case PNGImageIOEnums::RowFilter::Sub:
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+      break;
+    case PNGImageIOEnums::RowFilter::Up:
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_UP);
+      break;
+    case PNGImageIOEnums::RowFilter::Average:
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_AVG);
+      break;
+    case PNGImageIOEnums::RowFilter::Paeth:
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_PAETH);
+      break;
   }
 
   // write out the spacing information:
@@ -677,25 +738,31 @@ PNGImageIO::WriteSlice(const std::string & fileName, const void * const buffer)
 #endif
 
   png_write_info(png_ptr, info_ptr);
-  // default is big endian
-  if (bitDepth > 8)
+
+  const int rowInc = width * numComp * bitDepth / 8;
+  if (bitDepth > 8 && ByteSwapper<unsigned short>::SystemIsLittleEndian())
   {
-#ifndef ITK_WORDS_BIGENDIAN
-    png_set_swap(png_ptr);
-#endif
+    // The samples are written big endian: each row is swapped in a copy.
+    const auto         row = make_unique_for_overwrite<unsigned short[]>(width * numComp);
+    const auto * const input = static_cast<const unsigned short *>(buffer);
+    for (unsigned int ui = 0; ui < height; ++ui)
+    {
+      std::copy_n(input + static_cast<size_t>(ui) * width * numComp, width * numComp, row.get());
+      ByteSwapper<unsigned short>::SwapRangeFromSystemToBigEndian(row.get(), width * numComp);
+      png_write_row(png_ptr, reinterpret_cast<png_const_bytep>(row.get()));
+    }
   }
-  const auto row_pointers = make_unique_for_overwrite<png_bytep[]>(height);
-
+  else
   {
-    const int                      rowInc = width * numComp * bitDepth / 8;
+    const auto                     row_pointers = make_unique_for_overwrite<png_bytep[]>(height);
     volatile const unsigned char * outPtr = ((const unsigned char *)buffer);
     for (unsigned int ui = 0; ui < height; ++ui)
     {
       row_pointers[ui] = const_cast<png_byte *>(outPtr);
       outPtr = const_cast<unsigned char *>(outPtr) + rowInc;
     }
+    png_write_image(png_ptr, row_pointers.get());
   }
-  png_write_image(png_ptr, row_pointers.get());
   png_write_end(png_ptr, info_ptr);
 
   if (paletteAllocated)
@@ -707,4 +774,50 @@ PNGImageIO::WriteSlice(const std::string & fileName, const void * const buffer)
 
   png_destroy_write_struct(&png_ptr, &info_ptr);
 }
+
+std::ostream &
+operator<<(std::ostream & out, const PNGImageIOEnums::RowFilter value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case PNGImageIOEnums::RowFilter::Default:
+        return "itk::PNGImageIOEnums::RowFilter::Default";
+      case PNGImageIOEnums::RowFilter::None:
+        return "itk::PNGImageIOEnums::RowFilter::None";
+      case PNGImageIOEnums::RowFilter::Sub:
+        return "itk::PNGImageIOEnums::RowFilter::Sub";
+      case PNGImageIOEnums::RowFilter::Up:
+        return "itk::PNGImageIOEnums::RowFilter::Up";
+      case PNGImageIOEnums::RowFilter::Average:
+        return "itk::PNGImageIOEnums::RowFilter::Average";
+      case PNGImageIOEnums::RowFilter::Paeth:
+        return "itk::PNGImageIOEnums::RowFilter::Paeth";
+      default:
+        return "INVALID VALUE FOR itk::PNGImageIOEnums::RowFilter";
+    }
+  }();
+}
+
+std::ostream &
+operator<<(std::ostream & out, const PNGImageIOEnums::CompressionStrategy value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case PNGImageIOEnums::CompressionStrategy::Default:
+        return "itk::PNGImageIOEnums::CompressionStrategy::Default";
+      case PNGImageIOEnums::CompressionStrategy::Filtered:
+        return "itk::PNGImageIOEnums::CompressionStrategy::Filtered";
+      case PNGImageIOEnums::CompressionStrategy::HuffmanOnly:
+        return "itk::PNGImageIOEnums::CompressionStrategy::HuffmanOnly";
+      case PNGImageIOEnums::CompressionStrategy::RLE:
+        return "itk::PNGImageIOEnums::CompressionStrategy::RLE";
+      case PNGImageIOEnums::CompressionStrategy::Fixed:
+        return "itk::PNGImageIOEnums::CompressionStrategy::Fixed";
+      default:
+        return "INVALID VALUE FOR itk::PNGImageIOEnums::CompressionStrategy";
+    }
+  }();
+}
 } // end namespace itk
@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkPNGImageIO.h"
+#include "itkRGBPixel.h"
+#include "itkTestingMacros.h"
+#include "itkTimeProbe.h"
+#include "itksys/SystemTools.hxx"
+
+
+namespace
+{
+using RowFilter = itk::PNGImageIOEnums::RowFilter;
+using CompressionStrategy = itk::PNGImageIOEnums::CompressionStrategy;
+
+// A slice with smooth variations and noise, as in microscopy images.
+template <typename TImage>
+typename TImage::Pointer
+MakeSlice()
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+  using ComponentType = typename PixelTraits::ComponentType;
+
+  auto image = TImage::New();
+  image->SetRegions(typename TImage::SizeType{ { 512, 384 } });
+  image->Allocate();
+  const double  maximum = itk::NumericTraits<ComponentType>::max();
+  unsigned long noise = 12345;
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto &               index = it.GetIndex();
+    typename TImage::PixelType pixel;
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      noise = (noise * 1103515245 + 12345) % 2147483648;
+      const double value = 0.4 * maximum * (1.0 + std::sin(0.02 * index[0] + 0.5 * c) * std::cos(0.03 * index[1])) +
+                           0.01 * maximum * static_cast<double>(noise % 1000) / 1000.0;
+      PixelTraits::SetNthComponent(static_cast<int>(c), pixel, static_cast<ComponentType>(value));
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+// Writes the slice with each row filter and compression strategy, checking
+// that it is read back unchanged, and reports the size of the files and the
+// time taken to write and read them.
+template <typename TImage>
+int
+TestWriteStrategies(const std::string & prefix)
+{
+  const typename TImage::Pointer image = MakeSlice<TImage>();
+
+  struct Setting
+  {
+    RowFilter           rowFilter;
+    CompressionStrategy compressionStrategy;
+    int                 compressionLevel;
+  };
+  for (const Setting & setting : { Setting{ RowFilter::Default, CompressionStrategy::Default, 4 },
+                                   Setting{ RowFilter::None, CompressionStrategy::Default, 4 },
+                                   Setting{ RowFilter::Sub, CompressionStrategy::Filtered, 4 },
+                                   Setting{ RowFilter::Up, CompressionStrategy::RLE, 1 },
+                                   Setting{ RowFilter::Average, CompressionStrategy::HuffmanOnly, 4 },
+                                   Setting{ RowFilter::Paeth, CompressionStrategy::Fixed, 6 } })
+  {
+    auto imageIO = itk::PNGImageIO::New();
+    imageIO->SetRowFilter(setting.rowFilter);
+    imageIO->SetCompressionStrategy(setting.compressionStrategy);
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetRowFilter(), setting.rowFilter);
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetCompressionStrategy(), setting.compressionStrategy);
+
+    const std::string fileName = prefix + ".png";
+    auto              writer = itk::ImageFileWriter<TImage>::New();
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetImageIO(imageIO);
+    writer->UseCompressionOn();
+    writer->SetCompressionLevel(setting.compressionLevel);
+
+    constexpr unsigned int numberOfRepetitions = 5;
+    itk::TimeProbe         writeProbe;
+    itk::TimeProbe         readProbe;
+    for (unsigned int i = 0; i < numberOfRepetitions; ++i)
+    {
+      writeProbe.Start();
+      ITK_TRY_EXPECT_NO_EXCEPTION(writer->Write());
+      writeProbe.Stop();
+
+      readProbe.Start();
+      const typename TImage::Pointer readImage = itk::ReadImage<TImage>(fileName);
+      readProbe.Stop();
+      if (!(*readImage == *image))
+      {
+        std::cerr << "The image read from " << fileName << " differs from the one written with " << setting.rowFilter
+                  << " and " << setting.compressionStrategy << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << setting.rowFilter << ", " << setting.compressionStrategy << ", level " << setting.compressionLevel
+              << ": " << itksys::SystemTools::FileLength(fileName) << " bytes, written in "
+              << writeProbe.GetMean() * 1000 << " ms, read in " << readProbe.GetMean() * 1000 << " ms" << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkPNGImageIOWriteStrategyTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkPNGImageIOWriteStrategyTest";
+
+  auto imageIO = itk::PNGImageIO::New();
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetRowFilter(), RowFilter::Default);
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetCompressionStrategy(), CompressionStrategy::Default);
+
+  int testStatus = EXIT_SUCCESS;
+  std::cout << "8 bit slices" << std::endl;
+  testStatus |= TestWriteStrategies<itk::Image<unsigned char, 2>>(prefix + "UChar");
+  std::cout << "16 bit slices" << std::endl;
+  testStatus |= TestWriteStrategies<itk::Image<unsigned short, 2>>(prefix + "UShort");
+  std::cout << "16 bit RGB slices" << std::endl;
+  testStatus |= TestWriteStrategies<itk::Image<itk::RGBPixel<unsigned short>, 2>>(prefix + "RGB");
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
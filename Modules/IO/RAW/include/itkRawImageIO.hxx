@@ -65,6 +65,36 @@ RawImageIO<TPixel, VImageDimension>::RawImageIO()
   m_FileType = IOFileEnum::Binary;
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+LightObject::Pointer
+RawImageIO<TPixel, VImageDimension>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_FileDimensionality = m_FileDimensionality;
+  rval->m_ManualHeaderSize = m_ManualHeaderSize;
+  rval->m_HeaderSize = m_HeaderSize;
+  rval->m_ImageMask = m_ImageMask;
+
+  // A raw file has no header: the description of its pixels is part of the
+  // reading options.
+  rval->m_PixelType = this->m_PixelType;
+  rval->m_ComponentType = this->m_ComponentType;
+  rval->m_NumberOfComponents = this->m_NumberOfComponents;
+  rval->SetNumberOfDimensions(this->m_NumberOfDimensions);
+  rval->m_Dimensions = this->m_Dimensions;
+  rval->m_Spacing = this->m_Spacing;
+  rval->m_Origin = this->m_Origin;
+  rval->m_Direction = this->m_Direction;
+  rval->ComputeStrides();
+  return loPtr;
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void
 RawImageIO<TPixel, VImageDimension>::PrintSelf(std::ostream & os, Indent indent) const
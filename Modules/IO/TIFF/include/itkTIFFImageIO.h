@@ -38,6 +38,14 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Striped and tiled images whose pixels are decoded by this class, rather
+ * than through the RGBA interface of libtiff, can be streamed: only the
+ * strips or tiles intersecting the requested region are decoded. The
+ * reduced-resolution subfiles of the first image (the levels of a pyramid,
+ * stored either as SubIFDs or as the directories following it) can be read
+ * as separate images by selecting their level. Images are written in strips,
+ * unless a tile size is set.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -83,6 +91,27 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Returns true when the pixels of the selected level are decoded by this
+   * class, in which case only the strips or tiles intersecting the requested
+   * region are read. */
+  bool
+  CanStreamRead() override;
+
+  /** Returns the requested region when streaming is enabled and possible, and
+   * the largest possible region otherwise. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
+
+  /** Set/Get the resolution level read. Level 0, the default, is the full
+   * resolution image, and the following levels are its reduced-resolution
+   * subfiles, each read as a 2D image. */
+  itkSetMacro(Level, unsigned int);
+  itkGetConstMacro(Level, unsigned int);
+
+  /** Get the number of resolution levels of the file, including the full
+   * resolution image. Valid after ReadImageInformation() has been called. */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -172,6 +201,14 @@ public:
   }
 
 
+  /** Set/Get the width and the height of the tiles written, in pixels. Both
+   * must be multiples of 16. When they are 0, the default, the image is
+   * written in strips. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
   /** Get a const ref to the palette of the image. In the case of non palette
    * image or ExpandRGBPalette set to true, a vector of size
    * 0 is returned.
@@ -196,6 +233,10 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Also copies the level read, and the compression, palette and tile size written. */
+  LightObject::Pointer
+  InternalClone() const override;
+
   void
   InternalSetCompressor(const std::string & _compressor) override;
 
@@ -252,12 +293,19 @@ private:
   void
   AllocateTiffPalette(uint16_t bps);
 
+  void
+  SelectLevel();
+
   void
   ReadCurrentPage(void * buffer, size_t pixelOffset);
 
+  // Reads the pixels of the current page within the given rectangle.
+  void
+  ReadGenericImage(void * out, uint32_t xStart, uint32_t yStart, uint32_t width, uint32_t height);
+
   template <typename TComponent>
   void
-  ReadGenericImage(void * _out, unsigned int width, unsigned int height);
+  ReadGenericImage(void * _out, uint32_t xStart, uint32_t yStart, uint32_t width, uint32_t height);
 
   template <typename TComponent>
   void
@@ -309,6 +357,11 @@ private:
   uint16_t *   m_ColorBlue{};
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+  bool         m_CanStreamRead{ false };
+  unsigned int m_Level{ 0 };
+  unsigned int m_NumberOfLevels{ 0 };
+  unsigned int m_TileWidth{ 0 };
+  unsigned int m_TileHeight{ 0 };
 };
 } // end namespace itk
 
@@ -9,6 +9,7 @@ itk_module(ITKIOTIFF
     ITKTIFF
   TEST_DEPENDS
     ITKTestKernel
+    ITKTIFF
   FACTORY_NAMES
     ImageIO::TIFF
   DESCRIPTION
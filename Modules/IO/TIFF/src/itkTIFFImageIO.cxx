@@ -24,6 +24,8 @@
 
 #include "itk_tiff.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -54,27 +56,33 @@ TIFFImageIO::CanReadFile(const char * file)
 
 void
 TIFFImageIO::ReadGenericImage(void * out, unsigned int width, unsigned int height)
+{
+  this->ReadGenericImage(out, 0, 0, width, height);
+}
+
+void
+TIFFImageIO::ReadGenericImage(void * out, uint32_t xStart, uint32_t yStart, uint32_t width, uint32_t height)
 {
 
   if (m_ComponentType == IOComponentEnum::UCHAR)
   {
-    this->ReadGenericImage<unsigned char>(out, width, height);
+    this->ReadGenericImage<unsigned char>(out, xStart, yStart, width, height);
   }
   else if (m_ComponentType == IOComponentEnum::CHAR)
   {
-    this->ReadGenericImage<char>(out, width, height);
+    this->ReadGenericImage<char>(out, xStart, yStart, width, height);
   }
   else if (m_ComponentType == IOComponentEnum::USHORT)
   {
-    this->ReadGenericImage<unsigned short>(out, width, height);
+    this->ReadGenericImage<unsigned short>(out, xStart, yStart, width, height);
   }
   else if (m_ComponentType == IOComponentEnum::SHORT)
   {
-    this->ReadGenericImage<short>(out, width, height);
+    this->ReadGenericImage<short>(out, xStart, yStart, width, height);
   }
   else if (m_ComponentType == IOComponentEnum::FLOAT)
   {
-    this->ReadGenericImage<float>(out, width, height);
+    this->ReadGenericImage<float>(out, xStart, yStart, width, height);
   }
 }
 
@@ -149,10 +157,13 @@ TIFFImageIO::GetFormat()
 void
 TIFFImageIO::ReadVolume(void * buffer)
 {
-  const size_t width{ m_InternalImage->m_Width };
-  const size_t height{ m_InternalImage->m_Height };
+  const ImageIORegion & region = this->GetIORegion();
+  const size_t          pageSize = region.GetSize(0) * region.GetSize(1) * this->GetNumberOfComponents();
+  const size_t          firstSlice = region.GetIndex(2);
+  const size_t          endSlice = firstSlice + region.GetSize(2);
 
-  for (uint16_t page = 0; page < m_InternalImage->m_NumberOfPages; ++page)
+  size_t slice = 0;
+  for (uint16_t page = 0; page < m_InternalImage->m_NumberOfPages && slice < endSlice; ++page)
   {
     if (m_InternalImage->m_IgnoredSubFiles > 0)
     {
@@ -168,10 +179,12 @@ TIFFImageIO::ReadVolume(void * buffer)
       }
     }
 
-
-    const size_t pixelOffset = width * height * this->GetNumberOfComponents() * page;
-
-    ReadCurrentPage(buffer, pixelOffset);
+    // Only the pages of the requested region are decoded
+    if (slice >= firstSlice)
+    {
+      ReadCurrentPage(buffer, pageSize * (slice - firstSlice));
+    }
+    ++slice;
 
     TIFFReadDirectory(m_InternalImage->m_Image);
   }
@@ -189,6 +202,7 @@ TIFFImageIO::Read(void * buffer)
       itkExceptionMacro(<< "Cannot open file " << this->m_FileName << '!');
     }
   }
+  this->SelectLevel();
 
   // The IO region should be of dimensions 3 otherwise we read only the first
   // page
@@ -204,6 +218,36 @@ TIFFImageIO::Read(void * buffer)
   m_InternalImage->Clean();
 }
 
+bool
+TIFFImageIO::CanStreamRead()
+{
+  return m_CanStreamRead;
+}
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if (!m_UseStreamedReading || !m_CanStreamRead)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  }
+  return requestedRegion;
+}
+
+void
+TIFFImageIO::SelectLevel()
+{
+  if (m_Level == 0)
+  {
+    return;
+  }
+  if (!m_InternalImage->SetLevel(m_Level))
+  {
+    itkExceptionMacro(<< "Cannot read level " << m_Level << " of file " << this->m_FileName << ", which has "
+                      << m_InternalImage->m_LevelOffsets.size() << " levels");
+  }
+}
+
 TIFFImageIO::TIFFImageIO()
   : m_ColorPalette(0)
 
@@ -242,6 +286,24 @@ TIFFImageIO::~TIFFImageIO()
   delete m_InternalImage;
 }
 
+LightObject::Pointer
+TIFFImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_Compression = m_Compression;
+  rval->m_ColorPalette = m_ColorPalette;
+  rval->m_Level = m_Level;
+  rval->m_TileWidth = m_TileWidth;
+  rval->m_TileHeight = m_TileHeight;
+  return loPtr;
+}
+
 void
 TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
@@ -249,6 +311,10 @@ TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 
   os << indent << "Compression: " << m_Compression << std::endl;
   os << indent << "JPEGQuality: " << this->GetJPEGQuality() << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  os << indent << "TileWidth: " << m_TileWidth << std::endl;
+  os << indent << "TileHeight: " << m_TileHeight << std::endl;
   if (!m_ColorPalette.empty())
   {
     os << indent << "Image RGB palette:" << '\n';
@@ -343,6 +409,9 @@ TIFFImageIO::ReadImageInformation()
     }
   }
 
+  m_NumberOfLevels = static_cast<unsigned int>(m_InternalImage->m_LevelOffsets.size());
+  this->SelectLevel();
+
   ReadTIFFTags();
 
   // if the tiff file is multi-pages
@@ -486,6 +555,7 @@ TIFFImageIO::ReadImageInformation()
   }
 
 
+  m_CanStreamRead = m_InternalImage->CanRead();
   if (!m_InternalImage->CanRead())
   {
     //  exception if compression is not supported
@@ -627,6 +697,13 @@ TIFFImageIO::InternalWrite(const void * buffer)
 #endif
   }
 
+  const bool writeTiles = m_TileWidth > 0 || m_TileHeight > 0;
+  if (writeTiles && (m_TileWidth == 0 || m_TileHeight == 0 || m_TileWidth % 16 != 0 || m_TileHeight % 16 != 0))
+  {
+    itkExceptionMacro(<< "The tile width and height must be non-zero multiples of 16, not " << m_TileWidth << " and "
+                      << m_TileHeight);
+  }
+
   TIFF * tif = TIFFOpen(m_FileName.c_str(), mode);
   if (!tif)
   {
@@ -764,22 +841,30 @@ TIFFImageIO::InternalWrite(const void * buffer)
     // Using 1 MB per strip leads to 256 rows per strip, which takes only 4 seconds to write over sshfs.
     // Rather than change that value in the third party libtiff library, we instead compute the
     // rowsperstrip here to lead to this same value.
-#ifdef TIFF_INT64_T // detect if libtiff4
-    uint64_t scanlinesize = TIFFScanlineSize64(tif);
-#else
-    tsize_t scanlinesize = TIFFScanlineSize(tif);
-#endif
-    if (scanlinesize == 0)
+    if (writeTiles)
     {
-      itkExceptionMacro("TIFFScanlineSize returned 0");
+      TIFFSetField(tif, TIFFTAG_TILEWIDTH, m_TileWidth);
+      TIFFSetField(tif, TIFFTAG_TILELENGTH, m_TileHeight);
     }
-    rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
-    if (rowsperstrip < 1)
+    else
     {
-      rowsperstrip = 1;
-    }
+#ifdef TIFF_INT64_T // detect if libtiff4
+      uint64_t scanlinesize = TIFFScanlineSize64(tif);
+#else
+      tsize_t scanlinesize = TIFFScanlineSize(tif);
+#endif
+      if (scanlinesize == 0)
+      {
+        itkExceptionMacro("TIFFScanlineSize returned 0");
+      }
+      rowsperstrip = static_cast<uint32_t>(1024 * 1024 / scanlinesize);
+      if (rowsperstrip < 1)
+      {
+        rowsperstrip = 1;
+      }
 
-    TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+      TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, rowsperstrip));
+    }
 
     if (resolution_x > 0 && resolution_y > 0)
     {
@@ -819,17 +904,50 @@ TIFFImageIO::InternalWrite(const void * buffer)
     }
 
     rowLength *= this->GetNumberOfComponents();
+    const SizeValueType pixelSize = rowLength;
     rowLength *= width;
 
-    uint32_t row = 0;
-    for (unsigned int idx2 = 0; idx2 < height; ++idx2)
+    if (writeTiles)
+    {
+      // The tiles on the right and bottom edges are padded with zeros
+      const SizeValueType tileRowLength = pixelSize * m_TileWidth;
+      const auto          tile = make_unique_for_overwrite<char[]>(tileRowLength * m_TileHeight);
+      for (uint32_t tileRow = 0; tileRow < h; tileRow += m_TileHeight)
+      {
+        const uint32_t rows = std::min(m_TileHeight, h - tileRow);
+        for (uint32_t tileColumn = 0; tileColumn < w; tileColumn += m_TileWidth)
+        {
+          const SizeValueType columnsLength = pixelSize * std::min(m_TileWidth, w - tileColumn);
+          if (rows < m_TileHeight || columnsLength < tileRowLength)
+          {
+            std::fill_n(tile.get(), tileRowLength * m_TileHeight, char{});
+          }
+          for (uint32_t row = 0; row < rows; ++row)
+          {
+            std::copy_n(outPtr + (tileRow + row) * rowLength + tileColumn * pixelSize,
+                        columnsLength,
+                        tile.get() + row * tileRowLength);
+          }
+          if (TIFFWriteTile(tif, tile.get(), tileColumn, tileRow, 0, 0) < 0)
+          {
+            itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+          }
+        }
+      }
+      outPtr += rowLength * height;
+    }
+    else
     {
-      if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
+      uint32_t row = 0;
+      for (unsigned int idx2 = 0; idx2 < height; ++idx2)
       {
-        itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        if (TIFFWriteScanline(tif, const_cast<char *>(outPtr), row, 0) < 0)
+        {
+          itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        }
+        outPtr += rowLength;
+        ++row;
       }
-      outPtr += rowLength;
-      ++row;
     }
 
     if (m_NumberOfDimensions == 3)
@@ -1314,58 +1432,30 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
 
     this->InitializeColors();
 
+    // Only the rectangle of the IO region is read, the pages have been
+    // selected by the caller.
+    const ImageIORegion & region = this->GetIORegion();
+    const auto            xStart = static_cast<uint32_t>(region.GetIndex(0));
+    const auto            yStart = static_cast<uint32_t>(region.GetIndex(1));
+    const auto            regionWidth = static_cast<uint32_t>(region.GetSize(0));
+    const auto            regionHeight = static_cast<uint32_t>(region.GetSize(1));
 
-    if (m_ComponentType == IOComponentEnum::USHORT)
-    {
-      auto * volume = static_cast<unsigned short *>(buffer);
-      volume += pixelOffset;
-      this->ReadGenericImage(volume, width, height);
-    }
-    else if (m_ComponentType == IOComponentEnum::SHORT)
-    {
-      auto * volume = static_cast<short *>(buffer);
-      volume += pixelOffset;
-      this->ReadGenericImage(volume, width, height);
-    }
-    else if (m_ComponentType == IOComponentEnum::CHAR)
-    {
-      auto * volume = static_cast<char *>(buffer);
-      volume += pixelOffset;
-      this->ReadGenericImage(volume, width, height);
-    }
-    else if (m_ComponentType == IOComponentEnum::FLOAT)
-    {
-      auto * volume = static_cast<float *>(buffer);
-      volume += pixelOffset;
-      this->ReadGenericImage(volume, width, height);
-    }
-    else
-    {
-      auto * volume = static_cast<unsigned char *>(buffer);
-      volume += pixelOffset;
-      this->ReadGenericImage(volume, width, height);
-    }
+    char * const volume = static_cast<char *>(buffer) + pixelOffset * this->GetComponentSize();
+    this->ReadGenericImage(volume, xStart, yStart, regionWidth, regionHeight);
   }
 }
 
 template <typename TComponent>
 void
-TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int height)
+TIFFImageIO::ReadGenericImage(void * _out, uint32_t xStart, uint32_t yStart, uint32_t width, uint32_t height)
 {
   using ComponentType = TComponent;
 
-#ifdef TIFF_INT64_T // detect if libtiff4
-  uint64_t isize = TIFFScanlineSize64(m_InternalImage->m_Image);
-#else
-  tsize_t isize = TIFFScanlineSize(m_InternalImage->m_Image);
-#endif
+  TIFF * const tiff = m_InternalImage->m_Image;
 
-  size_t  inc;
-  tdata_t buf = _TIFFmalloc(static_cast<tmsize_t>(isize));
-  isize /= sizeof(ComponentType);
+  size_t inc;
 
-  auto *          out = static_cast<ComponentType *>(_out);
-  ComponentType * image;
+  auto * out = static_cast<ComponentType *>(_out);
 
   if (m_InternalImage->m_PlanarConfig != PLANARCONFIG_CONTIG && m_InternalImage->m_SamplesPerPixel != 1)
   {
@@ -1404,41 +1494,28 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       break;
   }
 
-  for (uint32_t row = 0; row < height; ++row)
-  {
-    if (TIFFReadScanline(m_InternalImage->m_Image, buf, row, 0) <= 0)
-    {
-      itkExceptionMacro(<< "Problem reading the row: " << row);
-    }
-
-    if (m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT)
-    {
-      image = out + inc * row * width;
-    }
-    else // bottom left
-    {
-      image = out + inc * width * (height - (row + 1));
-    }
-
+  // Converts count pixels of the file, starting at from, to the output
+  const auto putPixels = [this](ComponentType * image, void * from, uint32_t count) {
     switch (this->GetFormat())
     {
       case TIFFImageIO::GRAYSCALE:
         // check inverted
-        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(from), count, 1, 0, 0);
         break;
       case TIFFImageIO::RGB_:
-        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(from), count, 1, 0, 0);
         break;
 
       case TIFFImageIO::PALETTE_GRAYSCALE:
         switch (m_InternalImage->m_BitsPerSample)
         {
           case 8:
-            PutPaletteGrayscale<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+            PutPaletteGrayscale<ComponentType, unsigned char>(
+              image, static_cast<unsigned char *>(from), count, 1, 0, 0);
             break;
           case 16:
             PutPaletteGrayscale<ComponentType, unsigned short>(
-              image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              image, static_cast<unsigned short *>(from), count, 1, 0, 0);
             break;
           default:
             itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1451,10 +1528,10 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(from), count, 1, 0, 0);
               break;
             case 16:
-              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(from), count, 1, 0, 0);
               break;
             default:
               itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1466,11 +1543,11 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(from), count, 1, 0, 0);
               break;
             case 16:
               PutPaletteScalar<ComponentType, unsigned short>(
-                image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+                image, static_cast<unsigned short *>(from), count, 1, 0, 0);
               break;
             default:
               itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1482,9 +1559,92 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       default:
         itkExceptionMacro("Logic Error: Unexpected format!");
     }
+  };
+
+  // The rows of the file are read in increasing order, from firstRow, and
+  // their pixels stored in the output row of the same image row.
+  const uint32_t imageHeight = m_InternalImage->m_Height;
+  const bool     isTopLeft = m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT;
+  const uint32_t firstRow = isTopLeft ? yStart : imageHeight - (yStart + height);
+  const uint32_t endRow = firstRow + height;
+  const auto     outputRow = [=](uint32_t row) -> ComponentType * {
+    const uint32_t y = isTopLeft ? row : imageHeight - (row + 1);
+    return out + inc * width * (y - yStart);
+  };
+
+  // Size of a pixel in the file, the reader requires whole bytes per sample
+  const size_t filePixelSize = size_t{ m_InternalImage->m_SamplesPerPixel } * (m_InternalImage->m_BitsPerSample / 8);
+
+  if (!TIFFIsTiled(tiff))
+  {
+#ifdef TIFF_INT64_T // detect if libtiff4
+    uint64_t isize = TIFFScanlineSize64(tiff);
+#else
+    tsize_t isize = TIFFScanlineSize(tiff);
+#endif
+
+    // When the scanlines are exactly the rows of the output, read them directly
+    // into it, rather than copying them from a scanline buffer.
+    const bool readDirectly =
+      (this->GetFormat() == TIFFImageIO::GRAYSCALE || this->GetFormat() == TIFFImageIO::RGB_) && xStart == 0 &&
+      static_cast<size_t>(isize) == inc * width * sizeof(ComponentType);
+    // Only the strips containing these rows are decoded. As most codecs can
+    // only decode a strip from its start, the rows of the first strip that
+    // precede firstRow are decoded into the scanline buffer, and discarded.
+    uint32_t rowsPerStrip = imageHeight;
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+    const uint32_t stripRow = firstRow - firstRow % std::max(1u, std::min(rowsPerStrip, imageHeight));
+    const auto     buf =
+      make_unique_for_overwrite<char[]>(readDirectly && stripRow == firstRow ? 0 : static_cast<size_t>(isize));
+
+    for (uint32_t row = stripRow; row < endRow; ++row)
+    {
+      const bool            isDiscarded = row < firstRow;
+      ComponentType * const image = isDiscarded ? nullptr : outputRow(row);
+      if (TIFFReadScanline(tiff, readDirectly && !isDiscarded ? static_cast<void *>(image) : buf.get(), row, 0) <= 0)
+      {
+        itkExceptionMacro(<< "Problem reading the row: " << row);
+      }
+      if (!readDirectly && !isDiscarded)
+      {
+        putPixels(image, buf.get() + xStart * filePixelSize, width);
+      }
+    }
   }
+  else
+  {
+    const uint32_t tileWidth = m_InternalImage->m_TileWidth;
+    const uint32_t tileHeight = m_InternalImage->m_TileHeight;
+    const uint32_t xEnd = xStart + width;
+#ifdef TIFF_INT64_T // detect if libtiff4
+    const auto tileBuffer = make_unique_for_overwrite<char[]>(static_cast<size_t>(TIFFTileSize64(tiff)));
+#else
+    const auto tileBuffer = make_unique_for_overwrite<char[]>(static_cast<size_t>(TIFFTileSize(tiff)));
+#endif
+
+    // Only the tiles intersecting the rectangle are decoded
+    for (uint32_t tileRow = firstRow / tileHeight * tileHeight; tileRow < endRow; tileRow += tileHeight)
+    {
+      const uint32_t rowBegin = std::max(firstRow, tileRow);
+      const uint32_t rowEnd = std::min(endRow, tileRow + tileHeight);
+      for (uint32_t tileColumn = xStart / tileWidth * tileWidth; tileColumn < xEnd; tileColumn += tileWidth)
+      {
+        if (TIFFReadTile(tiff, tileBuffer.get(), tileColumn, tileRow, 0, 0) < 0)
+        {
+          itkExceptionMacro(<< "Problem reading the tile at column " << tileColumn << " and row " << tileRow);
+        }
 
-  _TIFFfree(buf);
+        const uint32_t columnBegin = std::max(xStart, tileColumn);
+        const uint32_t columnEnd = std::min(xEnd, tileColumn + tileWidth);
+        for (uint32_t row = rowBegin; row < rowEnd; ++row)
+        {
+          char * const from =
+            tileBuffer.get() + (size_t{ row - tileRow } * tileWidth + (columnBegin - tileColumn)) * filePixelSize;
+          putPixels(outputRow(row) + inc * (columnBegin - xStart), from, columnEnd - columnBegin);
+        }
+      }
+    }
+  }
 }
 
 // iso component scalar
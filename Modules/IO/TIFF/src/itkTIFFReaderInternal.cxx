@@ -88,6 +88,7 @@ TIFFReaderInternal::Clean()
   this->m_IgnoredSubFiles = 0;
   this->m_SampleFormat = 1;
   this->m_ResolutionUnit = 1; // none
+  this->m_LevelOffsets.clear();
   this->m_IsOpen = false;
 }
 
@@ -103,17 +104,6 @@ TIFFReaderInternal::Initialize()
 {
   if (this->m_Image)
   {
-    if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
-        !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
-    {
-      return 0;
-    }
-
-    // Get the resolution in each direction
-    TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
-    TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
-
     // Check the number of pages. First by looking at the number of directories
     this->m_NumberOfPages = TIFFNumberOfDirectories(this->m_Image);
 
@@ -122,20 +112,16 @@ TIFFReaderInternal::Initialize()
       itkGenericExceptionMacro("No directories found in TIFF file.");
     }
 
-    if (TIFFIsTiled(this->m_Image))
-    {
-      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+    // The first level is the full resolution image, followed by its
+    // reduced-resolution subfiles, stored either as SubIFDs or as the
+    // directories following it.
+    this->m_LevelOffsets.assign(1, TIFFCurrentDirOffset(this->m_Image));
 
-      if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
-          !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
-      {
-        itkGenericExceptionMacro(<< "Cannot read tile width and tile length from file");
-      }
-      else
-      {
-        this->m_TileRows = this->m_Height / this->m_TileHeight;
-        this->m_TileColumns = this->m_Width / this->m_TileWidth;
-      }
+    uint16_t numberOfSubIFDs = 0;
+    toff_t * subIFDOffsets = nullptr;
+    if (TIFFGetField(this->m_Image, TIFFTAG_SUBIFD, &numberOfSubIFDs, &subIFDOffsets))
+    {
+      this->m_LevelOffsets.insert(this->m_LevelOffsets.end(), subIFDOffsets, subIFDOffsets + numberOfSubIFDs);
     }
 
     // Checking if the TIFF contains subfiles
@@ -144,6 +130,7 @@ TIFFReaderInternal::Initialize()
       this->m_SubFiles = 0;
       this->m_IgnoredSubFiles = 0;
 
+      bool isFirstPage = true;
       for (unsigned int page = 0; page < this->m_NumberOfPages; ++page)
       {
         int32_t subfiletype = 6;
@@ -157,8 +144,15 @@ TIFFReaderInternal::Initialize()
           else if (subfiletype & FILETYPE_REDUCEDIMAGE || subfiletype & FILETYPE_MASK)
           {
             ++this->m_IgnoredSubFiles;
+            if (isFirstPage && !(subfiletype & FILETYPE_MASK))
+            {
+              this->m_LevelOffsets.push_back(TIFFCurrentDirOffset(this->m_Image));
+            }
+            TIFFReadDirectory(this->m_Image);
+            continue;
           }
         }
+        isFirstPage = (page == 0);
         TIFFReadDirectory(this->m_Image);
       }
 
@@ -166,27 +160,82 @@ TIFFReaderInternal::Initialize()
       TIFFSetDirectory(this->m_Image, 0);
     }
 
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
-
-    // If TIFFGetField returns false, there's no Photometric Interpretation
-    // set for this image, but that's a required field so we set a warning flag.
-    // (Because the "Photometrics" field is an enum, we can't rely on setting
-    // this->m_Photometrics to some signal value.)
-    if (TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics))
+    return this->ReadCurrentDirectory();
+  }
+
+  return 1;
+}
+
+int
+TIFFReaderInternal::SetLevel(unsigned int level)
+{
+  if (!this->m_Image || level >= this->m_LevelOffsets.size() ||
+      !TIFFSetSubDirectory(this->m_Image, this->m_LevelOffsets[level]))
+  {
+    return 0;
+  }
+
+  this->m_NumberOfPages = 1;
+  this->m_SubFiles = 0;
+  this->m_IgnoredSubFiles = 0;
+  return this->ReadCurrentDirectory();
+}
+
+int
+TIFFReaderInternal::ReadCurrentDirectory()
+{
+  if (!TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width) ||
+      !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height))
+  {
+    return 0;
+  }
+
+  // Get the resolution in each direction
+  TIFFGetField(this->m_Image, TIFFTAG_XRESOLUTION, &this->m_XResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_YRESOLUTION, &this->m_YResolution);
+  TIFFGetField(this->m_Image, TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
+
+  this->m_NumberOfTiles = 0;
+  this->m_TileRows = 0;
+  this->m_TileColumns = 0;
+  this->m_TileWidth = 0;
+  this->m_TileHeight = 0;
+  if (TIFFIsTiled(this->m_Image))
+  {
+    this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+
+    if (!TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth) ||
+        !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight))
     {
-      this->m_HasValidPhotometricInterpretation = true;
+      itkGenericExceptionMacro(<< "Cannot read tile width and tile length from file");
     }
     else
     {
-      this->m_HasValidPhotometricInterpretation = false;
+      this->m_TileRows = this->m_Height / this->m_TileHeight;
+      this->m_TileColumns = this->m_Width / this->m_TileWidth;
     }
   }
 
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION, &this->m_Orientation);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL, &this->m_SamplesPerPixel);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE, &this->m_BitsPerSample);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
+
+  // If TIFFGetField returns false, there's no Photometric Interpretation
+  // set for this image, but that's a required field so we set a warning flag.
+  // (Because the "Photometrics" field is an enum, we can't rely on setting
+  // this->m_Photometrics to some signal value.)
+  if (TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics))
+  {
+    this->m_HasValidPhotometricInterpretation = true;
+  }
+  else
+  {
+    this->m_HasValidPhotometricInterpretation = false;
+  }
+
   return 1;
 }
 
@@ -195,9 +244,7 @@ TIFFReaderInternal::CanRead()
 {
   const bool compressionSupported = (TIFFIsCODECConfigured(this->m_Compression) == 1);
   return (this->m_Image && (this->m_Width > 0) && (this->m_Height > 0) && (this->m_SamplesPerPixel > 0) &&
-          compressionSupported && (m_NumberOfTiles == 0) // just use TIFFReadRGBAImage, an
-                                                         // native optimized version would be nice
-          && (this->m_HasValidPhotometricInterpretation) &&
+          compressionSupported && (this->m_HasValidPhotometricInterpretation) &&
           (this->m_Photometrics == PHOTOMETRIC_RGB || this->m_Photometrics == PHOTOMETRIC_MINISWHITE ||
            this->m_Photometrics == PHOTOMETRIC_MINISBLACK ||
            (this->m_Photometrics == PHOTOMETRIC_PALETTE && this->m_BitsPerSample != 32)) &&
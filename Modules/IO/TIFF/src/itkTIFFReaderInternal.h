@@ -21,6 +21,7 @@
 #include "ITKIOTIFFExport.h"
 #include "itkIntTypes.h"
 #include "itk_tiff.h"
+#include <vector>
 
 
 namespace itk
@@ -42,6 +43,11 @@ public:
   int
   Open(const char * filename);
 
+  /** Makes the given resolution level the current directory, to be read as a
+   * single page image. */
+  int
+  SetLevel(unsigned int level);
+
   TIFF *   m_Image;
   bool     m_IsOpen;
   uint32_t m_Width;
@@ -66,6 +72,14 @@ public:
   float    m_XResolution;
   float    m_YResolution;
   uint16_t m_SampleFormat;
+
+  // Offsets of the directories of the full resolution image and of its
+  // reduced-resolution subfiles.
+  std::vector<toff_t> m_LevelOffsets;
+
+private:
+  int
+  ReadCurrentDirectory();
 };
 
 } // namespace itk
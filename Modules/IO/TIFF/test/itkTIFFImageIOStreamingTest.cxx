@@ -0,0 +1,321 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkRGBPixel.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTIFFImageIO.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+#include "itk_tiff.h"
+
+#include <vector>
+
+
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  using PixelTraits = itk::DefaultConvertPixelTraits<typename TImage::PixelType>;
+  using ComponentType = typename PixelTraits::ComponentType;
+
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int value = 0;
+  for (itk::ImageRegionIterator<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    auto & pixel = it.Value();
+    for (unsigned int c = 0; c < PixelTraits::GetNumberOfComponents(); ++c)
+    {
+      PixelTraits::SetNthComponent(static_cast<int>(c), pixel, static_cast<ComponentType>(value++ % 251));
+    }
+  }
+  return image;
+}
+
+bool
+IsTiled(const std::string & fileName)
+{
+  TIFF * const tiff = TIFFOpen(fileName.c_str(), "r");
+  const bool   isTiled = tiff != nullptr && TIFFIsTiled(tiff);
+  if (tiff != nullptr)
+  {
+    TIFFClose(tiff);
+  }
+  return isTiled;
+}
+
+// Writes the image in tiles or strips, then reads regions of it, and the
+// whole image in pieces.
+template <typename TImage>
+int
+TestStreaming(const TImage *                                   image,
+              const std::string &                              fileName,
+              unsigned int                                     tileSize,
+              const std::string &                              compressor,
+              const std::vector<typename TImage::RegionType> & regions)
+{
+  std::cout << "Streaming " << fileName << std::endl;
+
+  auto imageIO = itk::TIFFImageIO::New();
+  imageIO->SetTileWidth(tileSize);
+  imageIO->SetTileHeight(tileSize);
+  imageIO->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->SetUseCompression(compressor != "NoCompression");
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_EQUAL(IsTiled(fileName), tileSize > 0);
+
+  for (const auto & region : regions)
+  {
+    auto reader = itk::ImageFileReader<TImage>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(itk::TIFFImageIO::New());
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    ITK_TEST_EXPECT_TRUE(reader->GetImageIO()->CanStreamRead());
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<TImage>(image, reader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  constexpr unsigned int numberOfStreamDivisions = 3;
+
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetFileName(fileName);
+
+  auto monitor = itk::PipelineMonitorImageFilter<TImage>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto streamer = itk::StreamingImageFilter<TImage, TImage>::New();
+  streamer->SetInput(monitor->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(streamer->Update());
+
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+  if (!itk::Testing::EqualInRegion<TImage>(image, streamer->GetOutput(), image->GetBufferedRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+constexpr unsigned int numberOfLevels = 3;
+
+unsigned short
+PyramidValue(unsigned int level, unsigned int x, unsigned int y)
+{
+  return static_cast<unsigned short>(10000 * level + 100 * y + x);
+}
+
+// Writes a pyramid of numberOfLevels levels: a tiled full resolution image,
+// followed by reduced-resolution subfiles, stored either as SubIFDs or as the
+// next directories, alternately striped with a bottom-left orientation and
+// tiled.
+void
+WritePyramid(const std::string & fileName, bool useSubIFDs)
+{
+  TIFF * const tiff = TIFFOpen(fileName.c_str(), "w");
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    const uint32_t width = 96 >> level;
+    const uint32_t height = 80 >> level;
+    const bool     isTiled = level % 2 == 0;
+    TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, width);
+    TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, height);
+    TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, 1);
+    TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, 16);
+    TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+    TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_DEFLATE);
+    TIFFSetField(tiff, TIFFTAG_ORIENTATION, isTiled ? ORIENTATION_TOPLEFT : ORIENTATION_BOTLEFT);
+    if (level == 0 && useSubIFDs)
+    {
+      toff_t subIFDOffsets[numberOfLevels - 1] = {};
+      TIFFSetField(tiff, TIFFTAG_SUBIFD, numberOfLevels - 1, subIFDOffsets);
+    }
+    if (level > 0)
+    {
+      TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+    }
+
+    std::vector<unsigned short> pixels(size_t{ width } * height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+      const uint32_t row = isTiled ? y : height - 1 - y;
+      for (uint32_t x = 0; x < width; ++x)
+      {
+        pixels[row * width + x] = PyramidValue(level, x, y);
+      }
+    }
+
+    if (isTiled)
+    {
+      constexpr uint32_t tileSize = 16;
+      TIFFSetField(tiff, TIFFTAG_TILEWIDTH, tileSize);
+      TIFFSetField(tiff, TIFFTAG_TILELENGTH, tileSize);
+      std::vector<unsigned short> tile(tileSize * tileSize);
+      for (uint32_t tileRow = 0; tileRow < height; tileRow += tileSize)
+      {
+        for (uint32_t tileColumn = 0; tileColumn < width; tileColumn += tileSize)
+        {
+          std::fill(tile.begin(), tile.end(), 0);
+          for (uint32_t y = tileRow; y < std::min(height, tileRow + tileSize); ++y)
+          {
+            for (uint32_t x = tileColumn; x < std::min(width, tileColumn + tileSize); ++x)
+            {
+              tile[(y - tileRow) * tileSize + x - tileColumn] = pixels[y * width + x];
+            }
+          }
+          TIFFWriteTile(tiff, tile.data(), tileColumn, tileRow, 0, 0);
+        }
+      }
+    }
+    else
+    {
+      TIFFSetField(tiff, TIFFTAG_ROWSPERSTRIP, 7);
+      for (uint32_t row = 0; row < height; ++row)
+      {
+        TIFFWriteScanline(tiff, &pixels[row * width], row, 0);
+      }
+    }
+    TIFFWriteDirectory(tiff);
+  }
+  TIFFClose(tiff);
+}
+
+int
+TestPyramid(const std::string & fileName, bool useSubIFDs)
+{
+  std::cout << "Reading the levels of " << fileName << std::endl;
+
+  using ImageType = itk::Image<unsigned short, 2>;
+  WritePyramid(fileName, useSubIFDs);
+
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    const ImageType::SizeType   size{ { 96u >> level, 80u >> level } };
+    const ImageType::RegionType region{ { { 3, 17 >> level } }, { { size[0] / 2, size[1] / 3 } } };
+
+    auto imageIO = itk::TIFFImageIO::New();
+    imageIO->SetLevel(level);
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(imageIO);
+    reader->UpdateOutputInformation();
+    reader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfLevels(), numberOfLevels);
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfDimensions(), 2);
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetLargestPossibleRegion().GetSize(), size);
+    ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), region);
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(reader->GetOutput(), region); !it.IsAtEnd(); ++it)
+    {
+      const ImageType::IndexType index = it.GetIndex();
+      if (it.Get() != PyramidValue(level, index[0], index[1]))
+      {
+        std::cerr << "Pixel " << index << " of level " << level << " is " << it.Get() << " instead of "
+                  << PyramidValue(level, index[0], index[1]) << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  auto imageIO = itk::TIFFImageIO::New();
+  imageIO->SetLevel(numberOfLevels);
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_EXCEPTION(reader->Update());
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkTIFFImageIOStreamingTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string prefix = std::string(argv[1]) + "/itkTIFFImageIOStreamingTest";
+
+  using ShortImageType = itk::Image<unsigned short, 2>;
+  using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+  using FloatImageType = itk::Image<float, 3>;
+
+  const std::vector<ShortImageType::RegionType> regions2D{ { { { 0, 40 } }, { { 157, 3 } } },
+                                                           { { { 30, 17 } }, { { 41, 50 } } },
+                                                           { { { 156, 92 } }, { { 1, 1 } } } };
+  const std::vector<FloatImageType::RegionType> regions3D{ { { { 0, 0, 2 } }, { { 45, 37, 2 } } },
+                                                           { { { 7, 20, 1 } }, { { 17, 3, 4 } } } };
+
+  const ShortImageType::Pointer shortImage = MakeImage<ShortImageType>({ { 157, 93 } });
+  const RGBImageType::Pointer   rgbImage = MakeImage<RGBImageType>({ { 157, 93 } });
+  const FloatImageType::Pointer floatImage = MakeImage<FloatImageType>({ { 45, 37, 6 } });
+
+  int testStatus = EXIT_SUCCESS;
+  for (const char * compressor : { "NoCompression", "Deflate" })
+  {
+    for (const unsigned int tileSize : { 0u, 16u, 48u })
+    {
+      const std::string suffix = compressor + std::to_string(tileSize) + ".tif";
+      testStatus |=
+        TestStreaming<ShortImageType>(shortImage, prefix + "Short" + suffix, tileSize, compressor, regions2D);
+      testStatus |= TestStreaming<RGBImageType>(rgbImage, prefix + "RGB" + suffix, tileSize, compressor, regions2D);
+      testStatus |=
+        TestStreaming<FloatImageType>(floatImage, prefix + "Float" + suffix, tileSize, compressor, regions3D);
+    }
+  }
+
+  // Tiles must be multiples of 16 in both directions
+  auto imageIO = itk::TIFFImageIO::New();
+  imageIO->SetTileWidth(16);
+  imageIO->SetTileHeight(20);
+  auto writer = itk::ImageFileWriter<ShortImageType>::New();
+  writer->SetInput(shortImage);
+  writer->SetFileName(prefix + "InvalidTileSize.tif");
+  writer->SetImageIO(imageIO);
+  ITK_TRY_EXPECT_EXCEPTION(writer->Update());
+
+  testStatus |= TestPyramid(prefix + "Pyramid.tif", false);
+  testStatus |= TestPyramid(prefix + "PyramidSubIFDs.tif", true);
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}
@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkZarrImageIO_h
+#define itkZarrImageIO_h
+#include "ITKIOZarrExport.h"
+
+#include "itkStreamingImageIOBase.h"
+
+namespace itk
+{
+/**
+ * \class ZarrImageIO
+ *
+ * \brief ImageIO for Zarr (version 2) directory stores.
+ *
+ * A Zarr store is a directory in which an N-dimensional array is divided
+ * into chunks, each stored, possibly compressed, in its own file. This class
+ * reads and writes stores on the local file system, whose names end with
+ * ".zarr".
+ *
+ * An image is written as a group holding one array per resolution level:
+ * "0" is the full resolution image and each following level is subsampled
+ * by two along every dimension. The levels are described by the
+ * "multiscales" attribute of the group, following the OME-NGFF layout,
+ * with the pixel components as the last, fastest varying, axis. The
+ * direction cosines and pixel type are stored in its "itk" attribute. Arrays
+ * written by other tools, without these attributes, are read with unit
+ * spacing and zero origin.
+ *
+ * Only the chunks intersecting the region read or written are accessed, and
+ * they are decoded or encoded in parallel, so that both CanStreamRead() and
+ * CanStreamWrite() are true. When UseCompression is on, the chunks are
+ * compressed with the "ZLIB" compressor (the default) or the "GZIP" one;
+ * they are stored raw otherwise. Chunks compressed with "zlib" or "gzip",
+ * or raw, in either byte order and with either dimension separator, are
+ * read.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOZarr
+ */
+class ITKIOZarr_EXPORT ZarrImageIO : public StreamingImageIOBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ZarrImageIO);
+
+  /** Standard class type aliases. */
+  using Self = ZarrImageIO;
+  using Superclass = StreamingImageIOBase;
+  using Pointer = SmartPointer<Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ZarrImageIO, StreamingImageIOBase);
+
+  using ChunkSizeType = std::vector<SizeValueType>;
+
+  /** Set/Get the size of the chunks written, in pixels, along each dimension
+   * of the image. A size of 0, or a missing size, spans the whole image along
+   * its dimension, and sizes larger than the image are clamped. When empty
+   * (the default), chunks are 64 pixels wide along each dimension. */
+  void
+  SetChunkSize(const ChunkSizeType & chunkSize);
+  itkGetConstReferenceMacro(ChunkSize, ChunkSizeType);
+
+  /** Set/Get the number of resolution levels, including the full resolution
+   * image. When writing, it is the number of levels written, 1 by default.
+   * ReadImageInformation() sets it to the number of levels of the store. */
+  itkSetClampMacro(NumberOfLevels, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Set/Get the resolution level read. Level 0, the default, is the full
+   * resolution image. */
+  itkSetMacro(Level, unsigned int);
+  itkGetConstMacro(Level, unsigned int);
+
+  /*-------- This part of the interfaces deals with reading data. ----- */
+
+  /** Determine if the file can be read with this ImageIO implementation.
+   * Returns true if the file is a directory holding a Zarr array, or a group
+   * with "multiscales" attributes. */
+  bool
+  CanReadFile(const char *) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void
+  ReadImageInformation() override;
+
+  /** Reads the data from disk into the memory buffer provided. */
+  void
+  Read(void * buffer) override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine if the file can be written with this ImageIO
+   * implementation. */
+  bool
+  CanWriteFile(const char *) override;
+
+  /** The metadata of the store is written by Write(), when the first region
+   * is written. */
+  void
+  WriteImageInformation() override
+  {}
+
+  /** Writes the data to disk from the memory buffer provided. Make sure
+   * that the IORegion has been set properly. A store that already exists is
+   * replaced, unless the IORegion is only a part of the image, in which case
+   * the region is written into the existing store. */
+  void
+  Write(const void * buffer) override;
+
+  /** When the whole image is written in several pieces, makes the first
+   * piece written replace an existing store. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
+protected:
+  ZarrImageIO();
+  ~ZarrImageIO() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Also copies the level read, and the chunk size, number of levels and
+   * compression written. */
+  LightObject::Pointer
+  InternalClone() const override;
+
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
+  /** The image data is not stored in a single file. */
+  SizeType
+  GetHeaderSize() const override
+  {
+    return 0;
+  }
+
+private:
+  /** Returns the paths of the arrays of the resolution levels, and reads the
+   * image information of the given level into this object. */
+  std::vector<std::string>
+  ReadStoreInformation(unsigned int level);
+
+  /** Creates the store, replacing an existing one, with the image
+   * information of this object. */
+  void
+  CreateStore();
+
+  ChunkSizeType m_ChunkSize{};
+  unsigned int  m_NumberOfLevels{ 1 };
+  unsigned int  m_Level{ 0 };
+  bool          m_UseGzip{ false };
+  bool          m_CreateStoreOnWrite{ false };
+};
+} // end namespace itk
+
+#endif // itkZarrImageIO_h
@@ -0,0 +1,17 @@
+set(DOCUMENTATION "This module contains an ImageIO class for reading and writing
+images stored as <a href=\"https://zarr.readthedocs.io/\">Zarr</a> (version 2)
+directory stores, in which each chunk of the image is an independent file.")
+
+itk_module(ITKIOZarr
+  ENABLE_SHARED
+  DEPENDS
+    ITKIOImageBase
+  PRIVATE_DEPENDS
+    ITKZLIB
+  TEST_DEPENDS
+    ITKTestKernel
+  FACTORY_NAMES
+    ImageIO::Zarr
+  DESCRIPTION
+    "${DOCUMENTATION}"
+)
@@ -0,0 +1,1383 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkZarrImageIO.h"
+#include "itkByteSwapper.h"
+#include "itkMultiThreaderBase.h"
+#include "itkNumberToString.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+// A value of the JSON metadata files of a store.
+struct JSONValue
+{
+  enum class Type
+  {
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  Type                     type{ Type::Null };
+  bool                     boolean{ false };
+  double                   number{ 0.0 };
+  std::string              string{};
+  std::vector<JSONValue>   array{};
+  std::vector<std::string> keys{};
+  std::vector<JSONValue>   values{};
+
+  // Returns the value of the given key of an object, or nullptr.
+  const JSONValue *
+  Find(const std::string & key) const
+  {
+    const auto it = std::find(keys.cbegin(), keys.cend(), key);
+    return it == keys.cend() ? nullptr : &values[it - keys.cbegin()];
+  }
+};
+
+// A minimal JSON parser, enough for the metadata files of Zarr stores.
+class JSONReader
+{
+public:
+  explicit JSONReader(const std::string & text)
+    : m_Text(text)
+  {}
+
+  JSONValue
+  Read()
+  {
+    JSONValue value = this->ReadValue();
+    this->SkipWhitespace();
+    if (m_Position != m_Text.size())
+    {
+      this->Fail();
+    }
+    return value;
+  }
+
+private:
+  [[noreturn]] void
+  Fail() const
+  {
+    itkGenericExceptionMacro("Invalid JSON at offset " << m_Position);
+  }
+
+  void
+  SkipWhitespace()
+  {
+    while (m_Position < m_Text.size() && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+    {
+      ++m_Position;
+    }
+  }
+
+  bool
+  Consume(char c)
+  {
+    this->SkipWhitespace();
+    if (m_Position < m_Text.size() && m_Text[m_Position] == c)
+    {
+      ++m_Position;
+      return true;
+    }
+    return false;
+  }
+
+  void
+  Expect(char c)
+  {
+    if (!this->Consume(c))
+    {
+      this->Fail();
+    }
+  }
+
+  bool
+  ConsumeWord(const std::string & word)
+  {
+    if (m_Text.compare(m_Position, word.size(), word) == 0)
+    {
+      m_Position += word.size();
+      return true;
+    }
+    return false;
+  }
+
+  JSONValue
+  ReadValue()
+  {
+    JSONValue value;
+    if (this->Consume('{'))
+    {
+      value.type = JSONValue::Type::Object;
+      if (!this->Consume('}'))
+      {
+        do
+        {
+          this->SkipWhitespace();
+          value.keys.push_back(this->ReadString());
+          this->Expect(':');
+          value.values.push_back(this->ReadValue());
+        } while (this->Consume(','));
+        this->Expect('}');
+      }
+    }
+    else if (this->Consume('['))
+    {
+      value.type = JSONValue::Type::Array;
+      if (!this->Consume(']'))
+      {
+        do
+        {
+          value.array.push_back(this->ReadValue());
+        } while (this->Consume(','));
+        this->Expect(']');
+      }
+    }
+    else if (m_Position < m_Text.size() && m_Text[m_Position] == '"')
+    {
+      value.type = JSONValue::Type::String;
+      value.string = this->ReadString();
+    }
+    else if (this->ConsumeWord("true") || this->ConsumeWord("false"))
+    {
+      value.type = JSONValue::Type::Boolean;
+      value.boolean = m_Text[m_Position - 1] == 'e' && m_Text[m_Position - 2] == 'u';
+    }
+    else if (this->ConsumeWord("null"))
+    {
+      value.type = JSONValue::Type::Null;
+    }
+    else
+    {
+      // A number may end the text.
+      const size_t end = std::min(m_Text.find_first_not_of("+-0123456789.eE", m_Position), m_Text.size());
+      std::istringstream stream(m_Text.substr(m_Position, end - m_Position));
+      stream.imbue(std::locale::classic());
+      if (!(stream >> value.number) || !stream.eof())
+      {
+        this->Fail();
+      }
+      value.type = JSONValue::Type::Number;
+      m_Position = end;
+    }
+    return value;
+  }
+
+  std::string
+  ReadString()
+  {
+    if (m_Position >= m_Text.size() || m_Text[m_Position] != '"')
+    {
+      this->Fail();
+    }
+    ++m_Position;
+    std::string result;
+    while (m_Position < m_Text.size() && m_Text[m_Position] != '"')
+    {
+      const char c = m_Text[m_Position++];
+      if (c != '\\')
+      {
+        result += c;
+        continue;
+      }
+      if (m_Position >= m_Text.size())
+      {
+        this->Fail();
+      }
+      const char escaped = m_Text[m_Position++];
+      switch (escaped)
+      {
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'n':
+          result += '\n';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'u':
+        {
+          // code points of the basic multilingual plane, encoded as UTF-8
+          const std::string hexadecimal = m_Text.substr(m_Position, 4);
+          if (hexadecimal.size() != 4 || hexadecimal.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+          {
+            this->Fail();
+          }
+          m_Position += 4;
+          const unsigned long codePoint = std::stoul(hexadecimal, nullptr, 16);
+          if (codePoint < 0x80)
+          {
+            result += static_cast<char>(codePoint);
+          }
+          else if (codePoint < 0x800)
+          {
+            result += static_cast<char>(0xC0 | (codePoint >> 6));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+          }
+          else
+          {
+            result += static_cast<char>(0xE0 | (codePoint >> 12));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+          }
+          break;
+        }
+        default:
+          result += escaped;
+      }
+    }
+    if (m_Position >= m_Text.size())
+    {
+      this->Fail();
+    }
+    ++m_Position;
+    return result;
+  }
+
+  const std::string & m_Text;
+  size_t              m_Position{ 0 };
+};
+
+std::string
+QuoteJSON(const std::string & text)
+{
+  std::ostringstream quoted;
+  quoted << '"';
+  for (const char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted << '\\' << c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      quoted << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    }
+    else
+    {
+      quoted << c;
+    }
+  }
+  quoted << '"';
+  return quoted.str();
+}
+
+template <typename TValue>
+std::string
+JSONArray(const std::vector<TValue> & values)
+{
+  std::string text = "[";
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    text += (i == 0 ? "" : ", ") + ConvertNumberToString(values[i]);
+  }
+  return text + "]";
+}
+
+JSONValue
+ReadJSON(const std::string & fileName)
+{
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file)
+  {
+    itkGenericExceptionMacro("Unable to open " << fileName);
+  }
+  std::ostringstream text;
+  text << file.rdbuf();
+  try
+  {
+    return JSONReader(text.str()).Read();
+  }
+  catch (const ExceptionObject & error)
+  {
+    itkGenericExceptionMacro(<< error.GetDescription() << " in " << fileName);
+  }
+}
+
+void
+WriteText(const std::string & fileName, const std::string & text)
+{
+  std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file || !(file << text) || !file.flush())
+  {
+    itkGenericExceptionMacro("Unable to write " << fileName);
+  }
+}
+
+// The metadata of a Zarr array, from its ".zarray" file. The shape and the
+// chunks are in C order, the pixel components, if any, being the last
+// dimension.
+struct ZarrArray
+{
+  std::vector<SizeValueType> shape{};
+  std::vector<SizeValueType> chunks{};
+  IOComponentEnum            componentType{ IOComponentEnum::UNKNOWNCOMPONENTTYPE };
+  unsigned int               componentSize{ 0 };
+  bool                       bigEndian{ false };
+  std::string                compressor{};
+  int                        compressionLevel{ 1 };
+  double                     fillValue{ 0.0 };
+  char                       dimensionSeparator{ '.' };
+
+  SizeValueType
+  GetChunkLength() const
+  {
+    SizeValueType length = 1;
+    for (const SizeValueType chunk : chunks)
+    {
+      length *= chunk;
+    }
+    return length;
+  }
+
+  // Whether the chunks are in the byte order of this system.
+  bool
+  IsNativeByteOrder() const
+  {
+    return componentSize == 1 || bigEndian == ByteSwapper<int>::SystemIsBigEndian();
+  }
+};
+
+std::string
+ComponentTypeToDataType(IOComponentEnum componentType, unsigned int componentSize)
+{
+  char kind = 'i';
+  switch (componentType)
+  {
+    case IOComponentEnum::FLOAT:
+    case IOComponentEnum::DOUBLE:
+      kind = 'f';
+      break;
+    case IOComponentEnum::UCHAR:
+    case IOComponentEnum::USHORT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::ULONG:
+    case IOComponentEnum::ULONGLONG:
+      kind = 'u';
+      break;
+    default:
+      break;
+  }
+  const char byteOrder = componentSize == 1 ? '|' : (ByteSwapper<int>::SystemIsBigEndian() ? '>' : '<');
+  return std::string{ byteOrder, kind } + std::to_string(componentSize);
+}
+
+// Sets the component type, size and byte order of the array from its data
+// type, such as "<u2".
+void
+SetDataType(const std::string & dataType, ZarrArray & array)
+{
+  const unsigned int    size = dataType.size() == 3 ? dataType[2] - '0' : 0;
+  const char            kind = dataType.size() == 3 ? dataType[1] : ' ';
+  const IOComponentEnum signedTypes[] = {
+    IOComponentEnum::CHAR, IOComponentEnum::SHORT, IOComponentEnum::INT, IOComponentEnum::LONGLONG
+  };
+  const IOComponentEnum unsignedTypes[] = {
+    IOComponentEnum::UCHAR, IOComponentEnum::USHORT, IOComponentEnum::UINT, IOComponentEnum::ULONGLONG
+  };
+  const int             sizeIndex = size == 1 ? 0 : (size == 2 ? 1 : (size == 4 ? 2 : (size == 8 ? 3 : -1)));
+
+  array.componentType = IOComponentEnum::UNKNOWNCOMPONENTTYPE;
+  if (kind == 'f' && (size == 4 || size == 8))
+  {
+    array.componentType = size == 4 ? IOComponentEnum::FLOAT : IOComponentEnum::DOUBLE;
+  }
+  else if (kind == 'i' && sizeIndex >= 0)
+  {
+    array.componentType = signedTypes[sizeIndex];
+  }
+  else if ((kind == 'u' || (kind == 'b' && size == 1)) && sizeIndex >= 0)
+  {
+    array.componentType = unsignedTypes[sizeIndex];
+  }
+  if (array.componentType == IOComponentEnum::UNKNOWNCOMPONENTTYPE)
+  {
+    itkGenericExceptionMacro("Unsupported data type: " << dataType);
+  }
+  array.componentSize = size;
+  array.bigEndian = dataType[0] == '>';
+}
+
+ZarrArray
+ReadArray(const std::string & path)
+{
+  const std::string fileName = path + "/.zarray";
+  const JSONValue   metadata = ReadJSON(fileName);
+  const auto        get = [&metadata, &fileName](const char * key, JSONValue::Type type) -> const JSONValue & {
+    const JSONValue * value = metadata.Find(key);
+    if (value == nullptr || value->type != type)
+    {
+      itkGenericExceptionMacro("Missing or invalid \"" << key << "\" in " << fileName);
+    }
+    return *value;
+  };
+
+  if (get("zarr_format", JSONValue::Type::Number).number != 2)
+  {
+    itkGenericExceptionMacro("Unsupported Zarr format in " << fileName);
+  }
+  ZarrArray        array;
+  const JSONValue & shape = get("shape", JSONValue::Type::Array);
+  const JSONValue & chunks = get("chunks", JSONValue::Type::Array);
+  if (shape.array.empty() || shape.array.size() != chunks.array.size())
+  {
+    itkGenericExceptionMacro("Invalid shape or chunks in " << fileName);
+  }
+  for (size_t i = 0; i < shape.array.size(); ++i)
+  {
+    array.shape.push_back(static_cast<SizeValueType>(shape.array[i].number));
+    array.chunks.push_back(static_cast<SizeValueType>(chunks.array[i].number));
+    if (array.shape.back() == 0 || array.chunks.back() == 0)
+    {
+      itkGenericExceptionMacro("Invalid shape or chunks in " << fileName);
+    }
+  }
+  SetDataType(get("dtype", JSONValue::Type::String).string, array);
+
+  if (get("order", JSONValue::Type::String).string != "C")
+  {
+    itkGenericExceptionMacro("Unsupported order in " << fileName);
+  }
+  const JSONValue * filters = metadata.Find("filters");
+  if (filters != nullptr && filters->type != JSONValue::Type::Null &&
+      !(filters->type == JSONValue::Type::Array && filters->array.empty()))
+  {
+    itkGenericExceptionMacro("Unsupported filters in " << fileName);
+  }
+  const JSONValue * compressor = metadata.Find("compressor");
+  if (compressor != nullptr && compressor->type == JSONValue::Type::Object)
+  {
+    const JSONValue * id = compressor->Find("id");
+    array.compressor = id != nullptr ? id->string : "";
+    if (array.compressor != "zlib" && array.compressor != "gzip")
+    {
+      itkGenericExceptionMacro("Unsupported compressor \"" << array.compressor << "\" in " << fileName);
+    }
+    const JSONValue * level = compressor->Find("level");
+    array.compressionLevel = level != nullptr ? static_cast<int>(level->number) : array.compressionLevel;
+  }
+
+  const JSONValue * fillValue = metadata.Find("fill_value");
+  if (fillValue != nullptr && fillValue->type == JSONValue::Type::Number)
+  {
+    array.fillValue = fillValue->number;
+  }
+  else if (fillValue != nullptr && fillValue->type == JSONValue::Type::String)
+  {
+    array.fillValue = fillValue->string == "NaN" ? std::numeric_limits<double>::quiet_NaN()
+                                                 : (fillValue->string == "-Infinity" ? -1.0 : 1.0) *
+                                                     std::numeric_limits<double>::infinity();
+  }
+  const JSONValue * dimensionSeparator = metadata.Find("dimension_separator");
+  if (dimensionSeparator != nullptr && dimensionSeparator->string == "/")
+  {
+    array.dimensionSeparator = '/';
+  }
+  return array;
+}
+
+void
+WriteArray(const std::string & path, const ZarrArray & array)
+{
+  std::ostringstream metadata;
+  metadata << "{\n"
+           << "  \"zarr_format\": 2,\n"
+           << "  \"shape\": " << JSONArray(array.shape) << ",\n"
+           << "  \"chunks\": " << JSONArray(array.chunks) << ",\n"
+           << "  \"dtype\": " << QuoteJSON(ComponentTypeToDataType(array.componentType, array.componentSize)) << ",\n"
+           << "  \"compressor\": ";
+  if (array.compressor.empty())
+  {
+    metadata << "null";
+  }
+  else
+  {
+    metadata << "{ \"id\": " << QuoteJSON(array.compressor) << ", \"level\": " << array.compressionLevel << " }";
+  }
+  metadata << ",\n"
+           << "  \"fill_value\": " << ConvertNumberToString(array.fillValue) << ",\n"
+           << "  \"order\": \"C\",\n"
+           << "  \"filters\": null,\n"
+           << "  \"dimension_separator\": " << QuoteJSON(std::string(1, array.dimensionSeparator)) << "\n"
+           << "}\n";
+  WriteText(path + "/.zarray", metadata.str());
+}
+
+template <typename TComponent>
+void
+FillWith(char * data, SizeValueType numberOfComponents, double value)
+{
+  const auto component = std::isfinite(value) || std::numeric_limits<TComponent>::has_quiet_NaN
+                           ? static_cast<TComponent>(value)
+                           : TComponent{};
+  std::fill_n(reinterpret_cast<TComponent *>(data), numberOfComponents, component);
+}
+
+// Fills a chunk that is not stored with the fill value of the array.
+void
+FillChunk(const ZarrArray & array, char * chunk)
+{
+  const SizeValueType length = array.GetChunkLength();
+  switch (array.componentType)
+  {
+    case IOComponentEnum::CHAR:
+      FillWith<signed char>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::UCHAR:
+      FillWith<unsigned char>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::SHORT:
+      FillWith<int16_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::USHORT:
+      FillWith<uint16_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::INT:
+      FillWith<int32_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::UINT:
+      FillWith<uint32_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::LONGLONG:
+      FillWith<int64_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::ULONGLONG:
+      FillWith<uint64_t>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::FLOAT:
+      FillWith<float>(chunk, length, array.fillValue);
+      break;
+    case IOComponentEnum::DOUBLE:
+      FillWith<double>(chunk, length, array.fillValue);
+      break;
+    default:
+      std::fill_n(chunk, length * array.componentSize, '\0');
+  }
+}
+
+// Swaps the bytes of the length values of type T of a chunk, which converts
+// them from or to the byte order that is not the one of this system.
+template <typename T>
+void
+SwapValues(char * chunk, SizeValueType length)
+{
+  if (ByteSwapper<T>::SystemIsBigEndian())
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(reinterpret_cast<T *>(chunk), length);
+  }
+  else
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToBigEndian(reinterpret_cast<T *>(chunk), length);
+  }
+}
+
+void
+SwapBytes(const ZarrArray & array, char * chunk)
+{
+  const SizeValueType length = array.GetChunkLength();
+  switch (array.componentSize)
+  {
+    case 2:
+      SwapValues<uint16_t>(chunk, length);
+      break;
+    case 4:
+      SwapValues<uint32_t>(chunk, length);
+      break;
+    case 8:
+      SwapValues<uint64_t>(chunk, length);
+      break;
+    default:
+      break;
+  }
+}
+
+std::string
+GetChunkFileName(const std::string & path, const ZarrArray & array, const std::vector<SizeValueType> & chunkIndex)
+{
+  std::string fileName = path + '/';
+  for (size_t i = 0; i < chunkIndex.size(); ++i)
+  {
+    fileName += (i == 0 ? "" : std::string(1, array.dimensionSeparator)) + std::to_string(chunkIndex[i]);
+  }
+  return fileName;
+}
+
+// Reads the chunk of the given index into chunk, in the byte order of this
+// system. Returns false when the chunk is not stored.
+bool
+ReadChunk(const std::string &                path,
+          const ZarrArray &                  array,
+          const std::vector<SizeValueType> & chunkIndex,
+          char *                             chunk)
+{
+  const std::string fileName = GetChunkFileName(path, array, chunkIndex);
+  std::ifstream     file(fileName, std::ios::in | std::ios::binary);
+  if (!file)
+  {
+    return false;
+  }
+  const std::vector<char> encoded{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  const SizeValueType     chunkBytes = array.GetChunkLength() * array.componentSize;
+
+  if (array.compressor.empty())
+  {
+    if (encoded.size() != chunkBytes)
+    {
+      itkGenericExceptionMacro("Invalid chunk size of " << fileName);
+    }
+    std::copy(encoded.cbegin(), encoded.cend(), chunk);
+  }
+  else
+  {
+    // zlib and gzip streams are both detected
+    z_stream stream{};
+    if (inflateInit2(&stream, 15 + 32) != Z_OK)
+    {
+      itkGenericExceptionMacro("Unable to decompress " << fileName);
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(encoded.data()));
+    stream.avail_in = static_cast<uInt>(encoded.size());
+    stream.next_out = reinterpret_cast<Bytef *>(chunk);
+    stream.avail_out = static_cast<uInt>(chunkBytes);
+    const int result = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END || stream.total_out != chunkBytes)
+    {
+      itkGenericExceptionMacro("Unable to decompress " << fileName);
+    }
+  }
+  if (!array.IsNativeByteOrder())
+  {
+    SwapBytes(array, chunk);
+  }
+  return true;
+}
+
+// Writes the chunk of the given index, in the byte order of this system, and
+// swaps its bytes to the byte order of the array.
+void
+WriteChunk(const std::string &                path,
+           const ZarrArray &                  array,
+           const std::vector<SizeValueType> & chunkIndex,
+           char *                             chunk)
+{
+  if (!array.IsNativeByteOrder())
+  {
+    SwapBytes(array, chunk);
+  }
+  const SizeValueType chunkBytes = array.GetChunkLength() * array.componentSize;
+  const std::string   fileName = GetChunkFileName(path, array, chunkIndex);
+  std::vector<char>   encoded;
+  if (array.compressor.empty())
+  {
+    encoded.assign(chunk, chunk + chunkBytes);
+  }
+  else
+  {
+    z_stream stream{};
+    if (deflateInit2(&stream,
+                     array.compressionLevel,
+                     Z_DEFLATED,
+                     array.compressor == "gzip" ? 15 + 16 : 15,
+                     8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      itkGenericExceptionMacro("Unable to compress " << fileName);
+    }
+    encoded.resize(deflateBound(&stream, static_cast<uLong>(chunkBytes)));
+    stream.next_in = reinterpret_cast<Bytef *>(chunk);
+    stream.avail_in = static_cast<uInt>(chunkBytes);
+    stream.next_out = reinterpret_cast<Bytef *>(encoded.data());
+    stream.avail_out = static_cast<uInt>(encoded.size());
+    const int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
+    {
+      itkGenericExceptionMacro("Unable to compress " << fileName);
+    }
+    encoded.resize(stream.total_out);
+  }
+
+  if (array.dimensionSeparator == '/')
+  {
+    itksys::SystemTools::MakeDirectory(itksys::SystemTools::GetFilenamePath(fileName));
+  }
+  std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file || !file.write(encoded.data(), encoded.size()) || !file.flush())
+  {
+    itkGenericExceptionMacro("Unable to write " << fileName);
+  }
+}
+
+// Copies the box of the given extent at sourceStart, in a source of the given
+// shape, to destinationStart, in a destination of the given shape. All are in
+// C order, in elements of the given size.
+void
+CopyBox(const char *                       source,
+        const std::vector<SizeValueType> & sourceShape,
+        const std::vector<SizeValueType> & sourceStart,
+        char *                             destination,
+        const std::vector<SizeValueType> & destinationShape,
+        const std::vector<SizeValueType> & destinationStart,
+        const std::vector<SizeValueType> & extent,
+        SizeValueType                      elementSize)
+{
+  const size_t  rank = extent.size();
+  SizeValueType numberOfLines = 1;
+  for (size_t i = 0; i + 1 < rank; ++i)
+  {
+    numberOfLines *= extent[i];
+  }
+  std::vector<SizeValueType> position(rank, 0);
+  for (SizeValueType line = 0; line < numberOfLines; ++line)
+  {
+    SizeValueType remainder = line;
+    for (size_t i = rank - 1; i-- > 0;)
+    {
+      position[i] = remainder % extent[i];
+      remainder /= extent[i];
+    }
+    SizeValueType sourceOffset = 0;
+    SizeValueType destinationOffset = 0;
+    for (size_t i = 0; i < rank; ++i)
+    {
+      sourceOffset = sourceOffset * sourceShape[i] + sourceStart[i] + position[i];
+      destinationOffset = destinationOffset * destinationShape[i] + destinationStart[i] + position[i];
+    }
+    std::copy_n(source + sourceOffset * elementSize,
+                extent[rank - 1] * elementSize,
+                destination + destinationOffset * elementSize);
+  }
+}
+
+// Calls function(chunkIndex, chunkStart, start, size) in parallel for each
+// chunk of the array intersecting the region of the given start and size, with
+// the start and size of the intersection.
+template <typename TFunction>
+void
+ForEachChunk(const ZarrArray &                  array,
+             const std::vector<SizeValueType> & regionStart,
+             const std::vector<SizeValueType> & regionSize,
+             TFunction                          function)
+{
+  const size_t               rank = array.shape.size();
+  std::vector<SizeValueType> firstChunk(rank);
+  std::vector<SizeValueType> numberOfChunks(rank);
+  SizeValueType              totalNumberOfChunks = 1;
+  for (size_t i = 0; i < rank; ++i)
+  {
+    if (regionSize[i] == 0)
+    {
+      return;
+    }
+    firstChunk[i] = regionStart[i] / array.chunks[i];
+    numberOfChunks[i] = (regionStart[i] + regionSize[i] - 1) / array.chunks[i] - firstChunk[i] + 1;
+    totalNumberOfChunks *= numberOfChunks[i];
+  }
+
+  MultiThreaderBase::New()->ParallelizeArray(
+    0,
+    totalNumberOfChunks,
+    [&](SizeValueType n) {
+      std::vector<SizeValueType> chunkIndex(rank);
+      std::vector<SizeValueType> chunkStart(rank);
+      std::vector<SizeValueType> start(rank);
+      std::vector<SizeValueType> size(rank);
+      for (size_t i = rank; i-- > 0;)
+      {
+        chunkIndex[i] = firstChunk[i] + n % numberOfChunks[i];
+        n /= numberOfChunks[i];
+        chunkStart[i] = chunkIndex[i] * array.chunks[i];
+        start[i] = std::max(chunkStart[i], regionStart[i]);
+        size[i] = std::min(chunkStart[i] + array.chunks[i], regionStart[i] + regionSize[i]) - start[i];
+      }
+      function(chunkIndex, chunkStart, start, size);
+    },
+    nullptr);
+}
+
+std::vector<SizeValueType>
+Subtract(const std::vector<SizeValueType> & a, const std::vector<SizeValueType> & b)
+{
+  std::vector<SizeValueType> difference(a.size());
+  std::transform(a.cbegin(), a.cend(), b.cbegin(), difference.begin(), std::minus<SizeValueType>());
+  return difference;
+}
+
+void
+ReadRegion(const std::string &                path,
+           const ZarrArray &                  array,
+           const std::vector<SizeValueType> & regionStart,
+           const std::vector<SizeValueType> & regionSize,
+           char *                             buffer)
+{
+  ForEachChunk(array,
+               regionStart,
+               regionSize,
+               [&](const std::vector<SizeValueType> & chunkIndex,
+                   const std::vector<SizeValueType> & chunkStart,
+                   const std::vector<SizeValueType> & start,
+                   const std::vector<SizeValueType> & size) {
+                 std::vector<char> chunk(array.GetChunkLength() * array.componentSize);
+                 if (!ReadChunk(path, array, chunkIndex, chunk.data()))
+                 {
+                   FillChunk(array, chunk.data());
+                 }
+                 CopyBox(chunk.data(),
+                         array.chunks,
+                         Subtract(start, chunkStart),
+                         buffer,
+                         regionSize,
+                         Subtract(start, regionStart),
+                         size,
+                         array.componentSize);
+               });
+}
+
+void
+WriteRegion(const std::string &                path,
+            const ZarrArray &                  array,
+            const std::vector<SizeValueType> & regionStart,
+            const std::vector<SizeValueType> & regionSize,
+            const char *                       buffer)
+{
+  ForEachChunk(array,
+               regionStart,
+               regionSize,
+               [&](const std::vector<SizeValueType> & chunkIndex,
+                   const std::vector<SizeValueType> & chunkStart,
+                   const std::vector<SizeValueType> & start,
+                   const std::vector<SizeValueType> & size) {
+                 // the pixels of a chunk that are not in the region are kept
+                 bool covered = true;
+                 for (size_t i = 0; i < array.shape.size(); ++i)
+                 {
+                   covered = covered && start[i] == chunkStart[i] &&
+                             size[i] == std::min(array.chunks[i], array.shape[i] - chunkStart[i]);
+                 }
+                 std::vector<char> chunk(array.GetChunkLength() * array.componentSize);
+                 if (covered || !ReadChunk(path, array, chunkIndex, chunk.data()))
+                 {
+                   FillChunk(array, chunk.data());
+                 }
+                 CopyBox(buffer,
+                         regionSize,
+                         Subtract(start, regionStart),
+                         chunk.data(),
+                         array.chunks,
+                         Subtract(start, chunkStart),
+                         size,
+                         array.componentSize);
+                 WriteChunk(path, array, chunkIndex, chunk.data());
+               });
+}
+
+// Returns true if the directory holds a Zarr array or group.
+bool
+IsZarrStore(const std::string & path)
+{
+  return itksys::SystemTools::FileIsDirectory(path) &&
+         (itksys::SystemTools::FileExists(path + "/.zarray", true) ||
+          itksys::SystemTools::FileExists(path + "/.zgroup", true));
+}
+} // namespace
+
+ZarrImageIO::ZarrImageIO()
+{
+  this->AddSupportedReadExtension(".zarr");
+  this->AddSupportedWriteExtension(".zarr");
+
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(5);
+  this->Self::SetCompressor("");
+}
+
+ZarrImageIO::~ZarrImageIO() = default;
+
+LightObject::Pointer
+ZarrImageIO::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+
+  auto * rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval == nullptr)
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_ChunkSize = m_ChunkSize;
+  rval->m_NumberOfLevels = m_NumberOfLevels;
+  rval->m_Level = m_Level;
+  rval->m_UseGzip = m_UseGzip;
+  return loPtr;
+}
+
+void
+ZarrImageIO::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ChunkSize: [";
+  for (size_t i = 0; i < m_ChunkSize.size(); ++i)
+  {
+    os << (i == 0 ? "" : ", ") << m_ChunkSize[i];
+  }
+  os << ']' << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "UseGzip: " << (m_UseGzip ? "On" : "Off") << std::endl;
+}
+
+void
+ZarrImageIO::SetChunkSize(const ChunkSizeType & chunkSize)
+{
+  if (m_ChunkSize != chunkSize)
+  {
+    m_ChunkSize = chunkSize;
+    this->Modified();
+  }
+}
+
+void
+ZarrImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  if (_compressor.empty() || _compressor == "ZLIB")
+  {
+    m_UseGzip = false;
+  }
+  else if (_compressor == "GZIP")
+  {
+    m_UseGzip = true;
+  }
+  else
+  {
+    this->Superclass::InternalSetCompressor(_compressor);
+  }
+}
+
+bool
+ZarrImageIO::CanReadFile(const char * filename)
+{
+  const std::string path = filename;
+  if (path.empty() || !itksys::SystemTools::FileIsDirectory(path))
+  {
+    return false;
+  }
+  if (itksys::SystemTools::FileExists(path + "/.zarray", true))
+  {
+    return true;
+  }
+  if (!itksys::SystemTools::FileExists(path + "/.zattrs", true))
+  {
+    return false;
+  }
+  try
+  {
+    return ReadJSON(path + "/.zattrs").Find("multiscales") != nullptr;
+  }
+  catch (const ExceptionObject &)
+  {
+    return false;
+  }
+}
+
+std::vector<std::string>
+ZarrImageIO::ReadStoreInformation(unsigned int level)
+{
+  const std::string        store = m_FileName;
+  std::vector<std::string> paths;
+  std::vector<JSONValue>   transformations;
+  JSONValue                attributes;
+  JSONValue                axes;
+  if (itksys::SystemTools::FileExists(store + "/.zattrs", true))
+  {
+    attributes = ReadJSON(store + "/.zattrs");
+  }
+  if (itksys::SystemTools::FileExists(store + "/.zarray", true))
+  {
+    paths.push_back(store);
+  }
+  else
+  {
+    // the datasets of the first multiscale image of the group
+    const JSONValue * multiscales = attributes.Find("multiscales");
+    const JSONValue * datasets = multiscales != nullptr && !multiscales->array.empty()
+                                   ? multiscales->array[0].Find("datasets")
+                                   : nullptr;
+    if (datasets == nullptr || datasets->array.empty())
+    {
+      itkExceptionMacro("No multiscale image in " << store);
+    }
+    for (const JSONValue & dataset : datasets->array)
+    {
+      const JSONValue * path = dataset.Find("path");
+      if (path == nullptr || path->type != JSONValue::Type::String)
+      {
+        itkExceptionMacro("Invalid multiscales attribute in " << store);
+      }
+      paths.push_back(store + '/' + path->string);
+      const JSONValue * coordinateTransformations = dataset.Find("coordinateTransformations");
+      transformations.push_back(coordinateTransformations != nullptr ? *coordinateTransformations : JSONValue());
+    }
+    const JSONValue * multiscaleAxes = multiscales->array[0].Find("axes");
+    if (multiscaleAxes != nullptr)
+    {
+      axes = *multiscaleAxes;
+    }
+  }
+
+  m_NumberOfLevels = static_cast<unsigned int>(paths.size());
+  if (level >= paths.size())
+  {
+    itkExceptionMacro("Level " << level << " is not one of the " << paths.size() << " levels of " << store);
+  }
+  const ZarrArray array = ReadArray(paths[level]);
+
+  // the last axis holds the pixel components when it is a channel axis
+  const size_t      rank = array.shape.size();
+  const JSONValue * lastAxisType = axes.array.size() == rank && rank > 1 ? axes.array.back().Find("type") : nullptr;
+  const bool        hasComponents = lastAxisType != nullptr && lastAxisType->string == "channel";
+  const auto        numberOfDimensions = static_cast<unsigned int>(hasComponents ? rank - 1 : rank);
+  this->SetNumberOfDimensions(numberOfDimensions);
+  this->SetNumberOfComponents(hasComponents ? array.shape.back() : 1);
+  this->SetComponentType(array.componentType);
+
+  // the scale and translation of the level, if any
+  std::vector<double> scale(rank, 1.0);
+  std::vector<double> translation(rank, 0.0);
+  if (level < transformations.size())
+  {
+    for (const JSONValue & transformation : transformations[level].array)
+    {
+      const JSONValue * type = transformation.Find("type");
+      const JSONValue * values = type != nullptr ? transformation.Find(type->string) : nullptr;
+      if (values == nullptr || values->array.size() != rank ||
+          (type->string != "scale" && type->string != "translation"))
+      {
+        continue;
+      }
+      std::vector<double> & parameters = type->string == "scale" ? scale : translation;
+      for (size_t i = 0; i < rank; ++i)
+      {
+        parameters[i] = values->array[i].number;
+      }
+    }
+  }
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    this->SetDimensions(i, array.shape[numberOfDimensions - 1 - i]);
+    this->SetSpacing(i, scale[numberOfDimensions - 1 - i]);
+    this->SetOrigin(i, translation[numberOfDimensions - 1 - i]);
+  }
+
+  // the direction cosines and pixel type written by ITK
+  const JSONValue * itkAttributes = attributes.Find("itk");
+  const JSONValue * direction = itkAttributes != nullptr ? itkAttributes->Find("direction") : nullptr;
+  if (direction != nullptr && direction->array.size() == numberOfDimensions)
+  {
+    for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+      std::vector<double> axis;
+      for (const JSONValue & value : direction->array[i].array)
+      {
+        axis.push_back(value.number);
+      }
+      if (axis.size() == numberOfDimensions)
+      {
+        this->SetDirection(i, axis);
+      }
+    }
+  }
+  const JSONValue * pixelType = itkAttributes != nullptr ? itkAttributes->Find("pixelType") : nullptr;
+  this->SetPixelType(pixelType != nullptr ? ImageIOBase::GetPixelTypeFromString(pixelType->string)
+                                          : (hasComponents ? IOPixelEnum::VECTOR : IOPixelEnum::SCALAR));
+  return paths;
+}
+
+void
+ZarrImageIO::ReadImageInformation()
+{
+  this->ReadStoreInformation(m_Level);
+}
+
+void
+ZarrImageIO::Read(void * buffer)
+{
+  const std::vector<std::string> paths = this->ReadStoreInformation(m_Level);
+  const ZarrArray                array = ReadArray(paths[m_Level]);
+
+  // the region, in C order
+  const unsigned int         numberOfDimensions = this->GetNumberOfDimensions();
+  const ImageIORegion        regionToRead = this->GetIORegion();
+  std::vector<SizeValueType> start(array.shape.size(), 0);
+  std::vector<SizeValueType> size(array.shape);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    start[numberOfDimensions - 1 - i] = i < regionToRead.GetImageDimension() ? regionToRead.GetIndex(i) : 0;
+    size[numberOfDimensions - 1 - i] = i < regionToRead.GetImageDimension() ? regionToRead.GetSize(i) : 1;
+  }
+  ReadRegion(paths[m_Level], array, start, size, static_cast<char *>(buffer));
+}
+
+bool
+ZarrImageIO::CanWriteFile(const char * name)
+{
+  return this->HasSupportedWriteExtension(name);
+}
+
+void
+ZarrImageIO::CreateStore()
+{
+  const std::string store = m_FileName;
+  if (itksys::SystemTools::FileIsDirectory(store))
+  {
+    if (!IsZarrStore(store))
+    {
+      itkExceptionMacro(<< store << " exists and is not a Zarr store");
+    }
+    if (!itksys::SystemTools::RemoveADirectory(store))
+    {
+      itkExceptionMacro("Unable to remove " << store);
+    }
+  }
+  if (!itksys::SystemTools::MakeDirectory(store))
+  {
+    itkExceptionMacro("Unable to create " << store);
+  }
+  WriteText(store + "/.zgroup", "{\n  \"zarr_format\": 2\n}\n");
+
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  const unsigned int numberOfComponents = this->GetNumberOfComponents();
+  const char *       axisNames[] = { "x", "y", "z", "t" };
+
+  std::ostringstream axes;
+  axes << '[';
+  for (unsigned int i = numberOfDimensions; i-- > 0;)
+  {
+    axes << "{ \"name\": " << QuoteJSON(i < 4 ? axisNames[i] : "d" + std::to_string(i))
+         << ", \"type\": " << (i == 3 ? "\"time\"" : "\"space\"") << " }" << (i > 0 ? ", " : "");
+  }
+  if (numberOfComponents > 1)
+  {
+    axes << ", { \"name\": \"c\", \"type\": \"channel\" }";
+  }
+  axes << ']';
+
+  // each level halves the size of the previous one, and doubles its spacing
+  ZarrArray array;
+  array.componentType = this->GetComponentType();
+  array.componentSize = this->GetComponentSize();
+  array.bigEndian = ByteSwapper<int>::SystemIsBigEndian();
+  array.compressor = this->GetUseCompression() ? (m_UseGzip ? "gzip" : "zlib") : "";
+  array.compressionLevel = this->GetCompressionLevel();
+
+  std::vector<SizeValueType> shape(numberOfDimensions);
+  std::vector<double>        scale(numberOfDimensions);
+  std::vector<double>        translation(numberOfDimensions);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    shape[numberOfDimensions - 1 - i] = this->GetDimensions(i);
+    scale[numberOfDimensions - 1 - i] = this->GetSpacing(i);
+    translation[numberOfDimensions - 1 - i] = this->GetOrigin(i);
+  }
+  if (numberOfComponents > 1)
+  {
+    shape.push_back(numberOfComponents);
+    scale.push_back(1.0);
+    translation.push_back(0.0);
+  }
+
+  std::ostringstream datasets;
+  for (unsigned int level = 0; level < m_NumberOfLevels; ++level)
+  {
+    array.shape = shape;
+    array.chunks = shape;
+    for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+      SizeValueType & chunk = array.chunks[numberOfDimensions - 1 - i];
+      if (m_ChunkSize.empty())
+      {
+        chunk = 64;
+      }
+      else if (i < m_ChunkSize.size() && m_ChunkSize[i] > 0)
+      {
+        chunk = m_ChunkSize[i];
+      }
+      chunk = std::min(chunk, shape[numberOfDimensions - 1 - i]);
+    }
+    const std::string path = store + '/' + std::to_string(level);
+    if (!itksys::SystemTools::MakeDirectory(path))
+    {
+      itkExceptionMacro("Unable to create " << path);
+    }
+    WriteArray(path, array);
+
+    datasets << (level > 0 ? ",\n" : "") << "        {\n"
+             << "          \"path\": \"" << level << "\",\n"
+             << "          \"coordinateTransformations\": [\n"
+             << "            { \"type\": \"scale\", \"scale\": " << JSONArray(scale) << " },\n"
+             << "            { \"type\": \"translation\", \"translation\": " << JSONArray(translation) << " }\n"
+             << "          ]\n"
+             << "        }";
+
+    for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+      shape[i] = (shape[i] + 1) / 2;
+      scale[i] *= 2.0;
+    }
+  }
+
+  std::ostringstream direction;
+  direction << '[';
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    direction << (i > 0 ? ", " : "") << JSONArray(this->GetDirection(i));
+  }
+  direction << ']';
+
+  std::ostringstream attributes;
+  attributes << "{\n"
+             << "  \"multiscales\": [\n"
+             << "    {\n"
+             << "      \"axes\": " << axes.str() << ",\n"
+             << "      \"datasets\": [\n"
+             << datasets.str() << "\n"
+             << "      ]\n"
+             << "    }\n"
+             << "  ],\n"
+             << "  \"itk\": {\n"
+             << "    \"direction\": " << direction.str() << ",\n"
+             << "    \"pixelType\": " << QuoteJSON(ImageIOBase::GetPixelTypeAsString(this->GetPixelType())) << "\n"
+             << "  }\n"
+             << "}\n";
+  WriteText(store + "/.zattrs", attributes.str());
+}
+
+void
+ZarrImageIO::Write(const void * buffer)
+{
+  if (!this->RequestedToStream() || m_CreateStoreOnWrite || !IsZarrStore(m_FileName))
+  {
+    this->CreateStore();
+    m_CreateStoreOnWrite = false;
+  }
+
+  // the levels of the store, which may have been created by a previous call
+  const auto                     storeInformation = Self::New();
+  storeInformation->SetFileName(m_FileName);
+  const std::vector<std::string> paths = storeInformation->ReadStoreInformation(0);
+
+  // the region, in C order, without the pixel components
+  const unsigned int         numberOfDimensions = this->GetNumberOfDimensions();
+  const unsigned int         numberOfComponents = this->GetNumberOfComponents();
+  const SizeValueType        pixelSize = this->GetComponentSize() * numberOfComponents;
+  const ImageIORegion        regionToWrite = this->GetIORegion();
+  std::vector<SizeValueType> start(numberOfDimensions);
+  std::vector<SizeValueType> size(numberOfDimensions);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+  {
+    start[numberOfDimensions - 1 - i] = i < regionToWrite.GetImageDimension() ? regionToWrite.GetIndex(i) : 0;
+    size[numberOfDimensions - 1 - i] = i < regionToWrite.GetImageDimension() ? regionToWrite.GetSize(i) : 1;
+  }
+
+  std::vector<char> levelBuffer;
+  for (unsigned int level = 0; level < paths.size(); ++level)
+  {
+    const ZarrArray array = ReadArray(paths[level]);
+    if (ComponentTypeToDataType(array.componentType, array.componentSize) !=
+          ComponentTypeToDataType(this->GetComponentType(), this->GetComponentSize()) ||
+        array.shape.size() != numberOfDimensions + (numberOfComponents > 1 ? 1 : 0))
+    {
+      itkExceptionMacro("The pixel type or dimension of " << paths[level] << " does not match the image");
+    }
+
+    // the pixels of the region at the level, which subsamples the image
+    const char *               levelData = static_cast<const char *>(buffer);
+    std::vector<SizeValueType> levelStart(start);
+    std::vector<SizeValueType> levelSize(size);
+    if (level > 0)
+    {
+      const SizeValueType factor = SizeValueType{ 1 } << level;
+      SizeValueType       numberOfPixels = 1;
+      for (unsigned int i = 0; i < numberOfDimensions; ++i)
+      {
+        levelStart[i] = (start[i] + factor - 1) / factor;
+        levelSize[i] = (start[i] + size[i] + factor - 1) / factor - levelStart[i];
+        numberOfPixels *= levelSize[i];
+      }
+      levelBuffer.resize(numberOfPixels * pixelSize);
+      for (SizeValueType pixel = 0; pixel < numberOfPixels; ++pixel)
+      {
+        SizeValueType remainder = pixel;
+        SizeValueType offset = 0;
+        SizeValueType stride = 1;
+        for (unsigned int i = numberOfDimensions; i-- > 0;)
+        {
+          offset += ((levelStart[i] + remainder % levelSize[i]) * factor - start[i]) * stride;
+          remainder /= levelSize[i];
+          stride *= size[i];
+        }
+        std::copy_n(levelData + offset * pixelSize, pixelSize, levelBuffer.data() + pixel * pixelSize);
+      }
+      levelData = levelBuffer.data();
+    }
+    if (numberOfComponents > 1)
+    {
+      levelStart.push_back(0);
+      levelSize.push_back(numberOfComponents);
+    }
+    WriteRegion(paths[level], array, levelStart, levelSize, levelData);
+  }
+}
+
+unsigned int
+ZarrImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                               const ImageIORegion & pasteRegion,
+                                               const ImageIORegion & largestPossibleRegion)
+{
+  // the pieces of the whole image are written into a new store, which the
+  // first piece creates, instead of the existing store being removed now
+  m_CreateStoreOnWrite = pasteRegion == largestPossibleRegion;
+  if (m_CreateStoreOnWrite)
+  {
+    return this->GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+  }
+  return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+}
+} // end namespace itk
@@ -0,0 +1,277 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiThreaderBase.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkTestingEqualInRegion.h"
+#include "itkTestingMacros.h"
+#include "itkZarrImageIO.h"
+#include "itkZarrImageIOFactory.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+
+
+namespace
+{
+using PixelType = itk::Vector<short, 2>;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Streams the image from inputFileName to fileName, in the given number of
+// pieces, with the given chunk size and compressor, then reads the whole image
+// and regions of it.
+int
+TestStreaming(const ImageType *                       image,
+              const std::string &                     inputFileName,
+              const std::string &                     fileName,
+              const itk::ZarrImageIO::ChunkSizeType & chunkSize,
+              const std::string &                     compressor,
+              unsigned int                            numberOfStreamDivisions)
+{
+  std::cout << "Writing " << fileName << " in " << numberOfStreamDivisions << " pieces"
+            << (compressor.empty() ? "" : ", with " + compressor) << std::endl;
+
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(inputFileName);
+  reader->UseStreamingOn();
+
+  auto monitor = itk::PipelineMonitorImageFilter<ImageType>::New();
+  monitor->SetInput(reader->GetOutput());
+
+  auto imageIO = itk::ZarrImageIO::New();
+  imageIO->SetChunkSize(chunkSize);
+  imageIO->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(monitor->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->SetUseCompression(!compressor.empty());
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_TRUE(monitor->VerifyAllInputCanStream(numberOfStreamDivisions));
+  writer = nullptr;
+
+  const ImageType::Pointer writtenImage = itk::ReadImage<ImageType>(fileName);
+  ITK_TEST_EXPECT_EQUAL(writtenImage->GetBufferedRegion(), image->GetBufferedRegion());
+  ITK_TEST_EXPECT_EQUAL(writtenImage->GetSpacing(), image->GetSpacing());
+  ITK_TEST_EXPECT_EQUAL(writtenImage->GetOrigin(), image->GetOrigin());
+  ITK_TEST_EXPECT_EQUAL(writtenImage->GetDirection(), image->GetDirection());
+  if (!itk::Testing::EqualInRegion<ImageType>(image, writtenImage, image->GetBufferedRegion()))
+  {
+    return EXIT_FAILURE;
+  }
+
+  for (const ImageType::RegionType & region : { ImageType::RegionType{ { { 0, 0, 6 } }, { { 21, 12, 2 } } },
+                                                ImageType::RegionType{ { { 4, 3, 1 } }, { { 9, 1, 7 } } },
+                                                ImageType::RegionType{ { { 20, 11, 8 } }, { { 1, 1, 1 } } } })
+  {
+    auto regionReader = itk::ImageFileReader<ImageType>::New();
+    regionReader->SetFileName(fileName);
+    regionReader->UseStreamingOn();
+    regionReader->UpdateOutputInformation();
+    regionReader->GetOutput()->SetRequestedRegion(region);
+    ITK_TRY_EXPECT_NO_EXCEPTION(regionReader->Update());
+
+    ITK_TEST_EXPECT_EQUAL(regionReader->GetOutput()->GetBufferedRegion(), region);
+    if (!itk::Testing::EqualInRegion<ImageType>(image, regionReader->GetOutput(), region))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// Writes the image with several resolution levels, in the given number of
+// pieces, and verifies that each level subsamples the image.
+int
+TestLevels(const ImageType * image, const std::string & fileName, unsigned int numberOfStreamDivisions)
+{
+  std::cout << "Writing the levels of " << fileName << " in " << numberOfStreamDivisions << " pieces" << std::endl;
+
+  auto imageIO = itk::ZarrImageIO::New();
+  imageIO->SetChunkSize({ 4, 4, 4 });
+  imageIO->SetNumberOfLevels(3);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->UseCompressionOn();
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  for (const unsigned int level : { 0, 1, 2 })
+  {
+    auto levelIO = itk::ZarrImageIO::New();
+    levelIO->SetLevel(level);
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(levelIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(levelIO->GetNumberOfLevels(), 3);
+
+    const ImageType *   levelImage = reader->GetOutput();
+    const unsigned int  factor = 1u << level;
+    ImageType::SizeType expectedSize;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      expectedSize[d] = (image->GetBufferedRegion().GetSize(d) + factor - 1) / factor;
+      ITK_TEST_EXPECT_EQUAL(levelImage->GetSpacing()[d], image->GetSpacing()[d] * factor);
+    }
+    ITK_TEST_EXPECT_EQUAL(levelImage->GetBufferedRegion().GetSize(), expectedSize);
+    for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(levelImage, levelImage->GetBufferedRegion());
+         !it.IsAtEnd();
+         ++it)
+    {
+      const ImageType::IndexType index{ { it.GetIndex()[0] * factor,
+                                          it.GetIndex()[1] * factor,
+                                          it.GetIndex()[2] * factor } };
+      if (it.Get() != image->GetPixel(index))
+      {
+        std::cerr << "Pixel " << it.GetIndex() << " of level " << level << " is " << it.Get() << " instead of "
+                  << image->GetPixel(index) << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // There are only three levels.
+  auto levelIO = itk::ZarrImageIO::New();
+  levelIO->SetLevel(3);
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(levelIO);
+  ITK_TRY_EXPECT_EXCEPTION(reader->Update());
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+
+int
+itkZarrImageIOTest(int argc, char * argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ObjectFactoryBase::RegisterFactory(itk::ZarrImageIOFactory::New());
+
+  const std::string prefix = std::string(argv[1]) + "/itkZarrImageIOTest";
+
+  auto imageIO = itk::ZarrImageIO::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(imageIO, ZarrImageIO, StreamingImageIOBase);
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamRead());
+  ITK_TEST_EXPECT_TRUE(imageIO->CanStreamWrite());
+  ITK_TEST_EXPECT_TRUE(imageIO->CanWriteFile("image.zarr"));
+  ITK_TEST_EXPECT_TRUE(!imageIO->CanWriteFile("image.mha"));
+  ITK_TEST_EXPECT_TRUE(!imageIO->CanReadFile(argv[1]));
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize().empty());
+  const itk::ZarrImageIO::ChunkSizeType chunkSize{ 8, 8, 4 };
+  imageIO->SetChunkSize(chunkSize);
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChunkSize() == chunkSize);
+  ITK_TEST_SET_GET_VALUE(1, imageIO->GetNumberOfLevels());
+  imageIO->SetNumberOfLevels(0);
+  ITK_TEST_SET_GET_VALUE(1, imageIO->GetNumberOfLevels());
+  ITK_TEST_SET_GET_VALUE(0, imageIO->GetLevel());
+  ITK_TEST_SET_GET_VALUE(std::string(""), imageIO->GetCompressor());
+  imageIO->SetCompressor("gzip");
+  ITK_TEST_SET_GET_VALUE(std::string("gzip"), imageIO->GetCompressor());
+  imageIO->SetCompressor("Unknown");
+  ITK_TEST_SET_GET_VALUE(std::string(""), imageIO->GetCompressor());
+
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType{ { 21, 12, 9 } });
+  image->SetSpacing(itk::MakeVector(0.5, 0.75, 2.0));
+  image->SetOrigin(itk::MakePoint(-3.0, 1.5, 10.0));
+  ImageType::DirectionType direction;
+  direction.Fill(0.0);
+  direction(0, 1) = 1.0;
+  direction(1, 0) = -1.0;
+  direction(2, 2) = 1.0;
+  image->SetDirection(direction);
+  image->Allocate();
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Value()[0] = static_cast<short>(index[0] + 10 * index[1] + 100 * index[2]);
+    it.Value()[1] = static_cast<short>(-1000 * index[2]);
+  }
+  const std::string inputFileName = prefix + "Input.zarr";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, inputFileName));
+  ITK_TEST_EXPECT_TRUE(imageIO->CanReadFile(inputFileName.c_str()));
+
+  int testStatus = EXIT_SUCCESS;
+  for (const itk::ThreadIdType numberOfThreads : { 1, 4 })
+  {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+    for (const char * compressor : { "", "ZLIB", "GZIP" })
+    {
+      const std::string name = prefix + compressor + std::to_string(numberOfThreads);
+
+      // Chunks covered by the whole image, or by the slices of each piece.
+      testStatus |= TestStreaming(image, inputFileName, name + "Chunks.zarr", { 8, 8, 4 }, compressor, 1);
+      testStatus |= TestStreaming(image, inputFileName, name + "Slices.zarr", { 8, 8, 1 }, compressor, 5);
+
+      // Pieces that only cover parts of the chunks, and chunks clamped to the
+      // image, or spanning a whole dimension.
+      testStatus |= TestStreaming(image, inputFileName, name + "Pieces.zarr", { 8, 8, 4 }, compressor, 5);
+      testStatus |= TestStreaming(image, inputFileName, name + "Clamped.zarr", { 0, 64 }, compressor, 1);
+    }
+  }
+
+  // The chunks are compressed.
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileLength(prefix + "ZLIB1Chunks.zarr/0/0.0.0.0") <
+                       itksys::SystemTools::FileLength(prefix + "1Chunks.zarr/0/0.0.0.0"));
+
+  testStatus |= TestLevels(image, prefix + "Levels.zarr", 1);
+  testStatus |= TestLevels(image, prefix + "StreamedLevels.zarr", 5);
+
+  // A directory that is not a store is not replaced.
+  const std::string directory = prefix + "Directory.zarr";
+  itksys::SystemTools::MakeDirectory(directory);
+  ITK_TRY_EXPECT_EXCEPTION(itk::WriteImage(image, directory));
+
+  // Planning the pieces of a write leaves an existing store in place.
+  auto               splitIO = itk::ZarrImageIO::New();
+  itk::ImageIORegion largestRegion(3);
+  splitIO->SetFileName(inputFileName);
+  splitIO->SetNumberOfDimensions(3);
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    splitIO->SetDimensions(d, image->GetLargestPossibleRegion().GetSize(d));
+    largestRegion.SetSize(d, image->GetLargestPossibleRegion().GetSize(d));
+  }
+  ITK_TEST_EXPECT_EQUAL(splitIO->GetActualNumberOfSplitsForWriting(5, largestRegion, largestRegion), 5);
+  ITK_TEST_EXPECT_TRUE(imageIO->CanReadFile(inputFileName.c_str()));
+
+  // Metadata ending with a number, instead of the end of an object, are
+  // invalid.
+  const std::string truncatedFileName = prefix + "Truncated.zarr";
+  ITK_TRY_EXPECT_NO_EXCEPTION(itk::WriteImage(image, truncatedFileName));
+  std::ofstream(truncatedFileName + "/0/.zarray") << "{\"zarr_format\": 2";
+  ITK_TRY_EXPECT_EXCEPTION(itk::ReadImage<ImageType>(truncatedFileName));
+
+  std::cout << "Test finished." << std::endl;
+  return testStatus;
+}